@@ -0,0 +1,76 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace benchmarks
+ * @file: bench/bench_base16.cpp
+ *
+ * Throughput of bulk hex encoding and decoding compared to the byte at a time iterators.
+ *******************************************************************************/
+#include <solace/base16.hpp>
+#include <solace/byteWriter.hpp>
+
+#include "benchmark.hpp"
+
+#include <cstdlib>
+#include <vector>
+
+
+using namespace Solace;
+using Solace::bench::measure;
+
+
+int main() {
+    size_t const size = 1 << 24;
+    int const runs = 10;
+
+    std::vector<byte> data(size);
+    for (auto& b : data) {
+        b = static_cast<byte>(rand());
+    }
+
+    std::vector<byte> text(Base16Encoder::encodedSize(size));
+    std::vector<byte> decoded(size);
+    auto const dataView = wrapMemory(data.data(), data.size());
+    auto const textView = wrapMemory(text.data(), text.size());
+
+    measure("Base16Encoded_Iterator", size, runs, [&]() {
+        ByteWriter dest{textView};
+        for (auto i = base16Encode_begin(dataView), end = base16Encode_end(dataView); i != end; ++i) {
+            dest.write((*i).view());
+        }
+
+        return dest.position();
+    });
+
+    measure("base16Encode", size, runs, [&]() {
+        return base16Encode(dataView, textView).unwrap();
+    });
+
+    measure("Base16Decoded_Iterator", size, runs, [&]() {
+        ByteWriter dest{wrapMemory(decoded.data(), decoded.size())};
+        for (auto i = base16Decode_begin(textView), end = base16Decode_end(textView); i != end; ++i) {
+            dest.write(*i);
+        }
+
+        return dest.position();
+    });
+
+    measure("base16Decode", size, runs, [&]() {
+        return base16Decode(textView, wrapMemory(decoded.data(), decoded.size())).unwrap();
+    });
+
+    return (decoded == data) ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace benchmarks
+ * @file: bench/bench_base64.cpp
+ *
+ * Throughput of Base64 encoding and decoding compared to a scalar codec that writes one group at a time.
+ *******************************************************************************/
+#include <solace/base64.hpp>
+#include <solace/byteWriter.hpp>
+
+#include "benchmark.hpp"
+
+#include <cstdlib>
+#include <vector>
+
+
+using namespace Solace;
+using Solace::bench::measure;
+
+
+namespace {
+
+constexpr byte kAlphabet[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/// Scalar encoding that writes each group of 4 characters through the writer.
+size_t scalarEncode(ByteWriter& dest, byte const* src, size_t size) {
+    size_t i = 0;
+    for (; i + 2 < size; i += 3) {
+        byte const encoded[] = {
+            kAlphabet[(src[i] >> 2) & 0x3F],
+            kAlphabet[((src[i] & 0x3) << 4) | (src[i + 1] >> 4)],
+            kAlphabet[((src[i + 1] & 0xF) << 2) | (src[i + 2] >> 6)],
+            kAlphabet[src[i + 2] & 0x3F]
+        };
+
+        dest.write(wrapMemory(encoded));
+    }
+
+    return i;
+}
+
+
+/// Scalar decoding that writes each group of 3 bytes through the writer.
+size_t scalarDecode(ByteWriter& dest, byte const* src, size_t size, byte const* values) {
+    size_t i = 0;
+    for (; i + 4 <= size; i += 4) {
+        byte const decoded[] = {
+            static_cast<byte>(values[src[i]] << 2 | values[src[i + 1]] >> 4),
+            static_cast<byte>(values[src[i + 1]] << 4 | values[src[i + 2]] >> 2),
+            static_cast<byte>(values[src[i + 2]] << 6 | values[src[i + 3]])
+        };
+
+        dest.write(wrapMemory(decoded));
+    }
+
+    return i;
+}
+
+}  // namespace
+
+
+int main() {
+    size_t const size = 3 * (1 << 22);
+    int const runs = 10;
+
+    std::vector<byte> data(size);
+    for (auto& b : data) {
+        b = static_cast<byte>(rand());
+    }
+
+    std::vector<byte> text(Base64Encoder::encodedSize(size));
+    std::vector<byte> decoded(size);
+
+    byte values[256];
+    for (auto& v : values) {
+        v = 64;
+    }
+    for (byte i = 0; i < 64; ++i) {
+        values[kAlphabet[i]] = i;
+    }
+
+    measure("encode scalar", size, runs, [&]() {
+        ByteWriter dest{wrapMemory(text.data(), text.size())};
+        return scalarEncode(dest, data.data(), data.size());
+    });
+
+    measure("Base64Encoder", size, runs, [&]() {
+        ByteWriter dest{wrapMemory(text.data(), text.size())};
+        Base64Encoder(dest).encode(wrapMemory(data.data(), data.size()));
+        return dest.position();
+    });
+
+    measure("decode scalar", size, runs, [&]() {
+        ByteWriter dest{wrapMemory(decoded.data(), decoded.size())};
+        return scalarDecode(dest, text.data(), text.size(), values);
+    });
+
+    measure("Base64Decoder", size, runs, [&]() {
+        ByteWriter dest{wrapMemory(decoded.data(), decoded.size())};
+        Base64Decoder(dest).encode(wrapMemory(text.data(), text.size()));
+        return dest.position();
+    });
+
+    return (decoded == data) ? 0 : 1;
+}
@@ -0,0 +1,124 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace benchmarks
+ * @file: bench/bench_cursor.cpp
+ *
+ * Throughput of serializing records through reserved cursors compared to checked writes and reads.
+ *******************************************************************************/
+#include <solace/byteReader.hpp>
+#include <solace/byteWriter.hpp>
+
+#include "benchmark.hpp"
+
+#include <cstdlib>
+#include <vector>
+
+
+using namespace Solace;
+using Solace::bench::measure;
+
+
+namespace {
+
+struct Record {
+    uint64  id;
+    uint32  size;
+    uint16  kind;
+    uint16  flags;
+};
+
+constexpr size_t kRecordSize = sizeof(uint64) + sizeof(uint32) + 2 * sizeof(uint16);
+
+}  // namespace
+
+
+int main() {
+    size_t const count = 1 << 20;
+    size_t const size = count * kRecordSize;
+    int const runs = 10;
+
+    std::vector<Record> records(count);
+    for (auto& r : records) {
+        r.id = static_cast<uint64>(rand()) << 20 | static_cast<uint64>(rand());
+        r.size = static_cast<uint32>(rand());
+        r.kind = static_cast<uint16>(rand());
+        r.flags = static_cast<uint16>(rand());
+    }
+
+    std::vector<byte> buffer(size);
+    std::vector<Record> decoded(count);
+    auto const bufferView = wrapMemory(buffer.data(), buffer.size());
+
+    measure("ByteWriter_writeBE", size, runs, [&]() {
+        ByteWriter writer{bufferView};
+        for (auto const& r : records) {
+            if (!writer.writeBE(r.id) || !writer.writeBE(r.size) ||
+                !writer.writeBE(r.kind) || !writer.writeBE(r.flags)) {
+                break;
+            }
+        }
+
+        return writer.position();
+    });
+
+    measure("ByteWriter_Cursor", size, runs, [&]() {
+        ByteWriter writer{bufferView};
+        {
+            auto cursor = writer.reserve(size).unwrap();
+            for (auto const& r : records) {
+                cursor.putBE(r.id).putBE(r.size).putBE(r.kind).putBE(r.flags);
+            }
+        }
+
+        return writer.position();
+    });
+
+    measure("ByteReader_readBE", size, runs, [&]() {
+        ByteReader reader{bufferView};
+        for (auto& r : decoded) {
+            if (!reader.readBE(r.id) || !reader.readBE(r.size) ||
+                !reader.readBE(r.kind) || !reader.readBE(r.flags)) {
+                break;
+            }
+        }
+
+        return reader.position();
+    });
+
+    measure("ByteReader_Cursor", size, runs, [&]() {
+        ByteReader reader{bufferView};
+        {
+            auto cursor = reader.reserve(size).unwrap();
+            for (auto& r : decoded) {
+                r.id = cursor.getBE<uint64>();
+                r.size = cursor.getBE<uint32>();
+                r.kind = cursor.getBE<uint16>();
+                r.flags = cursor.getBE<uint16>();
+            }
+        }
+
+        return reader.position();
+    });
+
+    for (size_t i = 0; i < count; ++i) {
+        if (decoded[i].id != records[i].id || decoded[i].flags != records[i].flags) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
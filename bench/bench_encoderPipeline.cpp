@@ -0,0 +1,126 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace benchmarks
+ * @file: bench/bench_encoderPipeline.cpp
+ *
+ * Throughput of hashing and base64 encoding a blob in a single pass of a pipeline compared to
+ * a separate pass for the hash, the encoding and the copy into the output.
+ *******************************************************************************/
+#include <solace/encoderPipeline.hpp>
+#include <solace/base64.hpp>
+#include <solace/hashing/sha2.hpp>
+
+#include "benchmark.hpp"
+
+#include <cstdlib>
+#include <vector>
+
+
+using namespace Solace;
+using Solace::bench::measure;
+
+
+int main() {
+    size_t const size = 32 << 20;
+    int const runs = 5;
+
+    std::vector<byte> blob(size);
+    for (auto& b : blob) {
+        b = static_cast<byte>(rand());
+    }
+
+    auto const encodedSize = Base64Encoder::encodedSize(size);
+    std::vector<byte> encoded(encodedSize);
+    std::vector<byte> separateOutput(encodedSize);
+    std::vector<byte> pipelineOutput(encodedSize);
+    auto const blobView = wrapMemory(blob.data(), blob.size());
+
+    std::vector<byte> separateDigest;
+    measure("Separate_passes", size, runs, [&]() {
+        hashing::Sha256 hash;
+        hash.update(blobView);
+        auto const digest = hash.digest();
+        separateDigest.assign(digest.begin(), digest.end());
+
+        ByteWriter encodedWriter{wrapMemory(encoded.data(), encoded.size())};
+        if (!Base64Encoder{encodedWriter}.encode(blobView)) {
+            return size_t{0};
+        }
+
+        ByteWriter output{wrapMemory(separateOutput.data(), separateOutput.size())};
+        if (!output.write(encodedWriter.viewWritten())) {
+            return size_t{0};
+        }
+
+        return size_t{output.position()};
+    });
+
+    std::vector<byte> pipelineDigest;
+    measure("EncoderPipeline", size, runs, [&]() {
+        hashing::Sha256 hash;
+        ByteWriter output{wrapMemory(pipelineOutput.data(), pipelineOutput.size())};
+        Base64StreamEncoder base64{output};
+
+        EncoderPipeline pipeline{output};
+        pipeline.tap(hash)
+                .pipe(base64);
+        if (!pipeline.update(blobView) || !pipeline.finish()) {
+            return size_t{0};
+        }
+
+        auto const digest = hash.digest();
+        pipelineDigest.assign(digest.begin(), digest.end());
+
+        return size_t{output.position()};
+    });
+
+    if (separateOutput != pipelineOutput || separateDigest != pipelineDigest) {
+        return 1;
+    }
+
+    // Without the hash, which dominates the time above, the cost of the extra passes over memory shows
+    measure("Separate_passes_no_hash", size, runs, [&]() {
+        ByteWriter encodedWriter{wrapMemory(encoded.data(), encoded.size())};
+        if (!Base64Encoder{encodedWriter}.encode(blobView)) {
+            return size_t{0};
+        }
+
+        ByteWriter output{wrapMemory(separateOutput.data(), separateOutput.size())};
+        if (!output.write(encodedWriter.viewWritten())) {
+            return size_t{0};
+        }
+
+        return size_t{output.position()};
+    });
+
+    std::vector<byte> scratch(Base64Encoder::encodedSize(EncoderPipeline::kDefaultBlockSize + 2));
+    measure("EncoderPipeline_no_hash", size, runs, [&]() {
+        ByteWriter scratchWriter{wrapMemory(scratch.data(), scratch.size())};
+        ByteWriter output{wrapMemory(pipelineOutput.data(), pipelineOutput.size())};
+        Base64StreamEncoder base64{scratchWriter};
+
+        EncoderPipeline pipeline{output};
+        pipeline.pipe(base64);
+        if (!pipeline.update(blobView) || !pipeline.finish()) {
+            return size_t{0};
+        }
+
+        return size_t{output.position()};
+    });
+
+    return (separateOutput == pipelineOutput) ? 0 : 1;
+}
@@ -0,0 +1,86 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace benchmarks
+ * @file: bench/bench_endian.cpp
+ *
+ * Throughput of reading and writing arrays of big endian values compared to one value at a time.
+ *******************************************************************************/
+#include <solace/byteReader.hpp>
+#include <solace/byteWriter.hpp>
+
+#include "benchmark.hpp"
+
+#include <cstdlib>
+#include <vector>
+
+
+using namespace Solace;
+using Solace::bench::measure;
+
+
+int main() {
+    size_t const count = 1 << 22;
+    size_t const size = count * sizeof(uint32);
+    int const runs = 10;
+
+    std::vector<uint32> values(count);
+    for (auto& v : values) {
+        v = static_cast<uint32>(rand());
+    }
+
+    std::vector<byte> buffer(size);
+    std::vector<uint32> decoded(count);
+    auto const bufferView = wrapMemory(buffer.data(), buffer.size());
+
+    measure("writeBE_Loop", size, runs, [&]() {
+        ByteWriter writer{bufferView};
+        for (auto v : values) {
+            if (!writer.writeBE(v)) {
+                break;
+            }
+        }
+
+        return writer.position();
+    });
+
+    measure("writeBE_Array", size, runs, [&]() {
+        ByteWriter writer{bufferView};
+        return writer.writeBE(arrayView(values.data(), values.size()))
+                ? writer.position()
+                : 0;
+    });
+
+    measure("readBE_Loop", size, runs, [&]() {
+        ByteReader reader{bufferView};
+        for (auto& v : decoded) {
+            if (!reader.readBE(v)) {
+                break;
+            }
+        }
+
+        return reader.position();
+    });
+
+    measure("readBE_Array", size, runs, [&]() {
+        ByteReader reader{bufferView};
+        return reader.readBE(arrayView(decoded.data(), decoded.size()))
+                ? reader.position()
+                : 0;
+    });
+
+    return (decoded == values) ? 0 : 1;
+}
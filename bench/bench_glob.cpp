@@ -0,0 +1,126 @@
+/*
+*  Copyright 2016 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace benchmarks
+ * @file: bench/bench_glob.cpp
+ *
+ * Throughput of filtering paths with a set of globs compared to fnmatch.
+ *******************************************************************************/
+#include <solace/glob.hpp>
+
+#include "benchmark.hpp"
+
+#include <fnmatch.h>
+#include <string>
+#include <vector>
+
+
+using namespace Solace;
+using Solace::bench::measure;
+
+
+namespace {
+
+std::vector<std::string> makePaths(size_t count) {
+    char const* const dirs[] = {"src", "include", "solace", "test", "build", "docs", "third_party", "lib"};
+    char const* const files[] = {"main.cpp", "path.hpp", "README.md", "glob.o", "test_path.cpp", "CMakeLists.txt"};
+
+    std::vector<std::string> paths;
+    paths.reserve(count);
+
+    uint32 seed = 12345;
+    for (size_t i = 0; i < count; ++i) {
+        seed = seed * 1103515245 + 12345;
+        auto const depth = 1 + (seed >> 16) % 6;
+
+        std::string path;
+        for (size_t d = 0; d < depth; ++d) {
+            seed = seed * 1103515245 + 12345;
+            path += dirs[(seed >> 16) % 8];
+            path += '/';
+        }
+        seed = seed * 1103515245 + 12345;
+        path += files[(seed >> 16) % 6];
+        paths.push_back(std::move(path));
+    }
+
+    return paths;
+}
+
+
+
+void compare(char const* title, std::vector<std::string> const& strings, size_t bytes,
+             std::vector<char const*> const& patterns) {
+    int const runs = 10;
+
+    std::vector<StringView> views;
+    for (auto pattern : patterns) {
+        views.emplace_back(pattern);
+    }
+    auto const globs = makeGlobSet(ArrayView<const StringView>{views.data(), static_cast<uint32>(views.size())})
+            .unwrap();
+
+    std::cout << title << ", patterns: " << views.size() << std::endl;
+
+    measure("fnmatch", bytes, runs, [&strings, &patterns]() {
+        uint64 matches = 0;
+        for (auto const& s : strings) {
+            for (auto pattern : patterns) {
+                if (::fnmatch(pattern, s.c_str(), FNM_PATHNAME) == 0) {
+                    matches += 1;
+                    break;
+                }
+            }
+        }
+
+        return matches;
+    });
+
+    measure("GlobSet::matchesAny", bytes, runs, [&strings, &globs]() {
+        uint64 matches = 0;
+        for (auto const& s : strings) {
+            matches += globs.matchesAny(StringView{s.data(), static_cast<StringView::size_type>(s.size())}) ? 1 : 0;
+        }
+
+        return matches;
+    });
+}
+
+}  // namespace
+
+
+int main() {
+    auto const strings = makePaths(200000);
+    size_t bytes = 0;
+    for (auto const& s : strings) {
+        bytes += s.size();
+    }
+
+    std::cout << "Paths: " << strings.size() << ", " << bytes << " bytes" << std::endl;
+
+    // Globstars are not supported by fnmatch, so the patterns are ones both can evaluate
+    compare("Few patterns", strings, bytes,
+            {"*/*.o", "build/*/*", "*/*/*/*/*/*/CMakeLists.txt", "docs/*.md", "*/third_party/*"});
+
+    // A typical ignore list: most of the paths match none of the patterns
+    compare("Ignore list", strings, bytes,
+            {"*.o", "*.a", "*.so", "*.tmp", "*~", "*.swp", "*.orig", "*.rej", "*.pyc", "*.log",
+             "build/*", "*/build/*/*.d", "out/*", "bin/*", "obj/*", ".git/*", ".svn/*", "*/.cache/*",
+             "node_modules/*", "*/node_modules/*", "CMakeCache.txt", "*/CMakeFiles/*", "Makefile.in",
+             "*.gcda", "*.gcno", "core.[0-9]*", "*.bak", "tags", "TAGS", "*.[oa]ut"});
+
+    return 0;
+}
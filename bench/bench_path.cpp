@@ -0,0 +1,119 @@
+/*
+*  Copyright 2016 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace benchmarks
+ * @file: bench/bench_path.cpp
+ *
+ * Throughput of parsing, joining and normalizing paths.
+ *******************************************************************************/
+#include <solace/path.hpp>
+
+#include "benchmark.hpp"
+
+#include <string>
+#include <vector>
+
+
+using namespace Solace;
+using Solace::bench::measure;
+
+
+namespace {
+
+std::vector<std::string> makePaths(size_t count) {
+    char const* const names[] = {"usr", "local", "lib", "..", ".", "share", "libsolace", "include", "bin", "etc"};
+
+    std::vector<std::string> paths;
+    paths.reserve(count);
+
+    uint32 seed = 12345;
+    for (size_t i = 0; i < count; ++i) {
+        seed = seed * 1103515245 + 12345;
+        auto const depth = 2 + (seed >> 16) % 10;
+
+        std::string path;
+        for (size_t d = 0; d < depth; ++d) {
+            seed = seed * 1103515245 + 12345;
+            path += '/';
+            path += names[(seed >> 16) % 10];
+        }
+        paths.push_back(std::move(path));
+    }
+
+    return paths;
+}
+
+}  // namespace
+
+
+int main() {
+    size_t const count = 200000;
+    int const runs = 10;
+
+    auto const strings = makePaths(count);
+    size_t bytes = 0;
+    for (auto const& s : strings) {
+        bytes += s.size();
+    }
+
+    std::vector<Path> paths;
+    paths.reserve(count);
+    for (auto const& s : strings) {
+        paths.push_back(Path::parse(StringView{s.data(), static_cast<StringView::size_type>(s.size())}).unwrap());
+    }
+
+    std::cout << "Paths: " << count << ", " << bytes << " bytes" << std::endl;
+
+    measure("parse", bytes, runs, [&strings]() {
+        uint64 components = 0;
+        for (auto const& s : strings) {
+            components += Path::parse(StringView{s.data(), static_cast<StringView::size_type>(s.size())})
+                    .unwrap()
+                    .getComponentsCount();
+        }
+
+        return components;
+    });
+
+    measure("join", bytes, runs, [&paths]() {
+        uint64 components = 0;
+        for (auto const& p : paths) {
+            components += makePath(p, "include", StringView{"solace"}).getComponentsCount();
+        }
+
+        return components;
+    });
+
+    measure("normalize", bytes, runs, [&paths]() {
+        uint64 components = 0;
+        for (auto const& p : paths) {
+            components += p.normalize().getComponentsCount();
+        }
+
+        return components;
+    });
+
+    measure("getParent + startsWith", bytes, runs, [&paths]() {
+        uint64 matches = 0;
+        for (auto const& p : paths) {
+            matches += p.startsWith(p.getParent()) ? 1 : 0;
+        }
+
+        return matches;
+    });
+
+    return 0;
+}
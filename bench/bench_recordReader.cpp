@@ -0,0 +1,107 @@
+/*
+*  Copyright 2016 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace benchmarks
+ * @file: bench/bench_recordReader.cpp
+ *
+ * Throughput of splitting text into records with RecordReader,
+ * from memory and from a file descriptor, compared with a byte-at-a-time loop.
+ *******************************************************************************/
+#include <solace/recordReader.hpp>
+#include <solace/memoryManager.hpp>
+
+#include "benchmark.hpp"
+
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+
+
+using namespace Solace;
+using Solace::bench::measure;
+
+
+namespace {
+
+std::string makeText(size_t size, size_t averageLineLength, char const* delimiter) {
+    std::string text;
+    text.reserve(size + averageLineLength * 2);
+
+    uint32 seed = 12345;
+    while (text.size() < size) {
+        seed = seed * 1103515245 + 12345;
+        auto const length = 1 + (seed >> 16) % (2 * averageLineLength);
+        for (size_t i = 0; i < length; ++i) {
+            text += static_cast<char>('a' + (i + seed) % 26);
+        }
+        text += delimiter;
+    }
+
+    return text;
+}
+
+}  // namespace
+
+
+int main(int argc, const char **argv) {
+    size_t const size = 64 * 1024 * 1024;
+    size_t const lineLength = (argc > 1) ? std::stoul(argv[1]) : 80;
+    int const runs = 10;
+
+    auto text = makeText(size, lineLength, "\n");
+    auto crlfText = makeText(size, lineLength, "\r\n");
+    std::cout << "Splitting " << text.size() << " bytes with average record length " << lineLength << std::endl;
+
+    measure("byte loop", text.size(), runs, [&text]() {
+        uint64 count = 0;
+        for (auto c : text) {
+            count += (c == '\n');
+        }
+
+        return count;
+    });
+
+    measure("RecordReader(memory)", text.size(), runs, [&text]() {
+        RecordReader reader{wrapMemory(&text[0], text.size())};
+
+        return reader.forEach([](StringView) {}).unwrap();
+    });
+
+    measure("RecordReader(memory, \"\\r\\n\")", crlfText.size(), runs, [&crlfText]() {
+        RecordReader reader{wrapMemory(&crlfText[0], crlfText.size()), "\r\n"};
+
+        return reader.forEach([](StringView) {}).unwrap();
+    });
+
+    auto file = std::tmpfile();
+    if (!file || std::fwrite(text.data(), 1, text.size(), file) != text.size() || std::fflush(file) != 0) {
+        std::cerr << "Failed to write a temporary file" << std::endl;
+        return 1;
+    }
+
+    auto const fd = ::fileno(file);
+    measure("RecordReader(fd)", text.size(), runs, [fd]() {
+        ::lseek(fd, 0, SEEK_SET);
+        RecordReader reader{fd};
+
+        return reader.forEach([](StringView) {}).unwrap();
+    });
+
+    std::fclose(file);
+
+    return 0;
+}
@@ -0,0 +1,134 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace benchmarks
+ * @file: bench/bench_uuid.cpp
+ *
+ * Throughput of UUID generation compared to filling UUIDs with rand(),
+ * and of UUID text conversion compared to generic base16 encoding.
+ *******************************************************************************/
+#include <solace/uuid.hpp>
+#include <solace/base16.hpp>
+#include <solace/byteWriter.hpp>
+
+#include "benchmark.hpp"
+
+#include <cstdlib>
+#include <vector>
+
+
+using namespace Solace;
+using Solace::bench::measure;
+
+
+int main() {
+    size_t const count = 1000000;
+    int const runs = 5;
+    size_t const bytes = count * UUID::StaticSize;
+
+    std::vector<UUID> ids(count);
+    auto const view = arrayView(ids.data(), ids.size());
+
+    measure("rand()", bytes, runs, [&ids]() {
+        for (auto& id : ids) {
+            for (auto& b : id) {
+                b = static_cast<byte>(rand());
+            }
+        }
+
+        return ids.size();
+    });
+
+    measure("makeRandomUUID", bytes, runs, [&ids]() {
+        for (auto& id : ids) {
+            id = makeRandomUUID();
+        }
+
+        return ids.size();
+    });
+
+    measure("makeRandomUUIDs", bytes, runs, [view]() {
+        makeRandomUUIDs(view);
+
+        return view.size();
+    });
+
+    measure("makeTimeOrderedUUID", bytes, runs, [&ids]() {
+        for (auto& id : ids) {
+            id = makeTimeOrderedUUID();
+        }
+
+        return ids.size();
+    });
+
+    measure("makeTimeOrderedUUIDs", bytes, runs, [view]() {
+        makeTimeOrderedUUIDs(view);
+
+        return view.size();
+    });
+
+    std::vector<char> text(count * UUID::StringSize);
+    auto const textView = wrapMemory(text.data(), text.size());
+
+    measure("Base16Encoder", bytes, runs, [&ids, &text]() {
+        ByteWriter dest{wrapMemory(text.data(), text.size())};
+        Base16Encoder encoder{dest};
+        for (auto const& id : ids) {
+            auto const data = id.view();
+            encoder.encode(data.slice(0, 4));
+            dest.write('-');
+            encoder.encode(data.slice(4, 6));
+            dest.write('-');
+            encoder.encode(data.slice(6, 8));
+            dest.write('-');
+            encoder.encode(data.slice(8, 10));
+            dest.write('-');
+            encoder.encode(data.slice(10, 16));
+        }
+
+        return ids.size();
+    });
+
+    measure("UUID::toString", bytes, runs, [&ids, &text]() {
+        auto out = text.data();
+        for (auto const& id : ids) {
+            id.toString(wrapMemory(out, UUID::StringSize));
+            out += UUID::StringSize;
+        }
+
+        return ids.size();
+    });
+
+    measure("formatUUIDs", bytes, runs, [view, textView]() {
+        return formatUUIDs(view, textView).unwrap() / UUID::StringSize;
+    });
+
+    measure("UUID::parse", bytes, runs, [&ids, &text]() {
+        auto in = text.data();
+        for (auto& id : ids) {
+            id = UUID::parse(StringView{in, UUID::StringSize}).unwrap();
+            in += UUID::StringSize;
+        }
+
+        return ids.size();
+    });
+
+    measure("parseUUIDs", bytes, runs, [view, textView]() {
+        return parseUUIDs(textView, view).isOk() ? view.size() : 0;
+    });
+
+    return 0;
+}
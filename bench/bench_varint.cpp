@@ -0,0 +1,87 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace benchmarks
+ * @file: bench/bench_varint.cpp
+ *
+ * Throughput of batch varint decoding compared to reading one value at a time,
+ * for values of a few different length distributions.
+ *******************************************************************************/
+#include <solace/byteReader.hpp>
+#include <solace/byteWriter.hpp>
+
+#include "benchmark.hpp"
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+
+using namespace Solace;
+using Solace::bench::measure;
+
+
+namespace {
+
+int run(char const* name, uint32 maxBits) {
+    size_t const count = 1 << 22;
+    int const runs = 10;
+
+    std::vector<uint32> values(count);
+    for (auto& v : values) {
+        auto const bits = 1 + static_cast<uint32>(rand()) % maxBits;
+        v = static_cast<uint32>(rand()) & static_cast<uint32>((uint64{1} << bits) - 1);
+    }
+
+    std::vector<byte> encoded(count * 5);
+    ByteWriter writer{wrapMemory(encoded.data(), encoded.size())};
+    if (!writer.writeVarints(arrayView(values.data(), values.size()))) {
+        return 1;
+    }
+    auto const encodedView = writer.viewWritten();
+
+    std::vector<uint32> decoded(count);
+    auto const scalarName = std::string("readVarint_") + name;
+    measure(scalarName.c_str(), encodedView.size(), runs, [&]() {
+        ByteReader reader{encodedView};
+        for (auto& v : decoded) {
+            if (!reader.readVarint(v)) {
+                break;
+            }
+        }
+
+        return reader.position();
+    });
+
+    auto const batchName = std::string("readVarints_") + name;
+    measure(batchName.c_str(), encodedView.size(), runs, [&]() {
+        ByteReader reader{encodedView};
+        return reader.readVarints(arrayView(decoded.data(), decoded.size()))
+                ? reader.position()
+                : 0;
+    });
+
+    return (decoded == values) ? 0 : 1;
+}
+
+}  // namespace
+
+
+int main() {
+    return run("Small", 7) |
+            run("Mixed", 16) |
+            run("Full", 32);
+}
@@ -0,0 +1,113 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace benchmarks
+ * @file: bench/bench_version.cpp
+ *
+ * Throughput of parsing and sorting a package index of versions with Version and CompactVersion.
+ *******************************************************************************/
+#include <solace/compactVersion.hpp>
+
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+
+using namespace Solace;
+using Solace::bench::measure;
+
+
+namespace {
+
+std::string makeIndex(size_t count) {
+    char const* const labels[] = {"", "", "", "-alpha.1", "-beta.2", "-rc.1", "+build.7", "-rc.2+sha.5114f85"};
+
+    std::string index;
+    uint32 seed = 12345;
+    for (size_t i = 0; i < count; ++i) {
+        seed = seed * 1103515245 + 12345;
+        index += std::to_string((seed >> 16) % 20) + '.';
+        seed = seed * 1103515245 + 12345;
+        index += std::to_string((seed >> 16) % 50) + '.';
+        seed = seed * 1103515245 + 12345;
+        index += std::to_string((seed >> 16) % 200);
+        seed = seed * 1103515245 + 12345;
+        index += labels[(seed >> 16) % 8];
+        index += '\n';
+    }
+
+    return index;
+}
+
+
+/// Precedence of Version: numbers first, then a release follows its pre-releases.
+bool versionLess(Version const& lhs, Version const& rhs) {
+    if (lhs.majorNumber != rhs.majorNumber) {
+        return lhs.majorNumber < rhs.majorNumber;
+    }
+    if (lhs.minorNumber != rhs.minorNumber) {
+        return lhs.minorNumber < rhs.minorNumber;
+    }
+    if (lhs.patchNumber != rhs.patchNumber) {
+        return lhs.patchNumber < rhs.patchNumber;
+    }
+    if (lhs.preRelease.empty() || rhs.preRelease.empty()) {
+        return !lhs.preRelease.empty() && rhs.preRelease.empty();
+    }
+
+    auto const a = lhs.preRelease.view();
+    auto const b = rhs.preRelease.view();
+
+    return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+}
+
+}  // namespace
+
+
+int main() {
+    size_t const count = 200000;
+    int const runs = 5;
+
+    auto const index = makeIndex(count);
+    auto const bytes = index.size();
+    std::cout << "Versions: " << count << ", " << bytes << " bytes" << std::endl;
+
+    measure("Version::parse + sort", bytes, runs, [&index]() {
+        std::vector<Version> versions;
+        for (size_t i = 0; i < index.size(); ) {
+            auto const end = index.find('\n', i);
+            versions.push_back(Version::parse(StringView{index.data() + i,
+                                                         static_cast<StringView::size_type>(end - i)}).unwrap());
+            i = end + 1;
+        }
+
+        std::sort(versions.begin(), versions.end(), versionLess);
+
+        return versions.size();
+    });
+
+    measure("parseVersions + sort", bytes, runs, [&index]() {
+        VersionLabels labels;
+        auto versions = parseVersions(wrapMemory(index.data(), index.size()), labels).unwrap();
+        std::sort(versions.begin(), versions.end(), labels.less());
+
+        return versions.size();
+    });
+
+    return 0;
+}
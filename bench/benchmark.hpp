@@ -0,0 +1,57 @@
+/*
+*  Copyright 2016 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace benchmarks
+ * @file: bench/benchmark.hpp
+ *
+ * Minimal timing helpers shared by benchmarks.
+ *******************************************************************************/
+#pragma once
+#ifndef SOLACE_BENCH_BENCHMARK_HPP
+#define SOLACE_BENCH_BENCHMARK_HPP
+
+#include <solace/types.hpp>
+
+#include <chrono>
+#include <iostream>
+
+
+namespace Solace { namespace bench {
+
+/**
+ * Run the function the given number of times and print throughput.
+ * @param name Name of the benchmark.
+ * @param bytes Number of bytes processed by one run.
+ * @param runs Number of runs.
+ * @param f Function to run, returns number of items processed so that the work is not optimized away.
+ */
+template<typename F>
+void measure(char const* name, size_t bytes, int runs, F&& f) {
+    uint64 items = 0;
+    auto const start = std::chrono::steady_clock::now();
+    for (int i = 0; i < runs; ++i) {
+        items += f();
+    }
+    auto const elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << name << ": "
+              << (static_cast<double>(bytes) * runs / elapsed / 1e9) << " GB/s, "
+              << (static_cast<double>(items) / elapsed / 1e6) << " M items/s" << std::endl;
+}
+
+}  // namespace bench
+}  // namespace Solace
+#endif  // SOLACE_BENCH_BENCHMARK_HPP
@@ -0,0 +1,82 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace: ASCII case conversion
+ *	@file		solace/asciiCase.hpp
+ *	@brief		Locale independent case folding of ASCII text.
+ *
+ * Only ASCII letters 'A'-'Z' and 'a'-'z' are affected: all other bytes, including
+ * bytes of multi-byte UTF-8 sequences, are left as is.
+ * This is the case-insensitivity required by protocols such as HTTP.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_ASCIICASE_HPP
+#define SOLACE_ASCIICASE_HPP
+
+#include "solace/stringView.hpp"
+#include "solace/mutableMemoryView.hpp"
+#include "solace/result.hpp"
+#include "solace/error.hpp"
+
+
+namespace Solace {
+
+/// Convert ASCII letter to lower case. Other characters are returned as is.
+constexpr char toLowerAscii(char c) noexcept {
+    return (c >= 'A' && c <= 'Z')
+            ? static_cast<char>(c + ('a' - 'A'))
+            : c;
+}
+
+/// Convert ASCII letter to upper case. Other characters are returned as is.
+constexpr char toUpperAscii(char c) noexcept {
+    return (c >= 'a' && c <= 'z')
+            ? static_cast<char>(c - ('a' - 'A'))
+            : c;
+}
+
+
+/**
+ * Copy the string into the given buffer converting ASCII letters to lower case.
+ * The destination may be the memory of the source itself to convert the string in place.
+ *
+ * @param str String to convert.
+ * @param dest Destination buffer. Must be at least str.size() bytes long.
+ * @return View of the converted string in the destination buffer or an error if the buffer is too small.
+ */
+Result<StringView, Error> toLowerAscii(StringView str, MutableMemoryView dest) noexcept;
+
+/**
+ * Copy the string into the given buffer converting ASCII letters to upper case.
+ * @see toLowerAscii
+ */
+Result<StringView, Error> toUpperAscii(StringView str, MutableMemoryView dest) noexcept;
+
+
+/**
+ * Find the first position where two character sequences differ ignoring case of ASCII letters.
+ * @return Index of the first mismatch or count if the sequences are equal.
+ */
+size_t mismatchIgnoreCaseAscii(char const* a, char const* b, size_t count) noexcept;
+
+/**
+ * Find the first occurrence of the given character ignoring case of ASCII letters.
+ * @return Index of the first occurrence or count if there is none.
+ */
+size_t findIgnoreCaseAscii(char const* data, size_t count, char c) noexcept;
+
+}  // End of namespace Solace
+#endif  // SOLACE_ASCIICASE_HPP
@@ -27,6 +27,37 @@
 
 namespace Solace {
 
+/// Case of letters of hex digits.
+enum class LetterCase : byte {
+    Lower,
+    Upper,
+    Any         //!< Letters of either case are accepted by decoders, encoders write lower case.
+};
+
+
+/**
+ * Encode bytes as hex digits, writing straight into the destination memory.
+ * Large inputs are encoded with AVX2 or SSSE3 instructions when the CPU supports them.
+ * @param src Bytes to encode.
+ * @param dest Memory to write 2 characters for each byte to.
+ * @param letterCase Case of the letters to write.
+ * @return Number of characters written or an error if the destination is too small.
+ */
+Result<MemoryView::size_type, Error>
+base16Encode(MemoryView src, MutableMemoryView dest, LetterCase letterCase = LetterCase::Lower);
+
+/**
+ * Decode hex digits, writing straight into the destination memory.
+ * @param src Text of an even number of hex digits.
+ * @param dest Memory to write a byte for each pair of digits to.
+ * @param letterCase Case of the letters to accept.
+ * @return Number of bytes written or an error if the text is not hex digits of the accepted case,
+ * its size is odd or the destination is too small.
+ */
+Result<MemoryView::size_type, Error>
+base16Decode(MemoryView src, MutableMemoryView dest, LetterCase letterCase = LetterCase::Any);
+
+
 /**
  * RFC-4648 compatible Base16 encoder.
  */
@@ -38,8 +69,9 @@ public:
 
 public:
 
-    Base16Encoder(ByteWriter& dest) :
-        Encoder(dest)
+    Base16Encoder(ByteWriter& dest, LetterCase letterCase = LetterCase::Lower) :
+        Encoder(dest),
+        _letterCase(letterCase)
     {}
 
     size_type encodedSize(MemoryView const& data) const override;
@@ -48,6 +80,9 @@ public:
 
     Result<void, Error>
     encode(MemoryView const& src) override;
+
+private:
+    LetterCase  _letterCase;
 };
 
 class Base16Encoded_Iterator {
@@ -98,8 +133,9 @@ public:
 
 public:
 
-    Base16Decoder(ByteWriter& dest) :
-        Encoder(dest)
+    Base16Decoder(ByteWriter& dest, LetterCase letterCase = LetterCase::Any) :
+        Encoder(dest),
+        _letterCase(letterCase)
     {}
 
     size_type encodedSize(const MemoryView& data) const override;
@@ -108,6 +144,9 @@ public:
 
     Result<void, Error>
     encode(const MemoryView& src) override;
+
+private:
+    LetterCase  _letterCase;
 };
 
 
@@ -151,5 +190,79 @@ Base16Decoded_Iterator base16Decode_end(MemoryView src) {
     return {src.end(), src.end()};
 }
 
+
+/**
+ * Base16 encoder of data that comes in chunks.
+ * Each byte is encoded on its own, so nothing is carried over between chunks.
+ */
+class Base16StreamEncoder : public StreamEncoder {
+public:
+    using StreamEncoder::size_type;
+
+public:
+
+    Base16StreamEncoder(ByteWriter& dest, LetterCase letterCase = LetterCase::Lower) :
+        StreamEncoder(dest),
+        _letterCase(letterCase)
+    {}
+
+    size_type maxOutputSize(size_type chunkSize) const noexcept override {
+        return Base16Encoder::encodedSize(chunkSize);
+    }
+
+    using StreamEncoder::update;
+
+    Result<void, Error>
+    update(MemoryView const& chunk) override;
+
+    Result<void, Error>
+    finish() override {
+        return Ok();
+    }
+
+    void reset() noexcept override {}
+
+private:
+    LetterCase  _letterCase;
+};
+
+
+/**
+ * Base16 decoder of data that comes in chunks.
+ * A character of a pair split between chunks is carried over to the next chunk.
+ */
+class Base16StreamDecoder : public StreamEncoder {
+public:
+    using StreamEncoder::size_type;
+
+public:
+
+    Base16StreamDecoder(ByteWriter& dest, LetterCase letterCase = LetterCase::Any) :
+        StreamEncoder(dest),
+        _letterCase(letterCase)
+    {}
+
+    size_type maxOutputSize(size_type chunkSize) const noexcept override {
+        return Base16Decoder::encodedSize(_carrySize + chunkSize);
+    }
+
+    using StreamEncoder::update;
+
+    Result<void, Error>
+    update(MemoryView const& chunk) override;
+
+    Result<void, Error>
+    finish() override;
+
+    void reset() noexcept override {
+        _carrySize = 0;
+    }
+
+private:
+    byte        _carry;
+    byte        _carrySize{0};
+    LetterCase  _letterCase;
+};
+
 }  // End of namespace Solace
 #endif  // SOLACE_BASE16_HPP
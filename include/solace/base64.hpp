@@ -28,6 +28,8 @@ namespace Solace {
 
 /**
  * RFC-4648 compatible Base64 encoder.
+ * Encoded text is written straight into the destination, which must have room for the whole of it.
+ * Large inputs are encoded with AVX2 or SSSE3 instructions when the CPU supports them.
  */
 class Base64Encoder : public Encoder {
 public:
@@ -55,11 +57,15 @@ public:
 
 /**
  * RFC-4648 compatible Base64 decoder.
+ * Decoding is strict: the text must only consist of characters of the alphabet, optionally followed by
+ * the padding that completes the last group of 4 characters, and the unused bits of the last character must be zero.
+ * Any other input is rejected with an error and nothing is written to the destination.
  */
 class Base64Decoder : public Encoder {
 public:
     using Encoder::size_type;
 
+    /// Number of bytes the text decodes to, 0 if the length of the text is not a valid length of encoded data.
     static size_type decodedSize(MemoryView const& data);
 
 public:
@@ -122,5 +128,117 @@ public:
 };
 
 
+/**
+ * Base64 encoder of data that comes in chunks.
+ * Up to 2 bytes that don't make a group of 3 are carried over to the next chunk, padding is only written by finish.
+ */
+class Base64StreamEncoder : public StreamEncoder {
+public:
+    using StreamEncoder::size_type;
+
+public:
+
+    Base64StreamEncoder(ByteWriter& dest) :
+        Base64StreamEncoder(dest, false)
+    {}
+
+    size_type maxOutputSize(size_type chunkSize) const noexcept override {
+        return Base64Encoder::encodedSize(_carrySize + chunkSize);
+    }
+
+    using StreamEncoder::update;
+
+    Result<void, Error>
+    update(MemoryView const& chunk) override;
+
+    Result<void, Error>
+    finish() override;
+
+    void reset() noexcept override {
+        _carrySize = 0;
+    }
+
+protected:
+
+    Base64StreamEncoder(ByteWriter& dest, bool urlSafe) :
+        StreamEncoder(dest),
+        _urlSafe(urlSafe)
+    {}
+
+private:
+    byte    _carry[2];
+    byte    _carrySize{0};
+    bool    _urlSafe;
+};
+
+
+/**
+ * URL safe variant of Base64 stream encoder.
+ */
+class Base64UrlStreamEncoder : public Base64StreamEncoder {
+public:
+
+    Base64UrlStreamEncoder(ByteWriter& dest) :
+        Base64StreamEncoder(dest, true)
+    {}
+};
+
+
+/**
+ * Base64 decoder of data that comes in chunks.
+ * Up to 3 characters that don't make a group of 4 are carried over to the next chunk.
+ * Decoding is as strict as of Base64Decoder: padding may only end the last chunk.
+ */
+class Base64StreamDecoder : public StreamEncoder {
+public:
+    using StreamEncoder::size_type;
+
+public:
+
+    Base64StreamDecoder(ByteWriter& dest) :
+        Base64StreamDecoder(dest, false)
+    {}
+
+    size_type maxOutputSize(size_type chunkSize) const noexcept override;
+
+    using StreamEncoder::update;
+
+    Result<void, Error>
+    update(MemoryView const& chunk) override;
+
+    Result<void, Error>
+    finish() override;
+
+    void reset() noexcept override {
+        _carrySize = 0;
+        _padded = false;
+    }
+
+protected:
+
+    Base64StreamDecoder(ByteWriter& dest, bool urlSafe) :
+        StreamEncoder(dest),
+        _urlSafe(urlSafe)
+    {}
+
+private:
+    byte    _carry[3];
+    byte    _carrySize{0};
+    bool    _padded{false};     //!< Padding has been decoded, no more data is expected.
+    bool    _urlSafe;
+};
+
+
+/**
+ * URL safe variant of Base64 stream decoder.
+ */
+class Base64UrlStreamDecoder : public Base64StreamDecoder {
+public:
+
+    Base64UrlStreamDecoder(ByteWriter& dest) :
+        Base64StreamDecoder(dest, true)
+    {}
+};
+
 }  // End of namespace Solace
 #endif  // SOLACE_BASE64_HPP
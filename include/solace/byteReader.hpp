@@ -25,10 +25,13 @@
 #include "solace/memoryView.hpp"
 #include "solace/mutableMemoryView.hpp"     // read destination
 #include "solace/memoryResource.hpp"
+#include "solace/array.hpp"
 
 #include "solace/result.hpp"
 #include "solace/error.hpp"
 
+#include <cstring>  // memcpy
+
 
 namespace Solace {
 
@@ -41,6 +44,8 @@ class ByteReader {
 public:
     using size_type = MemoryResource::size_type;
 
+    class Cursor;
+
 public:
 
     ~ByteReader() noexcept = default;
@@ -265,9 +270,72 @@ public:
     Result<void, Error>  readBE(int64& value) noexcept { return readBE(reinterpret_cast<uint64&>(value)); }
     Result<void, Error>  readBE(uint64& value)noexcept;
 
+    /**
+     * Read an array of little endian values.
+     * Bounds are checked once for the whole array. Values are copied as is if the platform is little endian,
+     * otherwise bytes of all the values are reversed at once using SIMD shuffles where available.
+     * Only values of 1, 2, 4 or 8 bytes can be swapped, so wider types such as long double are not accepted.
+     * @return Nothing if successfull or an error if the buffer has fewer bytes than the values take.
+     */
+    template<typename T>
+    std::enable_if_t<std::is_arithmetic<T>::value && sizeof(T) <= sizeof(uint64) && !std::is_const<T>::value,
+                     Result<void, Error>>
+    readLE(ArrayView<T> values) noexcept {
+        return readArray(values.begin(), values.size(), sizeof(T), isBigendian());
+    }
+
+    template<typename T>
+    std::enable_if_t<std::is_arithmetic<T>::value && sizeof(T) <= sizeof(uint64), Result<void, Error>>
+    readLE(Array<T>& values) noexcept { return readLE(values.view()); }
+
+    /**
+     * Read an array of big endian values.
+     * @see readLE(ArrayView<T>)
+     */
+    template<typename T>
+    std::enable_if_t<std::is_arithmetic<T>::value && sizeof(T) <= sizeof(uint64) && !std::is_const<T>::value,
+                     Result<void, Error>>
+    readBE(ArrayView<T> values) noexcept {
+        return readArray(values.begin(), values.size(), sizeof(T), !isBigendian());
+    }
+
+    template<typename T>
+    std::enable_if_t<std::is_arithmetic<T>::value && sizeof(T) <= sizeof(uint64), Result<void, Error>>
+    readBE(Array<T>& values) noexcept { return readBE(values.view()); }
+
+    /**
+     * Read a LEB128 variable length integer: 7 bits per byte, least significant first,
+     * with the high bit set in all bytes but the last. Signed values are zigzag encoded.
+     * @return Nothing if successfull or an error if the buffer ends before the value does
+     * or the value doesn't fit the type. Position is not changed on error.
+     */
+    Result<void, Error>  readVarint(int32& value) noexcept;
+    Result<void, Error>  readVarint(uint32& value) noexcept;
+    Result<void, Error>  readVarint(int64& value) noexcept;
+    Result<void, Error>  readVarint(uint64& value) noexcept;
+
+    /**
+     * Read a variable length integer into each of the values.
+     * Runs of values shorter than 3 bytes are decoded several at a time with SIMD instructions.
+     * @return Nothing if successfull or an error if any of the values is malformed. Position is not changed on error.
+     */
+    Result<void, Error>  readVarints(ArrayView<uint32> values) noexcept;
+
+    /**
+     * Reserve a run of bytes for reads that need no checks of their own.
+     * Bounds are checked once here, the cursor reads with plain loads and advances the position of this reader
+     * by the number of bytes read when it is destroyed. The reader must not be used while the cursor is alive.
+     * @param size Number of bytes to reserve. Reading more than that through the cursor is undefined behaviour.
+     * @return A cursor to read up to size bytes or an error if fewer bytes are left.
+     */
+    Result<Cursor, Error> reserve(size_type size) noexcept;
+
 protected:
     Result<void, Error>  read(void* dest, size_type count) noexcept;
 
+    /// Read count values of the given size, reversing bytes of each if swap is true.
+    Result<void, Error>  readArray(void* dest, size_type count, size_type elementSize, bool swap) noexcept;
+
 protected:
 
     size_type           _position{};
@@ -278,6 +346,92 @@ protected:
 };
 
 
+/**
+ * Unchecked reader of the bytes reserved by ByteReader::reserve().
+ *
+ * Example:
+ * @code{.cpp}
+ *  auto cursor = reader.reserve(points.size() * 2 * sizeof(uint32)).unwrap();
+ *  for (auto& p : points) {
+ *      p.x = cursor.getBE<uint32>();
+ *      p.y = cursor.getBE<uint32>();
+ *  }
+ * @endcode
+ */
+class ByteReader::Cursor {
+public:
+
+    ~Cursor() noexcept {
+        if (_reader) {
+            _reader->_position += consumed();
+        }
+    }
+
+    Cursor(Cursor const&) = delete;
+    Cursor& operator= (Cursor const&) = delete;
+    Cursor& operator= (Cursor&&) = delete;
+
+    Cursor(Cursor&& rhs) noexcept
+        : _reader{exchange(rhs._reader, nullptr)}
+        , _begin{rhs._begin}
+        , _position{rhs._position}
+    {}
+
+    /// Number of bytes read through this cursor.
+    size_type consumed() const noexcept { return static_cast<size_type>(_position - _begin); }
+
+    byte get() noexcept { return *_position++; }
+
+    Cursor& read(MutableMemoryView dest) noexcept {
+        std::memcpy(dest.dataAddress(), _position, dest.size());
+        _position += dest.size();
+
+        return *this;
+    }
+
+    Cursor& skip(size_type count) noexcept {
+        _position += count;
+
+        return *this;
+    }
+
+    /// Read a value stored in little endian byte order.
+    template<typename T>
+    std::enable_if_t<std::is_arithmetic<T>::value, T>
+    getLE() noexcept { return load<T>(kBigEndian); }
+
+    /// Read a value stored in big endian byte order.
+    template<typename T>
+    std::enable_if_t<std::is_arithmetic<T>::value, T>
+    getBE() noexcept { return load<T>(!kBigEndian); }
+
+private:
+
+    friend class ByteReader;
+
+    static constexpr bool kBigEndian = (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__);
+
+    Cursor(ByteReader& reader, byte const* begin) noexcept
+        : _reader{&reader}
+        , _begin{begin}
+        , _position{begin}
+    {}
+
+    template<typename T>
+    T load(bool swap) noexcept {
+        T value;
+        std::memcpy(&value, _position, sizeof(T));
+        _position += sizeof(T);
+
+        return swap ? byteSwapped(value) : value;
+    }
+
+    ByteReader*     _reader;
+    byte const*     _begin;
+    byte const*     _position;
+};
+
+
 inline
 void swap(ByteReader& lhs, ByteReader& rhs) noexcept {
     lhs.swap(rhs);
@@ -24,10 +24,13 @@
 
 #include "solace/mutableMemoryView.hpp"
 #include "solace/memoryResource.hpp"
+#include "solace/array.hpp"
 
 #include "solace/result.hpp"
 #include "solace/error.hpp"
 
+#include <cstring>  // memcpy
+
 
 namespace Solace {
 
@@ -39,6 +42,8 @@ class ByteWriter {
 public:
     using size_type = MemoryResource::size_type;
 
+    class Cursor;
+
 public:
 
     ~ByteWriter() noexcept = default;
@@ -264,10 +269,69 @@ public:
     Result<void, Error> writeBE(int64 value) noexcept { return writeBE(static_cast<uint64>(value)); }
     Result<void, Error> writeBE(uint64 value) noexcept;
 
+    /**
+     * Write an array of values in little endian byte order.
+     * Bounds are checked once for the whole array. Values are copied as is if the platform is little endian,
+     * otherwise bytes of all the values are reversed at once using SIMD shuffles where available.
+     * Only values of 1, 2, 4 or 8 bytes can be swapped, so wider types such as long double are not accepted.
+     * @return Nothing if successfull or an error if the buffer has no room for all of the values.
+     */
+    template<typename T>
+    std::enable_if_t<std::is_arithmetic<T>::value && sizeof(T) <= sizeof(uint64), Result<void, Error>>
+    writeLE(ArrayView<T> values) noexcept {
+        return writeArray(values.begin(), values.size(), sizeof(T), isBigendian());
+    }
+
+    template<typename T>
+    std::enable_if_t<std::is_arithmetic<T>::value && sizeof(T) <= sizeof(uint64), Result<void, Error>>
+    writeLE(Array<T> const& values) noexcept { return writeLE(values.view()); }
+
+    /**
+     * Write an array of values in big endian byte order.
+     * @see writeLE(ArrayView<T>)
+     */
+    template<typename T>
+    std::enable_if_t<std::is_arithmetic<T>::value && sizeof(T) <= sizeof(uint64), Result<void, Error>>
+    writeBE(ArrayView<T> values) noexcept {
+        return writeArray(values.begin(), values.size(), sizeof(T), !isBigendian());
+    }
+
+    template<typename T>
+    std::enable_if_t<std::is_arithmetic<T>::value && sizeof(T) <= sizeof(uint64), Result<void, Error>>
+    writeBE(Array<T> const& values) noexcept { return writeBE(values.view()); }
+
+    /**
+     * Write a LEB128 variable length integer: 7 bits per byte, least significant first,
+     * with the high bit set in all bytes but the last. Signed values are zigzag encoded,
+     * so that small negative values are short too.
+     */
+    Result<void, Error> writeVarint(int32 value) noexcept;
+    Result<void, Error> writeVarint(uint32 value) noexcept;
+    Result<void, Error> writeVarint(int64 value) noexcept;
+    Result<void, Error> writeVarint(uint64 value) noexcept;
+
+    /**
+     * Write each of the values as a variable length integer.
+     * @return Nothing if successfull or an error if the buffer has no room for all of the values.
+     */
+    Result<void, Error> writeVarints(ArrayView<const uint32> values) noexcept;
+
+    /**
+     * Reserve space for a run of writes that need no checks of their own.
+     * Capacity is checked once here, the cursor writes with plain stores and advances the position of this writer
+     * by the number of bytes written when it is destroyed. The writer must not be used while the cursor is alive.
+     * @param size Number of bytes to reserve. Writing more than that through the cursor is undefined behaviour.
+     * @return A cursor to write up to size bytes or an error if there is not enough space left.
+     */
+    Result<Cursor, Error> reserve(size_type size) noexcept;
+
 protected:
 
     Result<void, Error> write(void const* bytes, size_type count) noexcept;
 
+    /// Write count values of the given size, reversing bytes of each if swap is true.
+    Result<void, Error> writeArray(void const* values, size_type count, size_type elementSize, bool swap) noexcept;
+
 private:
 
     size_type           _position{};
@@ -277,6 +341,91 @@ private:
 };
 
 
+/**
+ * Unchecked writer into the space reserved by ByteWriter::reserve().
+ *
+ * Example:
+ * @code{.cpp}
+ *  auto cursor = writer.reserve(points.size() * 2 * sizeof(uint32)).unwrap();
+ *  for (auto const& p : points) {
+ *      cursor.putBE(p.x).putBE(p.y);
+ *  }
+ * @endcode
+ */
+class ByteWriter::Cursor {
+public:
+
+    ~Cursor() noexcept {
+        if (_writer) {
+            _writer->_position += written();
+        }
+    }
+
+    Cursor(Cursor const&) = delete;
+    Cursor& operator= (Cursor const&) = delete;
+    Cursor& operator= (Cursor&&) = delete;
+
+    Cursor(Cursor&& rhs) noexcept
+        : _writer{exchange(rhs._writer, nullptr)}
+        , _begin{rhs._begin}
+        , _position{rhs._position}
+    {}
+
+    /// Number of bytes written through this cursor.
+    size_type written() const noexcept { return static_cast<size_type>(_position - _begin); }
+
+    Cursor& put(byte value) noexcept {
+        *_position++ = value;
+
+        return *this;
+    }
+
+    Cursor& put(MemoryView data) noexcept {
+        std::memcpy(_position, data.dataAddress(), data.size());
+        _position += data.size();
+
+        return *this;
+    }
+
+    /// Write a value in little endian byte order.
+    template<typename T>
+    std::enable_if_t<std::is_arithmetic<T>::value, Cursor&>
+    putLE(T value) noexcept { return store(value, kBigEndian); }
+
+    /// Write a value in big endian byte order.
+    template<typename T>
+    std::enable_if_t<std::is_arithmetic<T>::value, Cursor&>
+    putBE(T value) noexcept { return store(value, !kBigEndian); }
+
+private:
+
+    friend class ByteWriter;
+
+    static constexpr bool kBigEndian = (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__);
+
+    Cursor(ByteWriter& writer, byte* begin) noexcept
+        : _writer{&writer}
+        , _begin{begin}
+        , _position{begin}
+    {}
+
+    template<typename T>
+    Cursor& store(T value, bool swap) noexcept {
+        if (swap) {
+            value = byteSwapped(value);
+        }
+        std::memcpy(_position, &value, sizeof(T));
+        _position += sizeof(T);
+
+        return *this;
+    }
+
+    ByteWriter*     _writer;
+    byte*           _begin;
+    byte*           _position;
+};
+
+
 inline void swap(ByteWriter& lhs, ByteWriter& rhs) noexcept {
     lhs.swap(rhs);
 }
@@ -0,0 +1,187 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace: Chained byte reader
+ *	@file		solace/chainedByteReader.hpp
+ *	@brief		Reader of data that arrives in a chain of memory segments.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_CHAINEDBYTEREADER_HPP
+#define SOLACE_CHAINEDBYTEREADER_HPP
+
+#include "solace/memoryManager.hpp"
+#include "solace/memoryResource.hpp"
+#include "solace/vector.hpp"
+
+#include "solace/result.hpp"
+#include "solace/error.hpp"
+
+
+namespace Solace {
+
+/**
+ * Reader of a stream of bytes that is stored in a queue of memory segments, such as buffers of consecutive
+ * network reads. A value that is stored in a single segment is read in place, only a value that crosses
+ * a boundary between segments is assembled from its parts. Segments are released as soon as they are
+ * fully read, so a long lived reader only holds the data it has not read yet.
+ *
+ * Example:
+ * @code{.cpp}
+ *  ChainedByteReader reader{memoryManager};
+ *  reader.append(std::move(firstRead));
+ *  reader.append(std::move(secondRead));
+ *  uint32 size;
+ *  reader.readBE(size);
+ * @endcode
+ */
+class ChainedByteReader {
+public:
+
+    using size_type = MemoryView::size_type;
+
+public:
+
+    ~ChainedByteReader() = default;
+
+    /**
+     * Construct an empty reader.
+     * @param memoryManager Memory manager to allocate the queue of segments from.
+     */
+    explicit ChainedByteReader(MemoryManager& memoryManager) noexcept
+        : _memoryManager{&memoryManager}
+    {}
+
+    ChainedByteReader(ChainedByteReader const&) = delete;
+    ChainedByteReader& operator= (ChainedByteReader const&) = delete;
+
+    ChainedByteReader(ChainedByteReader&& rhs) noexcept
+        : _memoryManager{rhs._memoryManager}
+        , _segments{std::move(rhs._segments)}
+        , _first{std::exchange(rhs._first, 0)}
+        , _offset{std::exchange(rhs._offset, 0)}
+        , _remaining{std::exchange(rhs._remaining, 0)}
+    {}
+
+    ChainedByteReader& operator= (ChainedByteReader&& rhs) noexcept {
+        return swap(rhs);
+    }
+
+    ChainedByteReader& swap(ChainedByteReader& rhs) noexcept {
+        using std::swap;
+
+        swap(_memoryManager, rhs._memoryManager);
+        swap(_segments, rhs._segments);
+        swap(_first, rhs._first);
+        swap(_offset, rhs._offset);
+        swap(_remaining, rhs._remaining);
+
+        return *this;
+    }
+
+public:
+
+    /**
+     * Add a segment of data to the end of the stream. The reader takes ownership of the segment.
+     */
+    ChainedByteReader& append(MemoryResource&& segment);
+
+    /** Get the number of bytes left to read in all of the segments. */
+    constexpr size_type remaining() const noexcept { return _remaining; }
+
+    /** Check if there is any data left to read. */
+    constexpr bool hasRemaining() const noexcept { return (_remaining != 0); }
+
+    /** Get the number of segments that are not yet fully read. */
+    uint32 segmentsCount() const noexcept { return _segments.size() - _first; }
+
+    /**
+     * Get a view of the data left in the current segment.
+     * @note This is the contiguous part of the remaining data only, @see remaining() for the total.
+     */
+    MemoryView viewRemaining() const noexcept {
+        return (_first < _segments.size())
+                ? _segments[_first].view().slice(_offset, _segments[_first].size())
+                : MemoryView{};
+    }
+
+    /**
+     * Skip the given number of bytes.
+     * @return Nothing if successfull or an error if fewer bytes are left.
+     */
+    Result<void, Error> advance(size_type increment) noexcept;
+
+    /**
+     * Read a single byte.
+     * @return A byte read or an error if there is no data left.
+     */
+    Result<byte, Error> get() noexcept;
+
+    /**
+     * Read data into the given destination.
+     * @param dest Buffer to store read data into.
+     * @return Nothing if successfull or an error if fewer bytes are left.
+     */
+    Result<void, Error>
+    read(MutableMemoryView& dest) noexcept {
+        return read(dest, dest.size());
+    }
+
+    Result<void, Error>
+    read(MutableMemoryView& dest, size_type bytesToRead) noexcept;
+
+    // Endianess aware read methods
+    Result<void, Error>  readLE(int8& value)  noexcept { return read(&value, sizeof(int8)); }
+    Result<void, Error>  readLE(uint8& value) noexcept { return read(&value, sizeof(uint8)); }
+    Result<void, Error>  readLE(int16& value) noexcept { return readLE(reinterpret_cast<uint16&>(value)); }
+    Result<void, Error>  readLE(uint16& value)noexcept;
+    Result<void, Error>  readLE(int32& value) noexcept { return readLE(reinterpret_cast<uint32&>(value)); }
+    Result<void, Error>  readLE(uint32& value)noexcept;
+    Result<void, Error>  readLE(int64& value) noexcept { return readLE(reinterpret_cast<uint64&>(value)); }
+    Result<void, Error>  readLE(uint64& value)noexcept;
+
+    Result<void, Error>  readBE(int8& value)  noexcept { return read(&value, sizeof(int8)); }
+    Result<void, Error>  readBE(uint8& value) noexcept { return read(&value, sizeof(uint8)); }
+    Result<void, Error>  readBE(int16& value) noexcept { return readBE(reinterpret_cast<uint16&>(value)); }
+    Result<void, Error>  readBE(uint16& value)noexcept;
+    Result<void, Error>  readBE(int32& value) noexcept { return readBE(reinterpret_cast<uint32&>(value)); }
+    Result<void, Error>  readBE(uint32& value)noexcept;
+    Result<void, Error>  readBE(int64& value) noexcept { return readBE(reinterpret_cast<uint64&>(value)); }
+    Result<void, Error>  readBE(uint64& value)noexcept;
+
+protected:
+
+    /// Copy bytes out of the segments, releasing the segments that are read to the end.
+    Result<void, Error>  read(void* dest, size_type count) noexcept;
+
+    /// Consume bytes known to be available, releasing the segments that are read to the end.
+    void consume(size_type count) noexcept;
+
+private:
+
+    MemoryManager*          _memoryManager;
+    Vector<MemoryResource>  _segments;
+    uint32                  _first{0};      //!< Index of the segment being read, preceding ones are released.
+    size_type               _offset{0};     //!< Position in the segment being read.
+    size_type               _remaining{0};
+};
+
+
+inline void swap(ChainedByteReader& lhs, ChainedByteReader& rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+}  // End of namespace Solace
+#endif  // SOLACE_CHAINEDBYTEREADER_HPP
@@ -0,0 +1,161 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace: Compact semantic version
+ *	@file		solace/compactVersion.hpp
+ *	@brief		Semantic version packed into an integer key with interned labels.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_COMPACTVERSION_HPP
+#define SOLACE_COMPACTVERSION_HPP
+
+#include "solace/version.hpp"
+#include "solace/array.hpp"
+#include "solace/memoryView.hpp"
+#include "solace/optional.hpp"
+
+
+namespace Solace {
+
+/**
+ * Semantic version packed for sorting and comparison of many versions.
+ *
+ * Major, minor and patch numbers are packed into a single 64 bit key together with a flag that
+ * the version is a release, so that versions that differ in numbers, or of which only one has a pre-release label,
+ * are ordered by a single integer comparison. Pre-release and build labels are interned by VersionLabels
+ * which is required to compare versions with the same numbers that both have a pre-release label.
+ */
+struct CompactVersion {
+    using value_type = Version::value_type;
+
+    /// Largest major, minor or patch number a compact version can hold.
+    static constexpr value_type MaxNumber = (1U << 21) - 1;
+
+    /// Id of the interned label, 0 for no label.
+    using LabelId = uint32;
+
+    /// Numbers packed as major:21, minor:21, patch:21, release:1, most significant first.
+    uint64      key{0};
+    LabelId     preRelease{0};
+    LabelId     build{0};
+
+    value_type majorNumber() const noexcept { return static_cast<value_type>(key >> 43); }
+    value_type minorNumber() const noexcept { return static_cast<value_type>(key >> 22) & MaxNumber; }
+    value_type patchNumber() const noexcept { return static_cast<value_type>(key >> 1) & MaxNumber; }
+
+    /// Pack the numbers into a key.
+    static constexpr uint64 makeKey(value_type aMajor, value_type aMinor, value_type aPatch, bool release) noexcept {
+        return (static_cast<uint64>(aMajor) << 43) |
+                (static_cast<uint64>(aMinor) << 22) |
+                (static_cast<uint64>(aPatch) << 1) |
+                (release ? 1 : 0);
+    }
+};
+
+
+/**
+ * Interned pre-release and build labels of compact versions.
+ * Each distinct label is stored once, so parsing many versions only allocates as the set of labels grows.
+ *
+ * Example:
+ * @code{.cpp}
+ *  VersionLabels labels;
+ *  auto versions = parseVersions(wrapMemory(index), labels).unwrap();
+ *  std::sort(versions.begin(), versions.end(), labels.less());
+ * @endcode
+ */
+class VersionLabels {
+public:
+
+    using LabelId = CompactVersion::LabelId;
+
+    /// Strict weak ordering of compact versions by precedence.
+    struct Less {
+        VersionLabels const* labels;
+
+        bool operator() (CompactVersion const& lhs, CompactVersion const& rhs) const noexcept {
+            return (lhs.key != rhs.key)
+                    ? lhs.key < rhs.key
+                    : labels->comparePreRelease(lhs.preRelease, rhs.preRelease) < 0;
+        }
+    };
+
+public:
+
+    VersionLabels();
+
+    VersionLabels(VersionLabels&& rhs) noexcept = default;
+    VersionLabels& operator= (VersionLabels&& rhs) noexcept = default;
+
+    /// Number of distinct labels, not counting the empty one.
+    uint32 size() const noexcept { return _labelsCount - 1; }
+
+    /// Find or add a label. @return Id of the label, 0 for the empty label.
+    LabelId intern(StringView label);
+
+    /// Text of the label.
+    StringView label(LabelId id) const noexcept;
+
+    /**
+     * Parse a version in the MAJOR.MINOR.PATCH[-PRERELEASE][+BUILD] form.
+     * @return Compact version or an error if the text is not a version or a number is greater than MaxNumber.
+     */
+    Result<CompactVersion, Error> parse(StringView text);
+
+    /// Pack a version. @return Compact version or an error if a number is greater than MaxNumber.
+    Result<CompactVersion, Error> compact(Version const& version);
+
+    /// Unpack a compact version.
+    Version expand(CompactVersion const& version) const;
+
+    /**
+     * Compare versions by precedence, build metadata is ignored.
+     * @return Negative value, zero or positive value if lhs precedes, is equal to or follows rhs.
+     */
+    int compare(CompactVersion const& lhs, CompactVersion const& rhs) const noexcept {
+        return (lhs.key != rhs.key)
+                ? (lhs.key < rhs.key ? -1 : 1)
+                : comparePreRelease(lhs.preRelease, rhs.preRelease);
+    }
+
+    /// Comparator to sort compact versions with.
+    Less less() const noexcept { return Less{this}; }
+
+private:
+
+    /// Compare pre-release labels of versions with the same numbers.
+    int comparePreRelease(LabelId lhs, LabelId rhs) const noexcept;
+
+    Optional<LabelId> find(StringView label) const noexcept;
+
+    Array<char>     _text;          //!< Text of all the labels.
+    Array<uint32>   _offsets;       //!< Offset of each label in the text, followed by the end of the last one.
+    Array<LabelId>  _slots;         //!< Open addressing table of label ids + 1.
+    uint32          _labelsCount{1};
+};
+
+
+/**
+ * Parse versions from a buffer, one version per line.
+ * Empty lines are skipped and lines may end with "\r\n". The result is allocated once for all the versions.
+ * @param text Text to parse.
+ * @param labels Labels to intern pre-release and build labels into.
+ * @return Parsed versions or an error if any line is not a valid version.
+ */
+Result<Array<CompactVersion>, Error> parseVersions(MemoryView text, VersionLabels& labels);
+
+}  // End of namespace Solace
+#endif  // SOLACE_COMPACTVERSION_HPP
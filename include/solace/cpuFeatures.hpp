@@ -0,0 +1,43 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace: CPU features
+ *	@file		solace/cpuFeatures.hpp
+ *	@brief		Runtime detection of instruction set extensions used to select vectorized code paths.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_CPUFEATURES_HPP
+#define SOLACE_CPUFEATURES_HPP
+
+
+namespace Solace {
+namespace cpu {
+
+/**
+ * Check if the CPU supports SSSE3 instructions.
+ * @note Features are detected once, on the first call of any of the checks. Always false on targets other than x86-64.
+ */
+bool hasSsse3() noexcept;
+
+/** Check if the CPU supports SSE4.1 instructions. */
+bool hasSse41() noexcept;
+
+/** Check if the CPU supports AVX2 instructions and the OS saves the AVX registers across context switches. */
+bool hasAvx2() noexcept;
+
+}  // End of namespace cpu
+}  // End of namespace Solace
+#endif  // SOLACE_CPUFEATURES_HPP
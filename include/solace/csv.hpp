@@ -0,0 +1,263 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace: CSV parser
+ *	@file		solace/csv.hpp
+ *	@brief		Zero-copy parser of CSV and TSV documents.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_CSV_HPP
+#define SOLACE_CSV_HPP
+
+#include "solace/memoryView.hpp"
+#include "solace/mutableMemoryView.hpp"
+#include "solace/stringView.hpp"
+#include "solace/byteReader.hpp"
+#include "solace/arrayView.hpp"
+#include "solace/optional.hpp"
+#include "solace/result.hpp"
+#include "solace/error.hpp"
+
+
+namespace Solace {
+
+/// Characters that define the format of a delimiter separated document.
+struct CsvDialect {
+    char delimiter{','};    //!< Separator of fields in a record.
+    char quote{'"'};        //!< Character that encloses fields. A quote inside a field is escaped by doubling it.
+    bool quoting{true};     //!< If false, quote characters have no special meaning.
+
+    /// Comma separated values as described by RFC 4180.
+    static constexpr CsvDialect csv() noexcept { return {',', '"', true}; }
+
+    /// Tab separated values: no quoting, fields must not contain tabs or newlines.
+    static constexpr CsvDialect tsv() noexcept { return {'\t', '"', false}; }
+};
+
+
+/**
+ * Error of parsing a CSV document.
+ * Carries the offset in the source of the character where the error was detected.
+ */
+struct CsvError {
+    enum class Kind {
+        Syntax,             //!< Quote character in an unexpected position.
+        UnclosedQuote,      //!< Quoted field is not terminated before the end of the document.
+        FieldTooLong        //!< Field is too long to be represented by a StringView.
+    };
+
+    Kind                    kind;
+    MemoryView::size_type   offset;
+
+    /// Convert to a generic error to be propagated through Result<T, Error>.
+    Error toError() const noexcept;
+
+    operator Error() const noexcept { return toError(); }
+};
+
+
+/**
+ * A field of a CSV record: a view into the source document.
+ */
+class CsvField {
+public:
+
+    CsvField(StringView raw, MemoryView::size_type offset, char quote, bool quoted, bool lastInRecord) noexcept
+        : _raw{raw}
+        , _offset{offset}
+        , _quote{quote}
+        , _quoted{quoted}
+        , _lastInRecord{lastInRecord}
+    {}
+
+    /// Field as written in the source, including enclosing quotes.
+    StringView raw() const noexcept { return _raw; }
+
+    /// Offset of the field in the source.
+    MemoryView::size_type offset() const noexcept { return _offset; }
+
+    /// True if the field is enclosed in quotes.
+    bool isQuoted() const noexcept { return _quoted; }
+
+    /// True if this is the last field of a record.
+    bool isLastInRecord() const noexcept { return _lastInRecord; }
+
+    /**
+     * Content of the field without enclosing quotes.
+     * Escaped quotes are left doubled, @see unescape().
+     */
+    StringView view() const noexcept {
+        return _quoted ? _raw.substring(1, _raw.size() - 1) : _raw;
+    }
+
+    /// Test if the field contains escaped quotes and must be unescaped to get its value.
+    bool hasEscapes() const noexcept;
+
+    /**
+     * Get value of the field.
+     * Fields without escaped quotes are returned as views into the source without copying,
+     * otherwise the value is written into the scratch buffer.
+     * @param scratch Buffer to write unescaped value into. Value is never longer than the view() of the field.
+     * @return Value of the field or an error if the scratch buffer is too small.
+     */
+    Result<StringView, Error> unescape(MutableMemoryView scratch) const;
+
+private:
+    StringView              _raw;
+    MemoryView::size_type   _offset;
+    char                    _quote;
+    bool                    _quoted;
+    bool                    _lastInRecord;
+};
+
+
+/**
+ * Parser of CSV documents that yields fields one at a time as views into the source.
+ *
+ * The source is classified 64 bytes at a time into bitmasks of quotes, delimiters and newlines.
+ * Quoted regions are found with a prefix XOR of the quote mask, which makes delimiters and newlines
+ * inside quotes invisible, and positions of quotes are validated with a few bitwise operations per block.
+ * Nothing is copied and nothing is allocated: the source must outlive the parser and the fields.
+ *
+ * Records end with '\n' or "\r\n". An empty line is a record with a single empty field.
+ *
+ * Example:
+ * @code{.cpp}
+ *  CsvReader reader{mappedFile.view()};
+ *  for (auto field = reader.next(); field && field.unwrap().isSome(); field = reader.next()) {
+ *      ...
+ *  }
+ * @endcode
+ */
+class CsvReader {
+public:
+
+    using size_type = MemoryView::size_type;
+
+public:
+
+    explicit CsvReader(MemoryView source, CsvDialect dialect = CsvDialect::csv()) noexcept;
+
+    explicit CsvReader(StringView source, CsvDialect dialect = CsvDialect::csv()) noexcept
+        : CsvReader{source.view(), dialect}
+    {}
+
+    /// Parse the remaining bytes of the reader.
+    explicit CsvReader(ByteReader const& reader, CsvDialect dialect = CsvDialect::csv()) noexcept
+        : CsvReader{reader.viewRemaining(), dialect}
+    {}
+
+    /// Dialect of the document being parsed.
+    CsvDialect const& dialect() const noexcept { return _dialect; }
+
+    /**
+     * Parse the next field.
+     * @return The next field, none at the end of the document, or an error.
+     */
+    Result<Optional<CsvField>, CsvError> next();
+
+    /**
+     * Call f(CsvField const&) for each of the remaining fields.
+     * @return Number of records parsed or an error.
+     */
+    template<typename F>
+    Result<uint64, CsvError> forEachField(F&& f) {
+        uint64 records = 0;
+        while (true) {
+            auto field = next();
+            if (!field) {
+                return Err(field.moveError());
+            }
+
+            if (field.unwrap().isNone()) {
+                return Ok(records);
+            }
+
+            auto const& value = field.unwrap().get();
+            f(value);
+            records += value.isLastInRecord() ? 1 : 0;
+        }
+    }
+
+private:
+
+    /// Classify the next block of the source and collect its field boundaries.
+    void nextBlock() noexcept;
+
+    Result<Optional<CsvField>, CsvError> makeField(size_type end, bool lastInRecord);
+
+    byte const*     _data;
+    size_type       _size;
+    CsvDialect      _dialect;
+
+    size_type       _blockStart{0};
+    size_type       _nextBlock{0};
+    uint64          _boundaries{0};     //!< Unconsumed field boundaries of the current block.
+
+    uint64          _prevInQuote{0};    //!< All ones if the previous block ended inside quotes.
+    uint64          _prevClose{0};      //!< 1 if the previous block ended with a closing quote.
+    uint64          _prevBoundary{1};   //!< 1 if the previous block ended with a field boundary.
+    size_type       _lastQuote{0};
+
+    size_type       _fieldStart{0};
+    bool            _pendingField;      //!< True if there is at least one more field to return.
+
+    Optional<CsvError>  _error;         //!< The first error detected in the blocks classified so far.
+};
+
+
+/**
+ * Summary of a chunk of a CSV document, used to split a document into chunks to be parsed in parallel.
+ *
+ * Whether a chunk starts inside quotes depends on all the chunks before it. Summary records what is
+ * needed for both possibilities, so that summaries of all chunks can be computed in parallel and then
+ * combined in a cheap sequential pass by alignCsvChunks().
+ */
+struct CsvChunkSummary {
+    static constexpr MemoryView::size_type kNoRecordStart = ~MemoryView::size_type{0};
+
+    /// True if the chunk contains an odd number of quote characters.
+    bool oddQuotes;
+
+    /**
+     * Offset of the first record start in the chunk (just past a newline)
+     * if the chunk starts outside [0] or inside [1] quotes, or kNoRecordStart.
+     */
+    MemoryView::size_type recordStart[2];
+};
+
+
+/// Summarize a chunk of a document. Chunks of one document can be summarized concurrently.
+CsvChunkSummary summarizeCsvChunk(MemoryView chunk, CsvDialect dialect = CsvDialect::csv()) noexcept;
+
+/**
+ * Move boundaries of consecutive chunks of a document to the starts of records.
+ * Each of the adjusted chunks starts outside quotes and can be parsed with its own CsvReader.
+ * @param document The document.
+ * @param chunks Consecutive chunks covering the document. Chunks with no record start become empty.
+ * @param summaries Summary of each of the chunks.
+ */
+void alignCsvChunks(MemoryView document, ArrayView<MemoryView> chunks, ArrayView<const CsvChunkSummary> summaries);
+
+/**
+ * Split a document into chunks of roughly equal size that start at record boundaries.
+ * This is a sequential equivalent of summarizing each chunk with summarizeCsvChunk() and aligning them.
+ * @param chunks Chunks to split document into.
+ */
+void splitCsv(MemoryView document, ArrayView<MemoryView> chunks, CsvDialect dialect = CsvDialect::csv()) noexcept;
+
+}  // End of namespace Solace
+#endif  // SOLACE_CSV_HPP
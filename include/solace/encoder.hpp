@@ -82,5 +82,83 @@ private:
 };
 
 
+/**
+ * Base class for encoders / decoders of data that comes in chunks of any size.
+ * Input that doesn't make a whole group of the encoding is carried over to the next chunk, so that
+ * the output is the same as if all the chunks were encoded at once.
+ * A chunk is either processed as a whole or, on error, not at all: when the destination is full,
+ * the caller can drain it and update with the same chunk again.
+ *
+ * Example:
+ * @code{.cpp}
+ *  byte buffer[4096];
+ *  ByteWriter dest{wrapMemory(buffer)};
+ *  Base64StreamEncoder encoder{dest};
+ *  while (auto chunk = source.next()) {
+ *      encoder.update(chunk).unwrap();
+ *      sink.write(dest.viewWritten());
+ *      dest.rewind();
+ *  }
+ *  encoder.finish().unwrap();
+ * @endcode
+ */
+class StreamEncoder {
+public:
+    using size_type = Encoder::size_type;
+
+public:
+
+    virtual ~StreamEncoder();
+
+    /**
+     * Construct a new instance of encoder that will write transformed output into the dest buffer.
+     * @param dest Destination buffer to write transformed data to.
+     */
+    StreamEncoder(ByteWriter& dest) :
+        _dest(&dest)
+    {}
+
+    /// Get a pointer to the destination buffer.
+    ByteWriter* getDestBuffer() const noexcept {
+        return _dest;
+    }
+
+    /**
+     * Estimate the storage size for output of a chunk.
+     * @param chunkSize Size of the next chunk of data.
+     * @return Size in bytes of storage enough for output of update with the chunk followed by finish.
+     */
+    virtual size_type maxOutputSize(size_type chunkSize) const noexcept = 0;
+
+    /**
+     * Transform next chunk of data and write transformed output into the dest buffer.
+     * @param src Read buffer to read data from.
+     */
+    Result<void, Error>
+    update(ByteReader& src);
+
+    /**
+     * Transform next chunk of data and write transformed output into the dest buffer.
+     * @param chunk Memory view to read data from.
+     */
+    virtual Result<void, Error>
+    update(MemoryView const& chunk) = 0;
+
+    /**
+     * Write output of the data carried over from the previous chunks and end the stream.
+     * The encoder is ready for a new stream after it's finished.
+     */
+    virtual Result<void, Error>
+    finish() = 0;
+
+    /// Drop the data carried over and start a new stream.
+    virtual void reset() noexcept = 0;
+
+private:
+
+    ByteWriter* _dest;
+};
+
+
 }  // End of namespace Solace
 #endif  // SOLACE_ENCODER_HPP
@@ -0,0 +1,163 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace: Encoder pipeline
+ *	@file		solace/encoderPipeline.hpp
+ *	@brief		Chain of stream encoders and hashes that processes data in a single pass.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_ENCODERPIPELINE_HPP
+#define SOLACE_ENCODERPIPELINE_HPP
+
+#include "solace/encoder.hpp"
+#include "solace/hashing/digestAlgorithm.hpp"
+
+
+namespace Solace {
+
+/**
+ * Chain of steps that data passes through block by block, so that hashing, encoding and writing of a block
+ * happen while the block is still in cache, instead of a separate pass over the whole input for each of them.
+ * A step is either a hash that is updated with the data passing by, or a stream encoder that transforms it.
+ * Output of an encoder is what it writes into its destination buffer. An encoder that is not the last one,
+ * or the last one if it doesn't write straight into the pipeline destination, needs a buffer of its own
+ * large enough for the output of a single block. Such buffers are rewound after each block.
+ *
+ * Example:
+ * @code{.cpp}
+ *  hashing::Sha256 hash;
+ *  Base64StreamEncoder base64{dest};
+ *  EncoderPipeline pipeline{dest};
+ *  pipeline.tap(hash)
+ *          .pipe(base64);
+ *  pipeline.update(blob).unwrap();
+ *  pipeline.finish().unwrap();
+ *  auto const digest = hash.digest();
+ * @endcode
+ */
+class EncoderPipeline {
+public:
+    using size_type = StreamEncoder::size_type;
+
+    /// Default size of a block of input, small enough for a block and its encoding to stay in L1/L2 cache.
+    static constexpr size_type kDefaultBlockSize = 16*1024;
+
+    /// Maximum number of steps in a pipeline.
+    static constexpr uint32 kMaxSteps = 8;
+
+public:
+
+    /**
+     * Construct a new pipeline with no steps.
+     * @param dest Destination buffer for the output of the last step.
+     * @param blockSize Size of the blocks input is split into.
+     */
+    explicit EncoderPipeline(ByteWriter& dest, size_type blockSize = kDefaultBlockSize) noexcept
+        : _dest{&dest}
+        , _blockSize{(blockSize == 0) ? kDefaultBlockSize : blockSize}
+    {}
+
+    EncoderPipeline(EncoderPipeline const&) = delete;
+    EncoderPipeline& operator= (EncoderPipeline const&) = delete;
+
+    /// Get a pointer to the destination buffer.
+    ByteWriter* getDestBuffer() const noexcept {
+        return _dest;
+    }
+
+    /// Get the size of the blocks input is split into.
+    constexpr size_type blockSize() const noexcept { return _blockSize; }
+
+    /// Get the number of steps in the pipeline.
+    constexpr uint32 stepsCount() const noexcept { return _stepsCount; }
+
+    /**
+     * Add a step that updates the given hash with data coming out of the previous step.
+     * @note Raises OverflowException if the pipeline already has kMaxSteps steps.
+     */
+    EncoderPipeline& tap(hashing::HashingAlgorithm& hash);
+
+    /**
+     * Add a step that transforms data coming out of the previous step with the given encoder.
+     * @note Raises OverflowException if the pipeline already has kMaxSteps steps.
+     */
+    EncoderPipeline& pipe(StreamEncoder& encoder);
+
+    /**
+     * Pass data from the reader through the pipeline, block by block.
+     * Before a block is processed, it is checked that every buffer has room for its output, so a block is
+     * either processed as a whole or not at all and the reader is only advanced past processed blocks.
+     * When the destination is full, the caller can drain it and update with the same reader again.
+     * @param src Read buffer to read data from.
+     * @return Nothing if all the data is processed or an error.
+     */
+    Result<void, Error>
+    update(ByteReader& src);
+
+    /**
+     * Pass data through the pipeline, block by block.
+     * @param data Memory view to read data from.
+     * @return Nothing if all the data is processed or an error.
+     */
+    Result<void, Error>
+    update(MemoryView data) {
+        ByteReader reader{data};
+        return update(reader);
+    }
+
+    /**
+     * Finish every encoder in order, passing the output each one has carried over through the following steps.
+     * Hashes are not finalised, their digest is left for the caller to take.
+     * Before any encoder is finished, it is checked that every buffer has room for the output, so when the
+     * destination is full nothing is lost and the caller can drain it and finish again.
+     * @return Nothing if successfull or an error. After an error other than overflow the pipeline must be reset.
+     */
+    Result<void, Error>
+    finish();
+
+    /// Reset all the encoders and drop data left in their buffers.
+    void reset() noexcept;
+
+protected:
+
+    /// Pass data through the steps starting from the given one and write the result into the destination.
+    Result<void, Error> run(MemoryView data, uint32 firstStep);
+
+    /// Check that every buffer has room for the output of a block of the given size.
+    bool hasRoomFor(size_type blockSize) const noexcept;
+
+    /// Rewind buffers of the encoders that don't write into the destination.
+    void rewindBuffers() noexcept;
+
+    /// Check if output of the last step goes straight into the destination.
+    bool writesIntoDest() const noexcept;
+
+private:
+
+    struct Step {
+        hashing::HashingAlgorithm*  hash;
+        StreamEncoder*              encoder;
+    };
+
+    ByteWriter*     _dest;
+    size_type       _blockSize;
+
+    Step            _steps[kMaxSteps];
+    uint32          _stepsCount{0};
+};
+
+}  // End of namespace Solace
+#endif  // SOLACE_ENCODERPIPELINE_HPP
@@ -0,0 +1,645 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace: Type-safe formatting
+ *	@file		solace/format.hpp
+ *	@brief		Format string parsing and rendering of values into a ByteWriter.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_FORMAT_HPP
+#define SOLACE_FORMAT_HPP
+
+#include "solace/byteWriter.hpp"
+#include "solace/string.hpp"
+#include "solace/arrayView.hpp"
+
+#include <type_traits>
+
+
+namespace Solace {
+
+/**
+ * Specification of a single replacement field of a format string.
+ * Replacement field syntax is: {[index][:[[fill]align][0][width][.precision][type]]}
+ *
+ *  - align is one of '<' (left), '>' (right) or '^' (center).
+ *  - '0' pads numbers with zeros after the sign.
+ *  - type is one of:
+ *      'd', 'x', 'X', 'o', 'b', 'c' for integers,
+ *      'f', 'F', 'e', 'E', 'g', 'G', 'a', 'A' for floating point numbers,
+ *      's' for strings and booleans, 'p' for pointers.
+ * Floating point numbers without precision and type are rendered in the shortest form that round-trips.
+ */
+struct FormatSpec {
+    enum class Align : byte {
+        Default,
+        Left,
+        Right,
+        Center
+    };
+
+    char    fill{' '};
+    Align   align{Align::Default};
+    bool    zeroPad{false};
+    uint16  width{0};
+    int16   precision{-1};
+    char    type{0};
+};
+
+
+/**
+ * Parsed piece of a format string: a run of literal text optionally followed by a replacement field.
+ */
+struct FormatField {
+    uint16      literalOffset{0};
+    uint16      literalLength{0};
+    //!< Index of the argument to format after the literal or -1 if this is a literal only piece.
+    int16       argIndex{-1};
+    FormatSpec  spec{};
+};
+
+
+/**
+ * Kind of a value that can be formatted.
+ */
+enum class FormatArgKind : byte {
+    None,
+    Bool,
+    Char,
+    Int,
+    Uint,
+    Float32,
+    Float64,
+    String,
+    Pointer
+};
+
+
+/**
+ * Maps a type to the kind of format argument it is rendered as.
+ * Types that are not formattable have kind FormatArgKind::None.
+ */
+template<typename T, typename Enable = void>
+struct FormatArgTraits {
+    static constexpr FormatArgKind kind = FormatArgKind::None;
+};
+
+template<>
+struct FormatArgTraits<bool> {
+    static constexpr FormatArgKind kind = FormatArgKind::Bool;
+};
+
+template<>
+struct FormatArgTraits<char> {
+    static constexpr FormatArgKind kind = FormatArgKind::Char;
+};
+
+template<typename T>
+struct FormatArgTraits<T, std::enable_if_t<std::is_integral<T>::value &&
+                                          !std::is_same<T, bool>::value &&
+                                          !std::is_same<T, char>::value>> {
+    static constexpr FormatArgKind kind = std::is_signed<T>::value
+            ? FormatArgKind::Int
+            : FormatArgKind::Uint;
+};
+
+template<>
+struct FormatArgTraits<float32> {
+    static constexpr FormatArgKind kind = FormatArgKind::Float32;
+};
+
+template<>
+struct FormatArgTraits<float64> {
+    static constexpr FormatArgKind kind = FormatArgKind::Float64;
+};
+
+template<>
+struct FormatArgTraits<StringView> {
+    static constexpr FormatArgKind kind = FormatArgKind::String;
+};
+
+template<>
+struct FormatArgTraits<StringLiteral> {
+    static constexpr FormatArgKind kind = FormatArgKind::String;
+};
+
+template<>
+struct FormatArgTraits<String> {
+    static constexpr FormatArgKind kind = FormatArgKind::String;
+};
+
+template<>
+struct FormatArgTraits<char const*> {
+    static constexpr FormatArgKind kind = FormatArgKind::String;
+};
+
+template<>
+struct FormatArgTraits<char*> {
+    static constexpr FormatArgKind kind = FormatArgKind::String;
+};
+
+template<size_t N>
+struct FormatArgTraits<char[N]> {
+    static constexpr FormatArgKind kind = FormatArgKind::String;
+};
+
+template<typename T>
+struct FormatArgTraits<T*, std::enable_if_t<!std::is_same<std::remove_cv_t<T>, char>::value>> {
+    static constexpr FormatArgKind kind = FormatArgKind::Pointer;
+};
+
+
+/**
+ * Type erased format argument.
+ * Format arguments are captured by value (strings by reference) so that a single non-template
+ * rendering function can serve all format calls.
+ */
+class FormatArg {
+public:
+
+    constexpr FormatArg() noexcept
+        : _kind{FormatArgKind::None}
+        , _uint{0}
+    {}
+
+    template<typename T,
+             typename Traits = FormatArgTraits<std::remove_cv_t<std::remove_reference_t<T>>>>
+    FormatArg(T const& value) noexcept
+        : _kind{Traits::kind}
+        , _uint{0}
+    {
+        static_assert(Traits::kind != FormatArgKind::None, "Type is not formattable");
+
+        capture(value);
+    }
+
+    constexpr FormatArgKind kind() const noexcept { return _kind; }
+
+    constexpr bool      asBool() const noexcept     { return _uint != 0; }
+    constexpr char      asChar() const noexcept     { return static_cast<char>(_int); }
+    constexpr int64     asInt() const noexcept      { return _int; }
+    constexpr uint64    asUint() const noexcept     { return _uint; }
+    constexpr float32   asFloat32() const noexcept  { return _float32; }
+    constexpr float64   asFloat64() const noexcept  { return _float64; }
+    constexpr void const* asPointer() const noexcept { return _pointer; }
+    StringView          asString() const noexcept   { return {_string.data, _string.size}; }
+
+private:
+
+    void capture(bool value) noexcept                   { _uint = value ? 1 : 0; }
+    void capture(char value) noexcept                   { _int = value; }
+    void capture(float32 value) noexcept                { _float32 = value; }
+    void capture(float64 value) noexcept                { _float64 = value; }
+    void capture(StringView value) noexcept             { _string = {value.data(), value.size()}; }
+    void capture(String const& value) noexcept          { capture(value.view()); }
+    void capture(char const* value) noexcept            { capture(StringView{value}); }
+    void capture(void const* value) noexcept            { _pointer = value; }
+
+    template<typename T>
+    std::enable_if_t<std::is_integral<T>::value && std::is_signed<T>::value>
+    capture(T value) noexcept { _int = value; }
+
+    template<typename T>
+    std::enable_if_t<std::is_integral<T>::value && std::is_unsigned<T>::value>
+    capture(T value) noexcept { _uint = value; }
+
+    template<typename T>
+    std::enable_if_t<!std::is_same<std::remove_cv_t<T>, char>::value>
+    capture(T* value) noexcept { _pointer = value; }
+
+private:
+
+    struct StringArg {
+        char const*             data;
+        StringView::size_type   size;
+    };
+
+    FormatArgKind   _kind;
+
+    union {
+        int64       _int;
+        uint64      _uint;
+        float32     _float32;
+        float64     _float64;
+        void const* _pointer;
+        StringArg   _string;
+    };
+};
+
+
+/**
+ * Base type of format strings that are parsed and checked at compile time.
+ * @see SOLACE_FMT
+ */
+struct FormatStringTag {};
+
+
+namespace details {
+
+/// Reasons a format string can be rejected for.
+enum class FormatParseError : byte {
+    None = 0,
+    UnmatchedOpenBrace,
+    UnmatchedCloseBrace,
+    InvalidSpec,
+    MixedIndexing,
+    ArgIndexOutOfRange,
+    TypeMismatch
+};
+
+
+/// Parser state carried between consecutive fields of the same format string.
+struct FormatParseState {
+    uint16  position{0};
+    int16   nextArg{0};
+    bool    automaticIndexing{false};
+    bool    manualIndexing{false};
+};
+
+
+constexpr bool isFormatDigit(char c) noexcept {
+    return (c >= '0' && c <= '9');
+}
+
+constexpr bool isFormatAlign(char c) noexcept {
+    return (c == '<' || c == '>' || c == '^');
+}
+
+constexpr FormatSpec::Align toFormatAlign(char c) noexcept {
+    return (c == '<')
+            ? FormatSpec::Align::Left
+            : (c == '>')
+              ? FormatSpec::Align::Right
+              : FormatSpec::Align::Center;
+}
+
+constexpr bool isFormatType(char c) noexcept {
+    switch (c) {
+    case 'd': case 'x': case 'X': case 'o': case 'b': case 'c':
+    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+    case 's': case 'p':
+        return true;
+    default:
+        return false;
+    }
+}
+
+
+/**
+ * Parse a decimal number of a width/precision/index of a field.
+ * @return False if the number does not fit into the limit.
+ */
+constexpr bool parseFormatNumber(char const* fmt, uint16 size, uint16& pos, uint16& value) noexcept {
+    uint32 result = 0;
+    while (pos < size && isFormatDigit(fmt[pos])) {
+        result = result * 10 + static_cast<uint32>(fmt[pos] - '0');
+        if (result > 0x7FFF) {
+            return false;
+        }
+
+        ++pos;
+    }
+
+    value = static_cast<uint16>(result);
+
+    return true;
+}
+
+
+/**
+ * Parse a format spec of a replacement field, that is everything between ':' and '}'.
+ */
+constexpr FormatParseError
+parseFormatSpec(char const* fmt, uint16 size, uint16& pos, FormatSpec& spec) noexcept {
+    if (pos + 1 < size && isFormatAlign(fmt[pos + 1]) && fmt[pos] != '{' && fmt[pos] != '}') {
+        spec.fill = fmt[pos];
+        spec.align = toFormatAlign(fmt[pos + 1]);
+        pos += 2;
+    } else if (pos < size && isFormatAlign(fmt[pos])) {
+        spec.align = toFormatAlign(fmt[pos]);
+        pos += 1;
+    }
+
+    if (pos < size && fmt[pos] == '0') {
+        spec.zeroPad = true;
+        pos += 1;
+    }
+
+    uint16 width = 0;
+    if (!parseFormatNumber(fmt, size, pos, width)) {
+        return FormatParseError::InvalidSpec;
+    }
+    spec.width = width;
+
+    if (pos < size && fmt[pos] == '.') {
+        pos += 1;
+        if (pos >= size || !isFormatDigit(fmt[pos])) {
+            return FormatParseError::InvalidSpec;
+        }
+
+        uint16 precision = 0;
+        if (!parseFormatNumber(fmt, size, pos, precision)) {
+            return FormatParseError::InvalidSpec;
+        }
+        spec.precision = static_cast<int16>(precision);
+    }
+
+    if (pos < size && isFormatType(fmt[pos])) {
+        spec.type = fmt[pos];
+        pos += 1;
+    }
+
+    return FormatParseError::None;
+}
+
+
+/**
+ * Parse next piece of a format string starting at the current position of the parser.
+ * @param fmt Format string to parse.
+ * @param size Size of the format string.
+ * @param state Parser state. Position is advanced past the piece parsed.
+ * @param field Parsed piece.
+ * @return FormatParseError::None if the piece was parsed successfully.
+ */
+constexpr FormatParseError
+parseFormatField(char const* fmt, uint16 size, FormatParseState& state, FormatField& field) noexcept {
+    field = FormatField{};
+    field.literalOffset = state.position;
+
+    uint16 pos = state.position;
+    while (pos < size && fmt[pos] != '{' && fmt[pos] != '}') {
+        ++pos;
+    }
+
+    field.literalLength = pos - state.position;
+    if (pos == size) {
+        state.position = pos;
+        return FormatParseError::None;
+    }
+
+    // Escaped brace: keep one in the literal and skip the other
+    if (pos + 1 < size && fmt[pos + 1] == fmt[pos]) {
+        field.literalLength += 1;
+        state.position = pos + 2;
+        return FormatParseError::None;
+    }
+
+    if (fmt[pos] == '}') {
+        return FormatParseError::UnmatchedCloseBrace;
+    }
+
+    pos += 1;  // Skip '{'
+    if (pos < size && isFormatDigit(fmt[pos])) {
+        if (state.automaticIndexing) {
+            return FormatParseError::MixedIndexing;
+        }
+
+        uint16 index = 0;
+        if (!parseFormatNumber(fmt, size, pos, index)) {
+            return FormatParseError::InvalidSpec;
+        }
+
+        state.manualIndexing = true;
+        field.argIndex = static_cast<int16>(index);
+    } else {
+        if (state.manualIndexing) {
+            return FormatParseError::MixedIndexing;
+        }
+
+        state.automaticIndexing = true;
+        field.argIndex = state.nextArg++;
+    }
+
+    if (pos < size && fmt[pos] == ':') {
+        pos += 1;
+        auto const specError = parseFormatSpec(fmt, size, pos, field.spec);
+        if (specError != FormatParseError::None) {
+            return specError;
+        }
+    }
+
+    if (pos >= size) {
+        return FormatParseError::UnmatchedOpenBrace;
+    }
+
+    if (fmt[pos] != '}') {
+        return FormatParseError::InvalidSpec;
+    }
+
+    state.position = pos + 1;
+
+    return FormatParseError::None;
+}
+
+
+/**
+ * Check if a format spec can be applied to a value of the given kind.
+ */
+constexpr bool isFormatSpecCompatible(FormatArgKind kind, FormatSpec const& spec) noexcept {
+    auto const type = spec.type;
+    auto const isIntegralType = (type == 0 || type == 'd' || type == 'x' || type == 'X' ||
+                                 type == 'o' || type == 'b' || type == 'c');
+
+    switch (kind) {
+    case FormatArgKind::Bool:
+        return (spec.precision < 0) && (type == 0 || type == 's');
+    case FormatArgKind::Char:
+    case FormatArgKind::Int:
+    case FormatArgKind::Uint:
+        return (spec.precision < 0) && isIntegralType;
+    case FormatArgKind::Float32:
+    case FormatArgKind::Float64:
+        return (type == 0 || type == 'f' || type == 'F' || type == 'e' || type == 'E' ||
+                type == 'g' || type == 'G' || type == 'a' || type == 'A');
+    case FormatArgKind::String:
+        return (type == 0 || type == 's');
+    case FormatArgKind::Pointer:
+        return (spec.precision < 0) && (type == 0 || type == 'p');
+    default:
+        return false;
+    }
+}
+
+
+/**
+ * Count number of pieces the format string consists of.
+ * @return Number of pieces in the format string or 1 if the format string is invalid.
+ */
+constexpr uint16 countFormatFields(StringView fmt) noexcept {
+    uint16 count = 0;
+    FormatParseState state;
+    FormatField field;
+    while (state.position < fmt.size()) {
+        if (parseFormatField(fmt.data(), fmt.size(), state, field) != FormatParseError::None) {
+            return 1;
+        }
+
+        count += 1;
+    }
+
+    return (count == 0) ? 1 : count;
+}
+
+
+/**
+ * Format string parsed into a sequence of fields.
+ */
+template<uint16 N>
+struct CompiledFormat {
+    FormatField         fields[N] {};
+    uint16              count{0};
+    FormatParseError    error{FormatParseError::None};
+};
+
+
+/**
+ * Parse the format string and check it against the kinds of arguments given.
+ * This is designed to be evaluated at compile time.
+ */
+template<uint16 N>
+constexpr CompiledFormat<N>
+compileFormat(StringView fmt, FormatArgKind const* kinds, uint16 nbArgs) noexcept {
+    CompiledFormat<N> result{};
+    FormatParseState state;
+
+    while (state.position < fmt.size() && result.count < N) {
+        auto& field = result.fields[result.count];
+        result.error = parseFormatField(fmt.data(), fmt.size(), state, field);
+        if (result.error != FormatParseError::None) {
+            return result;
+        }
+
+        if (field.argIndex >= 0) {
+            if (field.argIndex >= nbArgs) {
+                result.error = FormatParseError::ArgIndexOutOfRange;
+                return result;
+            }
+
+            if (!isFormatSpecCompatible(kinds[field.argIndex], field.spec)) {
+                result.error = FormatParseError::TypeMismatch;
+                return result;
+            }
+        }
+
+        result.count += 1;
+    }
+
+    return result;
+}
+
+}  // namespace details
+
+
+/**
+ * Render a single value into the destination according to the format spec.
+ * @param dest Destination to write formatted value into.
+ * @param spec Format spec to apply.
+ * @param arg Value to format.
+ * @return Nothing or an error if the value does not fit into the destination.
+ */
+Result<void, Error>
+formatValue(ByteWriter& dest, FormatSpec const& spec, FormatArg const& arg);
+
+
+/**
+ * Format arguments according to the format string parsed at runtime.
+ * @param dest Destination to write formatted string into.
+ * @param fmt Format string.
+ * @param args Arguments to format.
+ * @return Nothing or an error if format string is invalid or the output does not fit into the destination.
+ */
+Result<void, Error>
+formatTo(ByteWriter& dest, StringView fmt, ArrayView<const FormatArg> args);
+
+/**
+ * Format arguments according to the previously parsed format string.
+ * @param dest Destination to write formatted string into.
+ * @param fmt Format string that has been parsed.
+ * @param fields Parsed fields of the format string.
+ * @param args Arguments to format.
+ * @return Nothing or an error if the output does not fit into the destination.
+ */
+Result<void, Error>
+formatTo(ByteWriter& dest, StringView fmt, ArrayView<const FormatField> fields, ArrayView<const FormatArg> args);
+
+
+/**
+ * Format arguments according to the format string.
+ * Format string is parsed at runtime, thus errors in the format string are reported as errors.
+ */
+template<typename... Args>
+Result<void, Error>
+formatTo(ByteWriter& dest, StringView fmt, Args const&... args) {
+    FormatArg const packedArgs[] = {FormatArg{args}..., FormatArg{}};
+
+    return formatTo(dest, fmt, arrayView(packedArgs, sizeof...(Args)));
+}
+
+
+/**
+ * Format arguments according to the format string parsed at compile time.
+ * Errors in the format string as well as mismatch between the format and argument types are compile errors.
+ * @see SOLACE_FMT
+ */
+template<typename Fmt, typename... Args>
+std::enable_if_t<std::is_base_of<FormatStringTag, Fmt>::value, Result<void, Error>>
+formatTo(ByteWriter& dest, Fmt, Args const&... args) {
+    using details::FormatParseError;
+
+    static constexpr FormatArgKind kinds[] = {
+        FormatArgTraits<std::remove_cv_t<Args>>::kind...,
+        FormatArgKind::None
+    };
+    static constexpr auto compiled = details::compileFormat<details::countFormatFields(Fmt::value())>(
+                Fmt::value(), kinds, sizeof...(Args));
+
+    static_assert(compiled.error != FormatParseError::UnmatchedOpenBrace, "Format string: unmatched '{'");
+    static_assert(compiled.error != FormatParseError::UnmatchedCloseBrace, "Format string: unmatched '}'");
+    static_assert(compiled.error != FormatParseError::InvalidSpec, "Format string: invalid format spec");
+    static_assert(compiled.error != FormatParseError::MixedIndexing,
+                  "Format string: automatic and manual argument indexing can not be mixed");
+    static_assert(compiled.error != FormatParseError::ArgIndexOutOfRange,
+                  "Format string: refers to more arguments than given");
+    static_assert(compiled.error != FormatParseError::TypeMismatch,
+                  "Format string: format spec does not match argument type");
+
+    FormatArg const packedArgs[] = {FormatArg{args}..., FormatArg{}};
+
+    return formatTo(dest, Fmt::value(),
+                    arrayView(compiled.fields, compiled.count),
+                    arrayView(packedArgs, sizeof...(Args)));
+}
+
+}  // End of namespace Solace
+
+
+/**
+ * Declare a format string literal to be parsed and checked at compile time.
+ * Example:
+ * @code
+ *     formatTo(dest, SOLACE_FMT("{} has {:08.3f} units"), name, value);
+ * @endcode
+ */
+#define SOLACE_FMT(str) \
+    [] { \
+        struct SolaceFormatString : public ::Solace::FormatStringTag { \
+            static constexpr ::Solace::StringLiteral value() noexcept { return str; } \
+        }; \
+        return SolaceFormatString{}; \
+    }()
+
+
+#endif  // SOLACE_FORMAT_HPP
@@ -0,0 +1,208 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace: Scatter/gather writer
+ *	@file		solace/gatherWriter.hpp
+ *	@brief		Writer that collects a message as a list of segments for writev.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_GATHERWRITER_HPP
+#define SOLACE_GATHERWRITER_HPP
+
+#include "solace/byteWriter.hpp"
+#include "solace/memoryManager.hpp"
+#include "solace/vector.hpp"
+
+#include <sys/uio.h>  // iovec
+
+
+namespace Solace {
+
+/**
+ * Writer that builds a message out of a sequence of segments without copying large payloads.
+ * Small writes are copied into scratch pages allocated from a memory manager, consecutive copies coalesced
+ * into a single segment. Views of at least the borrow threshold size are referenced as they are,
+ * so the memory they point to must stay valid and unchanged until the message is sent.
+ * The message is exposed as a list of iovec ready for writev(2) or sendmsg(2).
+ *
+ * Example:
+ * @code{.cpp}
+ *  GatherWriter writer{memoryManager};
+ *  writer.writeBE(static_cast<uint32>(payload.size()))
+ *        .write(payload);
+ *  auto const segments = writer.iovecs();
+ *  ::writev(fd, segments.begin(), segments.size());
+ * @endcode
+ */
+class GatherWriter {
+public:
+    using size_type = MemoryView::size_type;
+
+    /// Default size of a scratch page.
+    static constexpr size_type kDefaultPageSize = 4096;
+
+    /// Views of this size or larger are referenced rather than copied by default.
+    static constexpr size_type kDefaultBorrowThreshold = 512;
+
+public:
+
+    ~GatherWriter() = default;
+
+    /**
+     * Construct a new empty writer that allocates scratch pages from the given manager.
+     * @param memoryManager Memory manager to allocate pages from.
+     * @param pageSize Size of a scratch page.
+     * @param borrowThreshold Size of a view from which write() references the view instead of copying it.
+     */
+    explicit GatherWriter(MemoryManager& memoryManager,
+                          size_type pageSize = kDefaultPageSize,
+                          size_type borrowThreshold = kDefaultBorrowThreshold) noexcept
+        : _memoryManager{&memoryManager}
+        , _pageSize{(pageSize == 0) ? kDefaultPageSize : pageSize}
+        , _borrowThreshold{borrowThreshold}
+    {}
+
+    GatherWriter(GatherWriter const&) = delete;
+    GatherWriter& operator= (GatherWriter const&) = delete;
+
+    GatherWriter(GatherWriter&& rhs) noexcept
+        : _memoryManager{rhs._memoryManager}
+        , _pageSize{rhs._pageSize}
+        , _borrowThreshold{rhs._borrowThreshold}
+        , _pages{std::move(rhs._pages)}
+        , _segments{std::move(rhs._segments)}
+        , _currentPage{std::exchange(rhs._currentPage, 0)}
+        , _pageUsed{std::exchange(rhs._pageUsed, 0)}
+        , _size{std::exchange(rhs._size, 0)}
+    {}
+
+    GatherWriter& operator= (GatherWriter&& rhs) noexcept {
+        return swap(rhs);
+    }
+
+    GatherWriter& swap(GatherWriter& rhs) noexcept {
+        using std::swap;
+
+        swap(_memoryManager, rhs._memoryManager);
+        swap(_pageSize, rhs._pageSize);
+        swap(_borrowThreshold, rhs._borrowThreshold);
+        swap(_pages, rhs._pages);
+        swap(_segments, rhs._segments);
+        swap(_currentPage, rhs._currentPage);
+        swap(_pageUsed, rhs._pageUsed);
+        swap(_size, rhs._size);
+
+        return *this;
+    }
+
+public:
+
+    /**
+     * Write data, referencing it if it is at least the borrow threshold in size, copying it otherwise.
+     * @note Referenced data must outlive the use of iovecs().
+     */
+    GatherWriter& write(MemoryView data) {
+        return (data.size() < _borrowThreshold)
+                ? copy(data)
+                : reference(data);
+    }
+
+    /// Copy data into scratch pages.
+    GatherWriter& copy(MemoryView data);
+
+    /**
+     * Add a segment referencing the data without copying it.
+     * @note The data must outlive the use of iovecs().
+     */
+    GatherWriter& reference(MemoryView data);
+
+    GatherWriter& write(uint8 value) { return copy(wrapMemory(&value, sizeof(value))); }
+
+    // Endianess aware write methods
+    template<typename T>
+    std::enable_if_t<std::is_arithmetic<T>::value && sizeof(T) <= sizeof(uint64), GatherWriter&>
+    writeLE(T value) { return copyValue(value, isBigendian()); }
+
+    template<typename T>
+    std::enable_if_t<std::is_arithmetic<T>::value && sizeof(T) <= sizeof(uint64), GatherWriter&>
+    writeBE(T value) { return copyValue(value, !isBigendian()); }
+
+    /** Remove all segments. Scratch pages are kept for reuse. */
+    GatherWriter& clear() noexcept;
+
+    /** Get total number of bytes written. */
+    constexpr size_type size() const noexcept { return _size; }
+
+    constexpr bool empty() const noexcept { return (_size == 0); }
+
+    /** Get number of segments of the message. */
+    uint32 segmentsCount() const noexcept { return _segments.size(); }
+
+    /** Get a view of the given segment. */
+    MemoryView segment(uint32 index) const {
+        auto const& s = _segments[index];
+        return wrapMemory(s.iov_base, s.iov_len);
+    }
+
+    /**
+     * Get the segments of the message as a list of iovec for writev(2) or sendmsg(2).
+     * @note The list is invalidated by any following write. A message with more than IOV_MAX segments
+     * must be sent in several calls.
+     */
+    ArrayView<const iovec> iovecs() const noexcept { return _segments.view(); }
+
+    /**
+     * Copy the message into the given writer.
+     * @return Nothing or an error if the destination does not have enough space.
+     */
+    Result<void, Error> copyTo(ByteWriter& dest) const;
+
+private:
+
+    /// Copy bytes of a value, in the reverse order if swap is set.
+    template<typename T>
+    GatherWriter& copyValue(T value, bool swap) {
+        if (swap) {
+            value = byteSwapped(value);
+        }
+
+        return copy(wrapMemory(&value, sizeof(value)));
+    }
+
+    /// Get free space of the current page, moving to the next one if the current one is full.
+    MutableMemoryView reserve();
+
+    /// Add a segment, extending the last one if the new one immediately follows it.
+    void appendSegment(void* data, size_type size);
+
+    MemoryManager*          _memoryManager;
+    size_type               _pageSize;
+    size_type               _borrowThreshold;
+
+    Vector<MemoryResource>  _pages;             //!< Scratch pages, kept across clear().
+    Vector<iovec>           _segments;
+    uint32                  _currentPage{0};    //!< Index of the page being filled.
+    size_type               _pageUsed{0};       //!< Bytes used in the current page.
+    size_type               _size{0};
+};
+
+
+inline void swap(GatherWriter& lhs, GatherWriter& rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+}  // End of namespace Solace
+#endif  // SOLACE_GATHERWRITER_HPP
@@ -0,0 +1,178 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace: Glob patterns
+ *	@file		solace/glob.hpp
+ *	@brief		Compiled set of glob patterns matched against paths.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_GLOB_HPP
+#define SOLACE_GLOB_HPP
+
+#include "solace/multiPatternMatcher.hpp"
+#include "solace/path.hpp"
+#include "solace/optional.hpp"
+
+#include <type_traits>
+
+
+namespace Solace {
+
+/**
+ * Compiled set of glob patterns that are matched against a path simultaneously.
+ *
+ * Supported syntax:
+ *  - `?` matches any single character except '/';
+ *  - `*` matches any sequence of characters except '/';
+ *  - `**` matches any sequence of characters including '/'. A `**` that forms a whole path component
+ *    and is followed by '/' matches zero or more directories: both "a/b" and "a/x/y/b" match the pattern
+ *    made of "a/", "**" and "/b";
+ *  - `[abc]`, `[a-z]`, `[!a-z]` or `[^a-z]` match a single character from a class. Classes never match '/';
+ *  - `\` escapes the next character.
+ * A pattern must match the whole path.
+ *
+ * All patterns are compiled into a single non-deterministic automaton which is simulated with bit-parallel
+ * operations: a path is matched in a single pass, one step per byte, with no backtracking, and
+ * the result is the set of all the patterns that match. Before the automaton is run, a literal that each
+ * pattern requires, preferably its literal prefix or suffix, is searched for with a MultiPatternMatcher,
+ * so that patterns that cannot match are never started and most of the paths that match none of the patterns
+ * are rejected by a single SIMD scan.
+ *
+ * Example:
+ * @code{.cpp}
+ *  StringView excludes[] = {"*.o", "*~", "src/[a-z]?*.tmp"};
+ *  auto globs = makeGlobSet(arrayView(excludes)).unwrap();
+ *  if (!globs.matchesAny(path)) {
+ *      ...
+ *  }
+ * @endcode
+ */
+class GlobSet {
+public:
+
+    using PatternId = uint32;
+
+public:
+
+    GlobSet(GlobSet&&) noexcept = default;
+    GlobSet& operator= (GlobSet&&) noexcept = default;
+
+    /// Number of patterns in the set.
+    PatternId patternsCount() const noexcept { return _patternStart.size() - 1; }
+
+    /// Number of states of the compiled automaton.
+    uint32 statesCount() const noexcept { return _patternStart[patternsCount()]; }
+
+    /// Check if the text matches at least one of the patterns.
+    bool matchesAny(StringView text) const;
+
+    /// Check if the path, with components joined by '/', matches at least one of the patterns.
+    bool matchesAny(PathView path) const;
+
+    /**
+     * Find all the patterns that match the text.
+     * @param text Text to match.
+     * @param onMatch Callback invoked as onMatch(PatternId id) for each matching pattern, in increasing order of ids.
+     */
+    template<typename F>
+    void match(StringView text, F&& onMatch) const {
+        matchText(text, &invokeCallback<F>, callbackContext(onMatch));
+    }
+
+    /**
+     * Find all the patterns that match the path with components joined by '/'.
+     * @param path Path to match.
+     * @param onMatch Callback invoked as onMatch(PatternId id) for each matching pattern, in increasing order of ids.
+     */
+    template<typename F>
+    void match(PathView path, F&& onMatch) const {
+        matchPath(path, &invokeCallback<F>, callbackContext(onMatch));
+    }
+
+private:
+
+    /// Type erased match callback. @return True to continue reporting matches.
+    using MatchCallback = bool (*)(void* context, PatternId id);
+
+    template<typename F>
+    static bool invokeCallback(void* context, PatternId id) {
+        (*static_cast<std::remove_reference_t<F>*>(context))(id);
+
+        return true;
+    }
+
+    template<typename F>
+    static void* callbackContext(F& f) noexcept {
+        return const_cast<void*>(static_cast<void const*>(&f));
+    }
+
+    void matchText(StringView text, MatchCallback callback, void* context) const;
+
+    void matchPath(PathView path, MatchCallback callback, void* context) const;
+
+    /// Run the automaton over chunks of text produced by forEachChunk.
+    template<typename ForEachChunk>
+    void run(uint64* states, uint64* next, ForEachChunk&& forEachChunk, MatchCallback callback, void* context) const;
+
+    /// Start the pattern that requires the literal found at the offset if the literal is where the pattern needs it.
+    void startIfPlaced(uint64* states, uint32 literal, MemoryView::size_type offset,
+                       MemoryView::size_type textSize) const noexcept;
+
+    /// Add states reachable without consuming input. @return False if the set of states is empty.
+    bool closure(uint64* states) const noexcept;
+
+    friend Result<GlobSet, Error> makeGlobSet(ArrayView<const StringView> patterns);
+
+    GlobSet() noexcept = default;
+
+    /// Number of 64 bit words in a set of states.
+    uint32                  _words{0};
+
+    /// Map of byte values to their equivalence class: bytes that no pattern distinguishes share a class.
+    byte                    _byteClasses[256]{};
+
+    /// Transitions of each byte class: for each word of states, a word of states advanced by the byte
+    /// followed by a word of states that consume the byte and stay.
+    Array<uint64>           _transitions;
+
+    /// For each distance d in [1, _maxSkip], a word of states for each word of states: states that reach
+    /// the state d positions ahead without consuming input.
+    Array<uint64>           _closure;
+    uint32                  _maxSkip{0};
+
+    Array<uint64>           _finals;        //!< Accepting state of each pattern.
+    Array<uint64>           _starts;        //!< Start states of patterns that are not prefiltered.
+
+    /// First state of each pattern, followed by the total number of states.
+    Array<uint32>           _patternStart;
+
+    /// Prefilter over literals required by patterns. Literal i is required by pattern _literalPatterns[i]
+    /// at the start, at the end or anywhere in the text, as given by _literalAnchors[i].
+    Optional<MultiPatternMatcher>   _prefilter;
+    Array<PatternId>        _literalPatterns;
+    Array<byte>             _literalAnchors;
+};
+
+
+/**
+ * Compile a set of glob patterns.
+ * @param patterns Patterns to match. Patterns are compiled and don't need to outlive the set.
+ * @return A compiled set or an error if any of the patterns is malformed.
+ */
+Result<GlobSet, Error> makeGlobSet(ArrayView<const StringView> patterns);
+
+}  // End of namespace Solace
+#endif  // SOLACE_GLOB_HPP
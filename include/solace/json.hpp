@@ -0,0 +1,258 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace: JSON tokenizer
+ *	@file		solace/json.hpp
+ *	@brief		Zero-copy JSON tokenizer with on-demand access to values.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_JSON_HPP
+#define SOLACE_JSON_HPP
+
+#include "solace/memoryView.hpp"
+#include "solace/stringView.hpp"
+#include "solace/byteReader.hpp"
+#include "solace/byteWriter.hpp"
+#include "solace/array.hpp"
+#include "solace/optional.hpp"
+#include "solace/parseNumber.hpp"
+#include "solace/result.hpp"
+#include "solace/error.hpp"
+
+
+namespace Solace {
+
+/**
+ * Error of tokenizing a JSON document.
+ * Carries the offset in the source of the character where the error was detected.
+ */
+struct JsonError {
+    enum class Kind {
+        Syntax,             //!< Document is not a valid JSON.
+        InvalidUtf8,        //!< Document is not a well-formed UTF-8 text.
+        UnclosedString,     //!< String is not terminated before the end of the document.
+        DepthLimit,         //!< Containers are nested deeper than JsonDocument::kMaxDepth.
+        TooLarge            //!< Document is larger than JsonDocument::kMaxSize.
+    };
+
+    Kind                    kind;
+    MemoryView::size_type   offset;
+
+    /// Convert to a generic error to be propagated through Result<T, Error>.
+    Error toError() const noexcept;
+
+    operator Error() const noexcept { return toError(); }
+};
+
+
+/// Type of a JSON value.
+enum class JsonType {
+    Null,
+    Boolean,
+    Number,
+    String,
+    Array,
+    Object
+};
+
+
+class JsonDocument;
+
+
+/**
+ * A value of a tokenized JSON document.
+ * Value is a lightweight reference into the document and is only valid while the document is alive.
+ * Strings and numbers are not converted until requested, and strings are returned as views into the source.
+ */
+class JsonValue {
+public:
+
+    using size_type = uint32;
+
+    JsonType type() const noexcept;
+
+    bool isNull() const noexcept { return type() == JsonType::Null; }
+    bool isBool() const noexcept { return type() == JsonType::Boolean; }
+    bool isNumber() const noexcept { return type() == JsonType::Number; }
+    bool isString() const noexcept { return type() == JsonType::String; }
+    bool isArray() const noexcept { return type() == JsonType::Array; }
+    bool isObject() const noexcept { return type() == JsonType::Object; }
+
+    /// Get value of a boolean.
+    Result<bool, Error> getBool() const;
+
+    /**
+     * Get value of a number converted to the type T.
+     * @return Value of the number or an error if the value is not a number or it does not fit into T.
+     */
+    template<typename T>
+    Result<T, Error> getNumber() const {
+        auto token = numberToken();
+        if (!token) {
+            return Err(token.moveError());
+        }
+
+        return parseNumber<T>(token.unwrap());
+    }
+
+    /**
+     * Get content of a string as a view into the source, without decoding escape sequences.
+     * @return Raw content of the string or an error if the value is not a string.
+     */
+    Result<StringView, Error> getRawString() const;
+
+    /// Test if the string contains escape sequences and must be decoded with decodeString().
+    bool hasEscapes() const noexcept;
+
+    /**
+     * Decode string value, replacing escape sequences with the characters they represent.
+     * Escape sequences are validated only when the string is decoded.
+     * @param dest Writer to write decoded UTF-8 string into.
+     */
+    Result<void, Error> decodeString(ByteWriter& dest) const;
+
+    /// Number of elements of an array or members of an object, 0 for other values.
+    size_type size() const noexcept;
+
+    /// Get an element of an array by its index.
+    Optional<JsonValue> at(size_type index) const noexcept;
+
+    /**
+     * Find a member of an object by its key.
+     * Keys are compared as written in the source, without decoding escape sequences.
+     */
+    Optional<JsonValue> find(StringView key) const noexcept;
+
+    /// Call f(JsonValue) for each element of an array.
+    template<typename F>
+    void forEachElement(F&& f) const {
+        if (!isArray()) {
+            return;
+        }
+
+        for (auto i = _index + 1; !isContainerEnd(i); i = nextSibling(i)) {
+            f(JsonValue{_document, i});
+        }
+    }
+
+    /// Call f(StringView key, JsonValue value) for each member of an object.
+    template<typename F>
+    void forEachMember(F&& f) const {
+        if (!isObject()) {
+            return;
+        }
+
+        for (auto i = _index + 1; !isContainerEnd(i); i = nextSibling(i + 2)) {
+            f(JsonValue{_document, i}.getRawString().unwrap(), JsonValue{_document, i + 2});
+        }
+    }
+
+protected:
+
+    friend class JsonDocument;
+
+    JsonValue(JsonDocument const* document, uint32 index) noexcept
+        : _document{document}
+        , _index{index}
+    {}
+
+    Result<StringView, Error> numberToken() const;
+
+    bool isContainerEnd(uint32 index) const noexcept;
+
+    uint32 nextSibling(uint32 index) const noexcept;
+
+private:
+    JsonDocument const*     _document;
+    uint32                  _index;
+};
+
+
+/**
+ * Tokenized JSON document.
+ *
+ * Tokenization runs in two stages, following the approach of simdjson:
+ * stage 1 classifies 64 bytes at a time into bitmasks of quotes, escapes and structural characters
+ * and collects positions of all tokens; stage 2 walks those positions, validates the grammar and
+ * records a tape of tokens that refer to the source by offset. Nothing is copied from the source,
+ * which must outlive the document: a view of a memory mapped file can be tokenized in place.
+ */
+class JsonDocument {
+public:
+
+    /// Maximum nesting depth of arrays and objects.
+    static constexpr uint32 kMaxDepth = 1024;
+
+    /// Maximum size of a document in bytes.
+    static constexpr MemoryView::size_type kMaxSize = 0x7FFFFFFF;
+
+public:
+
+    JsonDocument(JsonDocument&&) noexcept = default;
+    JsonDocument& operator= (JsonDocument&&) noexcept = default;
+
+    /// Root value of the document.
+    JsonValue root() const noexcept {
+        return {this, 0};
+    }
+
+    /// Source text of the document.
+    MemoryView source() const noexcept {
+        return _source;
+    }
+
+    /// Number of entries in the token tape.
+    uint32 tapeSize() const noexcept {
+        return _tapeSize;
+    }
+
+protected:
+
+    friend class JsonValue;
+    friend Result<JsonDocument, JsonError> parseJson(MemoryView source);
+
+    JsonDocument(MemoryView source, Array<uint64>&& tape, uint32 tapeSize) noexcept
+        : _source{source}
+        , _tape{std::move(tape)}
+        , _tapeSize{tapeSize}
+    {}
+
+private:
+    MemoryView      _source;
+    Array<uint64>   _tape;
+    uint32          _tapeSize;
+};
+
+
+/**
+ * Tokenize a JSON document.
+ * The document must be UTF-8 text containing exactly one JSON value surrounded by optional whitespace.
+ * @param source Text of the document. It is not copied and must outlive the document.
+ * @return Tokenized document or an error.
+ */
+Result<JsonDocument, JsonError> parseJson(MemoryView source);
+
+inline Result<JsonDocument, JsonError> parseJson(StringView source) {
+    return parseJson(source.view());
+}
+
+/// Tokenize a JSON document from the remaining bytes of the reader.
+inline Result<JsonDocument, JsonError> parseJson(ByteReader const& reader) {
+    return parseJson(reader.viewRemaining());
+}
+
+}  // End of namespace Solace
+#endif  // SOLACE_JSON_HPP
@@ -27,6 +27,9 @@
 #include "solace/utils.hpp"
 #include "solace/result.hpp"
 
+#include <cstring>      // memcpy
+#include <type_traits>
+
 
 namespace Solace {
 
@@ -39,6 +42,42 @@ class Error;
  */
 bool isBigendian() noexcept;
 
+/**
+ * Copy an array of values reversing the order of bytes of each value.
+ * Neither the source nor the destination need to be aligned, but they must not overlap.
+ * @param dest Memory to copy values into, at least count * elementSize bytes.
+ * @param src Values to copy.
+ * @param count Number of values to copy.
+ * @param elementSize Size of a value in bytes: 1, 2, 4 or 8. Values of 1 byte are copied as is.
+ */
+void copySwappingBytes(void* dest, void const* src, uint64 count, uint64 elementSize) noexcept;
+
+/**
+ * Reverse the order of bytes of a value.
+ * @return Value with the bytes in the reverse order, compiles into a single bswap instruction.
+ */
+template<typename T>
+std::enable_if_t<std::is_arithmetic<T>::value && sizeof(T) <= sizeof(uint64), T>
+byteSwapped(T value) noexcept {
+    if constexpr (sizeof(T) == 1) {
+        return value;
+    } else {
+        using Bits = std::conditional_t<sizeof(T) == 2, uint16, std::conditional_t<sizeof(T) == 4, uint32, uint64>>;
+        Bits bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        if constexpr (sizeof(T) == 2) {
+            bits = __builtin_bswap16(bits);
+        } else if constexpr (sizeof(T) == 4) {
+            bits = __builtin_bswap32(bits);
+        } else {
+            bits = __builtin_bswap64(bits);
+        }
+        std::memcpy(&value, &bits, sizeof(bits));
+
+        return value;
+    }
+}
+
 
 /* Read-only view into a fixed-length raw memory buffer.
  * A very thin abstruction on top of raw memory address -
@@ -0,0 +1,222 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace: Multi-pattern matcher
+ *	@file		solace/multiPatternMatcher.hpp
+ *	@brief		Search for many literal patterns in one pass over the text.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_MULTIPATTERNMATCHER_HPP
+#define SOLACE_MULTIPATTERNMATCHER_HPP
+
+#include "solace/stringView.hpp"
+#include "solace/memoryView.hpp"
+#include "solace/arrayView.hpp"
+#include "solace/array.hpp"
+#include "solace/result.hpp"
+#include "solace/error.hpp"
+
+#include <type_traits>
+
+
+namespace Solace {
+
+/**
+ * Compiled set of literal patterns that are searched for simultaneously.
+ *
+ * The matcher is built once from a set of patterns and reports every occurrence of every pattern,
+ * including overlapping ones, as a pair of (pattern id, offset). Pattern id is the index of the pattern
+ * in the set the matcher was built from, offset is the position of the first byte of the occurrence.
+ *
+ * Patterns are compiled into a deterministic Aho-Corasick automaton over byte equivalence classes
+ * which scans the text in time linear in its size regardless of the number of patterns.
+ * Small sets of patterns are additionally searched with a SIMD prefilter (Teddy) when the CPU supports it.
+ *
+ * Example:
+ * @code{.cpp}
+ *  StringView keywords[] = {"error", "warn"};
+ *  auto matcher = makeMultiPatternMatcher(arrayView(keywords)).unwrap();
+ *  matcher.scan(line, [](MultiPatternMatcher::PatternId id, MultiPatternMatcher::size_type offset) {
+ *      ...
+ *  });
+ * @endcode
+ */
+class MultiPatternMatcher {
+public:
+
+    using PatternId = uint32;
+    using size_type = MemoryView::size_type;
+
+    /// Maximum number of patterns that is searched with the SIMD prefilter.
+    static constexpr PatternId kMaxPrefilterPatterns = 8;
+
+    /**
+     * Incremental search over text that arrives in chunks.
+     * Occurrences that span chunk boundaries are reported and offsets are counted from the beginning
+     * of the stream. Streams always run the automaton as its state carries over between chunks.
+     * The matcher must outlive the stream.
+     */
+    class Stream {
+    public:
+
+        explicit Stream(MultiPatternMatcher const& matcher) noexcept
+            : _matcher{&matcher}
+        {}
+
+        /**
+         * Search the next chunk of the stream.
+         * @param chunk Next chunk of the text.
+         * @param onMatch Callback invoked as onMatch(PatternId id, size_type offset) for each occurrence.
+         */
+        template<typename F>
+        Stream& feed(MemoryView chunk, F&& onMatch) {
+            _state = _matcher->feed(_state, _position, chunk, &invokeCallback<F>, callbackContext(onMatch));
+            _position += chunk.size();
+
+            return *this;
+        }
+
+        template<typename F>
+        Stream& feed(StringView chunk, F&& onMatch) {
+            return feed(chunk.view(), std::forward<F>(onMatch));
+        }
+
+        /// Number of bytes fed into the stream so far.
+        size_type position() const noexcept { return _position; }
+
+        /// Restart the stream from the beginning.
+        void reset() noexcept {
+            _state = 0;
+            _position = 0;
+        }
+
+    private:
+        MultiPatternMatcher const*  _matcher;
+        uint32                      _state{0};
+        size_type                   _position{0};
+    };
+
+public:
+
+    MultiPatternMatcher(MultiPatternMatcher&&) noexcept = default;
+    MultiPatternMatcher& operator= (MultiPatternMatcher&&) noexcept = default;
+
+    /// Number of patterns in the set.
+    PatternId patternsCount() const noexcept { return _patternLengths.size(); }
+
+    /// Length of the pattern with the given id.
+    StringView::size_type patternLength(PatternId id) const { return _patternLengths[id]; }
+
+    /// Number of states of the compiled automaton.
+    uint32 statesCount() const noexcept { return _statesCount; }
+
+    /// True if the SIMD prefilter is used to search the text.
+    bool usesPrefilter() const noexcept;
+
+    /**
+     * Search the text for all occurrences of all patterns.
+     * The automaton reports occurrences in order of the position of their last byte, while the prefilter
+     * (@see usesPrefilter) reports them in order of their offset, occurrences at the same offset in order of
+     * pattern id. Callers that depend on the order should sort the occurrences.
+     * @param text Text to search.
+     * @param onMatch Callback invoked as onMatch(PatternId id, size_type offset) for each occurrence.
+     */
+    template<typename F>
+    void scan(MemoryView text, F&& onMatch) const {
+        scan(text, &invokeCallback<F>, callbackContext(onMatch));
+    }
+
+    template<typename F>
+    void scan(StringView text, F&& onMatch) const {
+        scan(text.view(), &invokeCallback<F>, callbackContext(onMatch));
+    }
+
+    /// Check if the text contains at least one of the patterns.
+    bool matchesAny(MemoryView text) const noexcept;
+
+    bool matchesAny(StringView text) const noexcept {
+        return matchesAny(text.view());
+    }
+
+private:
+
+    /// Type erased match callback. @return True to continue the search.
+    using MatchCallback = bool (*)(void* context, PatternId id, size_type offset);
+
+    template<typename F>
+    static bool invokeCallback(void* context, PatternId id, size_type offset) {
+        (*static_cast<std::remove_reference_t<F>*>(context))(id, offset);
+
+        return true;
+    }
+
+    template<typename F>
+    static void* callbackContext(F& f) noexcept {
+        return const_cast<void*>(static_cast<void const*>(&f));
+    }
+
+    void scan(MemoryView text, MatchCallback callback, void* context) const;
+
+    uint32 feed(uint32 state, size_type position, MemoryView text, MatchCallback callback, void* context) const;
+
+    /// Run the automaton over the text. @return State after the last byte or kStopped if stopped by the callback.
+    uint32 runAutomaton(uint32 state, size_type position, MemoryView text,
+                        MatchCallback callback, void* context) const;
+
+    bool scanPrefiltered(MemoryView text, MatchCallback callback, void* context) const;
+
+    friend Result<MultiPatternMatcher, Error> makeMultiPatternMatcher(ArrayView<const StringView> patterns);
+
+    MultiPatternMatcher() noexcept = default;
+
+    /// Map of byte values to their equivalence class: bytes that do not distinguish patterns share a class.
+    byte                    _byteClasses[256]{};
+    uint32                  _classesCount{0};
+    uint32                  _statesCount{0};
+
+    /// Transition table. State ids are pre-multiplied by the number of classes to index rows directly.
+    Array<uint32>           _transitions;
+
+    /// States with an id not less than this one are accepting.
+    uint32                  _firstMatchState{0};
+
+    /// Accepting state i outputs patterns _outputs[_outputStart[i] .. _outputStart[i + 1]).
+    Array<uint32>           _outputStart;
+    Array<PatternId>        _outputs;
+
+    Array<StringView::size_type>    _patternLengths;
+
+    /// Copy of pattern bytes, pattern i starts at _patternOffsets[i]. Used to verify prefilter candidates.
+    Array<char>             _patternData;
+    Array<uint32>           _patternOffsets;
+
+    /// Number of leading bytes of each pattern used as a prefilter fingerprint or 0 if prefilter is not used.
+    uint32                  _fingerprintLength{0};
+
+    /// Prefilter nibble masks: [fingerprint byte][low/high nibble][nibble value] -> bit set of patterns.
+    byte                    _fingerprintMasks[3][2][16]{};
+};
+
+
+/**
+ * Compile a set of literal patterns into a matcher.
+ * @param patterns Patterns to search for. Patterns are copied and don't need to outlive the matcher.
+ * @return A compiled matcher or an error if any of the patterns is empty.
+ */
+Result<MultiPatternMatcher, Error> makeMultiPatternMatcher(ArrayView<const StringView> patterns);
+
+}  // End of namespace Solace
+#endif  // SOLACE_MULTIPATTERNMATCHER_HPP
@@ -80,7 +80,7 @@ operator<< (std::ostream& ostr, Solace::hashing::MessageDigest const& a) {
 
 
 // FIXME: std dependence, used for Unit Testing only
-inline std::ostream& operator<< (std::ostream& ostr, Solace::Path const& v) {
+inline std::ostream& operator<< (std::ostream& ostr, Solace::PathView const& v) {
     return ostr << v.toString();
 }
 
@@ -0,0 +1,194 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace: Numeric parsing
+ *	@file		solace/parseNumber.hpp
+ *	@brief		Locale independent parsing of numbers from string views.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_PARSENUMBER_HPP
+#define SOLACE_PARSENUMBER_HPP
+
+#include "solace/stringView.hpp"
+#include "solace/array.hpp"
+#include "solace/result.hpp"
+#include "solace/error.hpp"
+
+#include <limits>
+#include <type_traits>
+
+
+namespace Solace {
+
+namespace details {
+
+/**
+ * Parse an unsigned decimal number that spans the whole of the given string.
+ * @param str String of decimal digits. No sign, whitespace or other characters are allowed.
+ * @param maxValue Maximum acceptable value.
+ * @return Parsed value or an error:
+ *  BasicError::InvalidInput if the string is empty or contains non-digit characters,
+ *  GenericError::RANGE if the value is greater than maxValue.
+ */
+Result<uint64, Error> parseUnsigned(StringView str, uint64 maxValue) noexcept;
+
+/**
+ * Parse an optionally signed decimal number that spans the whole of the given string.
+ * @return Parsed value or an error, @see parseUnsigned.
+ */
+Result<int64, Error> parseSigned(StringView str, int64 minValue, int64 maxValue) noexcept;
+
+Result<float32, Error> parseFloat32(StringView str) noexcept;
+Result<float64, Error> parseFloat64(StringView str) noexcept;
+
+/// Error reported when a destination is too small to hold all parsed values.
+Error makeParseOverflowError() noexcept;
+
+}  // namespace details
+
+
+/**
+ * Parse a string as an unsigned integer value of type T.
+ * The whole string must be a decimal number: no whitespaces or sign are allowed.
+ * No NUL terminator is required and the result does not depend on the current locale.
+ *
+ * @return Parsed value or an error:
+ *  BasicError::InvalidInput if the string is not a number,
+ *  GenericError::RANGE if the number does not fit into T.
+ */
+template<typename T>
+std::enable_if_t<std::is_integral<T>::value && std::is_unsigned<T>::value, Result<T, Error>>
+parseUint(StringView str) noexcept {
+    return details::parseUnsigned(str, std::numeric_limits<T>::max())
+            .then([](uint64 value) { return static_cast<T>(value); });
+}
+
+
+/**
+ * Parse a string as a signed integer value of type T.
+ * The whole string must be a decimal number with an optional leading '-' or '+'.
+ *
+ * @return Parsed value or an error, @see parseUint.
+ */
+template<typename T>
+std::enable_if_t<std::is_integral<T>::value && std::is_signed<T>::value, Result<T, Error>>
+parseInt(StringView str) noexcept {
+    return details::parseSigned(str, std::numeric_limits<T>::min(), std::numeric_limits<T>::max())
+            .then([](int64 value) { return static_cast<T>(value); });
+}
+
+
+/**
+ * Parse a string as a floating point value of type T.
+ * Accepted syntax: [+-]digits[.digits][(e|E)[+-]digits], as well as 'inf', 'infinity' and 'nan'.
+ * Parsed value is correctly rounded.
+ *
+ * @return Parsed value or an error:
+ *  BasicError::InvalidInput if the string is not a number,
+ *  GenericError::RANGE if the number is too big or too small to be represented by T.
+ */
+template<typename T>
+std::enable_if_t<std::is_same<T, float32>::value, Result<T, Error>>
+parseFloat(StringView str) noexcept {
+    return details::parseFloat32(str);
+}
+
+template<typename T>
+std::enable_if_t<std::is_same<T, float64>::value, Result<T, Error>>
+parseFloat(StringView str) noexcept {
+    return details::parseFloat64(str);
+}
+
+
+/**
+ * Parse a string as a number of type T using one of parseInt, parseUint or parseFloat depending on T.
+ */
+template<typename T>
+std::enable_if_t<std::is_integral<T>::value && std::is_unsigned<T>::value, Result<T, Error>>
+parseNumber(StringView str) noexcept { return parseUint<T>(str); }
+
+template<typename T>
+std::enable_if_t<std::is_integral<T>::value && std::is_signed<T>::value, Result<T, Error>>
+parseNumber(StringView str) noexcept { return parseInt<T>(str); }
+
+template<typename T>
+std::enable_if_t<std::is_floating_point<T>::value, Result<T, Error>>
+parseNumber(StringView str) noexcept { return parseFloat<T>(str); }
+
+
+/**
+ * Parse delimited list of numbers into the given destination.
+ * @param str String to parse, for example a column of values "1,2,3".
+ * @param delimiter Character that separates values.
+ * @param dest Destination to store parsed values into.
+ * @return Number of values parsed or an error if any of the values can not be parsed
+ *  or the destination is too small to hold all the values.
+ */
+template<typename T>
+Result<typename ArrayView<T>::size_type, Error>
+parseList(StringView str, StringView::value_type delimiter, ArrayView<T> dest) noexcept {
+    using size_type = typename ArrayView<T>::size_type;
+
+    size_type count = 0;
+    uint32 from = 0;
+    for (uint32 i = 0; i <= str.size(); ++i) {
+        if (i != str.size() && str.data()[i] != delimiter) {
+            continue;
+        }
+
+        if (count >= dest.size()) {
+            return Err(details::makeParseOverflowError());
+        }
+
+        auto value = parseNumber<T>(str.substring(static_cast<StringView::size_type>(from),
+                                                  static_cast<StringView::size_type>(i)));
+        if (!value) {
+            return Err(value.moveError());
+        }
+
+        dest[count++] = value.unwrap();
+        from = i + 1;
+    }
+
+    return Ok(count);
+}
+
+
+/**
+ * Parse delimited list of numbers into a new array.
+ * Values are counted up-front so that the array is allocated exactly once.
+ * @return An array of parsed values or an error if any of the values can not be parsed.
+ */
+template<typename T>
+[[nodiscard]]
+Result<Array<T>, Error>
+parseList(StringView str, StringView::value_type delimiter) {
+    typename Array<T>::size_type count = 1;
+    for (auto c : str) {
+        count += (c == delimiter) ? 1 : 0;
+    }
+
+    auto values = makeArray<T>(count);
+    auto parsed = parseList<T>(str, delimiter, values.view());
+    if (!parsed) {
+        return Err(parsed.moveError());
+    }
+
+    return Ok(std::move(values));
+}
+
+}  // End of namespace Solace
+#endif  // SOLACE_PARSENUMBER_HPP
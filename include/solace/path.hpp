@@ -31,37 +31,103 @@
 #include "solace/error.hpp"
 #include "solace/vector.hpp"
 
+#include <iterator>
+
 
 namespace Solace {
 
-/** Hierarchical path class - the kind used by File system, but not exactly
- * Path is an ordered sequence of strings/names that can be represented by a string,
- * e.g Formattable and Parsable object.
- *
- * Examples of Paths (first 3 with the same '/' as a delimiter):
- * 	* File system path string: /etc/config.json
- * 	* URL path component: /webapp/action/index.html
- * 	* Tree element path: <root>/node x/taget_node
- * 	* Web host name also a path: www.blah.example.com
- * 	* Java package name: org.java.AwesomePackages
+class Path;
+
+namespace details {
+class PathBuilder;
+}  // namespace details
+
+/** Non-owning view of a hierarchical path.
  *
- * Note: that path object is designed to be immutable, e.g it cannot be changed once created,
- * It can be appended to / subtracted from - creating a new object (kind of like a linked list).
- * Being immutable means that any such addition or subtraction will produce a new object.
+ * A view refers to the storage of a Path object and is only valid while that path is alive.
+ * Parent and sub-paths of a view are views into the same storage, so taking them is O(1) and never allocates.
  *
- * Note: Path is an abstraction and is not designed to be compatible with
- * the underlying filesystem representation of a file path.
- * Wherever possible file objects can be created from a file system path,
- * but no direct compatibility is designed.
- * This also implies that functions line noramalize don't do file system travesal,
- * but operate on path string components only.
+ * Path components are stored back-to-back in a single buffer, delimiters are not stored.
+ * Component i spans bytes [offsets[i], offsets[i + 1]) of the buffer.
  */
-class Path {
+class PathView {
 public:
 
-    using value_type = String;
-    using size_type = Array<value_type>::size_type;
-    using const_iterator = Array<value_type>::const_iterator;
+    using value_type = StringView;
+    using size_type = uint32;
+
+    /** Iterator over path components */
+    class const_iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = StringView;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = StringView;
+
+        constexpr const_iterator(char const* data, uint32 const* offset) noexcept
+            : _data{data}
+            , _offset{offset}
+        {}
+
+        StringView operator* () const {
+            return {_data + _offset[0], static_cast<StringView::size_type>(_offset[1] - _offset[0])};
+        }
+
+        const_iterator& operator++ () noexcept {
+            ++_offset;
+            return *this;
+        }
+
+        const_iterator operator++ (int) noexcept {
+            auto const result = *this;
+            ++_offset;
+            return result;
+        }
+
+        const_iterator& operator-- () noexcept {
+            --_offset;
+            return *this;
+        }
+
+        const_iterator operator-- (int) noexcept {
+            auto const result = *this;
+            --_offset;
+            return result;
+        }
+
+        const_iterator& operator+= (difference_type n) noexcept {
+            _offset += n;
+            return *this;
+        }
+
+        const_iterator& operator-= (difference_type n) noexcept {
+            _offset -= n;
+            return *this;
+        }
+
+        const_iterator operator+ (difference_type n) const noexcept { return {_data, _offset + n}; }
+        const_iterator operator- (difference_type n) const noexcept { return {_data, _offset - n}; }
+
+        friend const_iterator operator+ (difference_type n, const_iterator const& it) noexcept { return it + n; }
+
+        difference_type operator- (const_iterator const& rhs) const noexcept {
+            return _offset - rhs._offset;
+        }
+
+        StringView operator[] (difference_type n) const { return *(*this + n); }
+
+        bool operator== (const_iterator const& rhs) const noexcept { return _offset == rhs._offset; }
+        bool operator!= (const_iterator const& rhs) const noexcept { return _offset != rhs._offset; }
+        bool operator< (const_iterator const& rhs) const noexcept { return _offset < rhs._offset; }
+        bool operator> (const_iterator const& rhs) const noexcept { return _offset > rhs._offset; }
+        bool operator<= (const_iterator const& rhs) const noexcept { return _offset <= rhs._offset; }
+        bool operator>= (const_iterator const& rhs) const noexcept { return _offset >= rhs._offset; }
+
+    private:
+        char const*     _data;
+        uint32 const*   _offset;
+    };
 
 public:  // Static methods
 
@@ -71,49 +137,24 @@ public:  // Static methods
 	 */
     static const StringView Delimiter;
 
-    /**
-     * Root path object
-     */
-    static const Path Root;
-
-    /**
-     * Parse a path object from a string.
-     *
-     * @param str A string to parse
-     * @param delim A delimiter used to separate path components
-     * @return Parsed path object
-     *
-     * TODO: Parse family of functions should return Result<Path, ParseError>
-     */
-    static Result<Path, Error>
-    parse(StringView str, StringView delim = Delimiter);
-
 public:  // Object construction
 
-	/** Construct an empty path */
-    Path() = default;
-
-    /** Construct an object by moving content from a given */
-    Path(Path&& p) noexcept: _components(std::move(p._components)) {
-        // No-op
-    }
-
-public:  // Operation
-
-    Path& swap(Path& rhs) noexcept {
-        _components.swap(rhs._components);
-
-        return (*this);
-    }
+	/** Construct an empty path view */
+    constexpr PathView() noexcept = default;
 
     /**
-     * Move assignement.
-     * @param rhs An object to move content from.
-     * @return A reference to this.
+     * Construct a view of path components.
+     * @param data Buffer holding components.
+     * @param offsets Offsets of components in the buffer, must have count + 1 elements.
+     * @param count Number of components.
      */
-    Path& operator= (Path&& rhs) noexcept {
-        return swap(rhs);
-    }
+    constexpr PathView(char const* data, uint32 const* offsets, size_type count) noexcept
+        : _data{data}
+        , _offsets{offsets}
+        , _count{count}
+    {}
+
+public:  // Operation
 
     /** Test if the path is empty.
      *
@@ -121,23 +162,21 @@ public:  // Operation
      * @return True if the path object is empty.
      */
     constexpr bool empty() const noexcept {
-        return _components.empty();
+        return (_count == 0);
     }
 
     /** Test if path is not empty.
      * @return True if this path is not an empty object.
      */
-    explicit constexpr operator bool() const {
+    explicit constexpr operator bool() const noexcept {
       return !empty();
     }
 
-
     /** Tests this path for equality with the given object.
      * @param rhv A path to compare this one to.
      * @return True if this path is equal to the give
      */
-    bool equals(Path const& rhv) const noexcept;
-
+    bool equals(PathView rhv) const noexcept;
 
     /**
      * Test if the path is absolute.
@@ -153,7 +192,9 @@ public:  // Operation
      * Relative path is the one that doe not starts with the root.
      * @return True if the path object represents relative path
      */
-    bool isRelative() const noexcept;
+    bool isRelative() const noexcept {
+        return !isAbsolute();
+    }
 
     /**
      * Get the lenght of the string representation of this path.
@@ -163,6 +204,14 @@ public:  // Operation
      */
     String::size_type length(StringView delim = Delimiter) const noexcept;
 
+    /**
+     * Get total size of all components, without delimiters.
+     * @return Number of bytes used to store path components.
+     */
+    uint32 dataSize() const noexcept {
+        return empty() ? 0 : _offsets[_count] - _offsets[0];
+    }
+
     //--------------------------------------------------------------------------
 	// --- Relational collection operations
 	//--------------------------------------------------------------------------
@@ -176,44 +225,38 @@ public:  // Operation
 	 * @return a value less than 0 if this string is lexicographically less than the string argument;
 	 * @return and a value greater than 0 if this string is lexicographically greater than the string argument.
 	 */
-    int compareTo(const Path& other) const;
+    int compareTo(PathView other) const noexcept;
 
     /** Tests if this path starts with the given path.
      * @param other
      * @return True, if this path object starts with the given
      */
-    bool startsWith(const Path& other) const;
+    bool startsWith(PathView other) const noexcept;
 
     /** Tests if this path string representation starts with the string given.
      * @param str A string to test
      * @return True, if this path object starts with the given string
      */
-    bool startsWith(StringView str) const {
-        // FIXME: Wasteful allocation of string representation
-        return toString().startsWith(str);
-    }
+    bool startsWith(StringView str) const noexcept;
 
     /** Tests if this path ends with the given path.
      * @param other
      * @return True, if this path object ends with the given
      */
-    bool endsWith(const Path& other) const;
+    bool endsWith(PathView other) const noexcept;
 
     /** Tests if this path ends with the given string.
      * @param other
      * @return True, if this path object ends with the given
      */
-    bool endsWith(StringView other) const {
-        // FIXME: Wasteful allocation of string representation
-        return toString().endsWith(other);
-    }
+    bool endsWith(StringView other) const noexcept;
 
 	/** Determine if the path contains a given subpath.
 	 *
 	 * @param path The subpath to search for.
 	 * @return <b>true</b> if the path contains the subpath, <b>false</b> otherwise.
 	 */
-    bool contains(const Path& path) const;
+    bool contains(PathView path) const noexcept;
 
     /** Determine if the path string representation contains a given substring.
      *
@@ -224,6 +267,7 @@ public:  // Operation
         // FIXME: Wasteful allocation of string representation
         return toString().contains(str);
     }
+
     /** Determine if the path string representation contains a given substring.
      *
      * @param str The substring to search for.
@@ -245,62 +289,52 @@ public:  // Operation
     Path normalize() const;
 
     // ---- decomposition ----
-    /** Get parent path or null path if this is the root
-     * @return Parent of this path or null
+    /** Get parent path or this path if this is the root or a single component path.
+     * @return Parent of this path, a view into the same storage.
      */
-    Path getParent() const;
+    PathView getParent() const noexcept;
 
     /**
      * Returns the name of the object this path leads to
      * @return The last element of the name sequence
      */
-    StringView getBasename() const;
+    StringView getBasename() const noexcept;
 
     /** Get number of components this path includes
      * @brief getComponentsCount
      * @return Number of path elements in this path
      */
     constexpr size_type getComponentsCount() const noexcept {
-        return _components.size();
+        return _count;
     }
 
-    /** Get number of components this path includes
-     * @brief getComponentsCount
-     * @return Number of path elements in this path
+    /** Get a component of this path.
+     * @param index Index of the component.
+     * @return Path element with the given index.
      */
-    const String& getComponent(size_type index) const;
+    StringView getComponent(size_type index) const;
 
-    const_iterator begin() const {
-        return _components.begin();
+    const_iterator begin() const noexcept {
+        return {_data, _offsets};
     }
 
-    const_iterator end() const {
-        return _components.end();
+    const_iterator end() const noexcept {
+        return {_data, _offsets + _count};
     }
 
     /** Returns sub path of this path
      * Slice of this path object
-     * @return Sub path of this path
+     * @return Sub path of this path, a view into the same storage.
      */
-    Path subpath(size_type beginIndex, size_type endIndex) const noexcept;
+    PathView subpath(size_type beginIndex, size_type endIndex) const noexcept;
 
 
     /** @see Iterable::forEach */
     template<typename F>
-    std::enable_if_t<isCallable<F, const value_type&>::value, const Path& >
+    std::enable_if_t<isCallable<F, value_type>::value, PathView const& >
     forEach(F&& f) const {
-        for (auto const& i : _components) {
-            f(i);
-        }
-
-        return *this;
-    }
-
-    template<typename F>
-    std::enable_if_t<isCallable<F, value_type&&>::value, Path& >
-    forEach(F&& f) && {
-        for (auto& i : _components) {
-            f(std::move(i));
+        for (auto component : *this) {
+            f(component);
         }
 
         return *this;
@@ -319,30 +353,139 @@ public:  // Operation
     }
 
 protected:
-    friend Path makePath(Array<String>&& array);
 
-    /** FIXME(abbyssoul): Only temporary here. to be removed
-     * Move-Construct the path object from a collection of String components
-     * @param array A collection of string components forming the path
+    char const*     _data{nullptr};
+    uint32 const*   _offsets{nullptr};
+    size_type       _count{0};
+};
+
+
+/** Hierarchical path class - the kind used by File system, but not exactly
+ * Path is an ordered sequence of strings/names that can be represented by a string,
+ * e.g Formattable and Parsable object.
+ *
+ * Examples of Paths (first 3 with the same '/' as a delimiter):
+ * 	* File system path string: /etc/config.json
+ * 	* URL path component: /webapp/action/index.html
+ * 	* Tree element path: <root>/node x/taget_node
+ * 	* Web host name also a path: www.blah.example.com
+ * 	* Java package name: org.java.AwesomePackages
+ *
+ * Note: that path object is designed to be immutable, e.g it cannot be changed once created,
+ * It can be appended to / subtracted from - creating a new object (kind of like a linked list).
+ * Being immutable means that any such addition or subtraction will produce a new object.
+ *
+ * Path owns a single buffer that holds the table of component offsets followed by the components,
+ * so constructing a path costs one allocation regardless of the number of components.
+ * All read-only operations are inherited from PathView.
+ *
+ * Note: Path is an abstraction and is not designed to be compatible with
+ * the underlying filesystem representation of a file path.
+ * Wherever possible file objects can be created from a file system path,
+ * but no direct compatibility is designed.
+ * This also implies that functions line noramalize don't do file system travesal,
+ * but operate on path string components only.
+ */
+class Path : public PathView {
+public:  // Static methods
+
+    /**
+     * Root path object
+     */
+    static const Path Root;
+
+    /**
+     * Parse a path object from a string.
+     *
+     * @param str A string to parse
+     * @param delim A delimiter used to separate path components
+     * @return Parsed path object
+     *
+     * TODO: Parse family of functions should return Result<Path, ParseError>
+     */
+    static Result<Path, Error>
+    parse(StringView str, StringView delim = Delimiter);
+
+public:  // Object construction
+
+	/** Construct an empty path */
+    Path() noexcept = default;
+
+    /** Construct an object by moving content from a given */
+    Path(Path&& p) noexcept
+        : PathView{p}
+        , _buffer{std::move(p._buffer)}
+    {
+        static_cast<PathView&>(p) = PathView{};
+    }
+
+    /** Construct a path by copying components of a view */
+    explicit Path(PathView view);
+
+public:  // Operation
+
+    Path& swap(Path& rhs) noexcept {
+        std::swap(static_cast<PathView&>(*this), static_cast<PathView&>(rhs));
+        _buffer.swap(rhs._buffer);
+
+        return (*this);
+    }
+
+    /**
+     * Move assignement.
+     * @param rhs An object to move content from.
+     * @return A reference to this.
      */
-    Path(Array<String>&& array): _components(std::move(array)) {
-        // No-op
+    Path& operator= (Path&& rhs) noexcept {
+        return swap(rhs);
+    }
+
+    /** Get a view of this path */
+    PathView view() const noexcept {
+        return *this;
+    }
+
+    /** Get parent path, a view into the storage of this path. @see PathView::getParent */
+    PathView getParent() const& noexcept {
+        return PathView::getParent();
     }
 
+    /** Get parent path of a temporary path, copied as a view would outlive the storage. */
+    Path getParent() && {
+        return Path{PathView::getParent()};
+    }
+
+    /** Get sub path, a view into the storage of this path. @see PathView::subpath */
+    PathView subpath(size_type beginIndex, size_type endIndex) const& noexcept {
+        return PathView::subpath(beginIndex, endIndex);
+    }
+
+    /** Get sub path of a temporary path, copied as a view would outlive the storage. */
+    Path subpath(size_type beginIndex, size_type endIndex) && {
+        return Path{PathView::subpath(beginIndex, endIndex)};
+    }
+
+protected:
+    friend class details::PathBuilder;
+
+    Path(PathView view, MemoryResource&& buffer) noexcept
+        : PathView{view}
+        , _buffer{std::move(buffer)}
+    {}
 
 private:
 
-    Array<String>  _components{};
+    MemoryResource  _buffer;
 };
 
 
 inline
-bool operator== (Path const& lhs, Path const& rhv) noexcept {
+bool operator== (PathView lhs, PathView rhv) noexcept {
     return lhs.equals(rhv);
 }
 
 inline
-bool operator!= (Path const& lhs, Path const& rhv) noexcept {
+bool operator!= (PathView lhs, PathView rhv) noexcept {
     return !lhs.equals(rhv);
 }
 
@@ -351,106 +494,131 @@ void swap(Path& lhs, Path& rhs) noexcept {
     lhs.swap(rhs);
 }
 
+
+namespace details {
+
 /**
- * Construct the path object from a single string component
- *
- * @note The string is is parsed into component, please use Path::parse
+ * Builder of a path: allocates storage for the given number of components and bytes once
+ * and appends components into it.
  */
-[[nodiscard]]
-Path makePath(StringView str);
+class PathBuilder {
+public:
 
-[[nodiscard]] inline
-Path makePath(String const& str) {
-    return makePath(str.view());
-}
+    PathBuilder(Path::size_type maxComponents, MemoryView::size_type maxDataSize);
 
-[[nodiscard]] inline
-Path makePath(char const* str) {
-    return makePath(StringView{str});
-}
+    PathBuilder& append(StringView component) noexcept;
 
-[[nodiscard]] inline
-Path makePath(Array<String>&& array) {
-    return {std::move(array)};
-}
+    PathBuilder& append(PathView path) noexcept;
 
-[[nodiscard]] inline
-Path makePath(Vector<String>&& vec) {
-    return makePath(vec.toArray());
-}
+    /** Remove the last component */
+    PathBuilder& pop() noexcept;
 
+    Path::size_type size() const noexcept { return _count; }
+
+    StringView back() const noexcept {
+        return {_data + _offsets[_count - 1], static_cast<StringView::size_type>(_offsets[_count] - _offsets[_count - 1])};
+    }
+
+    Path build() noexcept;
+
+private:
+    MemoryResource  _buffer;
+    uint32*         _offsets;
+    char*           _data;
+    Path::size_type _count{0};
+};
 
-namespace details {
 
 constexpr Path::size_type countPathComponents()                 noexcept { return 0; }
 constexpr Path::size_type countPathComponents(StringView)       noexcept { return 1; }
 constexpr Path::size_type countPathComponents(StringLiteral)    noexcept { return 1; }
 constexpr Path::size_type countPathComponents(String const&)    noexcept { return 1; }
-constexpr Path::size_type countPathComponents(String&)          noexcept { return 1; }
 constexpr Path::size_type countPathComponents(char const*)      noexcept { return 1; }
-constexpr Path::size_type countPathComponents(Path const& path) noexcept { return path.getComponentsCount(); }
-constexpr Path::size_type countPathComponents(Path& path)       noexcept { return path.getComponentsCount(); }
+constexpr Path::size_type countPathComponents(PathView path)    noexcept { return path.getComponentsCount(); }
 
-template<typename T, typename...Args>
-Path::size_type countPathComponents(T&& base, Args&&...args) {
-    return (countPathComponents(base) + countPathComponents(std::forward<Args>(args)...));
+template<typename T, typename U, typename...Args>
+Path::size_type countPathComponents(T&& base, U&& next, Args&&...args) {
+    return (countPathComponents(base) + countPathComponents(std::forward<U>(next), std::forward<Args>(args)...));
 }
 
 
-inline void joinComponents(Vector<String>& base, StringView view) {
-    base.emplace_back(makeString(view));
+inline MemoryView::size_type pathDataSize(StringView view)          noexcept { return view.size(); }
+inline MemoryView::size_type pathDataSize(String const& str)        noexcept { return str.size(); }
+inline MemoryView::size_type pathDataSize(PathView path)            noexcept { return path.dataSize(); }
+
+template<typename T, typename U, typename...Args>
+MemoryView::size_type pathDataSize(T&& base, U&& next, Args&&...args) {
+    return (pathDataSize(base) + pathDataSize(std::forward<U>(next), std::forward<Args>(args)...));
 }
 
-inline void joinComponents(Vector<String>& base, String&& str) {
-    base.emplace_back(std::move(str));
+
+inline void joinComponents(PathBuilder& base, StringView view) noexcept {
+    base.append(view);
 }
 
-inline void joinComponents(Vector<String>& base, String const& str) {
-    base.emplace_back(makeString(str));
+inline void joinComponents(PathBuilder& base, String const& str) noexcept {
+    base.append(str.view());
 }
 
-inline void joinComponents(Vector<String>& base, Path&& path) {
-    std::move(path).forEach([&base](Path::value_type&& component) {
-        base.emplace_back(std::move(component));
-    });
+inline void joinComponents(PathBuilder& base, PathView path) noexcept {
+    base.append(path);
 }
 
-inline void joinComponents(Vector<String>& base, Path const& path) {
-    for (auto const& component : path) {
-        base.emplace_back(makeString(component));
-    }
+template <typename T, typename U, typename...Args>
+void joinComponents(PathBuilder& base, T&& component, U&& next, Args&&...args) {
+    joinComponents(base, std::forward<T>(component));
+    joinComponents(base, std::forward<U>(next), std::forward<Args>(args)...);
 }
 
+}  // namespace details
+
 
-template <typename...Args>
-void joinComponents(Vector<String>& base, StringView view, Args&&...args) {
-    joinComponents(base, view);
-    joinComponents(base, std::forward<Args>(args)...);
+/**
+ * Construct the path object from a single string component
+ *
+ * @note The string is is parsed into component, please use Path::parse
+ */
+[[nodiscard]]
+Path makePath(StringView str);
+
+[[nodiscard]] inline
+Path makePath(String const& str) {
+    return makePath(str.view());
 }
 
-template <typename...Args>
-void joinComponents(Vector<String>& base, String const& view, Args&&...args) {
-    joinComponents(base, view);
-    joinComponents(base, std::forward<Args>(args)...);
+[[nodiscard]] inline
+Path makePath(char const* str) {
+    return makePath(StringView{str});
+}
+
+/** Construct the path object by copying components of a view */
+[[nodiscard]] inline
+Path makePath(PathView path) {
+    return Path{path};
 }
 
+[[nodiscard]]
+Path makePath(ArrayView<const String> components);
 
-template <typename...Args>
-void joinComponents(Vector<String>& base, Path const& path, Args&&...args) {
-    joinComponents(base, path);
-    joinComponents(base, std::forward<Args>(args)...);
+[[nodiscard]] inline
+Path makePath(Array<String>&& array) {
+    return makePath(array.view());
 }
 
-}  // namespace details
+[[nodiscard]] inline
+Path makePath(Vector<String>&& vec) {
+    return makePath(vec.view());
+}
 
 
 template<typename...Args>
 [[nodiscard]]
 Path makePath(Args&&...args) {
-    auto components = makeVector<Path::value_type>(details::countPathComponents(std::forward<Args>(args)...));
-    details::joinComponents(components, std::forward<Args>(args)...);
+    details::PathBuilder builder{details::countPathComponents(std::forward<Args>(args)...),
+                                 details::pathDataSize(std::forward<Args>(args)...)};
+    details::joinComponents(builder, std::forward<Args>(args)...);
 
-    return makePath(std::move(components));
+    return builder.build();
 }
 
 }  // namespace Solace
@@ -0,0 +1,329 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace: Path prefix trie
+ *	@file		solace/pathTrie.hpp
+ *	@brief		Associative container keyed by paths with longest-prefix lookup.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_PATHTRIE_HPP
+#define SOLACE_PATHTRIE_HPP
+
+#include "solace/path.hpp"
+#include "solace/array.hpp"
+#include "solace/vector.hpp"
+#include "solace/optional.hpp"
+
+
+namespace Solace {
+
+namespace details {
+
+/**
+ * Untyped index of a PathTrie: maps paths to nodes of a trie.
+ *
+ * Path components are interned: each distinct component string is stored once and is given a small integer label.
+ * Nodes are kept in a single flat array and children are found via a hash table keyed by (parent, label),
+ * so following an edge costs one hash probe regardless of the number of children.
+ * A wildcard component matches any single component of a path and is linked directly from its parent node.
+ */
+class PathTrieIndex {
+public:
+
+    using size_type = uint32;
+    using NodeId = uint32;
+
+    /// Node of the empty path.
+    static constexpr NodeId kRoot = 0;
+
+    /// Marker of a node with no value.
+    static constexpr size_type kNoValue = ~size_type{0};
+
+    /// Result of a prefix match: the node matched and the number of path components it covers.
+    struct Match {
+        NodeId      node;
+        size_type   depth;
+    };
+
+public:
+
+    explicit PathTrieIndex(StringView wildcard);
+
+    PathTrieIndex(PathTrieIndex&& rhs) noexcept = default;
+    PathTrieIndex& operator= (PathTrieIndex&& rhs) noexcept = default;
+
+    /// Find or create the node for a key. Components equal to the wildcard create wildcard nodes.
+    NodeId insert(PathView key);
+
+    /// Find the node of a key. Components equal to the wildcard only match wildcard nodes.
+    Optional<NodeId> find(PathView key) const noexcept;
+
+    /**
+     * Find the node with a value that matches the whole path.
+     * Wildcard nodes match any component, literal components take precedence.
+     * @note Allocates only if more than a few keys match a prefix of the path at the same time.
+     */
+    Optional<NodeId> match(PathView path) const;
+
+    /**
+     * Find the deepest node with a value that matches a prefix of the path.
+     * Wildcard nodes match any component, literal components take precedence at equal depth.
+     */
+    Optional<Match> longestPrefix(PathView path) const;
+
+    /// Index of the value of a node or kNoValue.
+    size_type valueIndex(NodeId node) const noexcept { return _nodes[node].value - 1; }
+
+    void setValueIndex(NodeId node, size_type index) noexcept { _nodes[node].value = index + 1; }
+
+    /// Reconstruct the key of a node.
+    Path keyOf(NodeId node) const;
+
+    /// Call f(NodeId) for the node and each of its descendants, parents before children.
+    template<typename F>
+    void forEachInSubtree(NodeId node, F&& f) const {
+        auto const top = node;
+        while (true) {
+            f(node);
+
+            // Descend first, then move to the next sibling of the nearest ancestor that has one.
+            if (_nodes[node].firstChild != 0) {
+                node = _nodes[node].firstChild;
+                continue;
+            }
+
+            while (node != top && _nodes[node].nextSibling == 0) {
+                node = _nodes[node].parent;
+            }
+
+            if (node == top) {
+                return;
+            }
+
+            node = _nodes[node].nextSibling;
+        }
+    }
+
+    /// Number of nodes, including the root.
+    size_type nodesCount() const noexcept { return _nodesCount; }
+
+private:
+
+    /// Node of the trie. Node 0 is the root and is never a child, so 0 also means 'no node'.
+    struct Node {
+        uint32  label;          //!< Interned component leading to this node.
+        uint32  parent;
+        uint32  firstChild;
+        uint32  nextSibling;
+        uint32  wildcard;       //!< Wildcard child.
+        uint32  value;          //!< Index of the value + 1, or 0.
+    };
+
+    /// Entry of the children table. Free entries have child == 0.
+    struct Edge {
+        uint32  parent;
+        uint32  label;
+        uint32  child;
+    };
+
+    StringView labelText(uint32 label) const noexcept;
+    Optional<uint32> findLabel(StringView component) const noexcept;
+    uint32 intern(StringView component);
+
+    uint32 findChild(NodeId parent, uint32 label) const noexcept;
+    NodeId addChild(NodeId parent, uint32 label);
+
+    /// Nodes reached by a prefix of a path, in order of precedence.
+    class Frontier;
+
+    /// Follow a path component from each node of the frontier, literal children before wildcard ones.
+    void advance(Frontier const& from, StringView component, Frontier& to) const;
+
+    /// First node of the frontier that has a value.
+    Optional<NodeId> firstWithValue(Frontier const& frontier) const noexcept;
+    void appendKey(PathBuilder& builder, NodeId node) const noexcept;
+
+    Array<Node>     _nodes;
+    size_type       _nodesCount{1};
+
+    Array<Edge>     _edges;             //!< Open addressing table of (parent, label) -> child.
+    size_type       _edgesCount{0};
+
+    Array<char>     _text;              //!< Text of the interned components, back-to-back.
+    Array<uint32>   _labelOffsets;      //!< Label i spans [_labelOffsets[i], _labelOffsets[i + 1]) of the text.
+    Array<uint32>   _labelSlots;        //!< Open addressing table of label + 1, 0 for free slots.
+    size_type       _labelsCount{0};
+
+    uint32          _wildcard;          //!< Label of the wildcard component.
+};
+
+}  // namespace details
+
+
+/**
+ * Associative container of values keyed by paths that finds values by path prefixes.
+ *
+ * Typical use is routing: given the prefixes under which handlers are registered, find the handler
+ * for a path by its longest registered prefix. Lookup follows the components of the path through a trie,
+ * so its cost depends on the depth of the path, not the number of keys.
+ *
+ * A key component equal to the wildcard (default "*") matches any single component of a path.
+ * When both a literal and a wildcard component match, the literal one is preferred.
+ *
+ * Example:
+ * @code{.cpp}
+ *  PathTrie<Handler> routes;
+ *  routes.insert(makePath("", "api"), apiHandler);
+ *  routes.insert(makePath("", "api", "users", "*"), userHandler);
+ *
+ *  auto handler = routes.longestPrefix(Path::parse("/api/users/42/avatar").unwrap());
+ * @endcode
+ */
+template<typename V>
+class PathTrie {
+public:
+
+    using size_type = uint32;
+    using value_type = V;
+
+    /// Result of a prefix match: the value and the number of path components matched by its key.
+    struct Match {
+        V*          value;
+        size_type   depth;
+    };
+
+public:
+
+    explicit PathTrie(StringView wildcard = StringView{"*"})
+        : _index{wildcard}
+    {}
+
+    PathTrie(PathTrie&& rhs) noexcept = default;
+    PathTrie& operator= (PathTrie&& rhs) noexcept = default;
+
+    /// Number of values in the trie.
+    size_type size() const noexcept { return _values.size(); }
+
+    bool empty() const noexcept { return _values.empty(); }
+
+    /**
+     * Associate a value with a key, replacing the previous value of the key if any.
+     * @return Reference to the stored value.
+     */
+    V& insert(PathView key, V value) {
+        auto const node = _index.insert(key);
+        auto const index = _index.valueIndex(node);
+        if (index != details::PathTrieIndex::kNoValue) {
+            V& stored = _values.view()[index];
+            stored = std::move(value);
+
+            return stored;
+        }
+
+        if (_values.size() == _values.capacity()) {
+            grow();
+        }
+
+        _index.setValueIndex(node, _values.size());
+        _values.emplace_back(std::move(value));
+
+        return _values.view()[_values.size() - 1];
+    }
+
+    /**
+     * Find the value of a key.
+     * Key components equal to the wildcard only match wildcard components.
+     * @return Pointer to the value or nullptr if the key is not in the trie.
+     */
+    V* find(PathView key) noexcept { return valueOf(_index.find(key)); }
+
+    V const* find(PathView key) const noexcept { return const_cast<PathTrie*>(this)->find(key); }
+
+    /**
+     * Find the value whose key matches the whole path, including wildcards.
+     * @return Pointer to the value or nullptr if no key matches.
+     */
+    V* match(PathView path) { return valueOf(_index.match(path)); }
+
+    V const* match(PathView path) const { return const_cast<PathTrie*>(this)->match(path); }
+
+    /**
+     * Find the value of the longest key that is a prefix of the path.
+     * @return The value found and the length of its key, or none.
+     */
+    Optional<Match> longestPrefix(PathView path) {
+        auto const found = _index.longestPrefix(path);
+        if (found.isNone()) {
+            return none;
+        }
+
+        return Match{valueOf(found.get().node), found.get().depth};
+    }
+
+    /**
+     * Call f(Path const& key, V& value) for each value whose key starts with the prefix.
+     * Components of the prefix equal to the wildcard only match wildcard components.
+     * Keys are reconstructed, so this allocates once per value visited.
+     */
+    template<typename F>
+    void forEachInSubtree(PathView prefix, F&& f) {
+        auto const top = _index.find(prefix);
+        if (top.isNone()) {
+            return;
+        }
+
+        _index.forEachInSubtree(top.get(), [this, &f](details::PathTrieIndex::NodeId node) {
+            auto const index = _index.valueIndex(node);
+            if (index != details::PathTrieIndex::kNoValue) {
+                f(_index.keyOf(node), _values.view()[index]);
+            }
+        });
+    }
+
+    /// Call f(Path const& key, V& value) for each value in the trie.
+    template<typename F>
+    void forEach(F&& f) {
+        forEachInSubtree(PathView{}, std::forward<F>(f));
+    }
+
+private:
+
+    V* valueOf(Optional<details::PathTrieIndex::NodeId> const& node) noexcept {
+        return node.isSome() ? valueOf(node.get()) : nullptr;
+    }
+
+    V* valueOf(details::PathTrieIndex::NodeId node) noexcept {
+        auto const index = _index.valueIndex(node);
+
+        return (index == details::PathTrieIndex::kNoValue) ? nullptr : &(_values.view()[index]);
+    }
+
+    void grow() {
+        auto const capacity = _values.capacity();
+        auto values = makeVector<V>((capacity < 8) ? 8 : 2 * capacity);
+        for (auto& value : _values.view()) {
+            values.emplace_back(std::move(value));
+        }
+
+        _values = std::move(values);
+    }
+
+    details::PathTrieIndex  _index;
+    Vector<V>               _values;
+};
+
+}  // End of namespace Solace
+#endif  // SOLACE_PATHTRIE_HPP
@@ -0,0 +1,118 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace: Random number generation
+ *	@file		solace/random.hpp
+ *	@brief		Cryptographically secure pseudo random number generator.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_RANDOM_HPP
+#define SOLACE_RANDOM_HPP
+
+#include "solace/mutableMemoryView.hpp"
+#include "solace/result.hpp"
+#include "solace/error.hpp"
+
+
+namespace Solace {
+
+/**
+ * Cryptographically secure pseudo random number generator.
+ * Random bytes are the key stream of ChaCha20 cipher, generated a few blocks at a time.
+ * A generator is not thread safe: each thread is expected to use its own, @see threadLocalRandom.
+ *
+ * Example:
+ * @code{.cpp}
+ *  auto& random = threadLocalRandom();
+ *  byte nonce[12];
+ *  random.fill(wrapMemory(nonce));
+ *  auto const id = random.nextUInt64();
+ * @endcode
+ */
+class SecureRandom {
+public:
+
+    using size_type = MemoryView::size_type;
+
+    /// Size of the key in bytes.
+    static constexpr size_type KeySize = 32;
+
+public:
+
+    /**
+     * Construct a generator that produces the key stream of the given key.
+     * Output is fully determined by the key and the stream, which is useful for testing,
+     * otherwise a generator should be seeded by the system, @see makeSecureRandom.
+     * @param key Key of the cipher, must be KeySize bytes long.
+     * @param stream Identifier of the stream, so that a key can be used to produce independent streams.
+     */
+    explicit SecureRandom(MemoryView key, uint64 stream = 0);
+
+    SecureRandom(SecureRandom const&) = delete;
+    SecureRandom& operator= (SecureRandom const&) = delete;
+
+    /**
+     * Move the generator, so that only one of them produces its stream.
+     * @note State of the moved-from generator is wiped, it must not be used other than to be assigned or destroyed.
+     */
+    SecureRandom(SecureRandom&& rhs) noexcept;
+    SecureRandom& operator= (SecureRandom&& rhs) noexcept;
+
+    ~SecureRandom() noexcept;
+
+    /// Fill the memory with random bytes.
+    void fill(MutableMemoryView dest) noexcept;
+
+    /// Get next random 64 bit number.
+    uint64 nextUInt64() noexcept;
+
+    /// Get next random 32 bit number.
+    uint32 nextUInt32() noexcept;
+
+private:
+
+    /// Number of cipher blocks generated at a time.
+    static constexpr size_type BlocksPerRefill = 4;
+    static constexpr size_type BlockSize = 64;
+
+    void refill() noexcept;
+
+    /// Overwrite the key and output in a way the compiler does not optimise away, leaving no output to use.
+    void wipe() noexcept;
+
+    uint32      _state[16];
+    byte        _buffer[BlocksPerRefill * BlockSize];
+    size_type   _position;
+};
+
+
+/**
+ * Create a generator seeded with a key from the system source of randomness.
+ * @return A new generator or an error if the system failed to provide the seed.
+ */
+Result<SecureRandom, Error> makeSecureRandom();
+
+/**
+ * Get a generator of the calling thread.
+ * The generator is seeded by the system when first used by a thread and is reseeded in the child process after fork,
+ * so that parent and child never produce the same numbers.
+ * @return A generator of the calling thread.
+ * @note Raises an exception if the system fails to provide the seed, @see makeSecureRandom.
+ */
+SecureRandom& threadLocalRandom();
+
+}  // End of namespace Solace
+#endif  // SOLACE_RANDOM_HPP
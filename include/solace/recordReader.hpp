@@ -0,0 +1,168 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace: Record reader
+ *	@file		solace/recordReader.hpp
+ *	@brief		Reader of delimited records, such as lines of text.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_RECORDREADER_HPP
+#define SOLACE_RECORDREADER_HPP
+
+#include "solace/stringView.hpp"
+#include "solace/byteReader.hpp"
+#include "solace/memoryResource.hpp"
+#include "solace/optional.hpp"
+#include "solace/result.hpp"
+#include "solace/error.hpp"
+
+#include <limits>
+
+
+namespace Solace {
+
+/**
+ * Reader of records separated by a delimiter, such as lines of newline-delimited text.
+ *
+ * Records are returned as views into the buffer that holds the data, and are valid until the next call to next().
+ * Input can be an in-memory buffer (for example a memory mapped file), a ByteReader or a file descriptor.
+ * When reading from a file descriptor a partial record at the end of the buffer is moved to its front
+ * before the buffer is refilled, so a record may be as long as the buffer.
+ * Records are limited to kMaxRecordLength, the size a StringView can hold: a longer record is reported
+ * as an error and skipped, so reading continues with the record that follows it.
+ *
+ * The default delimiter is '\n', in which case a '\r' preceding it is stripped as well so that
+ * CRLF-terminated lines are handled transparently. Last record does not need to be terminated.
+ *
+ * Example:
+ * @code{.cpp}
+ *  RecordReader reader{mappedFile.view()};
+ *  for (auto line = reader.next(); line && line.unwrap().isSome(); line = reader.next()) {
+ *      process(line.unwrap().get());
+ *  }
+ * @endcode
+ */
+class RecordReader {
+public:
+
+    using size_type = MemoryView::size_type;
+
+    /// Maximum length of a record, as records are returned as StringView.
+    static constexpr size_type kMaxRecordLength = std::numeric_limits<StringView::size_type>::max();
+
+    /// Maximum length of a delimiter.
+    static constexpr size_type kMaxDelimiterLength = 16;
+
+    /// Size of a buffer allocated to read from a file descriptor when none is given.
+    static constexpr size_type kDefaultBufferSize = 64 * 1024;
+
+public:
+
+    /**
+     * Read records of an in-memory buffer, such as a memory mapped file. Data is not copied.
+     * @param data Data to read records from.
+     * @param delimiter Non empty delimiter of records, @see kMaxDelimiterLength.
+     * @throws IllegalArgumentException if the delimiter is empty or too long.
+     */
+    explicit RecordReader(MemoryView data, StringView delimiter = "\n");
+
+    /**
+     * Read records of the remaining data of the byte reader.
+     * Data is not copied, and position of the byte reader is advanced past each record returned.
+     */
+    explicit RecordReader(ByteReader& reader, StringView delimiter = "\n");
+
+    /**
+     * Read records from a file descriptor into the given buffer.
+     * @param fd File descriptor to read from. It is not closed by the reader.
+     * @param buffer Buffer to read data into. It limits the maximum length of a record.
+     */
+    RecordReader(int fd, MemoryResource&& buffer, StringView delimiter = "\n");
+
+    /// Read records from a file descriptor into a buffer of the default size.
+    explicit RecordReader(int fd, StringView delimiter = "\n");
+
+    RecordReader(RecordReader const&) = delete;
+    RecordReader& operator= (RecordReader const&) = delete;
+
+    /**
+     * Read the next record.
+     * @return The next record without the delimiter, none if there are no more records, or an error.
+     * Records longer than the buffer or kMaxRecordLength result in SystemErrors::Overflow error.
+     * Such a record is skipped, so the next call returns the record that follows it.
+     */
+    Result<Optional<StringView>, Error> next();
+
+    /**
+     * Call f(StringView) for each of the remaining records.
+     * @return Number of records read or an error.
+     */
+    template<typename F>
+    Result<uint64, Error> forEach(F&& f) {
+        uint64 count = 0;
+        while (true) {
+            auto record = next();
+            if (!record) {
+                return Err(record.moveError());
+            }
+
+            if (record.unwrap().isNone()) {
+                return Ok(count);
+            }
+
+            f(record.unwrap().get());
+            count += 1;
+        }
+    }
+
+    /// Number of bytes consumed from the input so far, including delimiters.
+    uint64 position() const noexcept { return _consumed; }
+
+private:
+
+    void setDelimiter(StringView delimiter);
+
+    /// Move unconsumed data to the front of the buffer and read more. @return False at the end of input.
+    Result<bool, Error> refill();
+
+    /**
+     * Consume a record of the given length followed by delimiter of the given length.
+     * @return The record without the delimiter or an error if the byte reader can not be advanced past it.
+     */
+    Result<StringView, Error> consume(size_type recordLength, size_type delimiterLength);
+
+    /// Consume a record that is too long, or the rest of it. @return Overflow error unless the rest is skipped.
+    Result<Optional<StringView>, Error> skip(size_type recordLength, size_type delimiterLength);
+
+    MemoryResource      _buffer;
+    byte const*         _data{nullptr};
+    size_type           _begin{0};      //!< Start of unconsumed data.
+    size_type           _scanned{0};    //!< Data before this offset is known not to contain a delimiter.
+    size_type           _end{0};        //!< End of valid data.
+    uint64              _consumed{0};
+
+    ByteReader*         _reader{nullptr};
+    int                 _fd{-1};
+    bool                _eof{true};
+    bool                _skipRecord{false};  //!< The record being read was reported as too long.
+
+    byte                _delimiter[kMaxDelimiterLength];
+    size_type           _delimiterLength{0};
+    bool                _stripCarriageReturn{false};
+};
+
+}  // End of namespace Solace
+#endif  // SOLACE_RECORDREADER_HPP
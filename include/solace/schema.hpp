@@ -0,0 +1,466 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace: Schema serialization
+ *	@file		solace/schema.hpp
+ *	@brief		Serialization of structs described by a list of fields, read back in place.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_SCHEMA_HPP
+#define SOLACE_SCHEMA_HPP
+
+#include "solace/byteWriter.hpp"
+#include "solace/array.hpp"
+#include "solace/optional.hpp"
+#include "solace/string.hpp"
+#include "solace/stringView.hpp"
+#include "solace/posixErrorDomain.hpp"
+
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+
+namespace Solace {
+
+/**
+ * Declaration of the fields of a struct to serialize, specialized for each serializable struct.
+ * A specialization lists pointers to the members to serialize, in the order they are stored:
+ * @code{.cpp}
+ *  struct Entry {
+ *      uint64                  id;
+ *      StringView              name;
+ *      ArrayView<const uint32> blocks;
+ *      Optional<int32>         mode;
+ *  };
+ *
+ *  template<>
+ *  struct Schema<Entry> {
+ *      static constexpr auto fields = std::make_tuple(&Entry::id, &Entry::name, &Entry::blocks, &Entry::mode);
+ *  };
+ * @endcode
+ *
+ * Supported field types are arithmetic types, StringView and String, ArrayView and Array of arithmetic types,
+ * and Optional of any of these.
+ *
+ * A message starts with a slot of fixed size for each field, followed by the content of strings and arrays.
+ * Numbers are stored in their slots in little endian byte order. A string or an array stores in its slot
+ * the offset of its content from the start of the message and its length, both as 32 bit numbers,
+ * and an optional field stores a byte that tells if the value is present followed by the slot of the value.
+ * As every slot is at an offset known at compile time, a field is read in place without decoding the message.
+ */
+template<typename T>
+struct Schema;
+
+
+/**
+ * Array of numbers stored in little endian byte order in a serialized message.
+ * Elements are read on access, as the data may be neither aligned nor in the byte order of the platform.
+ */
+template<typename T>
+class PackedArrayView {
+public:
+    using size_type = uint32;
+
+public:
+
+    constexpr PackedArrayView() noexcept = default;
+
+    PackedArrayView(byte const* data, size_type count) noexcept
+        : _data{data}
+        , _size{count}
+    {}
+
+    constexpr size_type size() const noexcept { return _size; }
+
+    constexpr bool empty() const noexcept { return (_size == 0); }
+
+    /// Get an element at the given index. @note Raises IndexOutOfRangeException if index is outside [0, size()).
+    T operator[] (size_type index) const {
+        index = assertIndexInRange(index, 0, _size, "PackedArrayView[]");
+
+        T value;
+        std::memcpy(&value, _data + index * sizeof(T), sizeof(T));
+
+        return isLittleEndian() ? value : byteSwapped(value);
+    }
+
+    /// Get the raw bytes of the elements.
+    MemoryView view() const noexcept { return wrapMemory(_data, _size * sizeof(T)); }
+
+private:
+
+    static constexpr bool isLittleEndian() noexcept { return (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__); }
+
+    byte const* _data{nullptr};
+    size_type   _size{0};
+};
+
+
+namespace details {
+
+/// Read a number stored in little endian byte order.
+template<typename T>
+T loadLE(MemoryView message, uint32 offset) noexcept {
+    T value;
+    std::memcpy(&value, message.dataAddress(offset), sizeof(T));
+
+    return (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) ? value : byteSwapped(value);
+}
+
+template<typename P>
+struct MemberPointerTraits;
+
+template<typename C, typename M>
+struct MemberPointerTraits<M C::*> {
+    using Class = C;
+    using Member = M;
+};
+
+
+/**
+ * Wire format of a field type.
+ * Each codec provides the size of a slot, the size of the content stored after the slots,
+ * writing of both and in place reading of a field from a validated message.
+ */
+template<typename M, typename Enable = void>
+struct FieldCodec;
+
+
+template<typename M>
+struct FieldCodec<M, std::enable_if_t<std::is_arithmetic<M>::value>> {
+    using ViewType = M;
+
+    static constexpr uint32 kSlotSize = sizeof(M);
+
+    static uint64 payloadSize(M) noexcept { return 0; }
+
+    static void writeSlot(ByteWriter::Cursor& dest, M value, uint64) noexcept { dest.putLE(value); }
+
+    static void writePayload(ByteWriter::Cursor&, M) noexcept {}
+
+    static bool validate(MemoryView, uint32) noexcept { return true; }
+
+    static ViewType read(MemoryView message, uint32 slot) noexcept { return loadLE<M>(message, slot); }
+};
+
+
+/// Content stored after the slots: strings and arrays.
+template<typename M, typename E>
+struct SequenceCodec {
+    static constexpr uint32 kSlotSize = 2 * sizeof(uint32);
+
+    static void writeSlot(ByteWriter::Cursor& dest, M const& value, uint64 payloadOffset) noexcept {
+        dest.putLE(static_cast<uint32>(payloadOffset))
+            .putLE(static_cast<uint32>(value.size()));
+    }
+
+    /// Check that the content is within the message and its length is valid.
+    static bool validate(MemoryView message, uint32 slot, uint64 maxCount) noexcept {
+        uint64 const offset = loadLE<uint32>(message, slot);
+        uint64 const count = loadLE<uint32>(message, slot + sizeof(uint32));
+
+        return (count <= maxCount) && (offset + count * sizeof(E) <= message.size());
+    }
+};
+
+
+template<typename M>
+struct StringCodec : public SequenceCodec<M, char> {
+    using ViewType = StringView;
+
+    static StringView viewOf(StringView value) noexcept { return value; }
+    static StringView viewOf(String const& value) noexcept { return value.view(); }
+
+    static uint64 payloadSize(M const& value) noexcept { return viewOf(value).size(); }
+
+    static void writePayload(ByteWriter::Cursor& dest, M const& value) noexcept { dest.put(viewOf(value).view()); }
+
+    static bool validate(MemoryView message, uint32 slot) noexcept {
+        return SequenceCodec<M, char>::validate(message, slot, std::numeric_limits<StringView::size_type>::max());
+    }
+
+    static ViewType read(MemoryView message, uint32 slot) {
+        auto const offset = loadLE<uint32>(message, slot);
+        auto const size = loadLE<uint32>(message, slot + sizeof(uint32));
+
+        return StringView{reinterpret_cast<char const*>(message.dataAddress(offset)),
+                          static_cast<StringView::size_type>(size)};
+    }
+};
+
+template<>
+struct FieldCodec<StringView> : public StringCodec<StringView> {};
+
+template<>
+struct FieldCodec<String> : public StringCodec<String> {};
+
+
+template<typename M, typename E>
+struct ArrayCodec : public SequenceCodec<M, E> {
+    using ViewType = PackedArrayView<E>;
+
+    static uint64 payloadSize(M const& value) noexcept { return static_cast<uint64>(value.size()) * sizeof(E); }
+
+    static void writePayload(ByteWriter::Cursor& dest, M const& value) noexcept {
+        for (auto const& item : value) {
+            dest.putLE(item);
+        }
+    }
+
+    static bool validate(MemoryView message, uint32 slot) noexcept {
+        return SequenceCodec<M, E>::validate(message, slot, std::numeric_limits<uint32>::max());
+    }
+
+    static ViewType read(MemoryView message, uint32 slot) noexcept {
+        auto const offset = loadLE<uint32>(message, slot);
+        auto const count = loadLE<uint32>(message, slot + sizeof(uint32));
+
+        return ViewType{message.dataAddress(offset), count};
+    }
+};
+
+template<typename E>
+struct FieldCodec<ArrayView<E>, std::enable_if_t<std::is_arithmetic<E>::value>>
+        : public ArrayCodec<ArrayView<E>, std::remove_const_t<E>> {};
+
+template<typename E>
+struct FieldCodec<Array<E>, std::enable_if_t<std::is_arithmetic<E>::value>>
+        : public ArrayCodec<Array<E>, E> {};
+
+
+template<typename M>
+struct FieldCodec<Optional<M>> {
+    using Inner = FieldCodec<M>;
+    using ViewType = Optional<typename Inner::ViewType>;
+
+    static constexpr uint32 kSlotSize = 1 + Inner::kSlotSize;
+
+    static uint64 payloadSize(Optional<M> const& value) noexcept {
+        return value.isSome() ? Inner::payloadSize(value.get()) : 0;
+    }
+
+    static void writeSlot(ByteWriter::Cursor& dest, Optional<M> const& value, uint64 payloadOffset) noexcept {
+        if (value.isSome()) {
+            dest.put(byte{1});
+            Inner::writeSlot(dest, value.get(), payloadOffset);
+        } else {
+            for (uint32 i = 0; i < kSlotSize; ++i) {
+                dest.put(byte{0});
+            }
+        }
+    }
+
+    static void writePayload(ByteWriter::Cursor& dest, Optional<M> const& value) noexcept {
+        if (value.isSome()) {
+            Inner::writePayload(dest, value.get());
+        }
+    }
+
+    static bool validate(MemoryView message, uint32 slot) noexcept {
+        auto const present = message.dataAddress()[slot];
+
+        return (present == 0) || (present == 1 && Inner::validate(message, slot + 1));
+    }
+
+    static ViewType read(MemoryView message, uint32 slot) {
+        return (message.dataAddress()[slot] != 0)
+                ? ViewType{Inner::read(message, slot + 1)}
+                : ViewType{none};
+    }
+};
+
+
+template<typename T>
+using SchemaFields = std::remove_const_t<decltype(Schema<T>::fields)>;
+
+template<typename T>
+constexpr size_t fieldsCount() noexcept { return std::tuple_size<SchemaFields<T>>::value; }
+
+template<typename T, size_t I>
+using FieldCodecOf = FieldCodec<std::remove_cv_t<
+                        typename MemberPointerTraits<std::tuple_element_t<I, SchemaFields<T>>>::Member>>;
+
+/// Offset of the slot of the I-th field, the size of all the slots for I equal to the number of fields.
+template<typename T, size_t I>
+constexpr uint32 slotOffset() noexcept {
+    if constexpr (I == 0) {
+        return 0;
+    } else {
+        return slotOffset<T, I - 1>() + FieldCodecOf<T, I - 1>::kSlotSize;
+    }
+}
+
+/// Index of the field of the member, the number of fields if the member is not a field.
+template<typename T, auto Member, size_t I = 0>
+constexpr size_t fieldIndex() noexcept {
+    if constexpr (I == fieldsCount<T>()) {
+        return I;
+    } else {
+        if constexpr (std::is_same<std::tuple_element_t<I, SchemaFields<T>>, decltype(Member)>::value) {
+            if (std::get<I>(Schema<T>::fields) == Member) {
+                return I;
+            }
+        }
+
+        return fieldIndex<T, Member, I + 1>();
+    }
+}
+
+template<typename T, size_t I>
+uint64 payloadSize(T const& value) noexcept {
+    return FieldCodecOf<T, I>::payloadSize(value.*std::get<I>(Schema<T>::fields));
+}
+
+template<typename T, size_t... I>
+uint64 encodedSize(T const& value, std::index_sequence<I...>) noexcept {
+    return slotOffset<T, sizeof...(I)>() + (uint64{0} + ... + payloadSize<T, I>(value));
+}
+
+template<typename T, size_t I>
+void writeSlot(ByteWriter::Cursor& dest, T const& value, uint64& payloadOffset) noexcept {
+    auto const& member = value.*std::get<I>(Schema<T>::fields);
+    FieldCodecOf<T, I>::writeSlot(dest, member, payloadOffset);
+    payloadOffset += FieldCodecOf<T, I>::payloadSize(member);
+}
+
+template<typename T, size_t... I>
+void encode(ByteWriter::Cursor& dest, T const& value, std::index_sequence<I...>) noexcept {
+    uint64 payloadOffset = slotOffset<T, sizeof...(I)>();
+    (writeSlot<T, I>(dest, value, payloadOffset), ...);
+    (FieldCodecOf<T, I>::writePayload(dest, value.*std::get<I>(Schema<T>::fields)), ...);
+}
+
+template<typename T, size_t... I>
+bool validate(MemoryView message, std::index_sequence<I...>) noexcept {
+    return (true && ... && FieldCodecOf<T, I>::validate(message, slotOffset<T, I>()));
+}
+
+}  // namespace details
+
+
+/**
+ * Get the size of the serialized value.
+ * @return Number of bytes encode() writes for the value.
+ */
+template<typename T>
+uint64 encodedSize(T const& value) noexcept {
+    return details::encodedSize(value, std::make_index_sequence<details::fieldsCount<T>()>{});
+}
+
+
+/**
+ * Serialize a value of a struct described by Schema<T>.
+ * Space is checked once for the whole message, then fields are written with no checks of their own.
+ * @return Nothing if successfull or an error if the writer does not have enough space left
+ * or the message is larger than 4GiB.
+ */
+template<typename T>
+Result<void, Error> encode(ByteWriter& dest, T const& value) {
+    auto const size = encodedSize(value);
+    if (size > std::numeric_limits<uint32>::max()) {
+        return Err(makeError(SystemErrors::Overflow, "encode()"));
+    }
+
+    auto maybeCursor = dest.reserve(size);
+    if (!maybeCursor) {
+        return Err(maybeCursor.moveError());
+    }
+
+    auto cursor = maybeCursor.moveResult();
+    details::encode(cursor, value, std::make_index_sequence<details::fieldsCount<T>()>{});
+
+    return Ok();
+}
+
+
+template<typename T>
+class SchemaView;
+
+template<typename T>
+Result<SchemaView<T>, Error> makeSchemaView(MemoryView message);
+
+
+/**
+ * View of a message serialized by encode() that reads fields in place.
+ * Nothing is decoded or allocated: accessing a field reads its slot, strings and arrays refer to the message,
+ * so the view must not outlive the message memory.
+ *
+ * Example:
+ * @code{.cpp}
+ *  auto entry = makeSchemaView<Entry>(message).unwrap();
+ *  auto const id = entry.get<&Entry::id>();
+ *  StringView const name = entry.get<&Entry::name>();
+ * @endcode
+ */
+template<typename T>
+class SchemaView {
+public:
+
+    /// Size of the slots of all the fields: the smallest valid message.
+    static constexpr uint32 kFixedSize = details::slotOffset<T, details::fieldsCount<T>()>();
+
+public:
+
+    /**
+     * Get the value of a field.
+     * @return The number, StringView, PackedArrayView or Optional of those, depending on the type of the member.
+     */
+    template<auto Member>
+    auto get() const {
+        constexpr auto index = details::fieldIndex<T, Member>();
+        static_assert(index < details::fieldsCount<T>(), "The member is not a field of Schema<T>");
+
+        return details::FieldCodecOf<T, index>::read(_message, details::slotOffset<T, index>());
+    }
+
+    /// Get the memory of the message.
+    MemoryView message() const noexcept { return _message; }
+
+private:
+
+    friend Result<SchemaView<T>, Error> makeSchemaView<T>(MemoryView message);
+
+    explicit SchemaView(MemoryView message) noexcept
+        : _message{message}
+    {}
+
+    MemoryView  _message;
+};
+
+
+/**
+ * Create a view of a serialized message.
+ * All slots are checked to be within the message and the content of all strings and arrays to be within it too,
+ * so that reading any of the fields is safe afterwards.
+ * @return A view of the message or an error if the message is too short or malformed.
+ */
+template<typename T>
+Result<SchemaView<T>, Error> makeSchemaView(MemoryView message) {
+    if (message.size() < SchemaView<T>::kFixedSize) {
+        return Err(makeError(SystemErrors::Overflow, "makeSchemaView()"));
+    }
+
+    if (!details::validate<T>(message, std::make_index_sequence<details::fieldsCount<T>()>{})) {
+        return Err(makeError(SystemErrors::ILSEQ, "makeSchemaView()"));
+    }
+
+    return Ok(SchemaView<T>{message});
+}
+
+}  // End of namespace Solace
+#endif  // SOLACE_SCHEMA_HPP
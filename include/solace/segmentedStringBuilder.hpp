@@ -0,0 +1,267 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace: Growable string builder
+ *	@file		solace/segmentedStringBuilder.hpp
+ *	@brief		String builder that grows by chaining memory segments.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_SEGMENTEDSTRINGBUILDER_HPP
+#define SOLACE_SEGMENTEDSTRINGBUILDER_HPP
+
+#include "solace/format.hpp"
+#include "solace/memoryManager.hpp"
+#include "solace/posixErrorDomain.hpp"
+#include "solace/string.hpp"
+#include "solace/vector.hpp"
+
+#include <algorithm>  // std::max
+#include <sys/uio.h>  // iovec
+
+
+namespace Solace {
+
+/**
+ * String builder that grows as needed by allocating additional memory segments from a memory manager.
+ * Unlike StringBuilder, which is limited by the capacity of its buffer, this builder chains new segments
+ * once the current one is full. Data already written is never moved when the builder grows.
+ * The content can be flattened into a String or exposed as a list of iovec for zero-copy output.
+ */
+class SegmentedStringBuilder {
+public:
+    using size_type = MemoryView::size_type;
+
+    /// Default size of the first segment allocated.
+    static constexpr size_type kDefaultSegmentSize = 256;
+
+    /// Segments are doubled in size as the builder grows up to this limit.
+    static constexpr size_type kMaxSegmentSize = 64*1024;
+
+public:
+
+    ~SegmentedStringBuilder() = default;
+
+    /**
+     * Construct a new empty builder that allocates memory from the given manager.
+     * @param memoryManager Memory manager to allocate segments from.
+     * @param segmentSize Size of the first segment to allocate.
+     */
+    explicit SegmentedStringBuilder(MemoryManager& memoryManager, size_type segmentSize = kDefaultSegmentSize) noexcept
+        : _memoryManager{&memoryManager}
+        , _segmentSize{(segmentSize == 0) ? kDefaultSegmentSize : segmentSize}
+    {}
+
+    SegmentedStringBuilder(SegmentedStringBuilder const&) = delete;
+    SegmentedStringBuilder& operator= (SegmentedStringBuilder const&) = delete;
+
+    SegmentedStringBuilder(SegmentedStringBuilder&& rhs) noexcept
+        : _memoryManager{rhs._memoryManager}
+        , _segmentSize{rhs._segmentSize}
+        , _segments{std::move(rhs._segments)}
+        , _length{std::exchange(rhs._length, 0)}
+    {}
+
+    SegmentedStringBuilder& operator= (SegmentedStringBuilder&& rhs) noexcept {
+        return swap(rhs);
+    }
+
+    SegmentedStringBuilder& swap(SegmentedStringBuilder& rhs) noexcept {
+        using std::swap;
+
+        swap(_memoryManager, rhs._memoryManager);
+        swap(_segmentSize, rhs._segmentSize);
+        swap(_segments, rhs._segments);
+        swap(_length, rhs._length);
+
+        return *this;
+    }
+
+public:
+
+    SegmentedStringBuilder& append(char c);
+    SegmentedStringBuilder& append(StringView str);
+
+    SegmentedStringBuilder& append(String const& str) {
+        return append(str.view());
+    }
+
+    SegmentedStringBuilder& appendFormat(StringView fmt) { return append(fmt); }
+
+    /**
+     * Append arguments formatted according to the format string parsed at runtime.
+     * A new segment is allocated if the formatted value does not fit into the current one.
+     * @note Raises IllegalArgumentException if the format string is invalid or doesn't match the arguments.
+     */
+    template<typename T, typename... Args>
+    SegmentedStringBuilder& appendFormat(StringView fmt, T const& value, Args const&... args) {
+        return appendFormatted([&](ByteWriter& dest) { return formatTo(dest, fmt, value, args...); });
+    }
+
+    /**
+     * Append arguments formatted according to the format string parsed and type checked at compile time.
+     */
+    template<typename Fmt, typename... Args>
+    std::enable_if_t<std::is_base_of<FormatStringTag, Fmt>::value, SegmentedStringBuilder&>
+    appendFormat(Fmt fmt, Args const&... args) {
+        return appendFormatted([&](ByteWriter& dest) { return formatTo(dest, fmt, args...); });
+    }
+
+    /** Remove all content. The first segment is kept for reuse, the rest are released. */
+    SegmentedStringBuilder& clear() noexcept;
+
+    /** Get total number of characters in this builder */
+    constexpr size_type length() const noexcept { return _length; }
+
+    constexpr bool empty() const noexcept { return (_length == 0); }
+
+    /** Get total number of bytes allocated for segments */
+    size_type capacity() const noexcept;
+
+    /** Get number of memory segments allocated */
+    uint32 segmentsCount() const noexcept { return _segments.size(); }
+
+    /** Get a view of the content stored in the given segment */
+    MemoryView segment(uint32 index) const { return _segments[index].view(); }
+
+    /**
+     * Get a character at the given position.
+     * @note Raises IndexOutOfRangeException if index is outside of [0, length()).
+     */
+    char charAt(size_type index) const;
+
+    char operator[] (size_type index) const { return charAt(index); }
+
+    Optional<size_type> indexOf(char ch, size_type fromIndex = 0) const noexcept;
+    Optional<size_type> indexOf(StringView str, size_type fromIndex = 0) const noexcept;
+
+    /**
+     * Replace all occurrences of a character with another one.
+     * @return Number of replacements made.
+     */
+    size_type replace(char what, char with) noexcept;
+
+    /**
+     * Replace all non-overlapping occurrences of a string with another one.
+     * Replacements of the same length are done in place, otherwise content is rebuilt into new segments.
+     * @return Number of replacements made.
+     */
+    size_type replace(StringView what, StringView with);
+
+    /**
+     * Copy a range of characters [from, to) into a new string.
+     * @return A new string or an error if the range is too long for a String.
+     */
+    Result<String, Error> substring(size_type from, size_type to) const;
+
+    /**
+     * Flatten content of all segments into a single string.
+     * @return A new string or an error if the content is too long for a String.
+     */
+    Result<String, Error> toString() const {
+        return substring(0, _length);
+    }
+
+    /**
+     * Copy the content of this builder into the given writer.
+     * @return Nothing or an error if the destination does not have enough space.
+     */
+    Result<void, Error> copyTo(ByteWriter& dest) const;
+
+    /**
+     * Fill a list of iovec describing content of this builder for zero-copy output with writev(2).
+     * @param dest Destination to fill. At most dest.size() entries are filled.
+     * @return Number of entries filled.
+     */
+    ArrayView<iovec>::size_type toIOVec(ArrayView<iovec> dest) const noexcept;
+
+protected:
+
+    /// Memory segment and the number of bytes used in it.
+    struct Segment {
+        MemoryResource  memory;
+        size_type       size;
+
+        Segment(MemoryResource&& mem, size_type used) noexcept
+            : memory{std::move(mem)}
+            , size{used}
+        {}
+
+        MemoryView view() const noexcept { return memory.view().slice(0, size); }
+        MutableMemoryView remaining() noexcept { return memory.view().slice(size, memory.size()); }
+    };
+
+    /**
+     * Get a buffer to write into at the end of the builder.
+     * A new segment is allocated if the last segment has less than minSize bytes free or is full.
+     */
+    MutableMemoryView reserve(size_type minSize);
+
+    /// Account for bytes written into the buffer returned by reserve().
+    void commit(size_type bytesWritten) noexcept;
+
+    /// Append raw bytes, chaining new segments as needed.
+    void appendBytes(MemoryView bytes);
+
+    /**
+     * Call the visitor for each part of the range [from, to) stored in a separate segment.
+     * The visitor is called as f(segment, offsetInSegment, chunkSize, offsetInRange).
+     */
+    template<typename SegmentsView, typename F>
+    static void forEachChunk(SegmentsView segments, size_type from, size_type to, F&& f);
+
+    template<typename F>
+    SegmentedStringBuilder& appendFormatted(F&& format) {
+        size_type minSize = 0;
+        for (int attempt = 0; attempt < kMaxFormatAttempts; ++attempt) {
+            ByteWriter writer{reserve(minSize)};
+            auto result = format(writer);
+            if (result) {
+                commit(writer.position());
+                return *this;
+            }
+
+            if (!(result.getError() == makeError(SystemErrors::Overflow, "formatTo()"))) {
+                raiseFormatError(result.getError(), minSize);
+            }
+
+            minSize = std::max<size_type>(2 * writer.limit(), _segmentSize);
+        }
+
+        raiseFormatError(makeError(SystemErrors::Overflow, "formatTo()"), minSize);
+
+        return *this;
+    }
+
+private:
+
+    static constexpr int kMaxFormatAttempts = 8;
+
+    /// Raise an exception matching the error of formatting into a segment of the given size.
+    static void raiseFormatError(Error const& error, size_type segmentSize);
+
+    MemoryManager*      _memoryManager;
+    size_type           _segmentSize;
+    Vector<Segment>     _segments;
+    size_type           _length{0};
+};
+
+
+inline void swap(SegmentedStringBuilder& lhs, SegmentedStringBuilder& rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+}  // End of namespace Solace
+#endif  // SOLACE_SEGMENTEDSTRINGBUILDER_HPP
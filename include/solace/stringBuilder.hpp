@@ -27,6 +27,7 @@
 
 
 #include "solace/byteWriter.hpp"
+#include "solace/format.hpp"
 #include "solace/string.hpp"
 
 
@@ -93,45 +94,42 @@ public:
 
     StringBuilder& appendFormat(StringView fmt) { return append(fmt); }
 
-//        template<typename T>
-//        StringBuilder& appendFormat(const String& fmt, T&& value) {
-//            return append(Format(fmt).formatArg(std::forward<T>(value)));
-//        }
-
-//        template<typename T>
-//        StringBuilder& appendFormat(char* fmt, T&& value) {
-//            return append(Format(fmt).formatArg(std::forward<T>(value)));
-//        }
-
-//        template<typename T>
-//        StringBuilder& appendFormat(char16_t* fmt, T&& value) {
-//            return append(Format(fmt).formatArg(std::forward<T>(value)));
-//        }
-
-//        template<typename T>
-//        StringBuilder& appendFormat(char32_t* fmt, T&& value) {
-//            return append(Format(fmt).formatArg(std::forward<T>(value)));
-//        }
-
-//        template<typename T, typename... Args>
-//        StringBuilder& appendFormat(const String& fmt, T&& value, Args... args) {
-//            return append(Format(fmt).formatArg(std::forward<T>(value), args...));
-//        }
-
-//        template<typename T, typename... Args>
-//        StringBuilder& appendFormat(const char* fmt, T&& value, Args... args) {
-//            return append(Format(fmt).formatArg(std::forward<T>(value), args...));
-//        }
-
-//        template<typename T, typename... Args>
-//        StringBuilder& appendFormat(const char16_t* fmt, T&& value, Args... args) {
-//            return append(Format(fmt).formatArg(std::forward<T>(value), args...));
-//        }
-
-//        template<typename T, typename... Args>
-//        StringBuilder& appendFormat(const char32_t* fmt, T&& value, Args... args) {
-//            return append(Format(fmt).formatArg(std::forward<T>(value), args...));
-//        }
+    /**
+     * Append arguments formatted according to the format string.
+     * The format string is parsed at runtime. @see formatTo for the syntax of replacement fields.
+     * @note Raises OverflowException if the formatted text doesn't fit, or IllegalArgumentException
+     * if the format string is invalid or doesn't match the arguments. Nothing is appended in either case.
+     */
+    template<typename T, typename... Args>
+    StringBuilder& appendFormat(StringView fmt, T const& value, Args const&... args) {
+        auto const mark = _buffer.position();
+        auto result = formatTo(_buffer, fmt, value, args...);
+        if (!result) {
+            raiseFormatError(mark, result.getError());
+        }
+
+        return *this;
+    }
+
+    /**
+     * Append arguments formatted according to the format string parsed and type checked at compile time.
+     * Example:
+     * @code
+     *      builder.appendFormat(SOLACE_FMT("{}: {:.2f}"), name, value);
+     * @endcode
+     * @note Raises OverflowException if the formatted text doesn't fit.
+     */
+    template<typename Fmt, typename... Args>
+    std::enable_if_t<std::is_base_of<FormatStringTag, Fmt>::value, StringBuilder&>
+    appendFormat(Fmt fmt, Args const&... args) {
+        auto const mark = _buffer.position();
+        auto result = formatTo(_buffer, fmt, args...);
+        if (!result) {
+            raiseFormatError(mark, result.getError());
+        }
+
+        return *this;
+    }
 
 	StringView substring(size_type from, size_type to) const;
 	StringBuilder& clear();
@@ -159,6 +157,9 @@ public:
 
 private:
 
+    /// Drop partially formatted output and raise an exception matching the error.
+    void raiseFormatError(ByteWriter::size_type mark, Error const& error);
+
     ByteWriter  _buffer;
 };
 
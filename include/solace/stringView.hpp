@@ -120,6 +120,19 @@ public:
         return compareTo(StringView{x});
     }
 
+    /**
+     * Tests if two strings are equal ignoring case of ASCII letters.
+     * @see toLowerAscii
+     */
+    bool equalsIgnoreCase(StringView x) const noexcept;
+
+    /**
+     * Lexicographically compare two strings ignoring case of ASCII letters.
+     * @return Negative value if this string is less than the given one, 0 if they are equal and
+     * positive value if this string is greater.
+     */
+    int compareToIgnoreCase(StringView x) const noexcept;
+
     /**
      * Tests if the string starts with the specified prefix.
      *
@@ -159,6 +172,16 @@ public:
      */
     bool endsWith(StringView suffix) const noexcept;
 
+    /**
+     * Tests if the string starts with the specified prefix ignoring case of ASCII letters.
+     */
+    bool startsWithIgnoreCase(StringView prefix) const noexcept;
+
+    /**
+     * Tests if the string ends with the specified suffix ignoring case of ASCII letters.
+     */
+    bool endsWithIgnoreCase(StringView suffix) const noexcept;
+
     /** Index of the first occurrence of the given sub sequance.
      *
      * Returns the index within this string of the first occurrence of the
@@ -180,6 +203,12 @@ public:
      */
     Optional<size_type> indexOf(value_type ch, size_type fromIndex = 0) const noexcept;
 
+    /** Index of the first occurrence of the given sub sequence ignoring case of ASCII letters.
+     *
+     * @return Optional index of the first occurrence of the given substring.
+     */
+    Optional<size_type> indexOfIgnoreCase(StringView str, size_type fromIndex = 0) const noexcept;
+
     /** Index of the last occurrence of the given sub sequance.
      *
      * Returns the last index within this string of the of the give substring.
@@ -383,6 +412,13 @@ public:
      */
     uint64 hashCode() const noexcept;
 
+    /** Returns a hash code for this string that ignores case of ASCII letters.
+     * Strings that are equalsIgnoreCase() have the same hash code.
+     *
+     * @return A hash code value for the string.
+     */
+    uint64 hashCodeIgnoreCase() const noexcept;
+
     const_iterator begin() const noexcept {
         return empty()
                 ? nullptr
@@ -0,0 +1,127 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace: UTF-8 utilities
+ *	@file		solace/utf8.hpp
+ *	@brief		Validation, code-point counting and transcoding of UTF-8 text.
+ ******************************************************************************/
+#pragma once
+#ifndef SOLACE_UTF8_HPP
+#define SOLACE_UTF8_HPP
+
+#include "solace/memoryView.hpp"
+#include "solace/stringView.hpp"
+#include "solace/arrayView.hpp"
+#include "solace/byteWriter.hpp"
+#include "solace/result.hpp"
+#include "solace/error.hpp"
+
+
+namespace Solace {
+
+/**
+ * Error of validating or transcoding Unicode text.
+ * Carries the offset of the first code unit of the offending sequence in the source.
+ */
+struct EncodingError {
+    enum class Kind {
+        InvalidSequence,        //!< Source contains ill-formed sequence of code units.
+        DestinationTooSmall     //!< Destination does not have enough space for the result.
+    };
+
+    Kind                    kind;
+    MemoryView::size_type   offset;
+
+    /// Convert to a generic error to be propagated through Result<T, Error>.
+    Error toError() const noexcept;
+
+    operator Error() const noexcept { return toError(); }
+};
+
+
+/**
+ * Check that the given bytes are well-formed UTF-8.
+ * Overlong encodings, surrogates and code points above U+10FFFF are rejected.
+ * @return Nothing or an error with the offset of the first invalid sequence.
+ */
+Result<void, EncodingError> validateUtf8(MemoryView data) noexcept;
+
+inline Result<void, EncodingError> validateUtf8(StringView str) noexcept {
+    return validateUtf8(str.view());
+}
+
+/**
+ * Count number of code points in the given UTF-8 text.
+ * @return Number of code points or an error if the text is not well-formed UTF-8.
+ */
+Result<MemoryView::size_type, EncodingError> countCodePoints(MemoryView data) noexcept;
+
+inline Result<MemoryView::size_type, EncodingError> countCodePoints(StringView str) noexcept {
+    return countCodePoints(str.view());
+}
+
+
+/**
+ * Compute number of UTF-16 code units required to represent the given well-formed UTF-8 text.
+ * @note The input is not validated.
+ */
+MemoryView::size_type utf16Length(MemoryView utf8) noexcept;
+
+/**
+ * Compute number of bytes required to represent the given UTF-16 text in UTF-8.
+ * @note The input is not validated.
+ */
+MemoryView::size_type utf8Length(ArrayView<const char16_t> utf16) noexcept;
+
+/**
+ * Compute number of bytes required to represent the given UTF-32 text in UTF-8.
+ * @note The input is not validated.
+ */
+MemoryView::size_type utf8Length(ArrayView<const char32_t> utf32) noexcept;
+
+
+/**
+ * Convert UTF-8 text into UTF-16.
+ * @param src Source UTF-8 text.
+ * @param dest Destination buffer.
+ * @return Number of code units written into the destination or an error.
+ */
+Result<ArrayView<char16_t>::size_type, EncodingError>
+utf8ToUtf16(MemoryView src, ArrayView<char16_t> dest) noexcept;
+
+/**
+ * Convert UTF-8 text into UTF-32.
+ * @return Number of code units written into the destination or an error.
+ */
+Result<ArrayView<char32_t>::size_type, EncodingError>
+utf8ToUtf32(MemoryView src, ArrayView<char32_t> dest) noexcept;
+
+/**
+ * Convert UTF-16 text into UTF-8 written into the given writer.
+ * @return Nothing or an error. Error offset is given in code units of the source.
+ */
+Result<void, EncodingError>
+utf16ToUtf8(ArrayView<const char16_t> src, ByteWriter& dest) noexcept;
+
+/**
+ * Convert UTF-32 text into UTF-8 written into the given writer.
+ * @return Nothing or an error. Error offset is given in code units of the source.
+ */
+Result<void, EncodingError>
+utf32ToUtf8(ArrayView<const char32_t> src, ByteWriter& dest) noexcept;
+
+}  // End of namespace Solace
+#endif  // SOLACE_UTF8_HPP
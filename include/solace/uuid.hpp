@@ -27,7 +27,9 @@
 #include "solace/types.hpp"
 #include "solace/traits/icomparable.hpp"
 
+#include "solace/arrayView.hpp"
 #include "solace/memoryView.hpp"
+#include "solace/random.hpp"
 #include "solace/string.hpp"
 #include "solace/result.hpp"
 #include "solace/error.hpp"
@@ -62,6 +64,7 @@ public:
 
     /**
      * Parse a UUID object from a string.
+     * The string must be in the canonical 8-4-4-4-12 form, hex digits may be of either case.
      *
      * @param str A string representation of the UUID to parse
      * @return Parsed UUID object or an error.
@@ -111,6 +114,14 @@ public:
         return false;
     }
 
+    /**
+     * Get the version of the UUID layout, e.g. 4 for random and 7 for time-ordered UUIDs.
+     * @return Value of the version field.
+     */
+    uint32 version() const noexcept {
+        return _bytes[6] >> 4;
+    }
+
     /** Get the size in bytes of this UUID.
      * UUID has a fixed size of 16 bytes (128bit) as per RFC.
      *
@@ -157,6 +168,12 @@ public:
      * @return String representation of this path
      */
     String toString() const;
+
+    /**
+     * Write string representation of the UUID into the buffer.
+     * @param buffer Buffer of at least StringSize bytes.
+     * @return View of the string in the buffer.
+     */
     StringView toString(MutableMemoryView buffer) const;
 
     friend bool operator < (UUID const& lhs, UUID const& rhs) noexcept;
@@ -205,10 +222,93 @@ inline void swap(UUID& lhs, UUID& rhs) noexcept {
 [[nodiscard]] UUID makeUUID(uint32 a0, uint32 a1, uint32 a2, uint32 a3);
 
 
+/**
+ * Format UUIDs as contiguous text: UUID::StringSize characters for each UUID, without separators.
+ * @param ids UUIDs to format.
+ * @param dest Buffer to write the text into.
+ * @return Number of bytes written or an error if the buffer is too small.
+ */
+[[nodiscard]] Result<MemoryView::size_type, Error> formatUUIDs(ArrayView<UUID const> ids, MutableMemoryView dest);
+
+/**
+ * Parse UUIDs from contiguous text, as written by formatUUIDs.
+ * @param text Text of exactly UUID::StringSize characters for each UUID.
+ * @param dest UUIDs to parse into. UUIDs before an invalid one are parsed when an error is returned.
+ * @return Nothing or an error if the text is of the wrong size or is not valid.
+ */
+[[nodiscard]] Result<void, Error> parseUUIDs(MemoryView text, ArrayView<UUID> dest);
+
+
+/**
+ * Generator of random (version 4) and time-ordered (version 7) UUIDs as per RFC 9562.
+ *
+ * Time-ordered UUIDs start with a millisecond Unix timestamp followed by a 42 bit counter,
+ * so that UUIDs made by a generator are strictly increasing even within a millisecond
+ * and when the clock goes backwards. Counter starts from a random value each millisecond
+ * and remaining 32 bits are random.
+ * A generator is not thread safe, @see makeRandomUUID and makeTimeOrderedUUID for thread-local generation.
+ */
+class UUIDGenerator {
+public:
+
+    /**
+     * Construct a generator that draws random bits from the given source.
+     * @param random Source of random bits that must outlive the generator.
+     */
+    explicit UUIDGenerator(SecureRandom& random) noexcept
+        : _random{&random}
+    {}
+
+    /// Generate a random, version 4, UUID.
+    UUID random() noexcept;
+
+    /// Fill the array with random, version 4, UUIDs.
+    void random(ArrayView<UUID> dest) noexcept;
+
+    /// Generate a time-ordered, version 7, UUID stamped with the current system time.
+    UUID timeOrdered() noexcept;
+
+    /**
+     * Generate a time-ordered, version 7, UUID with the given timestamp.
+     * @param unixMillis Number of milliseconds since Unix epoch.
+     * Timestamp older than that of the previous UUID is replaced by the latter to keep UUIDs increasing.
+     */
+    UUID timeOrdered(uint64 unixMillis) noexcept;
+
+    /// Fill the array with increasing time-ordered, version 7, UUIDs stamped with the current system time.
+    void timeOrdered(ArrayView<UUID> dest) noexcept;
+
+private:
+
+    /// Store next time-ordered UUID into bytes.
+    void nextTimeOrdered(uint64 unixMillis, byte* bytes) noexcept;
+
+    SecureRandom*   _random;
+
+    uint64          _lastMillis{0};
+    uint64          _counter{0};
+};
+
+
 /** Create random UUID
- * This method uses system's random number generator to generate a new random UUID.
+ * This method uses a thread-local cryptographically secure generator to generate a new random (version 4) UUID.
+ * @note Raises an exception if the system fails to seed the generator of the thread, @see threadLocalRandom.
  */
-[[nodiscard]] UUID makeRandomUUID() noexcept;
+[[nodiscard]] UUID makeRandomUUID();
+
+/**
+ * Create time-ordered UUID.
+ * UUIDs created by a thread are strictly increasing, @see UUIDGenerator.
+ * @return A new time-ordered (version 7) UUID.
+ * @note Raises an exception if the system fails to seed the generator of the thread.
+ */
+[[nodiscard]] UUID makeTimeOrderedUUID();
+
+/// Fill the array with random (version 4) UUIDs. @see makeRandomUUID
+void makeRandomUUIDs(ArrayView<UUID> dest);
+
+/// Fill the array with increasing time-ordered (version 7) UUIDs. @see makeTimeOrderedUUID
+void makeTimeOrderedUUIDs(ArrayView<UUID> dest);
 
 }  // namespace Solace
 #endif  // SOLACE_UUID_HPP
@@ -0,0 +1,162 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		asciiCase.cpp
+ *	@brief		Implementation of ASCII case conversion.
+ *
+ * On x86-64 blocks of 16 characters are processed with SSE2, which is part of the baseline ISA
+ * so no runtime dispatch is required. A letter is detected with a single signed comparison:
+ * adding (0x80 - 'A') maps 'A'..'Z' onto the 26 smallest signed byte values.
+ ******************************************************************************/
+#include "solace/asciiCase.hpp"
+#include "solace/posixErrorDomain.hpp"
+
+#if defined(__x86_64__)
+#define SOLACE_ASCII_SSE2 1
+#include <emmintrin.h>
+#endif
+
+
+using namespace Solace;
+
+
+namespace /* anonymous */ {
+
+constexpr char kCaseBit = 'a' - 'A';
+
+
+#ifdef SOLACE_ASCII_SSE2
+
+constexpr size_t kBlockSize = sizeof(__m128i);
+
+/// Select bytes of the block that are letters in the range [first, first + 26).
+inline __m128i letterMask(__m128i v, char first) noexcept {
+    auto const shifted = _mm_add_epi8(v, _mm_set1_epi8(static_cast<char>(0x80 - first)));
+
+    return _mm_cmplt_epi8(shifted, _mm_set1_epi8(static_cast<char>(-128 + 26)));
+}
+
+inline __m128i foldLower(__m128i v) noexcept {
+    return _mm_xor_si128(v, _mm_and_si128(letterMask(v, 'A'), _mm_set1_epi8(kCaseBit)));
+}
+
+inline __m128i foldUpper(__m128i v) noexcept {
+    return _mm_xor_si128(v, _mm_and_si128(letterMask(v, 'a'), _mm_set1_epi8(kCaseBit)));
+}
+
+inline __m128i load(char const* data) noexcept {
+    return _mm_loadu_si128(reinterpret_cast<__m128i const*>(data));
+}
+
+inline void store(char* data, __m128i v) noexcept {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(data), v);
+}
+
+#endif
+
+
+template<bool Lower>
+void convertCase(char const* src, char* dest, size_t count) noexcept {
+    size_t i = 0;
+
+#ifdef SOLACE_ASCII_SSE2
+    for (; i + kBlockSize <= count; i += kBlockSize) {
+        auto const v = load(src + i);
+        store(dest + i, Lower ? foldLower(v) : foldUpper(v));
+    }
+#endif
+
+    for (; i < count; ++i) {
+        dest[i] = Lower ? toLowerAscii(src[i]) : toUpperAscii(src[i]);
+    }
+}
+
+
+template<bool Lower>
+Result<StringView, Error> convertCase(StringView str, MutableMemoryView dest) noexcept {
+    if (dest.size() < str.size()) {
+        return Err(makeError(SystemErrors::Overflow, Lower ? "toLowerAscii()" : "toUpperAscii()"));
+    }
+
+    auto const first = reinterpret_cast<char*>(dest.dataAddress());
+    convertCase<Lower>(str.data(), first, str.size());
+
+    return Ok(StringView{first, str.size()});
+}
+
+}  // anonymous namespace
+
+
+Result<StringView, Error>
+Solace::toLowerAscii(StringView str, MutableMemoryView dest) noexcept {
+    return convertCase<true>(str, dest);
+}
+
+
+Result<StringView, Error>
+Solace::toUpperAscii(StringView str, MutableMemoryView dest) noexcept {
+    return convertCase<false>(str, dest);
+}
+
+
+size_t
+Solace::mismatchIgnoreCaseAscii(char const* a, char const* b, size_t count) noexcept {
+    size_t i = 0;
+
+#ifdef SOLACE_ASCII_SSE2
+    for (; i + kBlockSize <= count; i += kBlockSize) {
+        auto const equal = _mm_cmpeq_epi8(foldLower(load(a + i)), foldLower(load(b + i)));
+        auto const mask = static_cast<unsigned>(_mm_movemask_epi8(equal));
+        if (mask != 0xFFFF) {
+            return i + static_cast<size_t>(__builtin_ctz(~mask));
+        }
+    }
+#endif
+
+    for (; i < count; ++i) {
+        if (toLowerAscii(a[i]) != toLowerAscii(b[i])) {
+            return i;
+        }
+    }
+
+    return count;
+}
+
+
+size_t
+Solace::findIgnoreCaseAscii(char const* data, size_t count, char c) noexcept {
+    auto const folded = toLowerAscii(c);
+    size_t i = 0;
+
+#ifdef SOLACE_ASCII_SSE2
+    auto const needle = _mm_set1_epi8(folded);
+    for (; i + kBlockSize <= count; i += kBlockSize) {
+        auto const mask = _mm_movemask_epi8(_mm_cmpeq_epi8(foldLower(load(data + i)), needle));
+        if (mask != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(static_cast<unsigned>(mask)));
+        }
+    }
+#endif
+
+    for (; i < count; ++i) {
+        if (toLowerAscii(data[i]) == folded) {
+            return i;
+        }
+    }
+
+    return count;
+}
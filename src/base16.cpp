@@ -17,15 +17,25 @@
  * libSolace
  *	@file		base16.cpp
  *	@brief		Implementation of Base16 encoder and decoder.
+ *
+ * Bulk conversion writes straight into the destination memory. Vectorized encoding splits bytes into
+ * nibbles, interleaves them and maps each nibble to its digit with a single shuffle of the 16 digits.
+ * Vectorized decoding validates digits and letters of the accepted case by range and joins each pair
+ * of nibbles with one multiply-add. AVX2 or SSSE3 code is selected at run time,
+ * the scalar code handles what is left.
  ******************************************************************************/
 #include "solace/base16.hpp"
+#include "solace/cpuFeatures.hpp"
 #include "solace/posixErrorDomain.hpp"
 
+#if defined(__x86_64__)
+#define SOLACE_BASE16_X86 1
+#include <immintrin.h>
+#endif
+
 
 using namespace Solace;
 
-// Not used
-/*
 static const char kBase16Alphabet_u[256][3] = {
     "00", "01", "02", "03", "04", "05", "06", "07", "08", "09", "0A", "0B", "0C", "0D", "0E", "0F",
     "10", "11", "12", "13", "14", "15", "16", "17", "18", "19", "1A", "1B", "1C", "1D", "1E", "1F",
@@ -44,7 +54,6 @@ static const char kBase16Alphabet_u[256][3] = {
     "E0", "E1", "E2", "E3", "E4", "E5", "E6", "E7", "E8", "E9", "EA", "EB", "EC", "ED", "EE", "EF",
     "F0", "F1", "F2", "F3", "F4", "F5", "F6", "F7", "F8", "F9", "FA", "FB", "FC", "FD", "FE", "FF"
 };
-*/
 
 static const char kBase16Alphabet_l[256][3] = {
     "00", "01", "02", "03", "04", "05", "06", "07", "08", "09", "0a", "0b", "0c", "0d", "0e", "0f",
@@ -81,7 +90,7 @@ static const signed char kHexToBin[128] = {
 
 Result<byte, Error>
 charToBin(byte c) {
-    auto const value = kHexToBin[c];
+    auto const value = (c < 128) ? kHexToBin[c] : -1;
 
     if (value < 0) {
         return Err(makeError(SystemErrors::ILSEQ, "charToBin"));
@@ -91,6 +100,245 @@ charToBin(byte c) {
 }
 
 
+namespace /* anonymous */ {
+
+using size_type = MemoryView::size_type;
+
+/// Value of a hex digit in the accepted case, -1 if the character is not one.
+int hexValue(byte c, LetterCase letterCase) noexcept {
+    auto const value = (c < 128) ? kHexToBin[c] : -1;
+    if (value >= 10 && letterCase != LetterCase::Any && ((c >= 'a') != (letterCase == LetterCase::Lower))) {
+        return -1;
+    }
+
+    return value;
+}
+
+
+#ifdef SOLACE_BASE16_X86
+
+__attribute__((target("ssse3")))
+size_type encodeSsse3(byte const* in, size_type size, byte* out, char const* digits) noexcept {
+    auto const lut = _mm_loadu_si128(reinterpret_cast<__m128i const*>(digits));
+    auto const lowNibbleMask = _mm_set1_epi8(0x0F);
+
+    size_type i = 0;
+    for (; i + 16 <= size; i += 16, out += 32) {
+        auto const input = _mm_loadu_si128(reinterpret_cast<__m128i const*>(in + i));
+        auto const high = _mm_and_si128(_mm_srli_epi16(input, 4), lowNibbleMask);
+        auto const low = _mm_and_si128(input, lowNibbleMask);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_shuffle_epi8(lut, _mm_unpacklo_epi8(high, low)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), _mm_shuffle_epi8(lut, _mm_unpackhi_epi8(high, low)));
+    }
+
+    return i;
+}
+
+
+__attribute__((target("avx2")))
+size_type encodeAvx2(byte const* in, size_type size, byte* out, char const* digits) noexcept {
+    auto const lut = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<__m128i const*>(digits)));
+    auto const lowNibbleMask = _mm256_set1_epi8(0x0F);
+
+    size_type i = 0;
+    for (; i + 32 <= size; i += 32, out += 64) {
+        // Unpacking works within lanes: put bytes 0-7 and 16-23 in the low lane, 8-15 and 24-31 in the high one
+        auto const input = _mm256_permute4x64_epi64(
+                    _mm256_loadu_si256(reinterpret_cast<__m256i const*>(in + i)), 0xD8);
+        auto const high = _mm256_and_si256(_mm256_srli_epi16(input, 4), lowNibbleMask);
+        auto const low = _mm256_and_si256(input, lowNibbleMask);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out),
+                            _mm256_shuffle_epi8(lut, _mm256_unpacklo_epi8(high, low)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 32),
+                            _mm256_shuffle_epi8(lut, _mm256_unpackhi_epi8(high, low)));
+    }
+
+    return i;
+}
+
+
+/// Bit that folds letters to lower case when any case is accepted.
+inline char letterFold(LetterCase letterCase) noexcept {
+    return (letterCase == LetterCase::Any) ? 0x20 : 0;
+}
+
+/// First letter of the accepted case.
+inline char letterBase(LetterCase letterCase) noexcept {
+    return (letterCase == LetterCase::Upper) ? 'A' : 'a';
+}
+
+
+/// Convert hex digits to their values. @return Mask of the characters that are hex digits.
+__attribute__((target("ssse3")))
+inline __m128i hexValues(__m128i chars, __m128i fold, __m128i base, int& valid) noexcept {
+    auto const digit = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+    auto const isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+
+    auto const letter = _mm_sub_epi8(_mm_or_si128(chars, fold), base);
+    auto const isLetter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+
+    valid &= _mm_movemask_epi8(_mm_or_si128(isDigit, isLetter));
+
+    return _mm_or_si128(_mm_and_si128(isDigit, digit),
+                        _mm_and_si128(isLetter, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+}
+
+
+__attribute__((target("avx2")))
+inline __m256i hexValues(__m256i chars, __m256i fold, __m256i base, int& valid) noexcept {
+    auto const digit = _mm256_sub_epi8(chars, _mm256_set1_epi8('0'));
+    auto const isDigit = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+
+    auto const letter = _mm256_sub_epi8(_mm256_or_si256(chars, fold), base);
+    auto const isLetter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+
+    valid &= _mm256_movemask_epi8(_mm256_or_si256(isDigit, isLetter));
+
+    return _mm256_or_si256(_mm256_and_si256(isDigit, digit),
+                           _mm256_and_si256(isLetter, _mm256_add_epi8(letter, _mm256_set1_epi8(10))));
+}
+
+
+/// @return Number of characters decoded, stops at a block that is not all hex digits.
+__attribute__((target("ssse3")))
+size_type decodeSsse3(byte const* in, size_type size, byte* out, LetterCase letterCase) noexcept {
+    auto const fold = _mm_set1_epi8(letterFold(letterCase));
+    auto const base = _mm_set1_epi8(letterBase(letterCase));
+    auto const weights = _mm_set1_epi16(0x0110);
+
+    size_type i = 0;
+    for (; i + 32 <= size; i += 32, out += 16) {
+        int valid = 0xFFFF;
+        auto const first = hexValues(_mm_loadu_si128(reinterpret_cast<__m128i const*>(in + i)), fold, base, valid);
+        auto const last = hexValues(_mm_loadu_si128(reinterpret_cast<__m128i const*>(in + i + 16)),
+                                    fold, base, valid);
+        if (valid != 0xFFFF) {
+            break;
+        }
+
+        // Each pair of nibbles becomes high * 16 + low
+        auto const packed = _mm_packus_epi16(_mm_maddubs_epi16(first, weights), _mm_maddubs_epi16(last, weights));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), packed);
+    }
+
+    return i;
+}
+
+
+__attribute__((target("avx2")))
+size_type decodeAvx2(byte const* in, size_type size, byte* out, LetterCase letterCase) noexcept {
+    auto const fold = _mm256_set1_epi8(letterFold(letterCase));
+    auto const base = _mm256_set1_epi8(letterBase(letterCase));
+    auto const weights = _mm256_set1_epi16(0x0110);
+
+    size_type i = 0;
+    for (; i + 64 <= size; i += 64, out += 32) {
+        int valid = -1;
+        auto const first = hexValues(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(in + i)),
+                                     fold, base, valid);
+        auto const last = hexValues(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(in + i + 32)),
+                                    fold, base, valid);
+        if (valid != -1) {
+            break;
+        }
+
+        // Packing works within lanes, so the 64 bit quarters of the result are reordered
+        auto const packed = _mm256_packus_epi16(_mm256_maddubs_epi16(first, weights),
+                                                _mm256_maddubs_epi16(last, weights));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_permute4x64_epi64(packed, 0xD8));
+    }
+
+    return i;
+}
+
+#endif  // SOLACE_BASE16_X86
+
+
+/// Encode size bytes into 2 * size characters.
+void encodeHex(byte const* in, size_type size, byte* out, LetterCase letterCase) noexcept {
+    auto const upper = (letterCase == LetterCase::Upper);
+
+    size_type i = 0;
+#ifdef SOLACE_BASE16_X86
+    auto const digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    if (cpu::hasAvx2()) {
+        i = encodeAvx2(in, size, out, digits);
+    } else if (cpu::hasSsse3()) {
+        i = encodeSsse3(in, size, out, digits);
+    }
+#endif
+
+    auto const alphabet = upper ? kBase16Alphabet_u : kBase16Alphabet_l;
+    for (out += 2 * i; i < size; ++i) {
+        *out++ = alphabet[in[i]][0];
+        *out++ = alphabet[in[i]][1];
+    }
+}
+
+
+/// Decode an even number of characters. @return False if any of the characters is not a hex digit.
+bool decodeHex(byte const* in, size_type size, byte* out, LetterCase letterCase) noexcept {
+    size_type i = 0;
+#ifdef SOLACE_BASE16_X86
+    if (cpu::hasAvx2()) {
+        i = decodeAvx2(in, size, out, letterCase);
+    } else if (cpu::hasSsse3()) {
+        i = decodeSsse3(in, size, out, letterCase);
+    }
+#endif
+
+    for (out += i / 2; i < size; i += 2) {
+        auto const high = hexValue(in[i], letterCase);
+        auto const low = hexValue(in[i + 1], letterCase);
+        if (high < 0 || low < 0) {
+            return false;
+        }
+
+        *out++ = static_cast<byte>((high << 4) | low);
+    }
+
+    return true;
+}
+
+}  // anonymous namespace
+
+
+Result<MemoryView::size_type, Error>
+Solace::base16Encode(MemoryView src, MutableMemoryView dest, LetterCase letterCase) {
+    auto const size = Base16Encoder::encodedSize(src.size());
+    if (dest.size() < size) {
+        return Err(makeError(SystemErrors::Overflow, "base16Encode"));
+    }
+
+    if (size != 0) {
+        encodeHex(src.dataAddress(), src.size(), dest.dataAddress(), letterCase);
+    }
+
+    return Ok(size);
+}
+
+
+Result<MemoryView::size_type, Error>
+Solace::base16Decode(MemoryView src, MutableMemoryView dest, LetterCase letterCase) {
+    if (src.size() % 2 != 0) {
+        return Err(makeError(GenericError::DOM, "base16Decode(): Input data size must be even"));
+    }
+
+    auto const size = Base16Decoder::encodedSize(src.size());
+    if (dest.size() < size) {
+        return Err(makeError(SystemErrors::Overflow, "base16Decode"));
+    }
+
+    if (size != 0 && !decodeHex(src.dataAddress(), src.size(), dest.dataAddress(), letterCase)) {
+        return Err(makeError(SystemErrors::ILSEQ, "base16Decode"));
+    }
+
+    return Ok(size);
+}
+
+
 Base16Encoder::size_type
 Base16Encoder::encodedSize(size_type len) {
     // FIXME(abyssoul): Does anybody care about size_type overflow?!
@@ -108,14 +356,12 @@ Result<void, Error>
 Base16Encoder::encode(MemoryView const& src) {
     auto& dest = *getDestBuffer();
 
-    for (auto value : src) {
-        auto res = dest.write(wrapMemory(kBase16Alphabet_l[value], 2));
-        if (!res) {
-            return Err(res.moveError());
-        }
+    auto written = base16Encode(src, dest.viewRemaining(), _letterCase);
+    if (!written) {
+        return Err(written.moveError());
     }
 
-    return Ok();
+    return dest.advance(written.unwrap());
 }
 
 
@@ -135,28 +381,14 @@ Base16Decoder::encodedSize(MemoryView const& data) const {
 
 Result<void, Error>
 Base16Decoder::encode(MemoryView const& src) {
-    if (src.size() % 2 != 0) {
-        return Err(makeError(GenericError::DOM, "encode(): Input data size must be even"));
-    }
-
     auto& dest = *getDestBuffer();
 
-    for (size_type i = 0; i < src.size(); i += 2) {
-        auto high = charToBin(src[i]);
-        auto low =  charToBin(src[i + 1]);
-
-        if (!high)
-            return Err(high.moveError());
-        if (!low)
-            return Err(low.moveError());
-
-        byte const value = static_cast<byte>(high.unwrap() << 4) + static_cast<byte>(low.unwrap());
-        auto res = dest.write(value);
-        if (!res)
-            return Err(res.moveError());
+    auto written = base16Decode(src, dest.viewRemaining(), _letterCase);
+    if (!written) {
+        return Err(written.moveError());
     }
 
-    return Ok();
+    return dest.advance(written.unwrap());
 }
 
 
@@ -227,3 +459,68 @@ Base16Decoded_Iterator::operator++ () {
 
     return *this;
 }
+
+
+Result<void, Error>
+Base16StreamEncoder::update(MemoryView const& chunk) {
+    auto& dest = *getDestBuffer();
+
+    auto written = base16Encode(chunk, dest.viewRemaining(), _letterCase);
+    if (!written) {
+        return Err(written.moveError());
+    }
+
+    return dest.advance(written.unwrap());
+}
+
+
+Result<void, Error>
+Base16StreamDecoder::update(MemoryView const& chunk) {
+    if (chunk.empty()) {
+        return Ok();
+    }
+
+    auto& dest = *getDestBuffer();
+    auto const outSize = (_carrySize + chunk.size()) / 2;
+    auto buffer = dest.viewRemaining();
+    if (buffer.size() < outSize) {
+        return Err(makeError(SystemErrors::Overflow, "Base16StreamDecoder::update()"));
+    }
+
+    // Output is written as the chunk is validated, the writer is only advanced if all of it is valid
+    auto in = chunk.dataAddress();
+    auto out = buffer.dataAddress();
+    auto left = chunk.size();
+    if (_carrySize != 0) {
+        byte const pair[] = {_carry, in[0]};
+        if (!decodeHex(pair, 2, out, _letterCase)) {
+            return Err(makeError(SystemErrors::ILSEQ, "Base16StreamDecoder::update()"));
+        }
+
+        in += 1;
+        out += 1;
+        left -= 1;
+    }
+
+    auto const whole = left & ~size_type{1};
+    if (!decodeHex(in, whole, out, _letterCase)) {
+        return Err(makeError(SystemErrors::ILSEQ, "Base16StreamDecoder::update()"));
+    }
+
+    _carrySize = static_cast<byte>(left - whole);
+    if (_carrySize != 0) {
+        _carry = in[whole];
+    }
+
+    return dest.advance(outSize);
+}
+
+
+Result<void, Error>
+Base16StreamDecoder::finish() {
+    if (_carrySize != 0) {
+        return Err(makeError(GenericError::DOM, "finish(): Input data size must be even"));
+    }
+
+    return Ok();
+}
@@ -17,62 +17,42 @@
  * libSolace
  *	@file		base64.cpp
  *	@brief		Implementation of Base64 encoder and decoder.
+ *
+ * Both directions write straight into the remaining space of the destination writer, which is
+ * checked once for the whole result, and only advance the writer when the whole input is processed.
+ *
+ * Vectorized paths follow Muła and Lemire, "Faster Base64 Encoding and Decoding Using AVX2
+ * Instructions" (2018). Encoding shuffles each 3 input bytes into a 32 bit lane, extracts four 6 bit
+ * indices with two multiplications and maps indices to characters by adding an offset looked up
+ * by the range of the index, so that both alphabets only differ in the last two offsets.
+ * Decoding classifies characters by range, which also validates them, adds the offset of the range
+ * and packs four 6 bit values into 3 bytes with two multiply-add instructions.
+ * AVX2 or SSSE3 path is selected at run time, whatever is left is handled by the scalar code.
  ******************************************************************************/
 #include "solace/base64.hpp"
+#include "solace/cpuFeatures.hpp"
 #include "solace/posixErrorDomain.hpp"
 
-#include <limits>
+#include <cstring>  // memcpy
 
+#if defined(__x86_64__)
+#define SOLACE_BASE64_X86 1
+#include <immintrin.h>
+#endif
 
-using namespace Solace;
-
-
-static constexpr byte kBase64Alphabet[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-static constexpr byte kBase64UrlAlphabet[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
 
+using namespace Solace;
 
-Result<void, Error>
-base64encode(ByteWriter& dest, MemoryView const& src, byte const alphabet[65]) {
-    MemoryView::size_type i = 0;
-
-    for (; i + 2 < src.size(); i += 3) {
-        byte const encoded[] = {
-            alphabet[ (src[i] >> 2) & 0x3F],
-            alphabet[((src[i] & 0x3) << 4)     | (static_cast<int>(src[i + 1] & 0xF0) >> 4)],
-            alphabet[((src[i + 1] & 0xF) << 2) | (static_cast<int>(src[i + 2] & 0xC0) >> 6)],
-            alphabet[  src[i + 2] & 0x3F]
-        };
-
-        auto res = dest.write(wrapMemory(encoded));
-        if (!res)
-            return Err(res.moveError());
-    }
-
-
-    if (i < src.size()) {
-        byte encoded[4];
-        encoded[0] = alphabet[(src[i] >> 2) & 0x3F];
-        if (i + 1 == src.size()) {
-            encoded[1] = alphabet[((src[i] & 0x3) << 4)];
-            encoded[2] = '=';
-        } else {
-            encoded[1] = alphabet[((src[i] & 0x3) << 4) | (static_cast<int>(src[i + 1] & 0xF0) >> 4)];
-            encoded[2] = alphabet[((src[i + 1] & 0xF) << 2)];
-        }
-
-        encoded[3] = '=';
-        auto res = dest.write(wrapMemory(encoded));
-        if (!res)
-            return Err(res.moveError());
-    }
 
-    return Ok();
-}
+namespace /* anonymous */ {
 
+using size_type = MemoryView::size_type;
 
+constexpr byte kBase64Alphabet[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+constexpr byte kBase64UrlAlphabet[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
 
 /* aaaack but it's fast and const should make it shared text page. */
-static const byte pr2six[256] = {
+const byte pr2six[256] = {
     /* ASCII table */
 //  00, 01, 02, 03, 04, 05, 06, 07, 08, 09, 0A, 0B, 0C, 0D, 0E, 0F,
     64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,  // 00..0F
@@ -94,7 +74,7 @@ static const byte pr2six[256] = {
 };
 
 
-static const byte prUrl2six[256] = {
+const byte prUrl2six[256] = {
     /* ASCII table */
 //  00, 01, 02, 03, 04, 05, 06, 07, 08, 09, 0A, 0B, 0C, 0D, 0E, 0F,
     64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64, 64,  // 00..0F
@@ -116,55 +96,385 @@ static const byte prUrl2six[256] = {
 };
 
 
+/// Characters of an alphabet and the table to decode them.
+struct Alphabet {
+    byte const* chars;
+    byte const* values;     //!< Value of each character, 64 for characters not in the alphabet.
+};
+
+constexpr Alphabet kStandard{kBase64Alphabet, pr2six};
+constexpr Alphabet kUrl{kBase64UrlAlphabet, prUrl2six};
+
+
+/// Number of trailing padding characters of the encoded text.
+size_type paddingSize(byte const* text, size_type size) noexcept {
+    if (size < 4 || size % 4 != 0) {
+        return 0;
+    }
+
+    return (text[size - 1] == '=')
+            ? ((text[size - 2] == '=') ? 2 : 1)
+            : 0;
+}
+
+
+/// Number of bytes encoded by the given number of characters, not counting the padding.
+size_type decodedLength(size_type length) noexcept {
+    auto const tail = length % 4;
+
+    return (length / 4) * 3 + (tail ? tail - 1 : 0);
+}
+
+
+#ifdef SOLACE_BASE64_X86
+
+/// Offset to add to a 6 bit value to get its character, indexed by the range of the value.
+__attribute__((target("ssse3")))
+inline __m128i encodingOffsets(Alphabet alphabet) noexcept {
+    auto const digit = static_cast<char>('0' - 52);
+
+    return _mm_setr_epi8(static_cast<char>('a' - 26), digit, digit, digit, digit, digit,
+                         digit, digit, digit, digit, digit,
+                         static_cast<char>(alphabet.chars[62] - 62), static_cast<char>(alphabet.chars[63] - 63),
+                         'A', 0, 0);
+}
+
+
+/// Encode 12 bytes of each 16 byte lane, given as [0, 12), into 16 characters.
+__attribute__((target("ssse3")))
+inline __m128i encodeBlock(__m128i input, __m128i offsets) noexcept {
+    // Each 3 bytes into a 32 bit lane as b1, b0, b2, b1
+    auto const in = _mm_shuffle_epi8(input, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+
+    // Move each 6 bit field into its own byte
+    auto const ac = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+    auto const bd = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+    auto const indices = _mm_or_si128(ac, bd);
+
+    // Range of each index: 0 for 26..51, 1..10 for digits, 11 and 12 for the last two, 13 for upper case letters
+    auto range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    auto const upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    range = _mm_or_si128(range, _mm_and_si128(upper, _mm_set1_epi8(13)));
+
+    return _mm_add_epi8(indices, _mm_shuffle_epi8(offsets, range));
+}
+
+
+__attribute__((target("ssse3")))
+size_type encodeSsse3(byte const* src, size_type size, byte* out, Alphabet alphabet) noexcept {
+    auto const offsets = encodingOffsets(alphabet);
+
+    size_type i = 0;
+    for (; i + 16 <= size; i += 12, out += 16) {
+        auto const input = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), encodeBlock(input, offsets));
+    }
+
+    return i;
+}
+
+
+__attribute__((target("avx2")))
+size_type encodeAvx2(byte const* src, size_type size, byte* out, Alphabet alphabet) noexcept {
+    auto const offsets = _mm256_broadcastsi128_si256(encodingOffsets(alphabet));
+    auto const shuffle = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+                                          1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+
+    size_type i = 0;
+    for (; i + 28 <= size; i += 24, out += 32) {
+        // Lanes hold bytes [0, 12) and [12, 24) of the block
+        auto const input = _mm256_inserti128_si256(
+                    _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i))),
+                    _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i + 12)), 1);
+
+        auto const in = _mm256_shuffle_epi8(input, shuffle);
+        auto const ac = _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0FC0FC00)),
+                                           _mm256_set1_epi32(0x04000040));
+        auto const bd = _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003F03F0)),
+                                           _mm256_set1_epi32(0x01000010));
+        auto const indices = _mm256_or_si256(ac, bd);
+
+        auto range = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        auto const upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+        range = _mm256_or_si256(range, _mm256_and_si256(upper, _mm256_set1_epi8(13)));
+
+        auto const encoded = _mm256_add_epi8(indices, _mm256_shuffle_epi8(offsets, range));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), encoded);
+    }
+
+    return i;
+}
+
+
+/// Mask of the characters in [first, last]. Bytes above 0x7F are negative and fall into no range.
+__attribute__((target("ssse3")))
+inline __m128i inRange(__m128i chars, char first, char last) noexcept {
+    return _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8(first - 1)),
+                         _mm_cmplt_epi8(chars, _mm_set1_epi8(last + 1)));
+}
+
+
+__attribute__((target("avx2")))
+inline __m256i inRange(__m256i chars, char first, char last) noexcept {
+    return _mm256_and_si256(_mm256_cmpgt_epi8(chars, _mm256_set1_epi8(first - 1)),
+                            _mm256_cmpgt_epi8(_mm256_set1_epi8(last + 1), chars));
+}
+
+
+/// Convert characters to their 6 bit values. @return Mask of the characters that are in the alphabet.
+__attribute__((target("ssse3")))
+inline __m128i decodeValues(__m128i chars, Alphabet alphabet, int& valid) noexcept {
+    auto const upper = inRange(chars, 'A', 'Z');
+    auto const lower = inRange(chars, 'a', 'z');
+    auto const digit = inRange(chars, '0', '9');
+    auto const c62 = static_cast<char>(alphabet.chars[62]);
+    auto const c63 = static_cast<char>(alphabet.chars[63]);
+    auto const is62 = _mm_cmpeq_epi8(chars, _mm_set1_epi8(c62));
+    auto const is63 = _mm_cmpeq_epi8(chars, _mm_set1_epi8(c63));
+
+    valid &= _mm_movemask_epi8(_mm_or_si128(_mm_or_si128(_mm_or_si128(upper, lower), digit),
+                                            _mm_or_si128(is62, is63)));
+
+    auto shift = _mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')),
+                              _mm_and_si128(lower, _mm_set1_epi8(26 - 'a')));
+    shift = _mm_or_si128(shift, _mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+    shift = _mm_or_si128(shift, _mm_and_si128(is62, _mm_set1_epi8(static_cast<char>(62 - c62))));
+    shift = _mm_or_si128(shift, _mm_and_si128(is63, _mm_set1_epi8(static_cast<char>(63 - c63))));
+
+    return _mm_add_epi8(chars, shift);
+}
+
+
+/// Pack four 6 bit values of each 32 bit lane into 3 bytes, at the bottom 12 bytes of the register.
+__attribute__((target("ssse3")))
+inline __m128i packValues(__m128i values) noexcept {
+    auto const pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    auto const words = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+
+    return _mm_shuffle_epi8(words, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+
+/// @return Number of characters decoded or the offset of a block with a character not in the alphabet.
+__attribute__((target("ssse3")))
+size_type decodeSsse3(byte const* src, size_type size, byte* out, size_type capacity, Alphabet alphabet,
+                      bool& valid) noexcept {
+    size_type i = 0;
+    size_type o = 0;
+    for (; i + 16 <= size && o + 16 <= capacity; i += 16, o += 12) {
+        int mask = 0xFFFF;
+        auto const values = decodeValues(_mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i)), alphabet, mask);
+        if (mask != 0xFFFF) {
+            valid = false;
+            break;
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + o), packValues(values));
+    }
+
+    return i;
+}
+
+
+__attribute__((target("avx2")))
+size_type decodeAvx2(byte const* src, size_type size, byte* out, size_type capacity, Alphabet alphabet,
+                     bool& valid) noexcept {
+    auto const c62 = static_cast<char>(alphabet.chars[62]);
+    auto const c63 = static_cast<char>(alphabet.chars[63]);
+
+    size_type i = 0;
+    size_type o = 0;
+    for (; i + 32 <= size && o + 32 <= capacity; i += 32, o += 24) {
+        auto const chars = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + i));
+        auto const upper = inRange(chars, 'A', 'Z');
+        auto const lower = inRange(chars, 'a', 'z');
+        auto const digit = inRange(chars, '0', '9');
+        auto const is62 = _mm256_cmpeq_epi8(chars, _mm256_set1_epi8(c62));
+        auto const is63 = _mm256_cmpeq_epi8(chars, _mm256_set1_epi8(c63));
+
+        auto const known = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(upper, lower), digit),
+                                           _mm256_or_si256(is62, is63));
+        if (_mm256_movemask_epi8(known) != -1) {
+            valid = false;
+            break;
+        }
+
+        auto shift = _mm256_or_si256(_mm256_and_si256(upper, _mm256_set1_epi8(-'A')),
+                                     _mm256_and_si256(lower, _mm256_set1_epi8(26 - 'a')));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(digit, _mm256_set1_epi8(52 - '0')));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(is62, _mm256_set1_epi8(static_cast<char>(62 - c62))));
+        shift = _mm256_or_si256(shift, _mm256_and_si256(is63, _mm256_set1_epi8(static_cast<char>(63 - c63))));
+        auto const values = _mm256_add_epi8(chars, shift);
+
+        auto const pairs = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        auto const words = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+        auto const packed = _mm256_shuffle_epi8(words, _mm256_setr_epi8(
+                                                    2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                                    2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+
+        // Join 12 bytes of each lane
+        auto const joined = _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + o), joined);
+    }
+
+    return i;
+}
+
+#endif  // SOLACE_BASE64_X86
+
+
+/// Encode whole groups of 3 bytes. @return Number of bytes encoded.
+size_type encodeGroups(byte const* in, size_type size, byte* out, Alphabet alphabet) noexcept {
+    auto const chars = alphabet.chars;
+
+    size_type i = 0;
+#ifdef SOLACE_BASE64_X86
+    if (cpu::hasAvx2()) {
+        i = encodeAvx2(in, size, out, alphabet);
+    } else if (cpu::hasSsse3()) {
+        i = encodeSsse3(in, size, out, alphabet);
+    }
+    out += (i / 3) * 4;
+#endif
+
+    for (; i + 2 < size; i += 3, out += 4) {
+        auto const group = (static_cast<uint32>(in[i]) << 16) | (static_cast<uint32>(in[i + 1]) << 8) | in[i + 2];
+        out[0] = chars[(group >> 18) & 0x3F];
+        out[1] = chars[(group >> 12) & 0x3F];
+        out[2] = chars[(group >> 6) & 0x3F];
+        out[3] = chars[group & 0x3F];
+    }
+
+    return i;
+}
+
+
+/// Encode the last 1 or 2 bytes into 4 characters with padding.
+void encodeLast(byte const* in, size_type size, byte* out, byte const* chars) noexcept {
+    auto const second = (size > 1) ? in[1] : 0;
+    out[0] = chars[(in[0] >> 2) & 0x3F];
+    out[1] = chars[((in[0] & 0x3) << 4) | (second >> 4)];
+    out[2] = (size > 1) ? chars[(second & 0xF) << 2] : '=';
+    out[3] = '=';
+}
+
+
+/**
+ * Decode whole groups of 4 characters, padding is not allowed.
+ * @param capacity Size of the output buffer, vectorized code may write past the decoded bytes.
+ * @return False if any of the characters is not in the alphabet.
+ */
+bool decodeGroups(byte const* in, size_type size, byte* out, size_type capacity, Alphabet alphabet) noexcept {
+    auto const values = alphabet.values;
+
+    size_type i = 0;
+#ifdef SOLACE_BASE64_X86
+    bool valid = true;
+    if (cpu::hasAvx2()) {
+        i = decodeAvx2(in, size, out, capacity, alphabet, valid);
+    } else if (cpu::hasSsse3()) {
+        i = decodeSsse3(in, size, out, capacity, alphabet, valid);
+    }
+
+    if (!valid) {
+        return false;
+    }
+#else
+    (void)capacity;
+#endif
+
+    for (auto o = (i / 4) * 3; i + 4 <= size; i += 4, o += 3) {
+        auto const a = values[in[i]], b = values[in[i + 1]], c = values[in[i + 2]], d = values[in[i + 3]];
+        if ((a | b | c | d) & 0xC0) {
+            return false;
+        }
+
+        auto const group = (static_cast<uint32>(a) << 18) | (static_cast<uint32>(b) << 12) | (c << 6) | d;
+        out[o] = static_cast<byte>(group >> 16);
+        out[o + 1] = static_cast<byte>(group >> 8);
+        out[o + 2] = static_cast<byte>(group);
+    }
+
+    return true;
+}
+
+
+/**
+ * Decode the last 2 or 3 characters of the text, not counting the padding.
+ * @return False if a character is not in the alphabet or the bits that don't make a whole byte are not zero.
+ */
+bool decodeLast(byte const* in, size_type size, byte* out, byte const* values) noexcept {
+    auto const a = values[in[0]];
+    auto const b = values[in[1]];
+    auto const c = (size > 2) ? values[in[2]] : 0;
+    auto const unused = (size > 2) ? (c & 0x03) : (b & 0x0F);
+    if (((a | b | c) & 0xC0) || unused) {
+        return false;
+    }
+
+    out[0] = static_cast<byte>((a << 2) | (b >> 4));
+    if (size > 2) {
+        out[1] = static_cast<byte>((b << 4) | (c >> 2));
+    }
+
+    return true;
+}
+
 
 Result<void, Error>
-base64decode(ByteWriter& dest, MemoryView const& src, byte const* decodingTable) {
-    byte const* bufin = src.dataAddress();
-    if (!bufin || src.size() == 0) {
-        return Err(makeError(SystemErrors::NODATA, "base64decode"));
+base64encode(ByteWriter& dest, MemoryView const& src, Alphabet alphabet) {
+    auto const size = src.size();
+    auto const encodedSize = Base64Encoder::encodedSize(size);
+    auto buffer = dest.viewRemaining();
+    if (buffer.size() < encodedSize) {
+        return Err(makeError(SystemErrors::Overflow, "base64encode"));
     }
 
-    while (decodingTable[*(bufin++)] <= 63)
-    {}
+    if (size == 0) {
+        return Ok();
+    }
 
-    long nprbytes = (bufin - src.dataAddress()) - 1;  // NOLINT(runtime/int)
-    bufin = src.dataAddress();
+    auto const in = src.dataAddress();
+    auto const out = buffer.dataAddress();
+    auto const encoded = encodeGroups(in, size, out, alphabet);
+    if (encoded < size) {
+        encodeLast(in + encoded, size - encoded, out + (encoded / 3) * 4, alphabet.chars);
+    }
 
-    while (nprbytes > 4) {
-        byte const encoded[] = {
-            static_cast<byte>(decodingTable[bufin[0]] << 2 | decodingTable[bufin[1]] >> 4),
-            static_cast<byte>(decodingTable[bufin[1]] << 4 | decodingTable[bufin[2]] >> 2),
-            static_cast<byte>(decodingTable[bufin[2]] << 6 | decodingTable[bufin[3]])
-        };
+    return dest.advance(encodedSize);
+}
 
-        auto res = dest.write(wrapMemory(encoded));
-        if (!res)
-            return Err(res.moveError());
 
-        bufin += 4;
-        nprbytes -= 4;
+Result<void, Error>
+base64decode(ByteWriter& dest, MemoryView const& src, Alphabet alphabet) {
+    auto const in = src.dataAddress();
+    auto const size = src.size() - paddingSize(in, src.size());
+    if (size % 4 == 1) {
+        return Err(makeError(SystemErrors::ILSEQ, "base64decode"));
     }
 
-    /* Note: (nprbytes == 1) would be an error, so just ingore that case */
-    if (nprbytes > 1) {
-        auto res = dest.write(static_cast<byte>(decodingTable[bufin[0]] << 2 | decodingTable[bufin[1]] >> 4));
-        if (!res)
-            return Err(res.moveError());
+    auto const decodedSize = decodedLength(size);
+    auto buffer = dest.viewRemaining();
+    if (buffer.size() < decodedSize) {
+        return Err(makeError(SystemErrors::Overflow, "base64decode"));
     }
-    if (nprbytes > 2) {
-        auto res = dest.write(static_cast<byte>(decodingTable[bufin[1]] << 4 | decodingTable[bufin[2]] >> 2));
-        if (!res)
-            return Err(res.moveError());
+
+    if (size == 0) {
+        return Ok();
     }
-    if (nprbytes > 3) {
-        auto res = dest.write(static_cast<byte>(decodingTable[bufin[2]] << 6 | decodingTable[bufin[3]]));
-        if (!res)
-            return Err(res.moveError());
+
+    auto const out = buffer.dataAddress();
+    auto const groups = (size / 4) * 4;
+    if (!decodeGroups(in, groups, out, buffer.size(), alphabet) ||
+        (groups < size && !decodeLast(in + groups, size - groups, out + (groups / 4) * 3, alphabet.values))) {
+        return Err(makeError(SystemErrors::ILSEQ, "base64decode"));
     }
 
-    return Ok();
+    return dest.advance(decodedSize);
 }
 
+}  // anonymous namespace
+
 
 Base64Encoder::size_type
 Base64Encoder::encodedSize(size_type len) {
@@ -178,20 +488,12 @@ Base64Decoder::decodedSize(MemoryView const& data) {
         return 0;
     }
 
-    if (data.size() % 4) {
-        return 0;  // FIXME: Probably throw!
-    }
-
-    size_type nprbytes = 0;
-    for (const auto& b : data) {
-        if (pr2six[b] <= 63) {
-            ++nprbytes;
-        } else {
-            break;
-        }
+    auto const length = data.size() - paddingSize(data.dataAddress(), data.size());
+    if (length % 4 == 1) {
+        return 0;  // Not a valid encoding
     }
 
-    return (nprbytes * 3 / 4);
+    return decodedLength(length);
 }
 
 
@@ -203,20 +505,191 @@ Base64Decoder::encodedSize(MemoryView const& data) const {
 
 Result<void, Error>
 Base64Encoder::encode(MemoryView const& src) {
-   return base64encode(*getDestBuffer(), src, kBase64Alphabet);
+   return base64encode(*getDestBuffer(), src, kStandard);
 }
 
 Result<void, Error>
 Base64UrlEncoder::encode(MemoryView const& src) {
-    return base64encode(*getDestBuffer(), src, kBase64UrlAlphabet);
+    return base64encode(*getDestBuffer(), src, kUrl);
 }
 
 Result<void, Error>
 Base64Decoder::encode(MemoryView const& src) {
-    return base64decode(*getDestBuffer(), src, pr2six);
+    return base64decode(*getDestBuffer(), src, kStandard);
 }
 
 Result<void, Error>
 Base64UrlDecoder::encode(MemoryView const& src) {
-    return base64decode(*getDestBuffer(), src, prUrl2six);
+    return base64decode(*getDestBuffer(), src, kUrl);
+}
+
+
+Result<void, Error>
+Base64StreamEncoder::update(MemoryView const& chunk) {
+    auto const size = chunk.size();
+    auto const total = _carrySize + size;
+    if (total < 3) {
+        if (size != 0) {
+            std::memcpy(_carry + _carrySize, chunk.dataAddress(), size);
+            _carrySize += size;
+        }
+
+        return Ok();
+    }
+
+    auto& dest = *getDestBuffer();
+    auto const outSize = (total / 3) * 4;
+    auto buffer = dest.viewRemaining();
+    if (buffer.size() < outSize) {
+        return Err(makeError(SystemErrors::Overflow, "Base64StreamEncoder::update()"));
+    }
+
+    auto const alphabet = _urlSafe ? kUrl : kStandard;
+    auto in = chunk.dataAddress();
+    auto out = buffer.dataAddress();
+
+    // Complete the group carried over from the previous chunk
+    if (_carrySize != 0) {
+        byte group[3];
+        std::memcpy(group, _carry, _carrySize);
+        std::memcpy(group + _carrySize, in, 3 - _carrySize);
+        encodeGroups(group, 3, out, alphabet);
+
+        in += 3 - _carrySize;
+        out += 4;
+    }
+
+    auto const left = static_cast<size_type>(chunk.dataAddress() + size - in);
+    auto const encoded = encodeGroups(in, left, out, alphabet);
+    _carrySize = static_cast<byte>(left - encoded);
+    std::memcpy(_carry, in + encoded, _carrySize);
+
+    return dest.advance(outSize);
+}
+
+
+Result<void, Error>
+Base64StreamEncoder::finish() {
+    if (_carrySize != 0) {
+        auto& dest = *getDestBuffer();
+        auto buffer = dest.viewRemaining();
+        if (buffer.size() < 4) {
+            return Err(makeError(SystemErrors::Overflow, "Base64StreamEncoder::finish()"));
+        }
+
+        encodeLast(_carry, _carrySize, buffer.dataAddress(), _urlSafe ? kBase64UrlAlphabet : kBase64Alphabet);
+        _carrySize = 0;
+
+        return dest.advance(4);
+    }
+
+    return Ok();
+}
+
+
+Base64StreamDecoder::size_type
+Base64StreamDecoder::maxOutputSize(size_type chunkSize) const noexcept {
+    return decodedLength(_carrySize + chunkSize);
+}
+
+
+Result<void, Error>
+Base64StreamDecoder::update(MemoryView const& chunk) {
+    auto const size = chunk.size();
+    if (size == 0) {
+        return Ok();
+    }
+
+    if (_padded) {  // Nothing may follow the padding
+        return Err(makeError(SystemErrors::ILSEQ, "Base64StreamDecoder::update()"));
+    }
+
+    auto const in = chunk.dataAddress();
+    auto const total = _carrySize + size;
+    if (total < 4) {
+        std::memcpy(_carry + _carrySize, in, size);
+        _carrySize += size;
+
+        return Ok();
+    }
+
+    // Group carried over from the previous chunk, completed by the chunk
+    byte first[4];
+    size_type const head = (_carrySize != 0) ? 4 - _carrySize : 0;
+    std::memcpy(first, _carry, _carrySize);
+    std::memcpy(first + _carrySize, in, head);
+
+    auto const body = ((size - head) / 4) * 4;
+    auto const rest = size - head - body;
+
+    // Only the last group of the stream may be padded
+    auto const last = (body != 0) ? in + head + body - 4 : first;
+    size_type const padding = (last[3] == '=') ? ((last[2] == '=') ? 2 : 1) : 0;
+    if (padding != 0 && rest != 0) {
+        return Err(makeError(SystemErrors::ILSEQ, "Base64StreamDecoder::update()"));
+    }
+
+    auto& dest = *getDestBuffer();
+    auto const outSize = (total / 4) * 3 - padding;
+    auto buffer = dest.viewRemaining();
+    if (buffer.size() < outSize) {
+        return Err(makeError(SystemErrors::Overflow, "Base64StreamDecoder::update()"));
+    }
+
+    auto const alphabet = _urlSafe ? kUrl : kStandard;
+    auto out = buffer.dataAddress();
+    auto capacity = buffer.size();
+    bool valid = true;
+    if (head != 0) {
+        valid = (body == 0 && padding != 0)
+                ? decodeLast(first, 4 - padding, out, alphabet.values)
+                : decodeGroups(first, 4, out, capacity, alphabet);
+        out += 3;
+        capacity -= 3;
+    }
+
+    if (valid && body != 0) {
+        auto const whole = (padding != 0) ? body - 4 : body;
+        valid = decodeGroups(in + head, whole, out, capacity, alphabet) &&
+                (padding == 0 || decodeLast(last, 4 - padding, out + (whole / 4) * 3, alphabet.values));
+    }
+
+    if (!valid) {
+        return Err(makeError(SystemErrors::ILSEQ, "Base64StreamDecoder::update()"));
+    }
+
+    _carrySize = static_cast<byte>(rest);
+    std::memcpy(_carry, in + head + body, rest);
+    _padded = (padding != 0);
+
+    return dest.advance(outSize);
+}
+
+
+Result<void, Error>
+Base64StreamDecoder::finish() {
+    if (_carrySize == 0) {
+        _padded = false;
+
+        return Ok();
+    }
+
+    if (_carrySize == 1) {  // A single character can't encode a byte
+        return Err(makeError(SystemErrors::ILSEQ, "Base64StreamDecoder::finish()"));
+    }
+
+    auto& dest = *getDestBuffer();
+    size_type const outSize = _carrySize - 1u;
+    auto buffer = dest.viewRemaining();
+    if (buffer.size() < outSize) {
+        return Err(makeError(SystemErrors::Overflow, "Base64StreamDecoder::finish()"));
+    }
+
+    if (!decodeLast(_carry, _carrySize, buffer.dataAddress(), _urlSafe ? prUrl2six : pr2six)) {
+        return Err(makeError(SystemErrors::ILSEQ, "Base64StreamDecoder::finish()"));
+    }
+
+    reset();
+
+    return dest.advance(outSize);
 }
@@ -17,15 +17,338 @@
  * libSolace
  *	@file		byteReader.cpp
  *	@brief		Implementation of Byte Reader
+ *
+ * Batch decoding of varints follows the idea of Masked VByte by Plaisance, Kurz and Lemire,
+ * "Vectorized VByte Decoding" (2015): continuation bits of 16 bytes are gathered into a mask,
+ * 16 single byte values are widened at once, otherwise the low 12 bits of the mask select
+ * a shuffle from a table that spreads the leading values into lanes of 16, 32 or 64 bits,
+ * depending on how long they are, where their 7 bit groups are joined.
+ * Only a value that doesn't end within 12 bytes is decoded on its own.
  ******************************************************************************/
 #include "solace/byteReader.hpp"
+#include "solace/cpuFeatures.hpp"
 #include "solace/posixErrorDomain.hpp"
 
 #include <cstring>  // memmove
 
+#if defined(__x86_64__)
+#define SOLACE_BYTEREADER_X86 1
+#include <immintrin.h>
+#endif
+
 using namespace Solace;
 
 
+namespace /* anonymous */ {
+
+/// Result of decoding a varint that is not well formed.
+constexpr int kMalformed = -1;
+
+/**
+ * Decode a LEB128 varint of at most the given number of bytes.
+ * @return Number of bytes decoded, 0 if the data ends before the value or kMalformed if the value
+ * doesn't fit the type or is over-long, i.e. ends with a zero byte after the first one.
+ */
+template<typename T>
+inline int decodeVarint(byte const* data, size_t size, T& value) noexcept {
+    constexpr int maxBytes = (sizeof(T) * 8 + 6) / 7;
+    constexpr int lastBits = sizeof(T) * 8 - 7 * (maxBytes - 1);
+
+    T result = 0;
+    for (int i = 0; i < maxBytes; ++i) {
+        if (static_cast<size_t>(i) == size) {
+            return 0;
+        }
+
+        auto const b = data[i];
+        result |= static_cast<T>(b & 0x7F) << (7 * i);
+        if (!(b & 0x80)) {
+            if (i != 0 && b == 0) {
+                return kMalformed;
+            }
+            if (i == maxBytes - 1 && (b >> lastBits) != 0) {
+                return kMalformed;
+            }
+
+            value = result;
+            return i + 1;
+        }
+    }
+
+    return kMalformed;
+}
+
+
+template<typename T>
+Result<void, Error>
+readVarint(byte const* data, ByteReader::size_type size, T& value, ByteReader::size_type& consumed) noexcept {
+    auto const decoded = decodeVarint(data, size, value);
+    if (decoded == 0) {
+        return Err<Error>(makeError(SystemErrors::Overflow, "ByteReader::readVarint()"));
+    }
+    if (decoded == kMalformed) {
+        return Err<Error>(makeError(SystemErrors::ILSEQ, "ByteReader::readVarint()"));
+    }
+
+    consumed = static_cast<ByteReader::size_type>(decoded);
+
+    return Ok();
+}
+
+
+#ifdef SOLACE_BYTEREADER_X86
+
+/// How a shuffle spreads the leading values of a chunk into lanes.
+enum class VarintLanes : byte {
+    None,       //!< The first value is longer than 5 bytes or doesn't end in 12 bytes.
+    Lanes16,    //!< Up to 6 values of 1 or 2 bytes in 16 bit lanes.
+    Lanes32,    //!< Up to 4 values of 1 to 4 bytes in 32 bit lanes.
+    Lanes64,    //!< Up to 2 values of 1 to 5 bytes in 64 bit lanes.
+};
+
+
+/// Shuffle that spreads the leading values of a chunk into lanes of one size.
+struct VarintShuffle {
+    byte        shuffle[16];
+    VarintLanes lanes;
+};
+
+
+/// Values at the start of a chunk with the given continuation bits.
+struct VarintChunk {
+    uint16  shuffle;        //!< Index of the shuffle.
+    byte    count;          //!< Number of values.
+    byte    consumed;       //!< Number of bytes the values take.
+};
+
+
+/**
+ * Shuffles for each mask of continuation bits of 12 bytes.
+ * Of the lane sizes the one that takes the most values is chosen, the smaller one on a tie.
+ * Different masks often select the same shuffle, so the masks only index the 412 distinct ones.
+ * Count and size of the values are kept with the mask, so that the next chunk can be loaded
+ * without waiting for the shuffle.
+ */
+struct VarintShuffleTable {
+    static constexpr int kMaskBits = 12;
+    static constexpr int kMaxShuffles = 512;
+
+    VarintChunk     chunks[1 << kMaskBits];
+    VarintShuffle   shuffles[kMaxShuffles];
+
+    VarintShuffleTable() noexcept {
+        std::memset(chunks, 0, sizeof(chunks));
+        std::memset(shuffles, 0, sizeof(shuffles));
+        unsigned shufflesCount = 1;     // The first one is VarintLanes::None
+
+        for (unsigned mask = 0; mask < (1U << kMaskBits); ++mask) {
+            byte lengths[kMaskBits];
+            unsigned valuesCount = 0;
+            for (unsigned i = 0, start = 0; i < kMaskBits; ++i) {
+                if (!(mask & (1U << i))) {
+                    lengths[valuesCount++] = static_cast<byte>(i + 1 - start);
+                    start = i + 1;
+                }
+            }
+
+            auto const leading = [&](unsigned maxLength, unsigned maxCount) {
+                unsigned n = 0;
+                while (n < valuesCount && n < maxCount && lengths[n] <= maxLength) {
+                    ++n;
+                }
+                return n;
+            };
+
+            auto const count16 = leading(2, 6);
+            auto const count32 = leading(4, 4);
+            auto const count64 = leading(5, 2);
+
+            VarintShuffle entry;
+            std::memset(entry.shuffle, 0x80, sizeof(entry.shuffle));
+            entry.lanes = VarintLanes::None;
+            unsigned count = 0;
+            unsigned laneSize = 0;
+            if (count16 != 0 && count16 >= count32 && count16 >= count64) {
+                entry.lanes = VarintLanes::Lanes16;
+                count = count16;
+                laneSize = 2;
+            } else if (count32 != 0 && count32 >= count64) {
+                entry.lanes = VarintLanes::Lanes32;
+                count = count32;
+                laneSize = 4;
+            } else if (count64 != 0) {
+                entry.lanes = VarintLanes::Lanes64;
+                count = count64;
+                laneSize = 8;
+            }
+
+            unsigned consumed = 0;
+            for (unsigned n = 0; n < count; ++n) {
+                for (unsigned b = 0; b < lengths[n]; ++b) {
+                    entry.shuffle[n * laneSize + b] = static_cast<byte>(consumed++);
+                }
+            }
+
+            unsigned found = 0;
+            if (count != 0) {
+                found = 1;
+                while (found < shufflesCount &&
+                       (shuffles[found].lanes != entry.lanes ||
+                        std::memcmp(shuffles[found].shuffle, entry.shuffle, sizeof(entry.shuffle)) != 0)) {
+                    ++found;
+                }
+                if (found == shufflesCount) {
+                    shuffles[shufflesCount++] = entry;
+                }
+            }
+
+            chunks[mask] = VarintChunk{static_cast<uint16>(found), static_cast<byte>(count),
+                                       static_cast<byte>(consumed)};
+        }
+    }
+};
+
+
+/**
+ * Decode the values at the start of a chunk of 16 bytes.
+ * @param mask Continuation bits of the chunk, at least the low 16 bits.
+ * @param malformed Bits of the bytes of the chunk that make their values malformed.
+ * @param out Memory for 16 values, some may be overwritten past the decoded ones.
+ * @return Number of bytes decoded or 0 if the first value has to be decoded on its own,
+ * because it is malformed or longer than the shuffles allow.
+ */
+__attribute__((target("ssse3"), always_inline))
+inline unsigned
+decodeChunk(VarintShuffleTable const& table, __m128i chunk, unsigned mask, unsigned malformed, uint32* values,
+            ArrayView<uint32>::size_type& decoded) noexcept {
+    auto const zero = _mm_setzero_si128();
+    auto out = reinterpret_cast<__m128i*>(values);
+
+    if ((mask & 0xFFFF) == 0) {  // 16 single byte values, none of them malformed
+        auto const low = _mm_unpacklo_epi8(chunk, zero);
+        auto const high = _mm_unpackhi_epi8(chunk, zero);
+        _mm_storeu_si128(out, _mm_unpacklo_epi16(low, zero));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(low, zero));
+        _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(high, zero));
+        _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(high, zero));
+        decoded += 16;
+        return 16;
+    }
+
+    mask &= (1U << VarintShuffleTable::kMaskBits) - 1;
+    auto const chunkValues = table.chunks[mask];
+    if (malformed & ((1U << chunkValues.consumed) - 1)) {
+        return 0;
+    }
+
+    auto const& entry = table.shuffles[chunkValues.shuffle];
+    auto const lanes = _mm_shuffle_epi8(chunk, _mm_loadu_si128(reinterpret_cast<__m128i const*>(entry.shuffle)));
+
+    // Values are joined for every lane size and the right ones are selected without a branch,
+    // since the lane size of the next chunk is as hard to predict as the length of a value.
+    auto const lanesSize = _mm_set1_epi32(static_cast<int>(entry.lanes));
+    auto const is16 = _mm_cmpeq_epi32(lanesSize, _mm_set1_epi32(static_cast<int>(VarintLanes::Lanes16)));
+    auto const is32 = _mm_cmpeq_epi32(lanesSize, _mm_set1_epi32(static_cast<int>(VarintLanes::Lanes32)));
+    auto const is64 = _mm_cmpeq_epi32(lanesSize, _mm_set1_epi32(static_cast<int>(VarintLanes::Lanes64)));
+
+    // 7 bit groups are joined into 14 bits in each 16 bit lane, then pairs of those into 28 bits
+    // in each 32 bit lane, which is a whole value of up to 4 bytes. A value of 5 bytes takes
+    // 4 more bits from the upper half of its 64 bit lane.
+    auto const joined16 = _mm_or_si128(_mm_and_si128(lanes, _mm_set1_epi16(0x007F)),
+                                       _mm_srli_epi16(_mm_and_si128(lanes, _mm_set1_epi16(0x7F00)), 1));
+    auto const joined32 = _mm_madd_epi16(joined16, _mm_set1_epi32(0x40000001));
+    auto const joined64 = _mm_shuffle_epi32(
+                _mm_or_si128(_mm_and_si128(joined32, _mm_set1_epi32(0x0FFFFFFF)),
+                             _mm_and_si128(_mm_srli_epi64(joined32, 4), _mm_set1_epi32(static_cast<int>(0xF0000000U)))),
+                _MM_SHUFFLE(3, 1, 2, 0));
+
+    auto const first = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_unpacklo_epi16(joined16, zero), is16),
+                                                 _mm_and_si128(joined32, is32)),
+                                    _mm_and_si128(joined64, is64));
+    _mm_storeu_si128(out, first);
+    _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(joined16, zero));
+    decoded += chunkValues.count;
+
+    return chunkValues.consumed;
+}
+
+
+/**
+ * Decode varints while at least 16 bytes and 16 values are left.
+ * Continuation bits of 64 bytes are gathered at once, so that finding where the next chunk starts
+ * doesn't wait for the chunk to be loaded.
+ * @return Number of values decoded, stops at a malformed value and leaves it to the caller.
+ */
+__attribute__((target("ssse3")))
+ArrayView<uint32>::size_type
+decodeVarintsSsse3(byte const* data, ByteReader::size_type size, uint32* values, ArrayView<uint32>::size_type count,
+                   ByteReader::size_type& consumed) noexcept {
+    static VarintShuffleTable const table;
+
+    auto const load = [data](ByteReader::size_type position) {
+        return _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + position));
+    };
+
+    ByteReader::size_type position = 0;
+    ArrayView<uint32>::size_type decoded = 0;
+    while (position + 16 <= size && decoded + 16 <= count) {
+        // Continuation bits of a block of 64 bytes if there is one, otherwise of a single chunk
+        auto const chunks = (position + 64 <= size) ? 4 : 1;
+        auto const bits = [](__m128i v) { return uint64{static_cast<unsigned>(_mm_movemask_epi8(v))}; };
+        uint64 masks = 0;
+        for (int i = 0; i < chunks; ++i) {
+            masks |= bits(load(position + 16 * i)) << (16 * i);
+        }
+        ByteReader::size_type const blockEnd = position + ((chunks == 4) ? 49 : 1);
+
+        // A value is malformed if it is over-long, ending with a zero byte after the first one,
+        // or if it takes 5 bytes and the last one has more than the 4 bits that fit 32 bits.
+        // The block starts with a value, so bits before it are rightly taken as zero.
+        uint64 malformed = 0;
+        if (masks != 0) {
+            uint64 zeros = 0;
+            uint64 wide = 0;
+            for (int i = 0; i < chunks; ++i) {
+                auto const chunk = load(position + 16 * i);
+                zeros |= bits(_mm_cmpeq_epi8(chunk, _mm_setzero_si128())) << (16 * i);
+                wide |= bits(_mm_cmpgt_epi8(chunk, _mm_set1_epi8(0x0F))) << (16 * i);
+            }
+
+            auto const fifthBytes = ~masks & (masks << 1) & (masks << 2) & (masks << 3) & (masks << 4);
+            malformed = (zeros & (masks << 1)) | (wide & fifthBytes);
+        }
+
+        auto offset = position;
+        while (offset < blockEnd && decoded + 16 <= count) {
+            auto length = decodeChunk(table, load(offset),
+                                      static_cast<unsigned>(masks), static_cast<unsigned>(malformed),
+                                      values + decoded, decoded);
+            if (length == 0) {
+                auto const scalarLength = decodeVarint(data + offset, size - offset, values[decoded]);
+                if (scalarLength <= 0) {
+                    consumed = offset;
+                    return decoded;
+                }
+                length = static_cast<unsigned>(scalarLength);
+                decoded += 1;
+            }
+            offset += length;
+            masks >>= length;
+            malformed >>= length;
+        }
+        position = offset;
+    }
+
+    consumed = position;
+
+    return decoded;
+}
+
+#endif  // SOLACE_BYTEREADER_X86
+
+}  // anonymous namespace
+
+
 Result<void, Error>
 ByteReader::limit(size_type newLimit) noexcept {
     if (capacity() < newLimit) {
@@ -122,6 +445,34 @@ ByteReader::read(size_type offset, MutableMemoryView& dest, size_type bytesToRea
 }
 
 
+Result<void, Error>
+ByteReader::readArray(void* dest, size_type count, size_type elementSize, bool swap) noexcept {
+    auto const size = count * elementSize;
+    if (remaining() < size) {
+        return Err<Error>(makeError(SystemErrors::Overflow, "ByteReader::readArray()"));
+    }
+
+    if (!swap) {
+        return read(dest, size);
+    }
+
+    copySwappingBytes(dest, _storage.view().dataAddress(_position), count, elementSize);
+    _position += size;
+
+    return Ok();
+}
+
+
+Result<ByteReader::Cursor, Error>
+ByteReader::reserve(size_type size) noexcept {
+    if (remaining() < size) {
+        return Err<Error>(makeError(SystemErrors::Overflow, "ByteReader::reserve()"));
+    }
+
+    return Ok(Cursor{*this, _storage.view().dataAddress(_position)});
+}
+
+
 Result<void, Error>
 ByteReader::readLE(uint16& value) noexcept {
     constexpr auto valueSize = sizeof(value);
@@ -229,3 +580,74 @@ ByteReader::readBE(uint64& value) noexcept {
                 }
     });
 }
+
+
+Result<void, Error>
+ByteReader::readVarint(int32& value) noexcept {
+    uint32 encoded;
+    return readVarint(encoded)
+            .then([&]() {
+                value = static_cast<int32>((encoded >> 1) ^ (~(encoded & 1) + 1));
+            });
+}
+
+
+Result<void, Error>
+ByteReader::readVarint(uint32& value) noexcept {
+    size_type consumed = 0;
+    return ::readVarint(_storage.view().dataAddress(_position), remaining(), value, consumed)
+            .then([this, &consumed]() {
+                _position += consumed;
+            });
+}
+
+
+Result<void, Error>
+ByteReader::readVarint(int64& value) noexcept {
+    uint64 encoded;
+    return readVarint(encoded)
+            .then([&]() {
+                value = static_cast<int64>((encoded >> 1) ^ (~(encoded & 1) + 1));
+            });
+}
+
+
+Result<void, Error>
+ByteReader::readVarint(uint64& value) noexcept {
+    size_type consumed = 0;
+    return ::readVarint(_storage.view().dataAddress(_position), remaining(), value, consumed)
+            .then([this, &consumed]() {
+                _position += consumed;
+            });
+}
+
+
+Result<void, Error>
+ByteReader::readVarints(ArrayView<uint32> values) noexcept {
+    auto const data = _storage.view().dataAddress(_position);
+    auto const size = remaining();
+    auto const count = values.size();
+    auto out = values.begin();
+
+    size_type position = 0;
+    ArrayView<uint32>::size_type decoded = 0;
+#ifdef SOLACE_BYTEREADER_X86
+    if (cpu::hasSsse3()) {
+        decoded = decodeVarintsSsse3(data, size, out, count, position);
+    }
+#endif
+
+    for (; decoded < count; ++decoded) {
+        size_type consumed = 0;
+        auto result = ::readVarint(data + position, size - position, out[decoded], consumed);
+        if (!result) {
+            return result;
+        }
+
+        position += consumed;
+    }
+
+    _position += position;
+
+    return Ok();
+}
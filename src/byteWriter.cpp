@@ -27,6 +27,28 @@
 using namespace Solace;
 
 
+namespace /* anonymous */ {
+
+/// Encode the value as LEB128. @return Number of bytes written.
+inline size_t encodeVarint(uint64 value, byte* out) noexcept {
+    size_t size = 0;
+    while (value >= 0x80) {
+        out[size++] = static_cast<byte>(value | 0x80);
+        value >>= 7;
+    }
+    out[size++] = static_cast<byte>(value);
+
+    return size;
+}
+
+
+inline size_t varintSize(uint32 value) noexcept {
+    return 1 + (value >= (1U << 7)) + (value >= (1U << 14)) + (value >= (1U << 21)) + (value >= (1U << 28));
+}
+
+}  // anonymous namespace
+
+
 Result<void, Error>
 ByteWriter::limit(size_type newLimit) noexcept {
     if (capacity() < newLimit) {
@@ -81,6 +103,34 @@ ByteWriter::write(void const* data, size_type count) noexcept {
 }
 
 
+Result<void, Error>
+ByteWriter::writeArray(void const* values, size_type count, size_type elementSize, bool swap) noexcept {
+    auto const size = count * elementSize;
+    if (!swap) {
+        return write(values, size);
+    }
+
+    if (remaining() < size) {
+        return Err<Error>(makeError(SystemErrors::Overflow, "ByteWriter::writeArray()"));
+    }
+
+    copySwappingBytes(viewRemaining().dataAddress(), values, count, elementSize);
+    _position += size;
+
+    return Ok();
+}
+
+
+Result<ByteWriter::Cursor, Error>
+ByteWriter::reserve(size_type size) noexcept {
+    if (remaining() < size) {
+        return Err<Error>(makeError(SystemErrors::Overflow, "ByteWriter::reserve()"));
+    }
+
+    return Ok(Cursor{*this, _storage.view().dataAddress(_position)});
+}
+
+
 Result<void, Error>
 ByteWriter::writeLE(uint16 value) noexcept {
     constexpr auto valueSize = sizeof(value);
@@ -191,3 +241,49 @@ ByteWriter::writeBE(uint64 value) noexcept {
 
     return write(&result, valueSize);
 }
+
+
+Result<void, Error>
+ByteWriter::writeVarint(int32 value) noexcept {
+    return writeVarint((static_cast<uint32>(value) << 1) ^ static_cast<uint32>(value >> 31));
+}
+
+
+Result<void, Error>
+ByteWriter::writeVarint(uint32 value) noexcept {
+    return writeVarint(static_cast<uint64>(value));
+}
+
+
+Result<void, Error>
+ByteWriter::writeVarint(int64 value) noexcept {
+    return writeVarint((static_cast<uint64>(value) << 1) ^ static_cast<uint64>(value >> 63));
+}
+
+
+Result<void, Error>
+ByteWriter::writeVarint(uint64 value) noexcept {
+    byte encoded[10];
+
+    return write(encoded, encodeVarint(value, encoded));
+}
+
+
+Result<void, Error>
+ByteWriter::writeVarints(ArrayView<const uint32> values) noexcept {
+    size_type size = 0;
+    for (auto value : values) {
+        size += varintSize(value);
+    }
+
+    if (remaining() < size) {
+        return Err<Error>(makeError(SystemErrors::Overflow, "ByteWriter::writeVarints()"));
+    }
+
+    auto out = viewRemaining().dataAddress();
+    for (auto value : values) {
+        out += encodeVarint(value, out);
+    }
+
+    return advance(size);
+}
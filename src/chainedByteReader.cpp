@@ -0,0 +1,207 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		chainedByteReader.cpp
+ *	@brief		Implementation of ChainedByteReader
+ *
+ * Segments are kept in a vector with the index of the first one not yet fully read. A segment is released
+ * the moment its last byte is read, and the slots of released segments are reclaimed when the vector
+ * needs to grow or when all the segments are read.
+ ******************************************************************************/
+#include "solace/chainedByteReader.hpp"
+#include "solace/posixErrorDomain.hpp"
+
+#include <algorithm>
+#include <cstring>  // memcpy
+
+
+using namespace Solace;
+
+
+ChainedByteReader&
+ChainedByteReader::append(MemoryResource&& segment) {
+    if (segment.empty()) {
+        return *this;
+    }
+
+    if (_segments.size() == _segments.capacity()) {
+        // Only segments not yet read are moved, leaving out the slots of released ones
+        auto const live = _segments.size() - _first;
+        auto const newCapacity = std::max<uint32>(4, 2 * live + 1);
+        auto newSegments = makeVector<MemoryResource>(_memoryManager->allocate(newCapacity * sizeof(MemoryResource)));
+        for (auto i = _first; i < _segments.size(); ++i) {
+            newSegments.emplace_back(std::move(_segments.view()[i]));
+        }
+
+        _segments = std::move(newSegments);
+        _first = 0;
+    }
+
+    _remaining += segment.size();
+    _segments.emplace_back(std::move(segment));
+
+    return *this;
+}
+
+
+void
+ChainedByteReader::consume(size_type count) noexcept {
+    _remaining -= count;
+    while (count != 0) {
+        auto& segment = _segments.view()[_first];
+        auto const chunkSize = std::min(count, segment.size() - _offset);
+        _offset += chunkSize;
+        count -= chunkSize;
+
+        if (_offset == segment.size()) {
+            segment = MemoryResource{};  // Release the memory right away
+            _first += 1;
+            _offset = 0;
+        }
+    }
+
+    if (_first == _segments.size()) {
+        while (!_segments.empty()) {
+            _segments.pop_back();
+        }
+        _first = 0;
+    }
+}
+
+
+Result<void, Error>
+ChainedByteReader::advance(size_type increment) noexcept {
+    if (remaining() < increment) {
+        return Err<Error>(makeError(SystemErrors::Overflow, "ChainedByteReader::advance()"));
+    }
+
+    consume(increment);
+
+    return Ok();
+}
+
+
+Result<byte, Error>
+ChainedByteReader::get() noexcept {
+    if (remaining() < 1) {
+        return Err<Error>(makeError(SystemErrors::Overflow, "ChainedByteReader::get()"));
+    }
+
+    auto const value = _segments[_first].view()[_offset];
+    consume(1);
+
+    return Ok(value);
+}
+
+
+Result<void, Error>
+ChainedByteReader::read(MutableMemoryView& dest, size_type bytesToRead) noexcept {
+    if (dest.size() < bytesToRead) {
+        return Err<Error>(makeError(SystemErrors::Overflow, "ChainedByteReader::read()"));
+    }
+
+    return read(dest.dataAddress(), bytesToRead);
+}
+
+
+Result<void, Error>
+ChainedByteReader::read(void* dest, size_type count) noexcept {
+    if (remaining() < count) {
+        return Err<Error>(makeError(SystemErrors::Overflow, "ChainedByteReader::read()"));
+    }
+
+    auto out = static_cast<byte*>(dest);
+    auto left = count;
+    auto offset = _offset;
+    for (auto i = _first; left != 0; ++i, offset = 0) {
+        auto const segment = _segments[i].view();
+        auto const chunkSize = std::min(left, segment.size() - offset);
+        std::memcpy(out, segment.dataAddress(offset), chunkSize);
+        out += chunkSize;
+        left -= chunkSize;
+    }
+
+    consume(count);
+
+    return Ok();
+}
+
+
+Result<void, Error>
+ChainedByteReader::readLE(uint16& value) noexcept {
+    return read(&value, sizeof(value))
+            .then([&]() {
+                if (isBigendian()) {
+                    value = __builtin_bswap16(value);
+                }
+            });
+}
+
+
+Result<void, Error>
+ChainedByteReader::readLE(uint32& value) noexcept {
+    return read(&value, sizeof(value))
+            .then([&]() {
+                if (isBigendian()) {
+                    value = __builtin_bswap32(value);
+                }
+            });
+}
+
+
+Result<void, Error>
+ChainedByteReader::readLE(uint64& value) noexcept {
+    return read(&value, sizeof(value))
+            .then([&]() {
+                if (isBigendian()) {
+                    value = __builtin_bswap64(value);
+                }
+            });
+}
+
+
+Result<void, Error>
+ChainedByteReader::readBE(uint16& value) noexcept {
+    return read(&value, sizeof(value))
+            .then([&]() {
+                if (!isBigendian()) {
+                    value = __builtin_bswap16(value);
+                }
+            });
+}
+
+
+Result<void, Error>
+ChainedByteReader::readBE(uint32& value) noexcept {
+    return read(&value, sizeof(value))
+            .then([&]() {
+                if (!isBigendian()) {
+                    value = __builtin_bswap32(value);
+                }
+            });
+}
+
+
+Result<void, Error>
+ChainedByteReader::readBE(uint64& value) noexcept {
+    return read(&value, sizeof(value))
+            .then([&]() {
+                if (!isBigendian()) {
+                    value = __builtin_bswap64(value);
+                }
+            });
+}
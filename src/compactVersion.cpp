@@ -0,0 +1,392 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		compactVersion.cpp
+ *	@brief		Implementation of VersionLabels and bulk version parsing.
+ *
+ * Labels live in a single growing text buffer indexed by offsets, with an open addressing table
+ * to find existing labels, so interning a label seen before allocates nothing.
+ * Bulk parsing counts lines first to allocate the result once, then parses each line in place
+ * without building any intermediate strings.
+ ******************************************************************************/
+#include "solace/compactVersion.hpp"
+#include "solace/posixErrorDomain.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+
+using namespace Solace;
+
+
+constexpr CompactVersion::value_type CompactVersion::MaxNumber;
+
+
+namespace /* anonymous */ {
+
+constexpr uint32 kInitialCapacity = 16;
+
+/// Spread a hash code over the slots of a power of two sized table.
+uint32 slotOf(uint64 hash, uint32 tableSize) noexcept {
+    return static_cast<uint32>((hash * 0x9E3779B97F4A7C15ULL) >> 32) & (tableSize - 1);
+}
+
+/// Grow the array to at least minSize elements, doubling its size, and keep its content.
+template<typename T>
+void reserve(Array<T>& array, uint32 minSize) {
+    auto size = array.size();
+    if (size >= minSize) {
+        return;
+    }
+
+    while (size < minSize) {
+        size *= 2;
+    }
+
+    auto bigger = makeArray<T>(size);
+    std::copy(array.begin(), array.end(), bigger.begin());
+    array = std::move(bigger);
+}
+
+
+bool isDigit(char c) noexcept {
+    return c >= '0' && c <= '9';
+}
+
+/// Characters allowed in pre-release and build labels: alphanumerics, hyphens and dots separating identifiers.
+bool isLabelChar(char c) noexcept {
+    return isDigit(c) || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '-' || c == '.';
+}
+
+bool isValidLabel(StringView label) noexcept {
+    if (label.empty() || label[0] == '.' || label[label.size() - 1] == '.') {
+        return false;
+    }
+
+    char previous = 0;
+    for (auto c : label) {
+        if (!isLabelChar(c) || (c == '.' && previous == '.')) {
+            return false;
+        }
+        previous = c;
+    }
+
+    return true;
+}
+
+
+/// Compare identifiers lexically in ASCII sort order.
+int compareAscii(StringView lhs, StringView rhs) noexcept {
+    auto const common = std::min(lhs.size(), rhs.size());
+    auto const diff = (common == 0) ? 0 : std::memcmp(lhs.data(), rhs.data(), common);
+
+    return (diff != 0)
+            ? diff
+            : static_cast<int>(lhs.size()) - static_cast<int>(rhs.size());
+}
+
+
+/// Digits of a number without leading zeroes.
+StringView significantDigits(StringView number) noexcept {
+    StringView::size_type i = 0;
+    while (i + 1 < number.size() && number[i] == '0') {
+        ++i;
+    }
+
+    return number.substring(i);
+}
+
+
+/// Compare dot separated identifiers of pre-release labels as defined by semantic versioning.
+int compareIdentifiers(StringView lhs, StringView rhs) noexcept {
+    StringView::size_type i = 0;
+    StringView::size_type j = 0;
+    while (i < lhs.size() && j < rhs.size()) {
+        auto const lhsEnd = lhs.indexOf('.', i).orElse(lhs.size());
+        auto const rhsEnd = rhs.indexOf('.', j).orElse(rhs.size());
+        auto const a = lhs.substring(i, lhsEnd);
+        auto const b = rhs.substring(j, rhsEnd);
+
+        bool const aNumeric = std::all_of(a.begin(), a.end(), isDigit);
+        bool const bNumeric = std::all_of(b.begin(), b.end(), isDigit);
+        if (aNumeric && bNumeric) {
+            // Numeric identifiers compare by value: the one with more significant digits is greater
+            auto const aDigits = significantDigits(a);
+            auto const bDigits = significantDigits(b);
+            if (aDigits.size() != bDigits.size()) {
+                return (aDigits.size() < bDigits.size()) ? -1 : 1;
+            }
+
+            auto const diff = compareAscii(aDigits, bDigits);
+            if (diff != 0) {
+                return diff;
+            }
+        } else if (aNumeric != bNumeric) {
+            // Numeric identifiers have lower precedence than alphanumeric ones
+            return aNumeric ? -1 : 1;
+        } else {
+            auto const diff = compareAscii(a, b);
+            if (diff != 0) {
+                return diff;
+            }
+        }
+
+        i = lhsEnd + 1;
+        j = rhsEnd + 1;
+    }
+
+    // A larger set of identifiers has a higher precedence
+    bool const lhsDone = (i >= lhs.size());
+    bool const rhsDone = (j >= rhs.size());
+
+    return (lhsDone == rhsDone) ? 0 : (lhsDone ? -1 : 1);
+}
+
+
+/// Parse a number of the version. @return Position after the number or 0 if there is no number.
+StringView::size_type parseNumber(StringView text, StringView::size_type from, uint64& value) noexcept {
+    auto i = from;
+    value = 0;
+    while (i < text.size() && isDigit(text[i]) && value <= CompactVersion::MaxNumber) {
+        value = value * 10 + static_cast<uint64>(text[i] - '0');
+        ++i;
+    }
+
+    return (i == from) ? 0 : i;
+}
+
+}  // anonymous namespace
+
+
+VersionLabels::VersionLabels()
+    : _text{makeArray<char>(kInitialCapacity * 8)}
+    , _offsets{makeArray<uint32>(kInitialCapacity)}
+    , _slots{makeArray<LabelId>(kInitialCapacity)}
+{
+    // Label 0 is the empty one and is never in the table
+    _offsets[0] = 0;
+    _offsets[1] = 0;
+}
+
+
+StringView
+VersionLabels::label(LabelId id) const noexcept {
+    auto const offset = _offsets[id];
+
+    return {_text.view().data() + offset, static_cast<StringView::size_type>(_offsets[id + 1] - offset)};
+}
+
+
+Optional<VersionLabels::LabelId>
+VersionLabels::find(StringView text) const noexcept {
+    auto const mask = _slots.size() - 1;
+    for (auto i = slotOf(text.hashCode(), _slots.size()); _slots[i] != 0; i = (i + 1) & mask) {
+        auto const id = _slots[i] - 1;
+        if (label(id) == text) {
+            return id;
+        }
+    }
+
+    return none;
+}
+
+
+VersionLabels::LabelId
+VersionLabels::intern(StringView text) {
+    if (text.empty()) {
+        return 0;
+    }
+
+    auto const found = find(text);
+    if (found.isSome()) {
+        return found.get();
+    }
+
+    auto const id = _labelsCount;
+    auto const offset = _offsets[id];
+    reserve(_text, offset + text.size());
+    reserve(_offsets, id + 2);
+    std::memcpy(_text.begin() + offset, text.data(), text.size());
+    _offsets[id + 1] = offset + text.size();
+    _labelsCount += 1;
+
+    // Keep the table at most half full
+    if (2 * _labelsCount > _slots.size()) {
+        auto slots = makeArray<LabelId>(2 * _slots.size());
+        auto const mask = slots.size() - 1;
+        for (LabelId l = 1; l < id; ++l) {
+            auto i = slotOf(label(l).hashCode(), slots.size());
+            while (slots[i] != 0) {
+                i = (i + 1) & mask;
+            }
+            slots[i] = l + 1;
+        }
+        _slots = std::move(slots);
+    }
+
+    auto const mask = _slots.size() - 1;
+    auto i = slotOf(text.hashCode(), _slots.size());
+    while (_slots[i] != 0) {
+        i = (i + 1) & mask;
+    }
+    _slots[i] = id + 1;
+
+    return id;
+}
+
+
+int
+VersionLabels::comparePreRelease(LabelId lhs, LabelId rhs) const noexcept {
+    if (lhs == rhs) {
+        return 0;
+    }
+
+    // Release follows all of its pre-releases, though it is already accounted for by the key
+    if (lhs == 0 || rhs == 0) {
+        return (lhs == 0) ? 1 : -1;
+    }
+
+    return compareIdentifiers(label(lhs), label(rhs));
+}
+
+
+Result<CompactVersion, Error>
+VersionLabels::parse(StringView text) {
+    uint64 numbers[3];
+    StringView::size_type i = 0;
+    for (int n = 0; n < 3; ++n) {
+        if (n != 0) {
+            if (i >= text.size() || text[i] != Version::NumberSeparator) {
+                return Err(makeError(BasicError::InvalidInput, "VersionLabels::parse()"));
+            }
+            ++i;
+        }
+
+        i = parseNumber(text, i, numbers[n]);
+        if (i == 0) {
+            return Err(makeError(BasicError::InvalidInput, "VersionLabels::parse()"));
+        }
+        if (numbers[n] > CompactVersion::MaxNumber) {
+            return Err(makeError(SystemErrors::Overflow, "VersionLabels::parse()"));
+        }
+    }
+
+    StringView preRelease;
+    StringView build;
+    if (i < text.size() && text[i] == Version::ReleaseSeparator) {
+        auto const end = text.indexOf(Version::BuildSeparator, i + 1).orElse(text.size());
+        preRelease = text.substring(i + 1, end);
+        if (!isValidLabel(preRelease)) {
+            return Err(makeError(BasicError::InvalidInput, "VersionLabels::parse()"));
+        }
+        i = end;
+    }
+
+    if (i < text.size()) {
+        if (text[i] != Version::BuildSeparator) {
+            return Err(makeError(BasicError::InvalidInput, "VersionLabels::parse()"));
+        }
+
+        build = text.substring(i + 1);
+        if (!isValidLabel(build)) {
+            return Err(makeError(BasicError::InvalidInput, "VersionLabels::parse()"));
+        }
+    }
+
+    CompactVersion version;
+    version.key = CompactVersion::makeKey(static_cast<CompactVersion::value_type>(numbers[0]),
+                                          static_cast<CompactVersion::value_type>(numbers[1]),
+                                          static_cast<CompactVersion::value_type>(numbers[2]),
+                                          preRelease.empty());
+    version.preRelease = intern(preRelease);
+    version.build = intern(build);
+
+    return Ok(version);
+}
+
+
+Result<CompactVersion, Error>
+VersionLabels::compact(Version const& version) {
+    if (version.majorNumber > CompactVersion::MaxNumber ||
+        version.minorNumber > CompactVersion::MaxNumber ||
+        version.patchNumber > CompactVersion::MaxNumber) {
+        return Err(makeError(SystemErrors::Overflow, "VersionLabels::compact()"));
+    }
+
+    CompactVersion result;
+    result.key = CompactVersion::makeKey(version.majorNumber, version.minorNumber, version.patchNumber,
+                                         version.preRelease.empty());
+    result.preRelease = intern(version.preRelease.view());
+    result.build = intern(version.build.view());
+
+    return Ok(result);
+}
+
+
+Version
+VersionLabels::expand(CompactVersion const& version) const {
+    return {version.majorNumber(), version.minorNumber(), version.patchNumber(),
+            makeString(label(version.preRelease)), makeString(label(version.build))};
+}
+
+
+Result<Array<CompactVersion>, Error>
+Solace::parseVersions(MemoryView text, VersionLabels& labels) {
+    auto const begin = text.dataAs<char>();
+    auto const end = begin + text.size();
+
+    // Count the lines first so that the result is allocated once
+    uint32 count = 0;
+    for (auto line = begin; line < end; ) {
+        auto const found = static_cast<char const*>(std::memchr(line, '\n', static_cast<size_t>(end - line)));
+        auto const lineEnd = (found == nullptr) ? end : found;
+        count += (lineEnd != line && !(lineEnd - line == 1 && *line == '\r')) ? 1 : 0;
+        line = lineEnd + 1;
+    }
+
+    auto versions = (count == 0)
+            ? makeArray<CompactVersion>()
+            : makeArray<CompactVersion>(count);
+
+    uint32 index = 0;
+    for (auto line = begin; line < end; ) {
+        auto const found = static_cast<char const*>(std::memchr(line, '\n', static_cast<size_t>(end - line)));
+        auto lineEnd = (found == nullptr) ? end : found;
+        auto const next = lineEnd + 1;
+        if (lineEnd != line && lineEnd[-1] == '\r') {
+            --lineEnd;
+        }
+
+        if (lineEnd != line) {
+            auto const length = lineEnd - line;
+            if (length > std::numeric_limits<StringView::size_type>::max()) {
+                return Err(makeError(BasicError::InvalidInput, "parseVersions()"));
+            }
+
+            auto parsed = labels.parse(StringView{line, static_cast<StringView::size_type>(length)});
+            if (!parsed) {
+                return Err(parsed.moveError());
+            }
+            versions[index++] = parsed.unwrap();
+        }
+
+        line = next;
+    }
+
+    return Ok(std::move(versions));
+}
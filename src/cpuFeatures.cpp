@@ -0,0 +1,97 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		cpuFeatures.cpp
+ *	@brief		Implementation of CPU feature detection
+ *
+ * Features are read with the cpuid instruction rather than __builtin_cpu_supports, which depends on
+ * the __cpu_model symbol of libgcc that is not linked in with LTO builds. AVX2 also requires the OS to
+ * have enabled saving of the YMM state, which is checked in XCR0.
+ ******************************************************************************/
+#include "solace/cpuFeatures.hpp"
+#include "solace/types.hpp"
+
+#if defined(__x86_64__)
+#define SOLACE_CPUFEATURES_X86 1
+#include <cpuid.h>
+#endif
+
+
+using namespace Solace;
+
+
+namespace /* anonymous */ {
+
+struct Features {
+    bool ssse3{false};
+    bool sse41{false};
+    bool avx2{false};
+};
+
+
+Features detectFeatures() noexcept {
+    Features features;
+
+#ifdef SOLACE_CPUFEATURES_X86
+    unsigned int eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return features;
+    }
+
+    features.ssse3 = (ecx & bit_SSSE3) != 0;
+    features.sse41 = (ecx & bit_SSE4_1) != 0;
+
+    if ((ecx & bit_OSXSAVE) && (ecx & bit_AVX)) {
+        uint32 xcr0Low, xcr0High;
+        __asm__ ("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+
+        // XMM and YMM state are both enabled by the OS
+        if ((xcr0Low & 0x6) == 0x6 && __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx)) {
+            features.avx2 = (ebx & bit_AVX2) != 0;
+        }
+    }
+#endif
+
+    return features;
+}
+
+
+Features const& features() noexcept {
+    static Features const detected = detectFeatures();
+
+    return detected;
+}
+
+}  // anonymous namespace
+
+
+bool
+cpu::hasSsse3() noexcept {
+    return features().ssse3;
+}
+
+
+bool
+cpu::hasSse41() noexcept {
+    return features().sse41;
+}
+
+
+bool
+cpu::hasAvx2() noexcept {
+    return features().avx2;
+}
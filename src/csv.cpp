@@ -0,0 +1,410 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		csv.cpp
+ *	@brief		Implementation of the CSV parser.
+ *
+ * Quote validation: with `inQuote` being the prefix XOR of quotes, a quote is opening if its own bit
+ * is set in `inQuote` and closing otherwise. An escaped quote is a closing quote immediately followed
+ * by an opening one. Hence an opening quote must start a field or follow a closing quote, and a closing
+ * quote must be followed by a field boundary, an opening quote, '\r' or the end of the document.
+ ******************************************************************************/
+#include "solace/csv.hpp"
+#include "solace/posixErrorDomain.hpp"
+#include "solace/exception.hpp"
+
+#include <algorithm>    // std::min
+#include <cstring>      // memcpy, memchr
+
+#if defined(__x86_64__)
+#define SOLACE_CSV_SSE2 1
+#include <emmintrin.h>
+#endif
+
+
+using namespace Solace;
+
+
+namespace /* anonymous */ {
+
+constexpr size_t kBlockSize = 64;
+
+/// Character classes of a 64 byte block, one bit per byte.
+struct BlockMasks {
+    uint64 quote;
+    uint64 delimiter;
+    uint64 newline;
+    uint64 carriageReturn;
+};
+
+
+#ifdef SOLACE_CSV_SSE2
+
+inline uint64 movemask(__m128i v, int shift) noexcept {
+    return static_cast<uint64>(static_cast<uint32>(_mm_movemask_epi8(v))) << shift;
+}
+
+BlockMasks classifyBlock(byte const* block, CsvDialect const& dialect) noexcept {
+    auto const quote = _mm_set1_epi8(dialect.quote);
+    auto const delimiter = _mm_set1_epi8(dialect.delimiter);
+    auto const newline = _mm_set1_epi8('\n');
+    auto const carriageReturn = _mm_set1_epi8('\r');
+
+    BlockMasks masks{0, 0, 0, 0};
+    for (int k = 0; k < 4; ++k) {
+        auto const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(block + 16*k));
+        masks.quote |= movemask(_mm_cmpeq_epi8(v, quote), 16*k);
+        masks.delimiter |= movemask(_mm_cmpeq_epi8(v, delimiter), 16*k);
+        masks.newline |= movemask(_mm_cmpeq_epi8(v, newline), 16*k);
+        masks.carriageReturn |= movemask(_mm_cmpeq_epi8(v, carriageReturn), 16*k);
+    }
+
+    if (!dialect.quoting) {
+        masks.quote = 0;
+    }
+
+    return masks;
+}
+
+#else
+
+BlockMasks classifyBlock(byte const* block, CsvDialect const& dialect) noexcept {
+    auto const quote = static_cast<byte>(dialect.quote);
+    auto const delimiter = static_cast<byte>(dialect.delimiter);
+
+    BlockMasks masks{0, 0, 0, 0};
+    for (size_t k = 0; k < kBlockSize; ++k) {
+        uint64 const bit = uint64{1} << k;
+        masks.quote |= (block[k] == quote) ? bit : 0;
+        masks.delimiter |= (block[k] == delimiter) ? bit : 0;
+        masks.newline |= (block[k] == '\n') ? bit : 0;
+        masks.carriageReturn |= (block[k] == '\r') ? bit : 0;
+    }
+
+    if (!dialect.quoting) {
+        masks.quote = 0;
+    }
+
+    return masks;
+}
+
+#endif
+
+
+/**
+ * Classify a block that may be shorter than kBlockSize.
+ * Bits past the end of the data are cleared.
+ */
+BlockMasks classify(byte const* data, size_t length, CsvDialect const& dialect) noexcept {
+    if (length == kBlockSize) {
+        return classifyBlock(data, dialect);
+    }
+
+    byte tail[kBlockSize]{};
+    std::memcpy(tail, data, length);
+    auto masks = classifyBlock(tail, dialect);
+
+    uint64 const valid = (uint64{1} << length) - 1;
+    masks.quote &= valid;
+    masks.delimiter &= valid;
+    masks.newline &= valid;
+    masks.carriageReturn &= valid;
+
+    return masks;
+}
+
+
+/// Prefix XOR: bit i of the result is the parity of bits 0..i of the argument.
+inline uint64 prefixXor(uint64 bits) noexcept {
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+
+    return bits;
+}
+
+
+/// Broadcast the top bit of the mask to all bits.
+inline uint64 carryState(uint64 mask) noexcept {
+    return static_cast<uint64>(static_cast<int64>(mask) >> 63);
+}
+
+
+/// Offset of the record that starts in a chunk given if the chunk starts in quotes.
+MemoryView::size_type
+recordStartOf(MemoryView::size_type chunkOffset, CsvChunkSummary const& summary, bool inQuotes) noexcept {
+    auto const start = summary.recordStart[inQuotes ? 1 : 0];
+
+    return (start == CsvChunkSummary::kNoRecordStart)
+            ? CsvChunkSummary::kNoRecordStart
+            : chunkOffset + start;
+}
+
+
+/**
+ * Convert chunks that hold an empty view at the start of each chunk into consecutive chunks
+ * covering the document.
+ */
+void spanChunks(MemoryView document, ArrayView<MemoryView> chunks) noexcept {
+    auto const base = document.dataAddress();
+    auto end = document.size();
+    for (auto i = chunks.size(); i > 0; --i) {
+        auto& chunk = chunks[i - 1];
+        auto const start = std::min(static_cast<MemoryView::size_type>(chunk.dataAddress() - base), end);
+        chunk = document.slice(start, end);
+        end = start;
+    }
+}
+
+}  // anonymous namespace
+
+
+Error
+CsvError::toError() const noexcept {
+    switch (kind) {
+    case Kind::FieldTooLong:
+        return makeError(SystemErrors::Overflow, "CsvReader");
+    default:
+        return makeError(BasicError::InvalidInput, "CsvReader");
+    }
+}
+
+
+bool
+CsvField::hasEscapes() const noexcept {
+    if (!_quoted) {
+        return false;
+    }
+
+    auto const content = view();
+
+    return !content.empty() && std::memchr(content.data(), _quote, content.size()) != nullptr;
+}
+
+
+Result<StringView, Error>
+CsvField::unescape(MutableMemoryView scratch) const {
+    auto const content = view();
+    if (!hasEscapes()) {
+        return Ok(content);
+    }
+
+    if (scratch.size() < content.size()) {
+        return Err(makeError(SystemErrors::Overflow, "CsvField::unescape()"));
+    }
+
+    auto const dest = reinterpret_cast<char*>(scratch.dataAddress());
+    StringView::size_type length = 0;
+    for (StringView::size_type i = 0; i < content.size(); ++i) {
+        auto const c = content.data()[i];
+        dest[length++] = c;
+        i += (c == _quote) ? 1 : 0;     // Escaped quotes are validated by the reader to be doubled
+    }
+
+    return Ok(StringView{dest, length});
+}
+
+
+CsvReader::CsvReader(MemoryView source, CsvDialect dialect) noexcept
+    : _data{source.dataAddress()}
+    , _size{source.size()}
+    , _dialect{dialect}
+    , _pendingField{source.size() != 0}
+{
+}
+
+
+void
+CsvReader::nextBlock() noexcept {
+    auto const blockStart = _nextBlock;
+    auto const length = std::min<size_type>(kBlockSize, _size - blockStart);
+    auto const masks = classify(_data + blockStart, length, _dialect);
+
+    auto const inQuote = prefixXor(masks.quote) ^ _prevInQuote;
+    auto const open = masks.quote & inQuote;
+    auto const close = masks.quote & ~inQuote;
+    auto const boundary = (masks.delimiter | masks.newline) & ~inQuote;
+
+    auto const fieldStart = (boundary << 1) | _prevBoundary;
+    auto const afterClose = (close << 1) | _prevClose;
+    uint64 const valid = (length == kBlockSize) ? ~uint64{0} : (uint64{1} << length) - 1;
+
+    auto const misplacedOpen = open & ~(fieldStart | afterClose);
+    auto const misplacedClose = afterClose & ~(boundary | open | masks.carriageReturn) & valid;
+    auto const misplaced = misplacedOpen | misplacedClose;
+    if (misplaced != 0 && !_error) {
+        _error = CsvError{CsvError::Kind::Syntax, blockStart + static_cast<size_type>(__builtin_ctzll(misplaced))};
+    }
+
+    if (masks.quote != 0) {
+        _lastQuote = blockStart + static_cast<size_type>(63 - __builtin_clzll(masks.quote));
+    }
+
+    _prevInQuote = carryState(inQuote);
+    _prevClose = close >> 63;
+    _prevBoundary = boundary >> 63;
+
+    _boundaries = boundary;
+    _blockStart = blockStart;
+    _nextBlock = blockStart + length;
+}
+
+
+Result<Optional<CsvField>, CsvError>
+CsvReader::makeField(size_type end, bool lastInRecord) {
+    if (_error && _error.get().offset < end) {
+        return Err(_error.get());
+    }
+
+    auto const start = _fieldStart;
+    auto last = end;
+    if (lastInRecord && last > start && _data[last - 1] == '\r') {
+        last -= 1;
+    }
+
+    auto const length = last - start;
+    if (length > StringView::size_type(~0)) {
+        return Err(CsvError{CsvError::Kind::FieldTooLong, start});
+    }
+
+    auto const quote = static_cast<byte>(_dialect.quote);
+    bool const quoted = _dialect.quoting && length != 0 && _data[start] == quote;
+    if (quoted && (length < 2 || _data[last - 1] != quote)) {
+        return Err(CsvError{CsvError::Kind::Syntax, last - 1});
+    }
+
+    StringView const raw{reinterpret_cast<char const*>(_data + start), static_cast<StringView::size_type>(length)};
+
+    return Ok(Optional<CsvField>{CsvField{raw, start, _dialect.quote, quoted, lastInRecord}});
+}
+
+
+Result<Optional<CsvField>, CsvError>
+CsvReader::next() {
+    while (_boundaries == 0) {
+        if (_nextBlock >= _size) {  // End of the document terminates the last field
+            if (!_pendingField) {
+                return Ok(Optional<CsvField>{none});
+            }
+
+            if (_prevInQuote != 0 && !_error) {
+                return Err(CsvError{CsvError::Kind::UnclosedQuote, _lastQuote});
+            }
+
+            auto field = makeField(_size, true);
+            if (field) {
+                _pendingField = false;
+            }
+
+            return field;
+        }
+
+        nextBlock();
+    }
+
+    auto const end = _blockStart + static_cast<size_type>(__builtin_ctzll(_boundaries));
+    bool const endOfRecord = (_data[end] == '\n');
+
+    auto field = makeField(end, endOfRecord);
+    if (field) {
+        _boundaries &= _boundaries - 1;
+        _fieldStart = end + 1;
+        _pendingField = !endOfRecord || (_fieldStart < _size);
+    }
+
+    return field;
+}
+
+
+CsvChunkSummary
+Solace::summarizeCsvChunk(MemoryView chunk, CsvDialect dialect) noexcept {
+    CsvChunkSummary summary{false, {CsvChunkSummary::kNoRecordStart, CsvChunkSummary::kNoRecordStart}};
+
+    auto const data = chunk.dataAddress();
+    auto const size = chunk.size();
+    uint64 prevInQuote = 0;     // Assuming the chunk starts outside quotes
+    for (MemoryView::size_type blockStart = 0; blockStart < size; blockStart += kBlockSize) {
+        auto const length = std::min<MemoryView::size_type>(kBlockSize, size - blockStart);
+        auto const masks = classify(data + blockStart, length, dialect);
+
+        // Once both record starts are known only parity of quotes matters
+        if (summary.recordStart[0] != CsvChunkSummary::kNoRecordStart &&
+            summary.recordStart[1] != CsvChunkSummary::kNoRecordStart) {
+            prevInQuote ^= (__builtin_popcountll(masks.quote) & 1) ? ~uint64{0} : 0;
+            continue;
+        }
+
+        auto const inQuote = prefixXor(masks.quote) ^ prevInQuote;
+        prevInQuote = carryState(inQuote);
+
+        // Starting inside quotes inverts the quote state of every byte
+        uint64 const recordEnds[2] = {masks.newline & ~inQuote, masks.newline & inQuote};
+        for (int state = 0; state < 2; ++state) {
+            if (summary.recordStart[state] == CsvChunkSummary::kNoRecordStart && recordEnds[state] != 0) {
+                summary.recordStart[state] = blockStart + static_cast<MemoryView::size_type>(
+                            __builtin_ctzll(recordEnds[state])) + 1;
+            }
+        }
+    }
+
+    summary.oddQuotes = (prevInQuote != 0);
+
+    return summary;
+}
+
+
+void
+Solace::alignCsvChunks(MemoryView document, ArrayView<MemoryView> chunks,
+                       ArrayView<const CsvChunkSummary> summaries) {
+    if (chunks.size() != summaries.size()) {
+        raise<IllegalArgumentException>("summaries");
+    }
+
+    auto const base = document.dataAddress();
+    bool inQuotes = false;
+    for (ArrayView<MemoryView>::size_type i = 0; i < chunks.size(); ++i) {
+        auto const offset = static_cast<MemoryView::size_type>(chunks[i].dataAddress() - base);
+        auto const start = (i == 0) ? 0 : recordStartOf(offset, summaries[i], inQuotes);
+        inQuotes ^= summaries[i].oddQuotes;
+
+        chunks[i] = document.slice(start, start);
+    }
+
+    spanChunks(document, chunks);
+}
+
+
+void
+Solace::splitCsv(MemoryView document, ArrayView<MemoryView> chunks, CsvDialect dialect) noexcept {
+    auto const count = chunks.size();
+    auto const size = document.size();
+    bool inQuotes = false;
+    for (ArrayView<MemoryView>::size_type i = 0; i < count; ++i) {
+        auto const from = (size / count) * i + std::min<MemoryView::size_type>(i, size % count);
+        auto const to = (size / count) * (i + 1) + std::min<MemoryView::size_type>(i + 1, size % count);
+        auto const summary = summarizeCsvChunk(document.slice(from, to), dialect);
+        auto const start = (i == 0) ? 0 : recordStartOf(from, summary, inQuotes);
+        inQuotes ^= summary.oddQuotes;
+
+        chunks[i] = document.slice(start, start);
+    }
+
+    spanChunks(document, chunks);
+}
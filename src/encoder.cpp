@@ -31,3 +31,14 @@ Encoder::encode(ByteReader& src) {
     return encode(src.viewRemaining())
             .then([&src, remaining]() { return src.advance(remaining); });
 }
+
+
+StreamEncoder::~StreamEncoder() = default;
+
+
+Result<void, Error>
+StreamEncoder::update(ByteReader& src) {
+    auto const remaining = src.remaining();
+    return update(src.viewRemaining())
+            .then([&src, remaining]() { return src.advance(remaining); });
+}
@@ -0,0 +1,190 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		encoderPipeline.cpp
+ *	@brief		Implementation of EncoderPipeline
+ *
+ * A block is handed from step to step as a view: the input block itself, and after an encoder the part of
+ * the encoder's buffer written while processing the block. Worst case output size of each encoder is known
+ * up front from maxOutputSize, which is what allows to check all the buffers before a block is touched.
+ ******************************************************************************/
+#include "solace/encoderPipeline.hpp"
+#include "solace/exception.hpp"
+#include "solace/posixErrorDomain.hpp"
+
+#include <algorithm>
+
+
+using namespace Solace;
+
+
+EncoderPipeline&
+EncoderPipeline::tap(hashing::HashingAlgorithm& hash) {
+    if (_stepsCount == kMaxSteps) {
+        raise<OverflowException>("steps", _stepsCount + 1, 0, kMaxSteps);
+    }
+
+    _steps[_stepsCount++] = Step{&hash, nullptr};
+
+    return *this;
+}
+
+
+EncoderPipeline&
+EncoderPipeline::pipe(StreamEncoder& encoder) {
+    if (_stepsCount == kMaxSteps) {
+        raise<OverflowException>("steps", _stepsCount + 1, 0, kMaxSteps);
+    }
+
+    _steps[_stepsCount++] = Step{nullptr, &encoder};
+
+    return *this;
+}
+
+
+bool
+EncoderPipeline::writesIntoDest() const noexcept {
+    for (auto i = _stepsCount; i != 0; --i) {
+        if (_steps[i - 1].encoder) {
+            return (_steps[i - 1].encoder->getDestBuffer() == _dest);
+        }
+    }
+
+    return false;
+}
+
+
+bool
+EncoderPipeline::hasRoomFor(size_type blockSize) const noexcept {
+    auto outputSize = blockSize;
+    for (uint32 i = 0; i < _stepsCount; ++i) {
+        auto const encoder = _steps[i].encoder;
+        if (encoder) {
+            outputSize = encoder->maxOutputSize(outputSize);
+            if (encoder->getDestBuffer()->remaining() < outputSize) {
+                return false;
+            }
+        }
+    }
+
+    return writesIntoDest() || (_dest->remaining() >= outputSize);
+}
+
+
+void
+EncoderPipeline::rewindBuffers() noexcept {
+    for (uint32 i = 0; i < _stepsCount; ++i) {
+        auto const encoder = _steps[i].encoder;
+        if (encoder && encoder->getDestBuffer() != _dest) {
+            encoder->getDestBuffer()->rewind();
+        }
+    }
+}
+
+
+Result<void, Error>
+EncoderPipeline::run(MemoryView data, uint32 firstStep) {
+    for (auto i = firstStep; i < _stepsCount; ++i) {
+        auto const& step = _steps[i];
+        if (step.hash) {
+            step.hash->update(data);
+            continue;
+        }
+
+        auto output = step.encoder->getDestBuffer();
+        auto const mark = output->position();
+        auto result = step.encoder->update(data);
+        if (!result) {
+            return result;
+        }
+
+        data = output->viewWritten().slice(mark, output->position());
+    }
+
+    if (writesIntoDest()) {
+        return Ok();
+    }
+
+    return _dest->write(data);
+}
+
+
+Result<void, Error>
+EncoderPipeline::update(ByteReader& src) {
+    while (src.hasRemaining()) {
+        auto const remaining = src.viewRemaining();
+        auto const block = remaining.slice(0, std::min(_blockSize, remaining.size()));
+        if (!hasRoomFor(block.size())) {
+            return Err(makeError(SystemErrors::Overflow, "EncoderPipeline::update()"));
+        }
+
+        auto result = run(block, 0);
+        rewindBuffers();
+        if (!result) {
+            return result;
+        }
+
+        src.advance(block.size());
+    }
+
+    return Ok();
+}
+
+
+Result<void, Error>
+EncoderPipeline::finish() {
+    // Output of finishing an encoder is passed through the following ones, which are finished after it,
+    // so the output of the whole finish is that of a block of no data.
+    if (!hasRoomFor(0)) {
+        return Err(makeError(SystemErrors::Overflow, "EncoderPipeline::finish()"));
+    }
+
+    for (uint32 i = 0; i < _stepsCount; ++i) {
+        auto const encoder = _steps[i].encoder;
+        if (!encoder) {
+            continue;
+        }
+
+        auto output = encoder->getDestBuffer();
+        auto const mark = output->position();
+        auto result = encoder->finish();
+        if (result) {
+            result = run(output->viewWritten().slice(mark, output->position()), i + 1);
+        }
+
+        if (!result) {
+            rewindBuffers();
+            return result;
+        }
+    }
+
+    rewindBuffers();
+
+    return Ok();
+}
+
+
+void
+EncoderPipeline::reset() noexcept {
+    for (uint32 i = 0; i < _stepsCount; ++i) {
+        if (_steps[i].encoder) {
+            _steps[i].encoder->reset();
+        }
+    }
+
+    rewindBuffers();
+}
@@ -0,0 +1,322 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		format.cpp
+ *	@brief		Implementation of type-safe formatting.
+ ******************************************************************************/
+#include "solace/format.hpp"
+#include "solace/posixErrorDomain.hpp"
+
+#include <algorithm>  // std::copy
+#include <charconv>
+#include <cstring>  // memmove, memset
+
+
+using namespace Solace;
+using namespace Solace::details;
+
+
+namespace /* anonymous */ {
+
+Error makeOverflowError() {
+    return makeError(SystemErrors::Overflow, "formatTo()");
+}
+
+
+void toUpperAscii(char* first, char* last) noexcept {
+    for (; first != last; ++first) {
+        if (*first >= 'a' && *first <= 'z') {
+            *first = static_cast<char>(*first - 'a' + 'A');
+        }
+    }
+}
+
+
+/**
+ * Render integer value in the base requested by the format type.
+ * @return Pointer past the last character written or nullptr if the value does not fit.
+ */
+template<typename T>
+char* renderInteger(char* first, char* last, T value, char type) noexcept {
+    int base = 10;
+    switch (type) {
+    case 'x':
+    case 'X':   base = 16; break;
+    case 'o':   base = 8; break;
+    case 'b':   base = 2; break;
+    default:    break;
+    }
+
+    auto const result = std::to_chars(first, last, value, base);
+    if (result.ec != std::errc{}) {
+        return nullptr;
+    }
+
+    if (type == 'X') {
+        toUpperAscii(first, result.ptr);
+    }
+
+    return result.ptr;
+}
+
+
+/**
+ * Render floating point value according to format type and precision.
+ * With no type and no precision the shortest representation that round-trips is used.
+ * @return Pointer past the last character written or nullptr if the value does not fit.
+ */
+template<typename T>
+char* renderFloat(char* first, char* last, T value, FormatSpec const& spec) noexcept {
+    std::chars_format format = std::chars_format::general;
+    switch (spec.type) {
+    case 'f':
+    case 'F':   format = std::chars_format::fixed; break;
+    case 'e':
+    case 'E':   format = std::chars_format::scientific; break;
+    case 'a':
+    case 'A':   format = std::chars_format::hex; break;
+    default:    break;
+    }
+
+    auto const result = (spec.precision >= 0)
+            ? std::to_chars(first, last, value, format, spec.precision)
+            : (spec.type == 0)
+              ? std::to_chars(first, last, value)
+              : std::to_chars(first, last, value, format);
+
+    if (result.ec != std::errc{}) {
+        return nullptr;
+    }
+
+    if (spec.type == 'F' || spec.type == 'E' || spec.type == 'G' || spec.type == 'A') {
+        toUpperAscii(first, result.ptr);
+    }
+
+    return result.ptr;
+}
+
+}  // anonymous namespace
+
+
+Result<void, Error>
+Solace::formatValue(ByteWriter& dest, FormatSpec const& spec, FormatArg const& arg) {
+    auto remaining = dest.viewRemaining();
+    auto const capacity = remaining.size();
+    char* const first = static_cast<char*>(static_cast<void*>(remaining.dataAddress()));
+    char* const last = first + capacity;
+
+    // Number of leading characters (sign and radix prefix) that zero padding goes after.
+    size_t prefixSize = 0;
+    bool isNumeric = true;
+    char* end = nullptr;
+
+    switch (arg.kind()) {
+    case FormatArgKind::Bool: {
+        StringView const text = arg.asBool() ? StringView{"true"} : StringView{"false"};
+        if (text.size() > capacity) {
+            return Err(makeOverflowError());
+        }
+
+        isNumeric = false;
+        end = std::copy(text.data(), text.data() + text.size(), first);
+    } break;
+
+    case FormatArgKind::Char:
+        if (spec.type == 0 || spec.type == 'c') {
+            if (capacity < 1) {
+                return Err(makeOverflowError());
+            }
+
+            isNumeric = false;
+            *first = arg.asChar();
+            end = first + 1;
+        } else {
+            end = renderInteger(first, last, arg.asInt(), spec.type);
+            prefixSize = (arg.asInt() < 0) ? 1 : 0;
+        }
+        break;
+
+    case FormatArgKind::Int:
+        if (spec.type == 'c') {
+            if (capacity < 1) {
+                return Err(makeOverflowError());
+            }
+
+            isNumeric = false;
+            *first = static_cast<char>(arg.asInt());
+            end = first + 1;
+        } else {
+            end = renderInteger(first, last, arg.asInt(), spec.type);
+            prefixSize = (arg.asInt() < 0) ? 1 : 0;
+        }
+        break;
+
+    case FormatArgKind::Uint:
+        if (spec.type == 'c') {
+            if (capacity < 1) {
+                return Err(makeOverflowError());
+            }
+
+            isNumeric = false;
+            *first = static_cast<char>(arg.asUint());
+            end = first + 1;
+        } else {
+            end = renderInteger(first, last, arg.asUint(), spec.type);
+        }
+        break;
+
+    case FormatArgKind::Float32:
+        end = renderFloat(first, last, arg.asFloat32(), spec);
+        prefixSize = (end && *first == '-') ? 1 : 0;
+        break;
+
+    case FormatArgKind::Float64:
+        end = renderFloat(first, last, arg.asFloat64(), spec);
+        prefixSize = (end && *first == '-') ? 1 : 0;
+        break;
+
+    case FormatArgKind::String: {
+        auto text = arg.asString();
+        if (spec.precision >= 0 && spec.precision < text.size()) {
+            text = text.substring(0, static_cast<StringView::size_type>(spec.precision));
+        }
+
+        if (text.size() > capacity) {
+            return Err(makeOverflowError());
+        }
+
+        isNumeric = false;
+        end = std::copy(text.data(), text.data() + text.size(), first);
+    } break;
+
+    case FormatArgKind::Pointer: {
+        if (capacity < 2) {
+            return Err(makeOverflowError());
+        }
+
+        first[0] = '0';
+        first[1] = 'x';
+        auto const address = reinterpret_cast<uintptr_t>(arg.asPointer());
+        end = renderInteger(first + 2, last, address, 'x');
+        prefixSize = 2;
+    } break;
+
+    default:
+        return Err(makeError(BasicError::InvalidInput, "formatValue()"));
+    }
+
+    if (!end) {
+        return Err(makeOverflowError());
+    }
+
+    size_t const size = static_cast<size_t>(end - first);
+    if (size < spec.width) {
+        size_t const padding = spec.width - size;
+        if (spec.width > capacity) {
+            return Err(makeOverflowError());
+        }
+
+        if (spec.zeroPad && isNumeric && spec.align == FormatSpec::Align::Default) {
+            std::memmove(first + prefixSize + padding, first + prefixSize, size - prefixSize);
+            std::memset(first + prefixSize, '0', padding);
+        } else {
+            auto align = spec.align;
+            if (align == FormatSpec::Align::Default) {
+                align = isNumeric ? FormatSpec::Align::Right : FormatSpec::Align::Left;
+            }
+
+            size_t const leftPadding = (align == FormatSpec::Align::Right)
+                    ? padding
+                    : (align == FormatSpec::Align::Center)
+                      ? padding / 2
+                      : 0;
+
+            std::memmove(first + leftPadding, first, size);
+            std::memset(first, spec.fill, leftPadding);
+            std::memset(first + leftPadding + size, spec.fill, padding - leftPadding);
+        }
+
+        return dest.advance(spec.width);
+    }
+
+    return dest.advance(size);
+}
+
+
+Result<void, Error>
+Solace::formatTo(ByteWriter& dest, StringView fmt,
+                 ArrayView<const FormatField> fields, ArrayView<const FormatArg> args) {
+    auto const startPosition = dest.position();
+
+    for (auto const& field : fields) {
+        auto const literal = fmt.substring(field.literalOffset, field.literalOffset + field.literalLength);
+        auto res = dest.write(literal.view());
+        if (!res) {
+            dest.position(startPosition);
+            return res;
+        }
+
+        if (field.argIndex < 0) {
+            continue;
+        }
+
+        if (static_cast<size_t>(field.argIndex) >= args.size()) {
+            dest.position(startPosition);
+            return Err(makeError(BasicError::InvalidInput, "formatTo(): argument index out of range"));
+        }
+
+        auto formatted = formatValue(dest, field.spec, args[field.argIndex]);
+        if (!formatted) {
+            dest.position(startPosition);
+            return formatted;
+        }
+    }
+
+    return Ok();
+}
+
+
+Result<void, Error>
+Solace::formatTo(ByteWriter& dest, StringView fmt, ArrayView<const FormatArg> args) {
+    auto const startPosition = dest.position();
+    FormatParseState state;
+    FormatField field;
+
+    while (state.position < fmt.size()) {
+        auto const parseError = parseFormatField(fmt.data(), fmt.size(), state, field);
+        if (parseError != FormatParseError::None) {
+            dest.position(startPosition);
+            return Err(makeError(BasicError::InvalidInput, "formatTo(): invalid format string"));
+        }
+
+        if (field.argIndex >= 0 &&
+            (static_cast<size_t>(field.argIndex) >= args.size() ||
+             !isFormatSpecCompatible(args[field.argIndex].kind(), field.spec))) {
+            dest.position(startPosition);
+            return Err(makeError(BasicError::InvalidInput, "formatTo(): argument does not match format"));
+        }
+
+        FormatField const& parsedField = field;
+        auto res = formatTo(dest, fmt, arrayView(&parsedField, 1), args);
+        if (!res) {
+            dest.position(startPosition);
+            return res;
+        }
+    }
+
+    return Ok();
+}
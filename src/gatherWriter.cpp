@@ -0,0 +1,147 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		gatherWriter.cpp
+ *	@brief		Implementation of GatherWriter
+ *
+ * Segments are kept as iovec entries so that the message can be handed to writev as is.
+ * Copied bytes go into the current scratch page, and a copy that lands right after the end
+ * of the last segment just extends it, so runs of small writes form a single segment.
+ ******************************************************************************/
+#include "solace/gatherWriter.hpp"
+#include "solace/posixErrorDomain.hpp"
+
+#include <algorithm>
+#include <cstring>  // memcpy
+
+
+using namespace Solace;
+
+
+namespace /* anonymous */ {
+
+/// Make room for one more element, moving the elements into a twice larger vector if it is full.
+template<typename T>
+void ensureRoom(Vector<T>& vector, MemoryManager& memoryManager) {
+    if (vector.size() < vector.capacity()) {
+        return;
+    }
+
+    auto const newCapacity = std::max<uint32>(4, 2 * vector.capacity());
+    auto grown = makeVector<T>(memoryManager.allocate(newCapacity * sizeof(T)));
+    for (auto& item : vector) {
+        grown.emplace_back(std::move(item));
+    }
+
+    vector = std::move(grown);
+}
+
+}  // anonymous namespace
+
+
+MutableMemoryView
+GatherWriter::reserve() {
+    if (!_pages.empty() && _pageUsed < _pages[_currentPage].size()) {
+        return _pages.view()[_currentPage].view().slice(_pageUsed, _pages[_currentPage].size());
+    }
+
+    if (!_pages.empty()) {
+        _currentPage += 1;
+    }
+    _pageUsed = 0;
+
+    if (_currentPage == _pages.size()) {
+        ensureRoom(_pages, *_memoryManager);
+        _pages.emplace_back(_memoryManager->allocate(_pageSize));
+    }
+
+    return _pages.view()[_currentPage].view();
+}
+
+
+void
+GatherWriter::appendSegment(void* data, size_type size) {
+    if (!_segments.empty()) {
+        auto& last = _segments.view()[_segments.size() - 1];
+        if (static_cast<byte*>(last.iov_base) + last.iov_len == data) {
+            last.iov_len += size;
+            _size += size;
+            return;
+        }
+    }
+
+    ensureRoom(_segments, *_memoryManager);
+    _segments.emplace_back(iovec{data, size});
+    _size += size;
+}
+
+
+GatherWriter&
+GatherWriter::copy(MemoryView data) {
+    while (!data.empty()) {
+        auto dest = reserve();
+        auto const chunkSize = std::min(dest.size(), data.size());
+        std::memcpy(dest.dataAddress(), data.dataAddress(), chunkSize);
+        appendSegment(dest.dataAddress(), chunkSize);
+        _pageUsed += chunkSize;
+
+        data = data.slice(chunkSize, data.size());
+    }
+
+    return *this;
+}
+
+
+GatherWriter&
+GatherWriter::reference(MemoryView data) {
+    if (!data.empty()) {
+        appendSegment(const_cast<byte*>(data.dataAddress()), data.size());
+    }
+
+    return *this;
+}
+
+
+GatherWriter&
+GatherWriter::clear() noexcept {
+    while (!_segments.empty()) {
+        _segments.pop_back();
+    }
+
+    _currentPage = 0;
+    _pageUsed = 0;
+    _size = 0;
+
+    return *this;
+}
+
+
+Result<void, Error>
+GatherWriter::copyTo(ByteWriter& dest) const {
+    if (dest.remaining() < _size) {
+        return Err(makeError(SystemErrors::Overflow, "GatherWriter::copyTo()"));
+    }
+
+    for (auto const& s : _segments) {
+        auto result = dest.write(wrapMemory(s.iov_base, s.iov_len));
+        if (!result) {
+            return result;
+        }
+    }
+
+    return Ok();
+}
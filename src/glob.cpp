@@ -0,0 +1,639 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		glob.cpp
+ *	@brief		Implementation of GlobSet.
+ *
+ * Each pattern is compiled into a chain of states, state i being 'the first i elements of the pattern
+ * have been matched', followed by an accepting state. Chains of all patterns are laid out back-to-back
+ * in one bit set. A byte moves state i to state i + 1 if the element accepts the byte,
+ * or keeps it at i if the element is a star that consumes the byte. Stars also lead to the next state
+ * without consuming input. This is the Shift-And algorithm extended with stars: one step of the automaton
+ * is a shift, two ANDs and an OR per word of states, followed by propagation of the states reachable
+ * without input. Transition masks are stored per byte equivalence class, like in MultiPatternMatcher.
+ ******************************************************************************/
+#include "solace/glob.hpp"
+#include "solace/memoryManager.hpp"
+#include "solace/posixErrorDomain.hpp"
+
+#include <algorithm>    // std::upper_bound, std::fill
+#include <cstring>      // memcmp
+
+
+using namespace Solace;
+
+using PatternId = GlobSet::PatternId;
+
+
+namespace /* anonymous */ {
+
+constexpr byte kSeparator = '/';
+
+/// Sets of states of up to this number of words are kept on stack while matching.
+constexpr uint32 kInlineWords = 32;
+
+
+template<typename T>
+Array<T> makeTable(uint32 size) {
+    return (size == 0)
+            ? makeArray<T>()
+            : makeArray<T>(size);
+}
+
+
+/// Set of byte values.
+struct ByteSet {
+    uint64 bits[4]{};
+
+    void add(byte b) noexcept { bits[b >> 6] |= uint64{1} << (b & 63); }
+    void remove(byte b) noexcept { bits[b >> 6] &= ~(uint64{1} << (b & 63)); }
+    bool contains(byte b) const noexcept { return (bits[b >> 6] >> (b & 63)) & 1; }
+
+    void invert() noexcept {
+        for (auto& word : bits) {
+            word = ~word;
+        }
+    }
+
+    static ByteSet all() noexcept {
+        ByteSet set;
+        set.invert();
+
+        return set;
+    }
+
+    static ByteSet allButSeparator() noexcept {
+        auto set = all();
+        set.remove(kSeparator);
+
+        return set;
+    }
+};
+
+
+/// State of a pattern chain.
+struct StateSpec {
+    ByteSet advance;        //!< Bytes that lead to the next state.
+    ByteSet stay;           //!< Bytes that are consumed without leaving the state.
+    bool    skipOne{false}; //!< Next state is reachable without input.
+    bool    skipTwo{false}; //!< State after the next one is reachable without input.
+};
+
+
+/// Where a required literal must occur in the text.
+enum class Anchor : byte {
+    Anywhere,
+    Start,
+    End,
+    Whole
+};
+
+
+/// Literal that every match of a pattern contains.
+struct RequiredLiteral {
+    StringView  text;
+    Anchor      anchor{Anchor::Anywhere};
+};
+
+
+Error malformedPattern() {
+    return makeError(BasicError::InvalidInput, "makeGlobSet()");
+}
+
+
+/// Parse a character class, position is just past the opening bracket. @return Position past the closing one.
+Result<uint32, Error> parseClass(StringView pattern, uint32 i, ByteSet& set) {
+    auto const n = pattern.size();
+    auto const p = pattern.data();
+
+    bool const negate = (i < n && (p[i] == '!' || p[i] == '^'));
+    i += negate ? 1 : 0;
+
+    // A closing bracket right after the opening one is a member of the class.
+    for (bool first = true; ; first = false) {
+        if (i >= n) {
+            return Err(malformedPattern());
+        }
+
+        if (p[i] == ']' && !first) {
+            i += 1;
+            break;
+        }
+
+        auto low = static_cast<byte>(p[i]);
+        if (p[i] == '\\') {
+            if (++i >= n) {
+                return Err(malformedPattern());
+            }
+            low = static_cast<byte>(p[i]);
+        }
+        i += 1;
+
+        auto high = low;
+        if (i + 1 < n && p[i] == '-' && p[i + 1] != ']') {
+            i += 1;
+            if (p[i] == '\\' && ++i >= n) {
+                return Err(malformedPattern());
+            }
+            high = static_cast<byte>(p[i]);
+            i += 1;
+        }
+
+        for (uint32 b = low; b <= high; ++b) {
+            set.add(static_cast<byte>(b));
+        }
+    }
+
+    if (negate) {
+        set.invert();
+    }
+    set.remove(kSeparator);
+
+    return Ok(i);
+}
+
+
+/**
+ * Parse a pattern calling onState(StateSpec const&) for each of its states except the accepting one.
+ * @return The most selective run of literal characters that any match must contain, or an error.
+ * Literal prefix or suffix of the pattern is preferred to other runs as its position in the text is known.
+ */
+template<typename F>
+Result<RequiredLiteral, Error> parseGlob(StringView pattern, F&& onState) {
+    auto const n = pattern.size();
+    auto const p = pattern.data();
+
+    StringView longest;
+    StringView prefix;
+    StringView suffix;
+    uint32 runStart = 0;
+    uint32 i = 0;
+    auto const endRun = [&]() {
+        if (i == runStart) {
+            return;
+        }
+
+        auto const run = pattern.substring(runStart, i);
+        prefix = (runStart == 0) ? run : prefix;
+        suffix = (i == n) ? run : suffix;
+        longest = (run.size() > longest.size()) ? run : longest;
+    };
+
+    while (i < n) {
+        StateSpec state;
+        auto const c = p[i];
+        if (c == '*') {
+            endRun();
+            uint32 stars = 1;
+            while (i + stars < n && p[i + stars] == '*') {
+                ++stars;
+            }
+
+            bool const startsComponent = (i == 0 || p[i - 1] == static_cast<char>(kSeparator));
+            bool const endsComponent = (i + stars < n && p[i + stars] == static_cast<char>(kSeparator));
+            i += stars;
+
+            if (stars == 1) {
+                state.stay = ByteSet::allButSeparator();
+                state.skipOne = true;
+            } else if (startsComponent && endsComponent) {
+                // "**/": either nothing, or anything that ends with a separator
+                state.advance = ByteSet::all();
+                state.skipTwo = true;
+                onState(state);
+
+                state = StateSpec{};
+                state.advance.add(kSeparator);
+                state.stay = ByteSet::all();
+                i += 1;
+
+                // Repeated "**/" is the same as a single one
+                while (i + 2 < n && p[i] == '*' && p[i + 1] == '*') {
+                    auto end = i + 2;
+                    while (end < n && p[end] == '*') {
+                        ++end;
+                    }
+
+                    if (end == n || p[end] != static_cast<char>(kSeparator)) {
+                        break;
+                    }
+                    i = end + 1;
+                }
+            } else {
+                state.stay = ByteSet::all();
+                state.skipOne = true;
+            }
+            runStart = i;
+        } else if (c == '?') {
+            endRun();
+            state.advance = ByteSet::allButSeparator();
+            runStart = ++i;
+        } else if (c == '[') {
+            endRun();
+            auto end = parseClass(pattern, i + 1, state.advance);
+            if (!end) {
+                return Err(end.moveError());
+            }
+            runStart = i = end.unwrap();
+        } else if (c == '\\') {
+            endRun();
+            if (i + 1 >= n) {
+                return Err(malformedPattern());
+            }
+            state.advance.add(static_cast<byte>(p[i + 1]));
+            runStart = i += 2;
+        } else {
+            state.advance.add(static_cast<byte>(c));
+            i += 1;
+        }
+
+        onState(state);
+    }
+    endRun();
+
+    if (n != 0 && prefix.size() == n) {
+        return Ok(RequiredLiteral{pattern, Anchor::Whole});
+    }
+
+    if (!prefix.empty() || !suffix.empty()) {
+        return Ok((suffix.size() >= prefix.size())
+                  ? RequiredLiteral{suffix, Anchor::End}
+                  : RequiredLiteral{prefix, Anchor::Start});
+    }
+
+    return Ok(RequiredLiteral{longest, Anchor::Anywhere});
+}
+
+
+inline void setBit(uint64* words, uint32 index) noexcept {
+    words[index >> 6] |= uint64{1} << (index & 63);
+}
+
+
+/// Storage for the current and the next set of states of the automaton.
+class StateBuffer {
+public:
+    explicit StateBuffer(uint32 words)
+        : _words{_inline}
+    {
+        if (words > kInlineWords) {
+            _heap = getSystemHeapMemoryManager().allocate(2 * words * sizeof(uint64));
+            _words = reinterpret_cast<uint64*>(_heap.view().dataAddress());
+        }
+
+        std::fill(_words, _words + 2 * words, 0);
+    }
+
+    uint64* states() noexcept { return _words; }
+
+private:
+    uint64          _inline[2 * kInlineWords];
+    MemoryResource  _heap;
+    uint64*         _words;
+};
+
+}  // anonymous namespace
+
+
+void
+GlobSet::startIfPlaced(uint64* states, uint32 literal, MemoryView::size_type offset,
+                       MemoryView::size_type textSize) const noexcept {
+    auto const anchor = static_cast<Anchor>(_literalAnchors[literal]);
+    bool const atStart = (offset == 0);
+    bool const atEnd = (offset + _prefilter.get().patternLength(literal) == textSize);
+
+    if ((anchor == Anchor::Anywhere) ||
+        (anchor == Anchor::Start && atStart) ||
+        (anchor == Anchor::End && atEnd) ||
+        (anchor == Anchor::Whole && atStart && atEnd)) {
+        setBit(states, _patternStart[_literalPatterns[literal]]);
+    }
+}
+
+
+bool
+GlobSet::closure(uint64* states) const noexcept {
+    // Closure of every state is precomputed, so a single pass adds all the states reachable without input.
+    auto const closure = _closure.data();
+    auto const words = _words;
+    uint64 carries[64];
+    std::fill(carries, carries + _maxSkip, 0);
+
+    uint64 any = 0;
+    for (uint32 w = 0; w < words; ++w) {
+        auto const current = states[w];
+        auto reached = current;
+        for (uint32 d = 1; d <= _maxSkip; ++d) {
+            auto const from = current & closure[(d - 1) * words + w];
+            reached |= (from << d) | carries[d - 1];
+            carries[d - 1] = from >> (64 - d);
+        }
+
+        states[w] = reached;
+        any |= reached;
+    }
+
+    return (any != 0);
+}
+
+
+template<typename ForEachChunk>
+void
+GlobSet::run(uint64* states, uint64* next, ForEachChunk&& forEachChunk, MatchCallback callback, void* context) const {
+    if (!closure(states)) {
+        return;
+    }
+
+    auto const transitions = _transitions.data();
+    auto const words = _words;
+    bool alive = true;
+    if (words == 1) {
+        // A few short patterns: the whole set of states fits into a register
+        auto const closure = _closure.data();
+        auto const maxSkip = _maxSkip;
+        auto current = states[0];
+        forEachChunk([&](StringView chunk) {
+            for (auto c : chunk) {
+                auto const row = transitions + 2 * _byteClasses[static_cast<byte>(c)];
+                auto const stepped = ((current & row[0]) << 1) | (current & row[1]);
+
+                current = stepped;
+                for (uint32 d = 1; d <= maxSkip; ++d) {
+                    current |= (stepped & closure[d - 1]) << d;
+                }
+
+                if (current == 0) {  // No pattern can match any more
+                    alive = false;
+                    return false;
+                }
+            }
+
+            return true;
+        });
+        states[0] = current;
+    } else {
+        forEachChunk([&](StringView chunk) {
+            for (auto c : chunk) {
+                auto const row = transitions + 2 * words * _byteClasses[static_cast<byte>(c)];
+                uint64 carry = 0;
+                for (uint32 w = 0; w < words; ++w) {
+                    auto const advanced = states[w] & row[2 * w];
+                    next[w] = (advanced << 1) | carry | (states[w] & row[2 * w + 1]);
+                    carry = advanced >> 63;
+                }
+
+                std::swap(states, next);
+                if (!closure(states)) {  // No pattern can match any more
+                    alive = false;
+                    return false;
+                }
+            }
+
+            return true;
+        });
+    }
+
+    if (!alive) {
+        return;
+    }
+
+    for (uint32 w = 0; w < words; ++w) {
+        auto accepted = states[w] & _finals[w];
+        while (accepted != 0) {
+            auto const state = w * 64 + static_cast<uint32>(__builtin_ctzll(accepted));
+            accepted &= accepted - 1;
+
+            auto const id = static_cast<PatternId>(std::upper_bound(_patternStart.begin(), _patternStart.end(), state)
+                                                   - _patternStart.begin() - 1);
+            if (!callback(context, id)) {
+                return;
+            }
+        }
+    }
+}
+
+
+void
+GlobSet::matchText(StringView text, MatchCallback callback, void* context) const {
+    StateBuffer buffer{_words};
+    auto const states = buffer.states();
+    std::copy(_starts.begin(), _starts.end(), states);
+
+    if (_prefilter.isSome()) {
+        _prefilter.get().scan(text, [this, states, &text](MultiPatternMatcher::PatternId literal,
+                                                          MemoryView::size_type offset) {
+            startIfPlaced(states, literal, offset, text.size());
+        });
+    }
+
+    run(states, states + _words, [text](auto&& onChunk) {
+        onChunk(text);
+    }, callback, context);
+}
+
+
+void
+GlobSet::matchPath(PathView path, MatchCallback callback, void* context) const {
+    StateBuffer buffer{_words};
+    auto const states = buffer.states();
+    std::copy(_starts.begin(), _starts.end(), states);
+
+    if (_prefilter.isSome()) {
+        // Root path is matched as an empty text, so the length of the path can't be used
+        MemoryView::size_type size = 0;
+        for (auto component : path) {
+            size += component.size() + 1;
+        }
+        size -= (size != 0) ? 1 : 0;
+
+        auto onLiteral = [this, states, size](MultiPatternMatcher::PatternId literal, MemoryView::size_type offset) {
+            startIfPlaced(states, literal, offset, size);
+        };
+
+        MultiPatternMatcher::Stream stream{_prefilter.get()};
+        for (PathView::size_type i = 0; i < path.getComponentsCount(); ++i) {
+            if (i != 0) {
+                stream.feed(PathView::Delimiter, onLiteral);
+            }
+            stream.feed(path.getComponent(i), onLiteral);
+        }
+    }
+
+    run(states, states + _words, [path](auto&& onChunk) {
+        for (PathView::size_type i = 0; i < path.getComponentsCount(); ++i) {
+            if (i != 0 && !onChunk(PathView::Delimiter)) {
+                return;
+            }
+
+            if (!onChunk(path.getComponent(i))) {
+                return;
+            }
+        }
+    }, callback, context);
+}
+
+
+bool
+GlobSet::matchesAny(StringView text) const {
+    bool found = false;
+    matchText(text, [](void* context, PatternId) {
+        *static_cast<bool*>(context) = true;
+
+        return false;
+    }, &found);
+
+    return found;
+}
+
+
+bool
+GlobSet::matchesAny(PathView path) const {
+    bool found = false;
+    matchPath(path, [](void* context, PatternId) {
+        *static_cast<bool*>(context) = true;
+
+        return false;
+    }, &found);
+
+    return found;
+}
+
+
+Result<GlobSet, Error>
+Solace::makeGlobSet(ArrayView<const StringView> patterns) {
+    GlobSet globs;
+    auto const patternsCount = patterns.size();
+
+    // Parse patterns to lay out their states and find the literals they require
+    auto literals = makeTable<RequiredLiteral>(patternsCount);
+    globs._patternStart = makeTable<uint32>(patternsCount + 1);
+    uint32 statesCount = 0;
+    uint32 literalsCount = 0;
+    for (PatternId id = 0; id < patternsCount; ++id) {
+        globs._patternStart[id] = statesCount;
+
+        auto literal = parseGlob(patterns[id], [&statesCount](StateSpec const&) { statesCount += 1; });
+        if (!literal) {
+            return Err(literal.moveError());
+        }
+
+        statesCount += 1;  // Accepting state
+        literals[id] = literal.unwrap();
+        literalsCount += literals[id].text.empty() ? 0 : 1;
+    }
+    globs._patternStart[patternsCount] = statesCount;
+
+    auto const words = (statesCount + 63) / 64;
+    auto const rowSize = 2 * words;
+    globs._words = words;
+    globs._finals = makeTable<uint64>(words);
+    globs._starts = makeTable<uint64>(words);
+
+    // Transition rows of every byte value
+    auto rows = makeTable<uint64>(256 * rowSize);
+    auto skips = makeTable<byte>(statesCount);
+    for (PatternId id = 0; id < patternsCount; ++id) {
+        auto state = globs._patternStart[id];
+        parseGlob(patterns[id], [&](StateSpec const& spec) {
+            auto const word = state / 64;
+            auto const bit = uint64{1} << (state % 64);
+            for (uint32 b = 0; b < 256; ++b) {
+                rows[b * rowSize + 2 * word + 0] |= spec.advance.contains(static_cast<byte>(b)) ? bit : 0;
+                rows[b * rowSize + 2 * word + 1] |= spec.stay.contains(static_cast<byte>(b)) ? bit : 0;
+            }
+
+            skips[state] = (spec.skipOne ? 1 : 0) | (spec.skipTwo ? 2 : 0);
+            state += 1;
+        });
+
+        setBit(globs._finals.begin(), state);
+        if (literals[id].text.empty()) {
+            setBit(globs._starts.begin(), globs._patternStart[id]);
+        }
+    }
+
+    // Distances to the states reachable from each state without input, as a bit set. Skips only lead forward.
+    auto distances = makeTable<uint64>(statesCount);
+    uint64 allDistances = 0;
+    for (auto state = statesCount; state-- > 0; ) {
+        distances[state] = 1
+                | (((skips[state] & 1) != 0) ? distances[state + 1] << 1 : 0)
+                | (((skips[state] & 2) != 0) ? distances[state + 2] << 2 : 0);
+        allDistances |= distances[state];
+    }
+
+    if ((allDistances >> 63) != 0) {
+        return Err(makeError(SystemErrors::Overflow, "makeGlobSet()"));
+    }
+
+    globs._maxSkip = 63 - static_cast<uint32>(__builtin_clzll(allDistances | 1));
+    globs._closure = makeTable<uint64>(globs._maxSkip * words);
+    for (uint32 state = 0; state < statesCount; ++state) {
+        for (uint32 d = 1; d <= globs._maxSkip; ++d) {
+            if ((distances[state] >> d) & 1) {
+                setBit(globs._closure.begin() + (d - 1) * words, state);
+            }
+        }
+    }
+
+    // Bytes with identical rows share a class
+    uint32 classesCount = 0;
+    byte representatives[256];
+    for (uint32 b = 0; b < 256; ++b) {
+        auto const row = rows.begin() + b * rowSize;
+        uint32 c = 0;
+        while (c < classesCount &&
+               std::memcmp(row, rows.begin() + representatives[c] * rowSize, rowSize * sizeof(uint64)) != 0) {
+            ++c;
+        }
+
+        if (c == classesCount) {
+            representatives[classesCount++] = static_cast<byte>(b);
+        }
+        globs._byteClasses[b] = static_cast<byte>(c);
+    }
+
+    globs._transitions = makeTable<uint64>(classesCount * rowSize);
+    for (uint32 c = 0; c < classesCount; ++c) {
+        auto const row = rows.begin() + representatives[c] * rowSize;
+        std::copy(row, row + rowSize, globs._transitions.begin() + c * rowSize);
+    }
+
+    // Patterns that require a literal are only started if the literal is found in its place in the text
+    if (literalsCount != 0) {
+        auto required = makeTable<StringView>(literalsCount);
+        globs._literalPatterns = makeTable<PatternId>(literalsCount);
+        globs._literalAnchors = makeTable<byte>(literalsCount);
+        uint32 i = 0;
+        for (PatternId id = 0; id < patternsCount; ++id) {
+            if (!literals[id].text.empty()) {
+                required[i] = literals[id].text;
+                globs._literalPatterns[i] = id;
+                globs._literalAnchors[i] = static_cast<byte>(literals[id].anchor);
+                ++i;
+            }
+        }
+
+        auto prefilter = makeMultiPatternMatcher(required.view());
+        if (!prefilter) {
+            return Err(prefilter.moveError());
+        }
+        globs._prefilter = prefilter.moveResult();
+    }
+
+    return Ok(std::move(globs));
+}
@@ -37,14 +37,8 @@ MessageDigest::MessageDigest(MemoryView viewBytes)
 String
 MessageDigest::toString() const {
     auto stringBuffer = makeVector<char>(Base16Encoder::encodedSize(size()));
-    ByteWriter dest(wrapMemory(stringBuffer.data(), stringBuffer.size()));
+    auto const written = base16Encode(_storage.view().view(), wrapMemory(stringBuffer.data(), stringBuffer.size()))
+            .unwrap();
 
-    auto const dataView = _storage.view().view();
-    for (auto i = base16Encode_begin(dataView),
-         end = base16Encode_end(dataView);
-         i != end; ++i) {
-        dest.write((*i).view());
-    }
-
-    return makeString(stringBuffer.data(), narrow_cast<String::size_type>(stringBuffer.size()));
+    return makeString(stringBuffer.data(), narrow_cast<String::size_type>(written));
 }
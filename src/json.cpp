@@ -0,0 +1,832 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		json.cpp
+ *	@brief		Implementation of the JSON tokenizer.
+ *
+ * Tape format: each entry is a 64 bit word with the token type in the top 8 bits.
+ *  - '{', '[': bits 0-31 - index of the entry after the matching close, bits 32-55 - number of children.
+ *  - '}', ']': index of the matching open entry.
+ *  - '"', 'd' (string, number): offset of the token in the source, followed by an entry with its length.
+ *  - 't', 'f', 'n': literals true, false and null.
+ ******************************************************************************/
+#include "solace/json.hpp"
+#include "solace/utf8.hpp"
+#include "solace/posixErrorDomain.hpp"
+
+#include <algorithm>    // std::min
+#include <cstring>      // memcpy, memset, memcmp
+
+#if defined(__x86_64__)
+#define SOLACE_JSON_SSE2 1
+#include <emmintrin.h>
+#endif
+
+
+using namespace Solace;
+
+
+namespace /* anonymous */ {
+
+constexpr uint64 kPayloadMask = (uint64{1} << 56) - 1;
+constexpr uint64 kMaxCount = 0xFFFFFF;
+
+constexpr uint64 makeEntry(char type, uint64 payload) noexcept {
+    return (static_cast<uint64>(static_cast<byte>(type)) << 56) | payload;
+}
+
+constexpr char entryType(uint64 entry) noexcept {
+    return static_cast<char>(entry >> 56);
+}
+
+constexpr uint64 entryPayload(uint64 entry) noexcept {
+    return entry & kPayloadMask;
+}
+
+
+Error makeTypeError() {
+    return makeError(BasicError::InvalidInput, "JsonValue");
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Stage 1: structural index
+//----------------------------------------------------------------------------------------------------------------------
+
+constexpr size_t kBlockSize = 64;
+
+/// Character classes of a 64 byte block, one bit per byte.
+struct BlockMasks {
+    uint64 quote;
+    uint64 backslash;
+    uint64 structural;      // One of {}[]:,
+    uint64 whitespace;
+    uint64 control;         // Bytes below 0x20
+};
+
+
+#ifdef SOLACE_JSON_SSE2
+
+inline uint64 movemask(__m128i v, int shift) noexcept {
+    return static_cast<uint64>(static_cast<uint32>(_mm_movemask_epi8(v))) << shift;
+}
+
+BlockMasks classifyBlock(byte const* block) noexcept {
+    BlockMasks masks{0, 0, 0, 0, 0};
+    for (int k = 0; k < 4; ++k) {
+        auto const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(block + 16*k));
+        auto const eq = [v](char c) { return _mm_cmpeq_epi8(v, _mm_set1_epi8(c)); };
+
+        auto const structural = _mm_or_si128(_mm_or_si128(_mm_or_si128(eq('{'), eq('}')),
+                                                          _mm_or_si128(eq('['), eq(']'))),
+                                             _mm_or_si128(eq(':'), eq(',')));
+        auto const whitespace = _mm_or_si128(_mm_or_si128(eq(' '), eq('\t')),
+                                             _mm_or_si128(eq('\n'), eq('\r')));
+        // Unsigned v <= 0x1F
+        auto const control = _mm_cmpeq_epi8(_mm_max_epu8(v, _mm_set1_epi8(0x1F)), _mm_set1_epi8(0x1F));
+
+        masks.quote |= movemask(eq('"'), 16*k);
+        masks.backslash |= movemask(eq('\\'), 16*k);
+        masks.structural |= movemask(structural, 16*k);
+        masks.whitespace |= movemask(whitespace, 16*k);
+        masks.control |= movemask(control, 16*k);
+    }
+
+    return masks;
+}
+
+#else
+
+BlockMasks classifyBlock(byte const* block) noexcept {
+    BlockMasks masks{0, 0, 0, 0, 0};
+    for (size_t k = 0; k < kBlockSize; ++k) {
+        uint64 const bit = uint64{1} << k;
+        switch (block[k]) {
+        case '"':   masks.quote |= bit; break;
+        case '\\':  masks.backslash |= bit; break;
+        case '{': case '}': case '[': case ']': case ':': case ',':
+            masks.structural |= bit;
+            break;
+        case ' ': case '\t': case '\n': case '\r':
+            masks.whitespace |= bit;
+            break;
+        default:
+            break;
+        }
+
+        if (block[k] < 0x20) {
+            masks.control |= bit;
+        }
+    }
+
+    return masks;
+}
+
+#endif
+
+
+/**
+ * Find characters escaped by backslashes: a character is escaped if it is preceded by an odd-length
+ * sequence of backslashes. @param prevEscaped Carries the escape state over block boundaries.
+ */
+inline uint64 findEscaped(uint64 backslash, uint64& prevEscaped) noexcept {
+    constexpr uint64 kEvenBits = 0x5555555555555555ULL;
+
+    backslash &= ~prevEscaped;
+    uint64 const followsEscape = (backslash << 1) | prevEscaped;
+    uint64 const oddSequenceStarts = backslash & ~kEvenBits & ~followsEscape;
+
+    uint64 sequencesStartingOnEvenBits;
+    prevEscaped = __builtin_add_overflow(oddSequenceStarts, backslash, &sequencesStartingOnEvenBits) ? 1 : 0;
+    uint64 const invertMask = sequencesStartingOnEvenBits << 1;
+
+    return (kEvenBits ^ invertMask) & followsEscape;
+}
+
+
+/// Prefix XOR: bit i of the result is the parity of bits 0..i of the argument.
+inline uint64 prefixXor(uint64 bits) noexcept {
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+
+    return bits;
+}
+
+
+/**
+ * Collect offsets of all structural characters, opening quotes of strings and starts of other scalars.
+ * @return Number of offsets collected or an error.
+ */
+Result<uint32, JsonError>
+findStructurals(byte const* data, size_t size, uint32* indexes) {
+    uint64 prevEscaped = 0;
+    uint64 prevInString = 0;
+    uint64 prevScalar = 0;
+    uint32 count = 0;
+    size_t lastQuote = 0;
+
+    for (size_t blockStart = 0; blockStart < size; blockStart += kBlockSize) {
+        auto const blockLength = std::min(kBlockSize, size - blockStart);
+
+        BlockMasks masks;
+        if (blockLength == kBlockSize) {
+            masks = classifyBlock(data + blockStart);
+        } else {  // Pad the last block with whitespace
+            byte tail[kBlockSize];
+            std::memset(tail, ' ', kBlockSize);
+            std::memcpy(tail, data + blockStart, blockLength);
+            masks = classifyBlock(tail);
+        }
+
+        auto const escaped = findEscaped(masks.backslash, prevEscaped);
+        auto const quote = masks.quote & ~escaped;
+        auto const inString = prefixXor(quote) ^ prevInString;
+        prevInString = static_cast<uint64>(static_cast<int64>(inString) >> 63);
+
+        if (quote != 0) {
+            lastQuote = blockStart + static_cast<size_t>(63 - __builtin_clzll(quote));
+        }
+
+        // Control characters are only allowed outside of strings, as whitespace.
+        auto const badControl = masks.control & (inString | ~masks.whitespace);
+        if (badControl != 0) {
+            return Err(JsonError{JsonError::Kind::Syntax,
+                                 blockStart + static_cast<size_t>(__builtin_ctzll(badControl))});
+        }
+
+        auto const scalar = ~(masks.structural | masks.whitespace | quote | inString);
+        auto const scalarStart = scalar & ~((scalar << 1) | prevScalar);
+        prevScalar = scalar >> 63;
+
+        auto bits = (masks.structural & ~inString) | (quote & inString) | scalarStart;
+        while (bits != 0) {
+            indexes[count++] = static_cast<uint32>(blockStart + static_cast<size_t>(__builtin_ctzll(bits)));
+            bits &= bits - 1;
+        }
+    }
+
+    if (prevInString != 0) {
+        return Err(JsonError{JsonError::Kind::UnclosedString, lastQuote});
+    }
+
+    return Ok(count);
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// Stage 2: tape
+//----------------------------------------------------------------------------------------------------------------------
+
+constexpr bool isDigit(byte c) noexcept {
+    return (c >= '0' && c <= '9');
+}
+
+constexpr bool isScalarEnd(byte c) noexcept {
+    return (c == ' ' || c == '\t' || c == '\n' || c == '\r' ||
+            c == ',' || c == ':' || c == '[' || c == ']' || c == '{' || c == '}' || c == '"');
+}
+
+
+/// Check that the token is a number according to JSON grammar: -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+bool isValidNumber(byte const* p, byte const* last) noexcept {
+    if (p != last && *p == '-') {
+        ++p;
+    }
+
+    if (p == last) {
+        return false;
+    }
+
+    if (*p == '0') {
+        ++p;
+    } else if (isDigit(*p)) {
+        while (p != last && isDigit(*p)) {
+            ++p;
+        }
+    } else {
+        return false;
+    }
+
+    if (p != last && *p == '.') {
+        ++p;
+        if (p == last || !isDigit(*p)) {
+            return false;
+        }
+
+        while (p != last && isDigit(*p)) {
+            ++p;
+        }
+    }
+
+    if (p != last && (*p == 'e' || *p == 'E')) {
+        ++p;
+        if (p != last && (*p == '+' || *p == '-')) {
+            ++p;
+        }
+
+        if (p == last || !isDigit(*p)) {
+            return false;
+        }
+
+        while (p != last && isDigit(*p)) {
+            ++p;
+        }
+    }
+
+    return (p == last);
+}
+
+
+class TapeBuilder {
+public:
+
+    TapeBuilder(byte const* data, size_t size, uint32 const* indexes, uint32 indexesCount, uint64* tape) noexcept
+        : _data{data}
+        , _size{size}
+        , _indexes{indexes}
+        , _indexesCount{indexesCount}
+        , _tape{tape}
+    {}
+
+    Result<uint32, JsonError> build();
+
+private:
+
+    enum class Expect {
+        Value,
+        FirstElement,       // Value or ']'
+        NextElement,        // ',' or ']'
+        FirstKey,           // String or '}'
+        Key,
+        Colon,
+        NextMember          // ',' or '}'
+    };
+
+    struct Frame {
+        uint32  openEntry;
+        uint32  count;
+        bool    isObject;
+    };
+
+    JsonError syntaxError(size_t offset) const noexcept {
+        return JsonError{JsonError::Kind::Syntax, offset};
+    }
+
+    /// Offset of the end of the token that starts at the given index.
+    size_t scalarEnd(size_t offset) const noexcept {
+        while (offset < _size && !isScalarEnd(_data[offset])) {
+            ++offset;
+        }
+
+        return offset;
+    }
+
+    /// Record a string that starts at the given structural index.
+    void writeString(uint32 index) noexcept {
+        auto const start = _indexes[index] + 1;
+        size_t end = (index + 1 < _indexesCount) ? _indexes[index + 1] : _size;
+        // Only whitespace may separate the closing quote from the next token.
+        do {
+            --end;
+        } while (_data[end] != '"');
+
+        _tape[_tapeSize++] = makeEntry('"', start);
+        _tape[_tapeSize++] = end - start;
+    }
+
+    Result<void, JsonError> writeScalar(uint32 index) noexcept;
+
+    byte const*     _data;
+    size_t          _size;
+    uint32 const*   _indexes;
+    uint32          _indexesCount;
+    uint64*         _tape;
+    uint32          _tapeSize{0};
+};
+
+
+Result<void, JsonError>
+TapeBuilder::writeScalar(uint32 index) noexcept {
+    auto const offset = _indexes[index];
+    auto const end = scalarEnd(offset);
+    auto const length = end - offset;
+
+    auto isLiteral = [this, offset, length](char const* literal, size_t literalLength) {
+        return (length == literalLength) && std::memcmp(_data + offset, literal, literalLength) == 0;
+    };
+
+    switch (_data[offset]) {
+    case 't':
+        if (!isLiteral("true", 4)) {
+            return Err(syntaxError(offset));
+        }
+        _tape[_tapeSize++] = makeEntry('t', 0);
+        break;
+    case 'f':
+        if (!isLiteral("false", 5)) {
+            return Err(syntaxError(offset));
+        }
+        _tape[_tapeSize++] = makeEntry('f', 0);
+        break;
+    case 'n':
+        if (!isLiteral("null", 4)) {
+            return Err(syntaxError(offset));
+        }
+        _tape[_tapeSize++] = makeEntry('n', 0);
+        break;
+    default:
+        if (!isValidNumber(_data + offset, _data + end)) {
+            return Err(syntaxError(offset));
+        }
+        _tape[_tapeSize++] = makeEntry('d', offset);
+        _tape[_tapeSize++] = length;
+        break;
+    }
+
+    return Ok();
+}
+
+
+Result<uint32, JsonError>
+TapeBuilder::build() {
+    if (_indexesCount == 0) {
+        return Err(syntaxError(_size));
+    }
+
+    Frame stack[JsonDocument::kMaxDepth];
+    uint32 depth = 0;
+    auto expect = Expect::Value;
+
+    auto closeContainer = [this, &stack, &depth]() {
+        auto const& frame = stack[--depth];
+        _tape[frame.openEntry] = makeEntry(frame.isObject ? '{' : '[',
+                                           (std::min<uint64>(frame.count, kMaxCount) << 32) | (_tapeSize + 1));
+        _tape[_tapeSize++] = makeEntry(frame.isObject ? '}' : ']', frame.openEntry);
+    };
+
+    for (uint32 i = 0; i < _indexesCount; ++i) {
+        auto const offset = _indexes[i];
+        auto const c = _data[offset];
+
+        switch (expect) {
+        case Expect::FirstElement:
+            if (c == ']') {
+                closeContainer();
+                break;
+            }
+            [[fallthrough]];
+
+        case Expect::Value:
+            if (depth > 0 && !stack[depth - 1].isObject) {
+                stack[depth - 1].count += 1;
+            }
+
+            if (c == '{' || c == '[') {
+                if (depth == JsonDocument::kMaxDepth) {
+                    return Err(JsonError{JsonError::Kind::DepthLimit, offset});
+                }
+
+                stack[depth++] = Frame{_tapeSize, 0, (c == '{')};
+                _tape[_tapeSize++] = 0;
+                expect = (c == '{') ? Expect::FirstKey : Expect::FirstElement;
+                continue;
+            }
+
+            if (c == '"') {
+                writeString(i);
+            } else if (c == ',' || c == ':' || c == ']' || c == '}') {
+                return Err(syntaxError(offset));
+            } else {
+                auto result = writeScalar(i);
+                if (!result) {
+                    return Err(result.moveError());
+                }
+            }
+            break;
+
+        case Expect::NextElement:
+            if (c == ',') {
+                expect = Expect::Value;
+                continue;
+            }
+
+            if (c != ']') {
+                return Err(syntaxError(offset));
+            }
+            closeContainer();
+            break;
+
+        case Expect::FirstKey:
+            if (c == '}') {
+                closeContainer();
+                break;
+            }
+            [[fallthrough]];
+
+        case Expect::Key:
+            if (c != '"') {
+                return Err(syntaxError(offset));
+            }
+
+            stack[depth - 1].count += 1;
+            writeString(i);
+            expect = Expect::Colon;
+            continue;
+
+        case Expect::Colon:
+            if (c != ':') {
+                return Err(syntaxError(offset));
+            }
+
+            expect = Expect::Value;
+            continue;
+
+        case Expect::NextMember:
+            if (c == ',') {
+                expect = Expect::Key;
+                continue;
+            }
+
+            if (c != '}') {
+                return Err(syntaxError(offset));
+            }
+            closeContainer();
+            break;
+        }
+
+        // A value has been completed
+        if (depth == 0) {
+            if (i + 1 != _indexesCount) {
+                return Err(syntaxError(_indexes[i + 1]));
+            }
+
+            return Ok(_tapeSize);
+        }
+
+        expect = stack[depth - 1].isObject ? Expect::NextMember : Expect::NextElement;
+    }
+
+    return Err(syntaxError(_size));
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// String decoding
+//----------------------------------------------------------------------------------------------------------------------
+
+int hexValue(byte c) noexcept {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+
+    return -1;
+}
+
+
+/// Parse 4 hex digits of \\u escape. @return Code unit or -1 if the digits are invalid.
+int32 parseHex4(byte const* p, byte const* last) noexcept {
+    if (last - p < 4) {
+        return -1;
+    }
+
+    int32 value = 0;
+    for (int k = 0; k < 4; ++k) {
+        auto const digit = hexValue(p[k]);
+        if (digit < 0) {
+            return -1;
+        }
+        value = (value << 4) | digit;
+    }
+
+    return value;
+}
+
+}  // anonymous namespace
+
+
+Error
+JsonError::toError() const noexcept {
+    switch (kind) {
+    case Kind::InvalidUtf8:
+        return makeError(SystemErrors::ILSEQ, "parseJson()");
+    case Kind::DepthLimit:
+    case Kind::TooLarge:
+        return makeError(SystemErrors::Overflow, "parseJson()");
+    default:
+        return makeError(BasicError::InvalidInput, "parseJson()");
+    }
+}
+
+
+Result<JsonDocument, JsonError>
+Solace::parseJson(MemoryView source) {
+    auto const size = source.size();
+    if (size > JsonDocument::kMaxSize) {
+        return Err(JsonError{JsonError::Kind::TooLarge, 0});
+    }
+
+    auto isValid = validateUtf8(source);
+    if (!isValid) {
+        return Err(JsonError{JsonError::Kind::InvalidUtf8, isValid.getError().offset});
+    }
+
+    auto const data = source.dataAddress();
+    auto indexes = makeArray<uint32>(static_cast<uint32>(size) + 1);
+    auto indexesCount = findStructurals(data, size, indexes.begin());
+    if (!indexesCount) {
+        return Err(indexesCount.moveError());
+    }
+
+    // Every token produces at most 2 tape entries
+    auto tape = makeArray<uint64>(2 * indexesCount.unwrap() + 1);
+    TapeBuilder builder{data, size, indexes.begin(), indexesCount.unwrap(), tape.begin()};
+    auto tapeSize = builder.build();
+    if (!tapeSize) {
+        return Err(tapeSize.moveError());
+    }
+
+    return Ok(JsonDocument{source, std::move(tape), tapeSize.unwrap()});
+}
+
+
+JsonType
+JsonValue::type() const noexcept {
+    switch (entryType(_document->_tape[_index])) {
+    case 't':
+    case 'f':   return JsonType::Boolean;
+    case 'd':   return JsonType::Number;
+    case '"':   return JsonType::String;
+    case '[':   return JsonType::Array;
+    case '{':   return JsonType::Object;
+    default:    return JsonType::Null;
+    }
+}
+
+
+bool
+JsonValue::isContainerEnd(uint32 index) const noexcept {
+    auto const type = entryType(_document->_tape[index]);
+
+    return (type == ']' || type == '}');
+}
+
+
+uint32
+JsonValue::nextSibling(uint32 index) const noexcept {
+    auto const entry = _document->_tape[index];
+    switch (entryType(entry)) {
+    case '"':
+    case 'd':
+        return index + 2;
+    case '[':
+    case '{':
+        return static_cast<uint32>(entry & 0xFFFFFFFF);
+    default:
+        return index + 1;
+    }
+}
+
+
+Result<bool, Error>
+JsonValue::getBool() const {
+    switch (entryType(_document->_tape[_index])) {
+    case 't':   return Ok(true);
+    case 'f':   return Ok(false);
+    default:    return Err(makeTypeError());
+    }
+}
+
+
+Result<StringView, Error>
+JsonValue::numberToken() const {
+    auto const entry = _document->_tape[_index];
+    if (entryType(entry) != 'd') {
+        return Err(makeTypeError());
+    }
+
+    auto const length = _document->_tape[_index + 1];
+    if (length > 0xFFFF) {  // Can't possibly be a representable number
+        return Err(makeError(GenericError::RANGE, "JsonValue"));
+    }
+
+    return Ok(StringView{reinterpret_cast<char const*>(_document->_source.dataAddress() + entryPayload(entry)),
+                         static_cast<StringView::size_type>(length)});
+}
+
+
+Result<StringView, Error>
+JsonValue::getRawString() const {
+    auto const entry = _document->_tape[_index];
+    if (entryType(entry) != '"') {
+        return Err(makeTypeError());
+    }
+
+    auto const length = _document->_tape[_index + 1];
+    if (length > 0xFFFF) {
+        return Err(makeError(SystemErrors::Overflow, "JsonValue"));
+    }
+
+    return Ok(StringView{reinterpret_cast<char const*>(_document->_source.dataAddress() + entryPayload(entry)),
+                         static_cast<StringView::size_type>(length)});
+}
+
+
+bool
+JsonValue::hasEscapes() const noexcept {
+    auto const entry = _document->_tape[_index];
+    if (entryType(entry) != '"') {
+        return false;
+    }
+
+    auto const first = _document->_source.dataAddress() + entryPayload(entry);
+
+    return std::memchr(first, '\\', _document->_tape[_index + 1]) != nullptr;
+}
+
+
+Result<void, Error>
+JsonValue::decodeString(ByteWriter& dest) const {
+    auto const entry = _document->_tape[_index];
+    if (entryType(entry) != '"') {
+        return Err(makeTypeError());
+    }
+
+    auto p = _document->_source.dataAddress() + entryPayload(entry);
+    auto const last = p + _document->_tape[_index + 1];
+    auto const startPosition = dest.position();
+    auto fail = [&dest, startPosition](Error&& e) -> Result<void, Error> {
+        dest.position(startPosition);
+
+        return Err(std::move(e));
+    };
+
+    while (p != last) {
+        auto const escape = static_cast<byte const*>(std::memchr(p, '\\', static_cast<size_t>(last - p)));
+        auto const runEnd = (escape != nullptr) ? escape : last;
+        auto written = dest.write(wrapMemory(p, static_cast<MemoryView::size_type>(runEnd - p)));
+        if (!written) {
+            return fail(written.moveError());
+        }
+
+        p = runEnd;
+        if (p == last) {
+            break;
+        }
+
+        // Decode escape sequence
+        if (last - p < 2) {
+            return fail(makeError(BasicError::InvalidInput, "decodeString()"));
+        }
+
+        char decoded = 0;
+        switch (p[1]) {
+        case '"':   decoded = '"'; break;
+        case '\\':  decoded = '\\'; break;
+        case '/':   decoded = '/'; break;
+        case 'b':   decoded = '\b'; break;
+        case 'f':   decoded = '\f'; break;
+        case 'n':   decoded = '\n'; break;
+        case 'r':   decoded = '\r'; break;
+        case 't':   decoded = '\t'; break;
+        case 'u': {
+            auto codePoint = parseHex4(p + 2, last);
+            p += 6;
+            if (codePoint < 0 || (codePoint >= 0xDC00 && codePoint <= 0xDFFF)) {
+                return fail(makeError(BasicError::InvalidInput, "decodeString()"));
+            }
+
+            if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {  // Surrogate pair
+                auto const low = (last - p >= 2 && p[0] == '\\' && p[1] == 'u') ? parseHex4(p + 2, last) : -1;
+                if (low < 0xDC00 || low > 0xDFFF) {
+                    return fail(makeError(BasicError::InvalidInput, "decodeString()"));
+                }
+
+                codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                p += 6;
+            }
+
+            char32_t const unit[] = {static_cast<char32_t>(codePoint)};
+            auto encoded = utf32ToUtf8(arrayView(unit), dest);
+            if (!encoded) {
+                return fail(encoded.getError().toError());
+            }
+        } continue;
+        default:
+            return fail(makeError(BasicError::InvalidInput, "decodeString()"));
+        }
+
+        auto written2 = dest.write(decoded);
+        if (!written2) {
+            return fail(written2.moveError());
+        }
+        p += 2;
+    }
+
+    return Ok();
+}
+
+
+JsonValue::size_type
+JsonValue::size() const noexcept {
+    auto const entry = _document->_tape[_index];
+    switch (entryType(entry)) {
+    case '[':
+    case '{':
+        return static_cast<size_type>((entry >> 32) & kMaxCount);
+    default:
+        return 0;
+    }
+}
+
+
+Optional<JsonValue>
+JsonValue::at(size_type index) const noexcept {
+    if (!isArray()) {
+        return none;
+    }
+
+    for (auto i = _index + 1; !isContainerEnd(i); i = nextSibling(i)) {
+        if (index-- == 0) {
+            return Optional<JsonValue>{JsonValue{_document, i}};
+        }
+    }
+
+    return none;
+}
+
+
+Optional<JsonValue>
+JsonValue::find(StringView key) const noexcept {
+    if (!isObject()) {
+        return none;
+    }
+
+    for (auto i = _index + 1; !isContainerEnd(i); i = nextSibling(i + 2)) {
+        auto const keyEntry = _document->_tape[i];
+        auto const keyLength = _document->_tape[i + 1];
+        if (keyLength == key.size() &&
+            std::memcmp(_document->_source.dataAddress() + entryPayload(keyEntry), key.data(), key.size()) == 0) {
+            return Optional<JsonValue>{JsonValue{_document, i + 2}};
+        }
+    }
+
+    return none;
+}
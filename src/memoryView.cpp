@@ -22,6 +22,7 @@
  *	ID:			$Id$
  ******************************************************************************/
 #include "solace/memoryView.hpp"
+#include "solace/cpuFeatures.hpp"
 #include "solace/exception.hpp"
 
 #include "solace/error.hpp"
@@ -29,17 +30,116 @@
 
 #include <sys/mman.h>  // mlock/munlock
 
+#if defined(__x86_64__)
+#define SOLACE_MEMORYVIEW_X86 1
+#include <immintrin.h>
+#endif
+
 
 using namespace Solace;
 
 
 constexpr int kOne = 1;
 
+
+namespace /* anonymous */ {
+
+template<typename T>
+void swapScalar(byte* dest, byte const* src, uint64 count) noexcept {
+    for (uint64 i = 0; i < count; ++i) {
+        T value;
+        std::memcpy(&value, src + i * sizeof(T), sizeof(T));
+        value = byteSwapped(value);
+        std::memcpy(dest + i * sizeof(T), &value, sizeof(T));
+    }
+}
+
+
+#ifdef SOLACE_MEMORYVIEW_X86
+
+/// Shuffle that reverses bytes of each value of the given size in 16 bytes.
+__attribute__((target("ssse3")))
+__m128i swapShuffle(uint64 elementSize) noexcept {
+    switch (elementSize) {
+    case 2:  return _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    case 4:  return _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+    default: return _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    }
+}
+
+
+/// Swap bytes of values in whole blocks of 16 bytes. @return Number of bytes processed.
+__attribute__((target("ssse3")))
+uint64 swapSsse3(byte* dest, byte const* src, uint64 size, uint64 elementSize) noexcept {
+    auto const shuffle = swapShuffle(elementSize);
+
+    uint64 i = 0;
+    for (; i + 16 <= size; i += 16) {
+        auto const chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), _mm_shuffle_epi8(chunk, shuffle));
+    }
+
+    return i;
+}
+
+
+/// Swap bytes of values in whole blocks of 64 bytes. @return Number of bytes processed.
+__attribute__((target("avx2")))
+uint64 swapAvx2(byte* dest, byte const* src, uint64 size, uint64 elementSize) noexcept {
+    auto const shuffle = _mm256_broadcastsi128_si256(swapShuffle(elementSize));
+
+    uint64 i = 0;
+    for (; i + 64 <= size; i += 64) {
+        auto const a = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + i));
+        auto const b = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + i + 32));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i), _mm256_shuffle_epi8(a, shuffle));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i + 32), _mm256_shuffle_epi8(b, shuffle));
+    }
+
+    return i;
+}
+
+#endif  // SOLACE_MEMORYVIEW_X86
+
+}  // anonymous namespace
+
 bool Solace::isBigendian() noexcept {
     return *reinterpret_cast<const char*>(&kOne) == 0;
 }
 
 
+void
+Solace::copySwappingBytes(void* dest, void const* src, uint64 count, uint64 elementSize) noexcept {
+    auto out = static_cast<byte*>(dest);
+    auto in = static_cast<byte const*>(src);
+    auto const size = count * elementSize;
+    if (size == 0) {
+        return;
+    }
+    if (elementSize < 2) {
+        std::memcpy(out, in, size);
+        return;
+    }
+
+    uint64 i = 0;
+#ifdef SOLACE_MEMORYVIEW_X86
+    if (cpu::hasAvx2()) {
+        i = swapAvx2(out, in, size, elementSize);
+    }
+    if (cpu::hasSsse3()) {
+        i += swapSsse3(out + i, in + i, size - i, elementSize);
+    }
+#endif
+
+    auto const rest = (size - i) / elementSize;
+    switch (elementSize) {
+    case 2:  swapScalar<uint16>(out + i, in + i, rest); break;
+    case 4:  swapScalar<uint32>(out + i, in + i, rest); break;
+    default: swapScalar<uint64>(out + i, in + i, rest); break;
+    }
+}
+
+
 MemoryView::MemoryView(const void* data, size_type newSize) :
     _size(newSize),
     _dataAddress(reinterpret_cast<const value_type*>(data))
@@ -0,0 +1,473 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		multiPatternMatcher.cpp
+ *	@brief		Implementation of the multi-pattern matcher.
+ *
+ * The automaton is a fully resolved DFA: failure transitions are folded into the transition table
+ * at build time so that the scan loop is a single table lookup per byte. Bytes that do not occur in
+ * any pattern share one equivalence class, which keeps rows short. States are renumbered so that
+ * all accepting states come last: a single comparison per byte detects a match.
+ *
+ * The prefilter follows the Teddy algorithm from Hyperscan: up to 3 leading bytes of each pattern are
+ * split into nibbles that index 16-byte masks with PSHUFB, yielding a bit set of patterns that may start
+ * at every position of a 16-byte block. Candidates are then verified by direct comparison.
+ ******************************************************************************/
+#include "solace/multiPatternMatcher.hpp"
+#include "solace/cpuFeatures.hpp"
+#include "solace/posixErrorDomain.hpp"
+
+#include <algorithm>    // std::sort, std::min
+#include <cstring>      // memcmp
+#include <limits>
+
+#if defined(__x86_64__)
+#define SOLACE_MATCHER_X86 1
+#include <immintrin.h>
+#endif
+
+
+using namespace Solace;
+
+using PatternId = MultiPatternMatcher::PatternId;
+using size_type = MultiPatternMatcher::size_type;
+using MatchCallback = bool (*)(void* context, PatternId id, size_type offset);
+
+
+namespace /* anonymous */ {
+
+constexpr uint32 kNone = std::numeric_limits<uint32>::max();
+constexpr uint32 kStopped = std::numeric_limits<uint32>::max();
+
+
+template<typename T>
+Array<T> makeTable(uint32 size) {
+    return (size == 0)
+            ? makeArray<T>()
+            : makeArray<T>(size);
+}
+
+
+/// Length of the common prefix of two strings.
+uint32 commonPrefixLength(StringView a, StringView b) noexcept {
+    auto const n = std::min(a.size(), b.size());
+    uint32 i = 0;
+    while (i < n && a.data()[i] == b.data()[i]) {
+        ++i;
+    }
+
+    return i;
+}
+
+
+/// Number of distinct prefixes of the patterns, including the empty one, which is the number of trie nodes.
+uint32 countTrieNodes(ArrayView<const StringView> patterns) {
+    auto order = makeTable<uint32>(patterns.size());
+    for (uint32 i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+
+    std::sort(order.begin(), order.end(), [&patterns](uint32 lhs, uint32 rhs) {
+        auto const& a = patterns[lhs];
+        auto const& b = patterns[rhs];
+
+        return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end(),
+                                            [](char x, char y) {
+            return static_cast<byte>(x) < static_cast<byte>(y);
+        });
+    });
+
+    uint32 count = 1;
+    for (uint32 i = 0; i < order.size(); ++i) {
+        auto const& pattern = patterns[order[i]];
+        count += pattern.size();
+        if (i > 0) {
+            count -= commonPrefixLength(pattern, patterns[order[i - 1]]);
+        }
+    }
+
+    return count;
+}
+
+
+#ifdef SOLACE_MATCHER_X86
+
+/// Pattern data required to verify prefilter candidates.
+struct PrefilterPatterns {
+    byte const*                     masks;
+    uint32                          fingerprintLength;
+    char const*                     data;
+    uint32 const*                   offsets;
+    StringView::size_type const*    lengths;
+    uint32                          count;
+};
+
+
+/// Report patterns from the candidate set that occur at the given position.
+bool verifyCandidates(PrefilterPatterns const& patterns, byte const* text, size_t size, size_t position,
+                      uint32 candidates, MatchCallback callback, void* context) {
+    while (candidates != 0) {
+        auto const id = static_cast<PatternId>(__builtin_ctz(candidates));
+        candidates &= candidates - 1;
+
+        auto const length = patterns.lengths[id];
+        if (position + length <= size &&
+            std::memcmp(text + position, patterns.data + patterns.offsets[id], length) == 0) {
+            if (!callback(context, id, position)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+__attribute__((target("ssse3")))
+bool scanTeddySsse3(PrefilterPatterns const& patterns, byte const* text, size_t size,
+                    MatchCallback callback, void* context) {
+    constexpr size_t kBlockSize = sizeof(__m128i);
+    auto const fingerprintLength = patterns.fingerprintLength;
+    auto const lowNibble = _mm_set1_epi8(0x0F);
+
+    __m128i lowMasks[3];
+    __m128i highMasks[3];
+    for (uint32 j = 0; j < fingerprintLength; ++j) {
+        lowMasks[j] = _mm_loadu_si128(reinterpret_cast<__m128i const*>(patterns.masks + (2*j + 0) * kBlockSize));
+        highMasks[j] = _mm_loadu_si128(reinterpret_cast<__m128i const*>(patterns.masks + (2*j + 1) * kBlockSize));
+    }
+
+    size_t i = 0;
+    for (; i + kBlockSize + fingerprintLength - 1 <= size; i += kBlockSize) {
+        auto candidates = _mm_set1_epi8(static_cast<char>(0xFF));
+        for (uint32 j = 0; j < fingerprintLength; ++j) {
+            auto const v = _mm_loadu_si128(reinterpret_cast<__m128i const*>(text + i + j));
+            auto const low = _mm_and_si128(v, lowNibble);
+            auto const high = _mm_and_si128(_mm_srli_epi16(v, 4), lowNibble);
+
+            candidates = _mm_and_si128(candidates,
+                                       _mm_and_si128(_mm_shuffle_epi8(lowMasks[j], low),
+                                                     _mm_shuffle_epi8(highMasks[j], high)));
+        }
+
+        auto positions = static_cast<uint32>(_mm_movemask_epi8(_mm_cmpeq_epi8(candidates, _mm_setzero_si128())))
+                ^ 0xFFFFu;
+        if (positions == 0) {
+            continue;
+        }
+
+        alignas(16) byte buckets[kBlockSize];
+        _mm_store_si128(reinterpret_cast<__m128i*>(buckets), candidates);
+        while (positions != 0) {
+            auto const k = static_cast<size_t>(__builtin_ctz(positions));
+            positions &= positions - 1;
+
+            if (!verifyCandidates(patterns, text, size, i + k, buckets[k], callback, context)) {
+                return false;
+            }
+        }
+    }
+
+    // Tail that is too short for a block: look up the same masks one position at a time.
+    for (; i + fingerprintLength <= size; ++i) {
+        uint32 candidates = 0xFF;
+        for (uint32 j = 0; j < fingerprintLength; ++j) {
+            auto const b = text[i + j];
+            candidates &= patterns.masks[(2*j + 0) * kBlockSize + (b & 0x0F)]
+                        & patterns.masks[(2*j + 1) * kBlockSize + (b >> 4)];
+        }
+
+        if (candidates != 0 && !verifyCandidates(patterns, text, size, i, candidates, callback, context)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+#endif
+
+}  // anonymous namespace
+
+
+bool
+MultiPatternMatcher::usesPrefilter() const noexcept {
+    return (_fingerprintLength != 0);
+}
+
+
+void
+MultiPatternMatcher::scan(MemoryView text, MatchCallback callback, void* context) const {
+    if (usesPrefilter()) {
+        scanPrefiltered(text, callback, context);
+    } else {
+        runAutomaton(0, 0, text, callback, context);
+    }
+}
+
+
+uint32
+MultiPatternMatcher::feed(uint32 state, size_type position, MemoryView text,
+                          MatchCallback callback, void* context) const {
+    return runAutomaton(state, position, text, callback, context);
+}
+
+
+bool
+MultiPatternMatcher::matchesAny(MemoryView text) const noexcept {
+    bool found = false;
+    scan(text, [](void* context, PatternId, size_type) {
+        *static_cast<bool*>(context) = true;
+
+        return false;
+    }, &found);
+
+    return found;
+}
+
+
+uint32
+MultiPatternMatcher::runAutomaton(uint32 state, size_type position, MemoryView text,
+                                  MatchCallback callback, void* context) const {
+    auto const transitions = _transitions.data();
+    auto const outputStart = _outputStart.data();
+    auto const outputs = _outputs.data();
+    auto const lengths = _patternLengths.data();
+    auto const data = text.dataAddress();
+    auto const size = text.size();
+
+    for (size_type i = 0; i < size; ++i) {
+        state = transitions[state + _byteClasses[data[i]]];
+        if (state < _firstMatchState) {
+            continue;
+        }
+
+        auto const index = (state - _firstMatchState) / _classesCount;
+        for (auto k = outputStart[index]; k < outputStart[index + 1]; ++k) {
+            auto const id = outputs[k];
+            if (!callback(context, id, position + i + 1 - lengths[id])) {
+                return kStopped;
+            }
+        }
+    }
+
+    return state;
+}
+
+
+bool
+MultiPatternMatcher::scanPrefiltered(MemoryView text, MatchCallback callback, void* context) const {
+#ifdef SOLACE_MATCHER_X86
+    PrefilterPatterns const patterns {
+        &_fingerprintMasks[0][0][0],
+        _fingerprintLength,
+        _patternData.data(),
+        _patternOffsets.data(),
+        _patternLengths.data(),
+        patternsCount()
+    };
+
+    return scanTeddySsse3(patterns, text.dataAddress(), text.size(), callback, context);
+#else
+    return (runAutomaton(0, 0, text, callback, context) != kStopped);
+#endif
+}
+
+
+Result<MultiPatternMatcher, Error>
+Solace::makeMultiPatternMatcher(ArrayView<const StringView> patterns) {
+    MultiPatternMatcher matcher;
+    auto const patternsCount = patterns.size();
+
+    // Copy patterns and assign equivalence classes to bytes that occur in them
+    bool used[256] = {};
+    uint32 totalLength = 0;
+    for (auto const& pattern : patterns) {
+        if (pattern.empty()) {
+            return Err(makeError(BasicError::InvalidInput, "makeMultiPatternMatcher()"));
+        }
+
+        for (auto c : pattern) {
+            used[static_cast<byte>(c)] = true;
+        }
+
+        totalLength += pattern.size();
+    }
+
+    uint32 usedCount = 0;
+    for (auto isUsed : used) {
+        usedCount += isUsed ? 1 : 0;
+    }
+
+    // Class 0 is shared by all bytes that do not occur in the patterns, if there are any.
+    uint32 nextClass = (usedCount < 256) ? 1 : 0;
+    for (uint32 b = 0; b < 256; ++b) {
+        matcher._byteClasses[b] = used[b] ? static_cast<byte>(nextClass++) : 0;
+    }
+    auto const classesCount = nextClass;
+    matcher._classesCount = classesCount;
+
+    matcher._patternLengths = makeTable<StringView::size_type>(patternsCount);
+    matcher._patternOffsets = makeTable<uint32>(patternsCount);
+    matcher._patternData = makeTable<char>(totalLength);
+    uint32 offset = 0;
+    for (PatternId id = 0; id < patternsCount; ++id) {
+        auto const& pattern = patterns[id];
+        std::copy(pattern.begin(), pattern.end(), matcher._patternData.begin() + offset);
+        matcher._patternLengths[id] = pattern.size();
+        matcher._patternOffsets[id] = offset;
+        offset += pattern.size();
+    }
+
+    // Build the trie. Node 0 is the root and, as no edge leads to the root, 0 marks a missing edge.
+    auto const statesCount = countTrieNodes(patterns);
+    uint64 const tableSize = uint64{statesCount} * classesCount;
+    if (tableSize > std::numeric_limits<uint32>::max()) {
+        return Err(makeError(SystemErrors::Overflow, "makeMultiPatternMatcher()"));
+    }
+
+    auto delta = makeTable<uint32>(static_cast<uint32>(tableSize));
+    auto ownPatterns = makeTable<uint32>(statesCount);     // First pattern ending at the node
+    auto nextPattern = makeTable<uint32>(patternsCount);   // Next pattern ending at the same node
+    std::fill(ownPatterns.begin(), ownPatterns.end(), kNone);
+
+    uint32 nodesCount = 1;
+    for (PatternId id = 0; id < patternsCount; ++id) {
+        uint32 node = 0;
+        for (auto c : patterns[id]) {
+            auto& edge = delta[node * classesCount + matcher._byteClasses[static_cast<byte>(c)]];
+            if (edge == 0) {
+                edge = nodesCount++;
+            }
+            node = edge;
+        }
+
+        nextPattern[id] = ownPatterns[node];
+        ownPatterns[node] = id;
+    }
+
+    // Resolve failure transitions in breadth first order so that the row of a failure state is complete
+    // before it is used. Dictionary link points to the nearest proper suffix state that ends a pattern.
+    auto queue = makeTable<uint32>(statesCount);
+    auto failure = makeTable<uint32>(statesCount);
+    auto dictionary = makeTable<uint32>(statesCount);
+    auto accepting = makeTable<bool>(statesCount);
+    dictionary[0] = kNone;
+
+    uint32 head = 0, tail = 0;
+    queue[tail++] = 0;
+    while (head < tail) {
+        auto const state = queue[head++];
+        auto const row = state * classesCount;
+        auto const failureRow = failure[state] * classesCount;
+
+        for (uint32 c = 0; c < classesCount; ++c) {
+            auto const next = delta[row + c];
+            if (next == 0) {  // Not a trie edge: borrow the transition of the failure state
+                delta[row + c] = (state == 0) ? 0 : delta[failureRow + c];
+                continue;
+            }
+
+            auto const nextFailure = (state == 0) ? 0 : delta[failureRow + c];
+            failure[next] = nextFailure;
+            dictionary[next] = (ownPatterns[nextFailure] != kNone) ? nextFailure : dictionary[nextFailure];
+            accepting[next] = (ownPatterns[next] != kNone) || accepting[nextFailure];
+            queue[tail++] = next;
+        }
+    }
+
+    // Renumber states: non-accepting states first, in BFS order, followed by accepting ones.
+    auto renumbered = makeTable<uint32>(statesCount);
+    uint32 acceptingCount = 0;
+    for (uint32 i = 0; i < statesCount; ++i) {
+        acceptingCount += accepting[i] ? 1 : 0;
+    }
+
+    uint32 nextRegular = 0;
+    uint32 nextAccepting = statesCount - acceptingCount;
+    for (uint32 i = 0; i < statesCount; ++i) {
+        auto const state = queue[i];
+        renumbered[state] = accepting[state] ? nextAccepting++ : nextRegular++;
+    }
+
+    matcher._statesCount = statesCount;
+    matcher._firstMatchState = (statesCount - acceptingCount) * classesCount;
+    matcher._transitions = makeTable<uint32>(static_cast<uint32>(tableSize));
+    for (uint32 state = 0; state < statesCount; ++state) {
+        auto const from = state * classesCount;
+        auto const to = renumbered[state] * classesCount;
+        for (uint32 c = 0; c < classesCount; ++c) {
+            matcher._transitions[to + c] = renumbered[delta[from + c]] * classesCount;
+        }
+    }
+
+    // Flatten outputs of every accepting state, including patterns that end at its suffixes.
+    auto const firstAccepting = statesCount - acceptingCount;
+    matcher._outputStart = makeTable<uint32>(acceptingCount + 1);
+    uint32 outputsCount = 0;
+    for (uint32 pass = 0; pass < 2; ++pass) {
+        outputsCount = 0;
+        for (uint32 i = 0; i < statesCount; ++i) {
+            auto const state = queue[i];
+            if (!accepting[state]) {
+                continue;
+            }
+
+            auto const index = renumbered[state] - firstAccepting;
+            if (pass == 0) {
+                matcher._outputStart[index] = outputsCount;
+            }
+
+            auto node = (ownPatterns[state] != kNone) ? state : dictionary[state];
+            for (; node != kNone; node = dictionary[node]) {
+                for (auto id = ownPatterns[node]; id != kNone; id = nextPattern[id]) {
+                    if (pass == 1) {
+                        matcher._outputs[outputsCount] = id;
+                    }
+                    outputsCount += 1;
+                }
+            }
+        }
+
+        if (pass == 0) {
+            matcher._outputs = makeTable<PatternId>(outputsCount);
+        }
+    }
+    matcher._outputStart[acceptingCount] = outputsCount;
+
+    // Small sets of patterns are searched with the prefilter
+#ifdef SOLACE_MATCHER_X86
+    if (patternsCount > 0 && patternsCount <= MultiPatternMatcher::kMaxPrefilterPatterns && cpu::hasSsse3()) {
+        uint32 fingerprintLength = 3;
+        for (auto const& pattern : patterns) {
+            fingerprintLength = std::min<uint32>(fingerprintLength, pattern.size());
+        }
+
+        for (PatternId id = 0; id < patternsCount; ++id) {
+            for (uint32 j = 0; j < fingerprintLength; ++j) {
+                auto const b = static_cast<byte>(patterns[id].data()[j]);
+                matcher._fingerprintMasks[j][0][b & 0x0F] |= static_cast<byte>(1u << id);
+                matcher._fingerprintMasks[j][1][b >> 4] |= static_cast<byte>(1u << id);
+            }
+        }
+
+        matcher._fingerprintLength = fingerprintLength;
+    }
+#endif
+
+    return Ok(std::move(matcher));
+}
@@ -0,0 +1,337 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		parseNumber.cpp
+ *	@brief		Implementation of numeric parsing.
+ ******************************************************************************/
+#include "solace/parseNumber.hpp"
+#include "solace/posixErrorDomain.hpp"
+
+#include <charconv>
+#include <cstring>  // memcpy
+
+
+using namespace Solace;
+
+
+namespace /* anonymous */ {
+
+enum class DigitsStatus {
+    Ok,
+    Invalid,
+    Overflow
+};
+
+
+Error makeInvalidInputError() noexcept {
+    return makeError(BasicError::InvalidInput, "parseNumber()");
+}
+
+Error makeRangeError() noexcept {
+    return makeError(GenericError::RANGE, "parseNumber()");
+}
+
+
+constexpr bool isDigit(char c) noexcept {
+    return (c >= '0' && c <= '9');
+}
+
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define SOLACE_PARSE_SWAR 1
+
+/// Check that all 8 bytes of the word are ASCII digits.
+inline bool isEightDigits(uint64 chunk) noexcept {
+    return ((chunk & 0xF0F0F0F0F0F0F0F0ULL) |
+            (((chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) == 0x3333333333333333ULL;
+}
+
+/// Convert 8 ASCII digits packed into a little-endian word into a number using 3 multiplications.
+inline uint32 parseEightDigits(uint64 chunk) noexcept {
+    chunk -= 0x3030303030303030ULL;
+    chunk = (chunk * 10) + (chunk >> 8);
+    chunk = (((chunk & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+             (((chunk >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+
+    return static_cast<uint32>(chunk);
+}
+#endif
+
+
+/**
+ * Convert a sequence of decimal digits into a number.
+ * Input is consumed 8 digits at a time while possible.
+ */
+DigitsStatus parseDigits(char const* first, char const* last, uint64& result) noexcept {
+    if (first == last) {
+        return DigitsStatus::Invalid;
+    }
+
+    uint64 value = 0;
+    bool overflow = false;
+
+#ifdef SOLACE_PARSE_SWAR
+    while (last - first >= 8) {
+        uint64 chunk;
+        std::memcpy(&chunk, first, sizeof(chunk));
+        if (!isEightDigits(chunk)) {
+            break;
+        }
+
+        overflow = overflow ||
+                __builtin_mul_overflow(value, uint64{100000000}, &value) ||
+                __builtin_add_overflow(value, parseEightDigits(chunk), &value);
+        first += 8;
+    }
+#endif
+
+    for (; first != last; ++first) {
+        if (!isDigit(*first)) {
+            return DigitsStatus::Invalid;
+        }
+
+        overflow = overflow ||
+                __builtin_mul_overflow(value, uint64{10}, &value) ||
+                __builtin_add_overflow(value, static_cast<uint64>(*first - '0'), &value);
+    }
+
+    result = value;
+
+    return overflow
+            ? DigitsStatus::Overflow
+            : DigitsStatus::Ok;
+}
+
+
+constexpr float64 kPowersOf10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/// Limits of exact representation used by the fast path.
+template<typename T>
+struct FastPathLimits;
+
+template<>
+struct FastPathLimits<float64> {
+    static constexpr uint64 kMaxMantissa = uint64{1} << 53;
+    static constexpr int kMaxExponent = 22;
+};
+
+template<>
+struct FastPathLimits<float32> {
+    static constexpr uint64 kMaxMantissa = uint64{1} << 24;
+    static constexpr int kMaxExponent = 10;
+};
+
+
+/**
+ * Clinger's fast path: when both the decimal mantissa and the power of 10 are exactly representable
+ * a single multiplication or division gives a correctly rounded result.
+ * @return True if the value was parsed by the fast path.
+ */
+template<typename T>
+bool parseFloatFastPath(char const* first, char const* last, T& result) noexcept {
+    uint64 mantissa = 0;
+    int significantDigits = 0;
+    int exponent = 0;
+    bool hasDigits = false;
+
+    auto p = first;
+    for (; p != last && isDigit(*p); ++p) {
+        hasDigits = true;
+        if (mantissa != 0 || *p != '0') {
+            mantissa = mantissa * 10 + static_cast<uint64>(*p - '0');
+            significantDigits += 1;
+        }
+
+        if (significantDigits > 19) {
+            return false;
+        }
+    }
+
+    if (p != last && *p == '.') {
+        for (++p; p != last && isDigit(*p); ++p) {
+            hasDigits = true;
+            exponent -= 1;
+            if (mantissa != 0 || *p != '0') {
+                mantissa = mantissa * 10 + static_cast<uint64>(*p - '0');
+                significantDigits += 1;
+            }
+
+            if (significantDigits > 19) {
+                return false;
+            }
+        }
+    }
+
+    if (!hasDigits) {
+        return false;
+    }
+
+    if (p != last && (*p == 'e' || *p == 'E')) {
+        ++p;
+        bool negativeExponent = false;
+        if (p != last && (*p == '-' || *p == '+')) {
+            negativeExponent = (*p == '-');
+            ++p;
+        }
+
+        if (p == last || last - p > 4) {
+            return false;
+        }
+
+        int explicitExponent = 0;
+        for (; p != last && isDigit(*p); ++p) {
+            explicitExponent = explicitExponent * 10 + (*p - '0');
+        }
+
+        exponent += negativeExponent ? -explicitExponent : explicitExponent;
+    }
+
+    if (p != last) {
+        return false;
+    }
+
+    if (mantissa == 0) {
+        result = 0;
+        return true;
+    }
+
+    if (mantissa > FastPathLimits<T>::kMaxMantissa ||
+        exponent < -FastPathLimits<T>::kMaxExponent ||
+        exponent > FastPathLimits<T>::kMaxExponent) {
+        return false;
+    }
+
+    auto value = static_cast<T>(mantissa);
+    result = (exponent < 0)
+            ? value / static_cast<T>(kPowersOf10[-exponent])
+            : value * static_cast<T>(kPowersOf10[exponent]);
+
+    return true;
+}
+
+
+template<typename T>
+Result<T, Error> parseFloatImpl(StringView str) noexcept {
+    char const* first = str.data();
+    char const* const last = first + str.size();
+
+    if (first == last) {
+        return Err(makeInvalidInputError());
+    }
+
+    bool const negative = (*first == '-');
+    if (*first == '-' || *first == '+') {
+        ++first;
+    }
+
+    // Only one sign is allowed
+    if (first == last || *first == '-' || *first == '+') {
+        return Err(makeInvalidInputError());
+    }
+
+    T value = 0;
+    if (!parseFloatFastPath(first, last, value)) {
+        // Slow path for long mantissas and large exponents: correctly rounded conversion of the standard library.
+        auto const result = std::from_chars(first, last, value);
+        if (result.ec == std::errc::result_out_of_range) {
+            return Err(makeRangeError());
+        }
+
+        if (result.ec != std::errc{} || result.ptr != last) {
+            return Err(makeInvalidInputError());
+        }
+    }
+
+    return Ok(negative ? -value : value);
+}
+
+}  // anonymous namespace
+
+
+Error
+details::makeParseOverflowError() noexcept {
+    return makeError(SystemErrors::Overflow, "parseList()");
+}
+
+
+Result<uint64, Error>
+details::parseUnsigned(StringView str, uint64 maxValue) noexcept {
+    uint64 value = 0;
+    switch (parseDigits(str.data(), str.data() + str.size(), value)) {
+    case DigitsStatus::Invalid:
+        return Err(makeInvalidInputError());
+    case DigitsStatus::Overflow:
+        return Err(makeRangeError());
+    default:
+        break;
+    }
+
+    if (value > maxValue) {
+        return Err(makeRangeError());
+    }
+
+    return Ok(value);
+}
+
+
+Result<int64, Error>
+details::parseSigned(StringView str, int64 minValue, int64 maxValue) noexcept {
+    char const* first = str.data();
+    char const* const last = first + str.size();
+
+    bool const negative = (first != last && *first == '-');
+    if (first != last && (*first == '-' || *first == '+')) {
+        ++first;
+    }
+
+    uint64 magnitude = 0;
+    switch (parseDigits(first, last, magnitude)) {
+    case DigitsStatus::Invalid:
+        return Err(makeInvalidInputError());
+    case DigitsStatus::Overflow:
+        return Err(makeRangeError());
+    default:
+        break;
+    }
+
+    // Compare magnitudes in unsigned arithmetic to handle the minimal value, which has no positive counterpart.
+    auto const limit = negative
+            ? uint64{0} - static_cast<uint64>(minValue)
+            : static_cast<uint64>(maxValue);
+    if (magnitude > limit) {
+        return Err(makeRangeError());
+    }
+
+    return Ok(negative
+              ? static_cast<int64>(uint64{0} - magnitude)
+              : static_cast<int64>(magnitude));
+}
+
+
+Result<float32, Error>
+details::parseFloat32(StringView str) noexcept {
+    return parseFloatImpl<float32>(str);
+}
+
+
+Result<float64, Error>
+details::parseFloat64(StringView str) noexcept {
+    return parseFloatImpl<float64>(str);
+}
@@ -20,92 +20,249 @@
  *  Created by soultaker on 8/03/16
 ******************************************************************************/
 #include "solace/path.hpp"
+#include "solace/byteWriter.hpp"
+#include "solace/posixErrorDomain.hpp"
 
 #include <algorithm>  // std::min/std::max
+#include <cstring>    // memcpy, memchr, memcmp
 
 using namespace Solace;
+using namespace Solace::details;
 
 
-const StringView Path::Delimiter("/");
+const StringView PathView::Delimiter("/");
 const StringView SelfRef(".");
 const StringView ParentRef("..");
 
 
-const Path Path::Root = makePath(StringLiteral{""});
+const Path Path::Root = makePath(StringView{});
+
+
+namespace /* anonymous */ {
+
+/** Test if the path is the root: a single empty component */
+bool isRoot(PathView path) noexcept {
+    return (path.getComponentsCount() == 1 && path.getComponent(0).empty());
+}
+
+/**
+ * Call f(StringView) for each component of the path string, ignoring a trailing empty component.
+ * @return Number of components.
+ */
+template<typename F>
+Path::size_type splitComponents(StringView str, StringView delim, F&& f) {
+    auto const data = str.data();
+    auto const size = str.size();
+    auto const delimSize = delim.size();
+    Path::size_type count = 0;
+
+    StringView::size_type from = 0;
+    for (StringView::size_type i = 0; i + delimSize <= size; ) {
+        auto const found = static_cast<char const*>(std::memchr(data + i, delim[0], size - delimSize + 1 - i));
+        if (!found) {
+            break;
+        }
+
+        auto const at = static_cast<StringView::size_type>(found - data);
+        if (std::memcmp(found + 1, delim.data() + 1, delimSize - 1) != 0) {
+            i = at + 1;
+            continue;
+        }
+
+        f(StringView{data + from, static_cast<StringView::size_type>(at - from)});
+        count += 1;
+        from = i = at + delimSize;
+    }
+
+    if (from < size) {
+        f(str.substring(from));
+        count += 1;
+    }
+
+    return count;
+}
+
+
+/**
+ * Call f(StringView) for each piece of the string representation of the path: components and delimiters.
+ * @param f Callback returning false to stop the iteration.
+ */
+template<typename F>
+void forEachPiece(PathView path, StringView delim, F&& f) {
+    if (isRoot(path)) {
+        f(delim);
+        return;
+    }
+
+    bool first = true;
+    for (auto component : path) {
+        if (!first && !f(delim)) {
+            return;
+        }
+
+        if (!f(component)) {
+            return;
+        }
+
+        first = false;
+    }
+}
+
+/** Same as forEachPiece, but iterates from the end of the string representation */
+template<typename F>
+void forEachPieceReversed(PathView path, StringView delim, F&& f) {
+    if (isRoot(path)) {
+        f(delim);
+        return;
+    }
+
+    auto const nbComponents = path.getComponentsCount();
+    for (PathView::size_type i = nbComponents; i > 0; --i) {
+        if (!f(path.getComponent(i - 1))) {
+            return;
+        }
+
+        if (i > 1 && !f(delim)) {
+            return;
+        }
+    }
+}
+
+}  // anonymous namespace
+
+
+PathBuilder::PathBuilder(Path::size_type maxComponents, MemoryView::size_type maxDataSize)
+    : _buffer{getSystemHeapMemoryManager().allocate((maxComponents + 1) * sizeof(uint32) + maxDataSize)}
+    , _offsets{reinterpret_cast<uint32*>(_buffer.view().dataAddress())}
+    , _data{reinterpret_cast<char*>(_buffer.view().dataAddress() + (maxComponents + 1) * sizeof(uint32))}
+{
+    _offsets[0] = 0;
+}
+
+
+PathBuilder&
+PathBuilder::append(StringView component) noexcept {
+    auto const size = component.size();
+    if (size != 0) {
+        std::memcpy(_data + _offsets[_count], component.data(), size);
+    }
+
+    _offsets[_count + 1] = _offsets[_count] + size;
+    _count += 1;
+
+    return *this;
+}
+
+
+PathBuilder&
+PathBuilder::append(PathView path) noexcept {
+    for (auto component : path) {
+        append(component);
+    }
+
+    return *this;
+}
+
+
+PathBuilder&
+PathBuilder::pop() noexcept {
+    _count -= 1;
+
+    return *this;
+}
+
+
+Path
+PathBuilder::build() noexcept {
+    return {PathView{_data, _offsets, _count}, std::move(_buffer)};
+}
 
 
 Path
 Solace::makePath(StringView str) {
-    return makePath(makeArrayOf<String>(makeString(str)));
+    return PathBuilder{1, str.size()}
+            .append(str)
+            .build();
+}
+
+
+Path
+Solace::makePath(ArrayView<const String> components) {
+    MemoryView::size_type dataSize = 0;
+    for (auto const& component : components) {
+        dataSize += component.size();
+    }
+
+    PathBuilder builder{components.size(), dataSize};
+    for (auto const& component : components) {
+        builder.append(component.view());
+    }
+
+    return builder.build();
+}
+
+
+Path::Path(PathView view)
+    : Path{PathBuilder{view.getComponentsCount(), view.dataSize()}
+                .append(view)
+                .build()}
+{
 }
 
 
 Result<Path, Error>
 Path::parse(StringView str, StringView delim) {
-    Vector<String> nonEmptyComponents;
-    str.split(delim, [&](StringView c, StringView::size_type i, StringView::size_type count) {
-        if (nonEmptyComponents.capacity() == 0 && count != 0) {
-            nonEmptyComponents = makeVector<String>(count);
-        }
+    if (delim.empty()) {
+        return Err(makeError(BasicError::InvalidInput, "Path::parse()"));
+    }
 
-        if (i + 1 == count && c.empty()) {
-            return;
-        }
+    auto const nbComponents = splitComponents(str, delim, [](StringView) {});
 
-        nonEmptyComponents.emplace_back(makeString(c));
+    PathBuilder builder{std::max<size_type>(nbComponents, 1), str.size()};
+    splitComponents(str, delim, [&builder](StringView component) {
+        builder.append(component);
     });
 
-    if (nonEmptyComponents.empty()) {
-        nonEmptyComponents.emplace_back(makeString(String::Empty));
+    if (builder.size() == 0) {  // Root
+        builder.append(StringView{});
     }
 
-    return Ok(Path(nonEmptyComponents.toArray()));
+    return Ok(builder.build());
 }
 
 
 String::size_type
-Path::length(StringView delim) const noexcept {
+PathView::length(StringView delim) const noexcept {
     auto const delimLen = delim.length();
 
-    auto const nbComponents = _components.size();
-    if (nbComponents == 0) {
+    if (_count == 0) {
         return 0;
-    } else if (nbComponents == 1) {
-        const auto& one = _components[0];
-        return  (one.empty())
-                ? delimLen          // Root - single empty item
-                : one.length();
+    } else if (isRoot(*this)) {
+        return delimLen;
     }
 
-    String::size_type len = 0;
-    for (auto const& s : _components) {  // Accomulate:
-        len += (delimLen + s.length());
-    }
-
-    return (len - delimLen);
+    return static_cast<String::size_type>(dataSize() + delimLen * (_count - 1));
 }
 
 
-int Path::compareTo(const Path& other) const {
-    const size_type minLen = std::min(getComponentsCount(), other.getComponentsCount());
+int
+PathView::compareTo(PathView other) const noexcept {
+    auto const minLen = std::min(getComponentsCount(), other.getComponentsCount());
 
     // Find where this path diverges from other:
     for (size_type i = 0; i < minLen; ++i) {
-        const auto& thisComponent = _components[i];
-        const auto& otherComponent = other._components[i];
-
-        auto const diff = thisComponent.compareTo(otherComponent);
+        auto const diff = getComponent(i).compareTo(other.getComponent(i));
         if (diff != 0) {
             return diff;
         }
     }
 
-
     return static_cast<int>(getComponentsCount()) - static_cast<int>(other.getComponentsCount());
 }
 
 
-bool Path::startsWith(const Path& other) const {
+bool
+PathView::startsWith(PathView other) const noexcept {
     if (empty())
         return other.empty();
 
@@ -117,8 +274,8 @@ bool Path::startsWith(const Path& other) const {
 
     auto const nbComponents = other.getComponentsCount();
     for (size_type i = 0; i < nbComponents; ++i) {
-        const auto& otherComponent = other._components[i];
-        const auto& thisComponent = _components[i];
+        auto const otherComponent = other.getComponent(i);
+        auto const thisComponent = getComponent(i);
 
         if (!thisComponent.equals(otherComponent)) {
             return thisComponent.startsWith(otherComponent) && (i + 1 == nbComponents);
@@ -128,7 +285,31 @@ bool Path::startsWith(const Path& other) const {
     return true;
 }
 
-bool Path::endsWith(const Path& other) const {
+
+bool
+PathView::startsWith(StringView str) const noexcept {
+    auto const strSize = str.size();
+    StringView::size_type matched = 0;
+    bool isMatch = true;
+
+    forEachPiece(*this, Delimiter, [&](StringView piece) {
+        auto const n = std::min<StringView::size_type>(piece.size(), strSize - matched);
+        if (!piece.substring(0, n).equals(str.substring(matched, matched + n))) {
+            isMatch = false;
+            return false;
+        }
+
+        matched += n;
+
+        return (matched < strSize);
+    });
+
+    return isMatch && (matched == strSize);
+}
+
+
+bool
+PathView::endsWith(PathView other) const noexcept {
     if (empty()) {
         return other.empty();
     }
@@ -141,11 +322,11 @@ bool Path::endsWith(const Path& other) const {
         return false;
     }
 
-    auto const thisEnd = _components.size();
+    auto const thisEnd = _count;
     auto const nbComponents = other.getComponentsCount();
     for (size_type i = 0; i < nbComponents; ++i) {
-        const auto& thisComponent = _components[thisEnd - 1 - i];
-        const auto& otherComponent = other._components[nbComponents - 1 - i];
+        auto const thisComponent = getComponent(thisEnd - 1 - i);
+        auto const otherComponent = other.getComponent(nbComponents - 1 - i);
 
         if (!thisComponent.equals(otherComponent)) {
             return thisComponent.endsWith(otherComponent) && (i + 1 == nbComponents);
@@ -155,7 +336,32 @@ bool Path::endsWith(const Path& other) const {
     return true;
 }
 
-bool Path::contains(const Path& path) const {
+
+bool
+PathView::endsWith(StringView str) const noexcept {
+    auto const strSize = str.size();
+    StringView::size_type matched = 0;
+    bool isMatch = true;
+
+    forEachPieceReversed(*this, Delimiter, [&](StringView piece) {
+        auto const n = std::min<StringView::size_type>(piece.size(), strSize - matched);
+        auto const strEnd = strSize - matched;
+        if (!piece.substring(piece.size() - n).equals(str.substring(strEnd - n, strEnd))) {
+            isMatch = false;
+            return false;
+        }
+
+        matched += n;
+
+        return (matched < strSize);
+    });
+
+    return isMatch && (matched == strSize);
+}
+
+
+bool
+PathView::contains(PathView path) const noexcept {
     auto const nbOtherComponents = path.getComponentsCount();
     auto const nbThisComponents = getComponentsCount();
 
@@ -167,21 +373,8 @@ bool Path::contains(const Path& path) const {
     for (size_type firstMatch = 0, nbComponents = nbThisComponents - nbOtherComponents + 1;
          firstMatch < nbComponents;
          ++firstMatch) {
-
-        const auto& a = _components[firstMatch];
-        if (a.equals(path._components[0])) {
-            bool allMatched = true;
-            for (size_type i = 1; i < nbOtherComponents; ++i) {
-                const auto& b = _components[firstMatch + i];
-
-                if (!b.equals(path._components[i])) {
-                    allMatched = false;
-                    break;
-                }
-            }
-
-            if (allMatched)
-                return true;
+        if (subpath(firstMatch, firstMatch + nbOtherComponents).equals(path)) {
+            return true;
         }
     }
 
@@ -190,96 +383,95 @@ bool Path::contains(const Path& path) const {
 
 
 bool
-Path::isAbsolute() const noexcept {
-    return (!empty() && _components[0].empty());
-}
-
-
-bool
-Path::isRelative() const noexcept {
-    return !isAbsolute();
+PathView::isAbsolute() const noexcept {
+    return (!empty() && getComponent(0).empty());
 }
 
 
 Path
-Path::normalize() const {
-    // FIXME(abbyssoul): Dynamic memory re-allocation!!!
-    auto components = makeVector<String>(_components.size());   // Assumption: we don't make path any longer
+PathView::normalize() const {
+    PathBuilder components{_count, dataSize()};     // Assumption: we don't make path any longer
 
-    for (auto const& c : _components) {
+    for (auto c : *this) {
         if (c.equals(SelfRef)) {            // Skip '.' entries
             continue;
         } else if (c.equals(ParentRef) && components.size() > 0) {   // Skip '..' entries
-            components.pop_back();
+            components.pop();
         } else {
-            components.emplace_back(makeString(c));
+            components.append(c);
         }
     }
 
-    return Path(components.toArray());
+    return components.build();
 }
 
 
-Path
-Path::getParent() const {
-    auto const nbComponents = _components.size();
-    if (nbComponents < 2) {
-        return {makeArray<String>(_components)};  // Copy components vector
-    }
-
-    auto const nbBaseComponents = nbComponents - 1;
-    auto basePath = makeVector<String>(nbBaseComponents);
-    // TODO(abbyssoul): Should use array copy
-    for (size_type i = 0; i < nbBaseComponents; ++i) {
-        basePath.emplace_back(makeString(_components[i]));
-    }
-
-    return Path(basePath.toArray());
+PathView
+PathView::getParent() const noexcept {
+    return (_count < 2)
+            ? *this
+            : subpath(0, _count - 1);
 }
 
 
 StringView
-Path::getBasename() const {
-    auto const nbComponents = _components.size();
-    return (nbComponents == 1 && _components[0].empty())
+PathView::getBasename() const noexcept {
+    return isRoot(*this)
             ? Delimiter
-            : (nbComponents == 0
-               ? String::Empty
-               : _components[nbComponents - 1]).view();
+            : (_count == 0
+               ? StringView{}
+               : getComponent(_count - 1));
 }
 
 
-Solace::String const&
-Path::getComponent(size_type index) const {
-    return _components[index];
+StringView
+PathView::getComponent(size_type index) const {
+    assertIndexInRange(index, 0, _count);
+
+    return {_data + _offsets[index], static_cast<StringView::size_type>(_offsets[index + 1] - _offsets[index])};
 }
 
 
-Path
-Path::subpath(size_type from, size_type to) const noexcept {
-    auto const nbComponent = _components.size();
+PathView
+PathView::subpath(size_type from, size_type to) const noexcept {
+    from = std::min(from, _count);
+    to = std::max(from, std::min(to, _count));
+
+    return {_data, _offsets + from, to - from};
+}
 
-    from = std::min(from, nbComponent);
-    to = std::max(from, std::min(to, nbComponent));
 
-    auto components = makeVector<String>(to - from);
-    for (size_type i = from; i < to; ++i) {
-        components.emplace_back(makeString(_components[i]));
+bool
+PathView::equals(PathView rhv) const noexcept {
+    if (_count != rhv._count) {
+        return false;
     }
 
-    return {components.toArray()};
-}
+    if (_offsets == rhv._offsets && _data == rhv._data) {
+        return true;
+    }
 
+    for (size_type i = 0; i < _count; ++i) {
+        if (!getComponent(i).equals(rhv.getComponent(i))) {
+            return false;
+        }
+    }
 
-bool
-Path::equals(Path const& rhv) const noexcept {
-    return (&rhv == this) || rhv._components == _components;
+    return true;
 }
 
 
 String
-Path::toString(StringView delim) const {
-    return (isAbsolute() && _components.size() == 1)
-            ? makeString(delim)
-            : makeStringJoin(delim, _components.view());
+PathView::toString(StringView delim) const {
+    auto const totalLength = length(delim);
+    auto buffer = getSystemHeapMemoryManager().allocate(totalLength);    // May throw
+    ByteWriter writer{buffer.view()};
+
+    forEachPiece(*this, delim, [&writer](StringView piece) {
+        writer.write(piece.view());
+
+        return true;
+    });
+
+    return {std::move(buffer), totalLength};
 }
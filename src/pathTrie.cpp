@@ -0,0 +1,405 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		pathTrie.cpp
+ *	@brief		Implementation of PathTrieIndex.
+ *
+ * All of the index lives in a handful of flat arrays that grow geometrically:
+ * nodes, a table of child edges, the text of interned components and a table of component labels.
+ * Lookup of a path interns nothing: each component is hashed once to find its label,
+ * and each label is followed with a single probe of the edge table.
+ * Matching with wildcards walks the path breadth first, keeping the frontier of nodes reached by the
+ * components so far. Literal children are put before wildcard ones, so the frontier stays ordered by
+ * precedence and the first node with a value is the one to report, without any backtracking.
+ ******************************************************************************/
+#include "solace/pathTrie.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+
+using namespace Solace;
+using namespace Solace::details;
+
+
+namespace /* anonymous */ {
+
+constexpr uint32 kInitialCapacity = 16;
+
+/// Spread a hash code over the slots of a power of two sized table.
+uint32 slotOf(uint64 hash, uint32 tableSize) noexcept {
+    return static_cast<uint32>((hash * 0x9E3779B97F4A7C15ULL) >> 32) & (tableSize - 1);
+}
+
+uint64 edgeHash(uint32 parent, uint32 label) noexcept {
+    return (static_cast<uint64>(parent) << 32) | label;
+}
+
+/// Grow the array to at least minSize elements, doubling its size, and keep its content.
+template<typename T>
+void reserve(Array<T>& array, uint32 minSize) {
+    auto size = array.size();
+    if (size >= minSize) {
+        return;
+    }
+
+    while (size < minSize) {
+        size *= 2;
+    }
+
+    auto bigger = makeArray<T>(size);
+    std::copy(array.begin(), array.end(), bigger.begin());
+    array = std::move(bigger);
+}
+
+}  // anonymous namespace
+
+
+PathTrieIndex::PathTrieIndex(StringView wildcard)
+    : _nodes{makeArray<Node>(kInitialCapacity)}
+    , _edges{makeArray<Edge>(kInitialCapacity)}
+    , _text{makeArray<char>(kInitialCapacity * 8)}
+    , _labelOffsets{makeArray<uint32>(kInitialCapacity)}
+    , _labelSlots{makeArray<uint32>(kInitialCapacity)}
+{
+    _wildcard = intern(wildcard);
+}
+
+
+StringView
+PathTrieIndex::labelText(uint32 label) const noexcept {
+    auto const offset = _labelOffsets[label];
+
+    return {_text.view().data() + offset, static_cast<StringView::size_type>(_labelOffsets[label + 1] - offset)};
+}
+
+
+Optional<uint32>
+PathTrieIndex::findLabel(StringView component) const noexcept {
+    auto const mask = _labelSlots.size() - 1;
+    for (auto i = slotOf(component.hashCode(), _labelSlots.size()); _labelSlots[i] != 0; i = (i + 1) & mask) {
+        auto const label = _labelSlots[i] - 1;
+        if (labelText(label) == component) {
+            return label;
+        }
+    }
+
+    return none;
+}
+
+
+uint32
+PathTrieIndex::intern(StringView component) {
+    auto const found = findLabel(component);
+    if (found.isSome()) {
+        return found.get();
+    }
+
+    auto const label = _labelsCount;
+    auto const offset = _labelOffsets[label];
+    reserve(_text, offset + component.size());
+    reserve(_labelOffsets, label + 2);
+    if (component.size() != 0) {
+        std::memcpy(_text.begin() + offset, component.data(), component.size());
+    }
+    _labelOffsets[label + 1] = offset + component.size();
+    _labelsCount += 1;
+
+    // Keep the table at most half full
+    if (2 * _labelsCount > _labelSlots.size()) {
+        auto slots = makeArray<uint32>(2 * _labelSlots.size());
+        auto const mask = slots.size() - 1;
+        for (uint32 l = 0; l < label; ++l) {
+            auto i = slotOf(labelText(l).hashCode(), slots.size());
+            while (slots[i] != 0) {
+                i = (i + 1) & mask;
+            }
+            slots[i] = l + 1;
+        }
+        _labelSlots = std::move(slots);
+    }
+
+    auto const mask = _labelSlots.size() - 1;
+    auto i = slotOf(component.hashCode(), _labelSlots.size());
+    while (_labelSlots[i] != 0) {
+        i = (i + 1) & mask;
+    }
+    _labelSlots[i] = label + 1;
+
+    return label;
+}
+
+
+uint32
+PathTrieIndex::findChild(NodeId parent, uint32 label) const noexcept {
+    auto const mask = _edges.size() - 1;
+    for (auto i = slotOf(edgeHash(parent, label), _edges.size()); _edges[i].child != 0; i = (i + 1) & mask) {
+        if (_edges[i].parent == parent && _edges[i].label == label) {
+            return _edges[i].child;
+        }
+    }
+
+    return 0;
+}
+
+
+PathTrieIndex::NodeId
+PathTrieIndex::addChild(NodeId parent, uint32 label) {
+    reserve(_nodes, _nodesCount + 1);
+
+    auto const node = _nodesCount;
+    _nodes[node] = Node{label, parent, 0, _nodes[parent].firstChild, 0, 0};
+    _nodes[parent].firstChild = node;
+    _nodesCount += 1;
+
+    if (label == _wildcard) {
+        _nodes[parent].wildcard = node;
+        return node;
+    }
+
+    // Keep the table at most half full
+    if (2 * (_edgesCount + 1) > _edges.size()) {
+        auto edges = makeArray<Edge>(2 * _edges.size());
+        auto const mask = edges.size() - 1;
+        for (auto const& edge : _edges) {
+            if (edge.child == 0) {
+                continue;
+            }
+
+            auto i = slotOf(edgeHash(edge.parent, edge.label), edges.size());
+            while (edges[i].child != 0) {
+                i = (i + 1) & mask;
+            }
+            edges[i] = edge;
+        }
+        _edges = std::move(edges);
+    }
+
+    auto const mask = _edges.size() - 1;
+    auto i = slotOf(edgeHash(parent, label), _edges.size());
+    while (_edges[i].child != 0) {
+        i = (i + 1) & mask;
+    }
+    _edges[i] = Edge{parent, label, node};
+    _edgesCount += 1;
+
+    return node;
+}
+
+
+PathTrieIndex::NodeId
+PathTrieIndex::insert(PathView key) {
+    NodeId node = kRoot;
+    for (auto component : key) {
+        auto const label = intern(component);
+        auto child = (label == _wildcard)
+                ? _nodes[node].wildcard
+                : findChild(node, label);
+
+        node = (child != 0)
+                ? child
+                : addChild(node, label);
+    }
+
+    return node;
+}
+
+
+Optional<PathTrieIndex::NodeId>
+PathTrieIndex::find(PathView key) const noexcept {
+    NodeId node = kRoot;
+    for (auto component : key) {
+        auto const label = findLabel(component);
+        if (label.isNone()) {
+            return none;
+        }
+
+        node = (label.get() == _wildcard)
+                ? _nodes[node].wildcard
+                : findChild(node, label.get());
+
+        if (node == 0) {
+            return none;
+        }
+    }
+
+    return node;
+}
+
+
+/**
+ * Set of nodes with small inline storage that only allocates for unusually wide frontiers.
+ * Every node of a trie has a unique key, so a frontier never holds the same node twice and
+ * its size is bounded by the number of keys matching the prefix of the path.
+ */
+class PathTrieIndex::Frontier {
+public:
+
+    Frontier() noexcept = default;
+
+    Frontier(Frontier const&) = delete;
+    Frontier& operator= (Frontier const&) = delete;
+
+    size_type size() const noexcept { return _size; }
+
+    bool empty() const noexcept { return (_size == 0); }
+
+    NodeId operator[] (size_type index) const noexcept { return _nodes[index]; }
+
+    void clear() noexcept { _size = 0; }
+
+    void push(NodeId node) {
+        if (_size == _capacity) {
+            grow();
+        }
+
+        _nodes[_size++] = node;
+    }
+
+private:
+
+    void grow() {
+        auto bigger = makeArray<NodeId>(2 * _capacity);
+        std::copy(_nodes, _nodes + _size, bigger.begin());
+        _heap = std::move(bigger);
+        _nodes = _heap.begin();
+        _capacity = _heap.size();
+    }
+
+    static constexpr size_type kInlineCapacity = 16;
+
+    NodeId          _inline[kInlineCapacity];
+    Array<NodeId>   _heap;
+    NodeId*         _nodes{_inline};
+    size_type       _size{0};
+    size_type       _capacity{kInlineCapacity};
+};
+
+
+void
+PathTrieIndex::advance(Frontier const& from, StringView component, Frontier& to) const {
+    to.clear();
+
+    // A component equal to the wildcard only matches wildcard nodes, an unknown one no literal node.
+    auto const label = findLabel(component);
+    bool const literal = label.isSome() && label.get() != _wildcard;
+    for (size_type i = 0; i < from.size(); ++i) {
+        if (literal) {
+            auto const child = findChild(from[i], label.get());
+            if (child != 0) {
+                to.push(child);
+            }
+        }
+
+        auto const wildcard = _nodes[from[i]].wildcard;
+        if (wildcard != 0) {
+            to.push(wildcard);
+        }
+    }
+}
+
+
+Optional<PathTrieIndex::NodeId>
+PathTrieIndex::firstWithValue(Frontier const& frontier) const noexcept {
+    for (size_type i = 0; i < frontier.size(); ++i) {
+        if (_nodes[frontier[i]].value != 0) {
+            return frontier[i];
+        }
+    }
+
+    return none;
+}
+
+
+Optional<PathTrieIndex::NodeId>
+PathTrieIndex::match(PathView path) const {
+    Frontier first;
+    Frontier second;
+    auto current = &first;
+    auto next = &second;
+
+    current->push(kRoot);
+    for (auto component : path) {
+        advance(*current, component, *next);
+        std::swap(current, next);
+        if (current->empty()) {
+            return none;
+        }
+    }
+
+    return firstWithValue(*current);
+}
+
+
+Optional<PathTrieIndex::Match>
+PathTrieIndex::longestPrefix(PathView path) const {
+    Frontier first;
+    Frontier second;
+    auto current = &first;
+    auto next = &second;
+
+    Optional<Match> best;
+    current->push(kRoot);
+    size_type depth = 0;
+    while (true) {
+        auto const node = firstWithValue(*current);
+        if (node.isSome()) {
+            best = Match{node.get(), depth};
+        }
+
+        if (depth == path.getComponentsCount()) {
+            break;
+        }
+
+        advance(*current, path.getComponent(depth), *next);
+        std::swap(current, next);
+        if (current->empty()) {
+            break;
+        }
+
+        depth += 1;
+    }
+
+    return best;
+}
+
+
+void
+PathTrieIndex::appendKey(PathBuilder& builder, NodeId node) const noexcept {
+    if (node == kRoot) {
+        return;
+    }
+
+    appendKey(builder, _nodes[node].parent);
+    builder.append(labelText(_nodes[node].label));
+}
+
+
+Path
+PathTrieIndex::keyOf(NodeId node) const {
+    size_type depth = 0;
+    MemoryView::size_type dataSize = 0;
+    for (auto n = node; n != kRoot; n = _nodes[n].parent) {
+        depth += 1;
+        dataSize += _labelOffsets[_nodes[n].label + 1] - _labelOffsets[_nodes[n].label];
+    }
+
+    PathBuilder builder{depth, dataSize};
+    appendKey(builder, node);
+
+    return builder.build();
+}
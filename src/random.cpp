@@ -0,0 +1,301 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		random.cpp
+ *	@brief		Implementation of ChaCha20 based SecureRandom.
+ *
+ * The state is the one of original ChaCha20: four constant words, eight words of the key,
+ * a 64 bit block counter and a 64 bit stream identifier. Each refill produces a few consecutive blocks
+ * so that the rounds of independent blocks can overlap. The system is only asked for a seed
+ * when a generator is created, never for the random numbers themselves.
+ ******************************************************************************/
+#include "solace/random.hpp"
+#include "solace/exception.hpp"
+#include "solace/posixErrorDomain.hpp"
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#include <pthread.h>
+#include <unistd.h>
+#ifdef SOLACE_PLATFORM_LINUX
+#include <sys/random.h>
+#endif
+
+
+using namespace Solace;
+
+
+namespace /* anonymous */ {
+
+constexpr uint32 kSigma[4] = {0x61707865, 0x3320646e, 0x79622d32, 0x6b206574};  // "expand 32-byte k"
+
+inline uint32 rotl(uint32 value, int count) noexcept {
+    return (value << count) | (value >> (32 - count));
+}
+
+inline void quarterRound(uint32* x, int a, int b, int c, int d) noexcept {
+    x[a] += x[b]; x[d] = rotl(x[d] ^ x[a], 16);
+    x[c] += x[d]; x[b] = rotl(x[b] ^ x[c], 12);
+    x[a] += x[b]; x[d] = rotl(x[d] ^ x[a], 8);
+    x[c] += x[d]; x[b] = rotl(x[b] ^ x[c], 7);
+}
+
+inline uint32 readLE32(byte const* p) noexcept {
+    return static_cast<uint32>(p[0]) |
+            (static_cast<uint32>(p[1]) << 8) |
+            (static_cast<uint32>(p[2]) << 16) |
+            (static_cast<uint32>(p[3]) << 24);
+}
+
+inline void writeLE32(byte* p, uint32 value) noexcept {
+    p[0] = static_cast<byte>(value);
+    p[1] = static_cast<byte>(value >> 8);
+    p[2] = static_cast<byte>(value >> 16);
+    p[3] = static_cast<byte>(value >> 24);
+}
+
+
+/// Fill the buffer from the system source of randomness.
+Result<void, Error> systemRandom(byte* dest, size_t size) {
+    while (size != 0) {
+#ifdef SOLACE_PLATFORM_LINUX
+        auto const got = ::getrandom(dest, size, 0);
+        if (got < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            return Err(makeErrno("getrandom"));
+        }
+        auto const chunk = static_cast<size_t>(got);
+#else
+        auto const chunk = (size < 256) ? size : 256;  // getentropy limits requests to 256 bytes
+        if (::getentropy(dest, chunk) != 0) {
+            return Err(makeErrno("getentropy"));
+        }
+#endif
+        dest += chunk;
+        size -= chunk;
+    }
+
+    return Ok();
+}
+
+
+/// Incremented in a child process after fork, so that threads know to reseed their generators.
+std::atomic<uint32> forkGeneration{0};
+
+void onFork() noexcept {
+    forkGeneration.fetch_add(1, std::memory_order_relaxed);
+}
+
+}  // anonymous namespace
+
+
+constexpr SecureRandom::size_type SecureRandom::KeySize;
+constexpr SecureRandom::size_type SecureRandom::BlocksPerRefill;
+constexpr SecureRandom::size_type SecureRandom::BlockSize;
+
+
+SecureRandom::SecureRandom(MemoryView key, uint64 stream)
+    : _position{sizeof(_buffer)}
+{
+    if (key.size() != KeySize) {
+        raise<IllegalArgumentException>("key");
+    }
+
+    auto const keyBytes = key.dataAddress();
+    for (int i = 0; i < 4; ++i) {
+        _state[i] = kSigma[i];
+    }
+    for (int i = 0; i < 8; ++i) {
+        _state[4 + i] = readLE32(keyBytes + 4 * i);
+    }
+    _state[12] = 0;
+    _state[13] = 0;
+    _state[14] = static_cast<uint32>(stream);
+    _state[15] = static_cast<uint32>(stream >> 32);
+}
+
+
+SecureRandom::SecureRandom(SecureRandom&& rhs) noexcept
+    : _position{rhs._position}
+{
+    // Only the output not yet used is copied, the rest of the buffer may never have been filled
+    std::memcpy(_state, rhs._state, sizeof(_state));
+    std::memcpy(_buffer + _position, rhs._buffer + _position, sizeof(_buffer) - _position);
+
+    // Two generators must never produce the same stream
+    rhs.wipe();
+}
+
+
+SecureRandom&
+SecureRandom::operator= (SecureRandom&& rhs) noexcept {
+    if (this != &rhs) {
+        _position = rhs._position;
+        std::memcpy(_state, rhs._state, sizeof(_state));
+        std::memcpy(_buffer + _position, rhs._buffer + _position, sizeof(_buffer) - _position);
+        rhs.wipe();
+    }
+
+    return *this;
+}
+
+
+SecureRandom::~SecureRandom() noexcept {
+    // Don't leave the key and unused output in memory
+    wipe();
+}
+
+
+void
+SecureRandom::wipe() noexcept {
+    volatile byte* state = reinterpret_cast<volatile byte*>(_state);
+    for (size_t i = 0; i < sizeof(_state); ++i) {
+        state[i] = 0;
+    }
+    volatile byte* buffer = _buffer;
+    for (size_t i = 0; i < sizeof(_buffer); ++i) {
+        buffer[i] = 0;
+    }
+    _position = sizeof(_buffer);
+}
+
+
+void
+SecureRandom::refill() noexcept {
+    uint32 x[BlocksPerRefill][16];
+    for (size_type b = 0; b < BlocksPerRefill; ++b) {
+        std::memcpy(x[b], _state, sizeof(_state));
+        auto const counter = ((static_cast<uint64>(_state[13]) << 32) | _state[12]) + b;
+        x[b][12] = static_cast<uint32>(counter);
+        x[b][13] = static_cast<uint32>(counter >> 32);
+    }
+
+    // Rounds of different blocks are independent and are interleaved by the compiler
+    for (int round = 0; round < 10; ++round) {
+        for (auto& w : x) {
+            quarterRound(w, 0, 4, 8, 12);
+            quarterRound(w, 1, 5, 9, 13);
+            quarterRound(w, 2, 6, 10, 14);
+            quarterRound(w, 3, 7, 11, 15);
+        }
+        for (auto& w : x) {
+            quarterRound(w, 0, 5, 10, 15);
+            quarterRound(w, 1, 6, 11, 12);
+            quarterRound(w, 2, 7, 8, 13);
+            quarterRound(w, 3, 4, 9, 14);
+        }
+    }
+
+    for (size_type b = 0; b < BlocksPerRefill; ++b) {
+        auto const counter = ((static_cast<uint64>(_state[13]) << 32) | _state[12]) + b;
+        auto const out = _buffer + b * BlockSize;
+        for (int i = 0; i < 16; ++i) {
+            auto const input = (i == 12) ? static_cast<uint32>(counter)
+                             : (i == 13) ? static_cast<uint32>(counter >> 32)
+                             : _state[i];
+            writeLE32(out + 4 * i, x[b][i] + input);
+        }
+    }
+
+    auto const next = ((static_cast<uint64>(_state[13]) << 32) | _state[12]) + BlocksPerRefill;
+    _state[12] = static_cast<uint32>(next);
+    _state[13] = static_cast<uint32>(next >> 32);
+    _position = 0;
+}
+
+
+void
+SecureRandom::fill(MutableMemoryView dest) noexcept {
+    auto out = dest.dataAddress();
+    auto remaining = dest.size();
+    while (remaining != 0) {
+        if (_position == sizeof(_buffer)) {
+            refill();
+        }
+
+        auto const available = static_cast<size_type>(sizeof(_buffer)) - _position;
+        auto const chunk = (remaining < available) ? remaining : available;
+        std::memcpy(out, _buffer + _position, chunk);
+        _position += chunk;
+        out += chunk;
+        remaining -= chunk;
+    }
+}
+
+
+uint64
+SecureRandom::nextUInt64() noexcept {
+    if (sizeof(_buffer) - _position < sizeof(uint64)) {
+        refill();
+    }
+
+    uint64 value;
+    std::memcpy(&value, _buffer + _position, sizeof(value));
+    _position += sizeof(value);
+
+    return value;
+}
+
+
+uint32
+SecureRandom::nextUInt32() noexcept {
+    if (sizeof(_buffer) - _position < sizeof(uint32)) {
+        refill();
+    }
+
+    uint32 value;
+    std::memcpy(&value, _buffer + _position, sizeof(value));
+    _position += sizeof(value);
+
+    return value;
+}
+
+
+Result<SecureRandom, Error>
+Solace::makeSecureRandom() {
+    byte key[SecureRandom::KeySize];
+    auto seeded = systemRandom(key, sizeof(key));
+    if (!seeded) {
+        return Err(seeded.moveError());
+    }
+
+    SecureRandom random{wrapMemory(key)};
+    std::memset(key, 0, sizeof(key));
+
+    return Ok(std::move(random));
+}
+
+
+SecureRandom&
+Solace::threadLocalRandom() {
+    [[maybe_unused]] static int const forkHandler = ::pthread_atfork(nullptr, nullptr, onFork);
+    thread_local SecureRandom random = makeSecureRandom().unwrap();
+    thread_local uint32 generation = forkGeneration.load(std::memory_order_relaxed);
+
+    auto const current = forkGeneration.load(std::memory_order_relaxed);
+    if (generation != current) {  // Running in a child process that must not repeat the parent
+        random = makeSecureRandom().unwrap();
+        generation = current;
+    }
+
+    return random;
+}
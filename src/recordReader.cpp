@@ -0,0 +1,298 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		recordReader.cpp
+ *	@brief		Implementation of RecordReader.
+ *
+ * Delimiters are found by searching for the first byte of the delimiter and verifying the rest.
+ * On x86-64 the search compares 64 bytes per iteration with SSE2 and only looks at individual
+ * bytes once a block with a candidate is found. Each byte of the buffer is scanned at most once:
+ * the reader remembers how far it has searched so a refill does not rescan a partial record.
+ ******************************************************************************/
+#include "solace/recordReader.hpp"
+#include "solace/memoryManager.hpp"
+#include "solace/posixErrorDomain.hpp"
+#include "solace/exception.hpp"
+
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+
+#if defined(__x86_64__)
+#define SOLACE_RECORD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+
+using namespace Solace;
+
+
+namespace /* anonymous */ {
+
+/// Find the first occurrence of the byte value. @return Offset of the byte or count if not found.
+size_t findByte(byte const* data, size_t count, byte value) noexcept {
+#ifdef SOLACE_RECORD_SSE2
+    size_t i = 0;
+    auto const needle = _mm_set1_epi8(static_cast<char>(value));
+    for (; i + 64 <= count; i += 64) {
+        auto const block = reinterpret_cast<__m128i const*>(data + i);
+        auto const m0 = _mm_cmpeq_epi8(_mm_loadu_si128(block + 0), needle);
+        auto const m1 = _mm_cmpeq_epi8(_mm_loadu_si128(block + 1), needle);
+        auto const m2 = _mm_cmpeq_epi8(_mm_loadu_si128(block + 2), needle);
+        auto const m3 = _mm_cmpeq_epi8(_mm_loadu_si128(block + 3), needle);
+        auto const any = _mm_or_si128(_mm_or_si128(m0, m1), _mm_or_si128(m2, m3));
+        if (_mm_movemask_epi8(any) == 0) {
+            continue;
+        }
+
+        uint64 const mask = static_cast<uint64>(static_cast<uint32>(_mm_movemask_epi8(m0)))
+                | static_cast<uint64>(static_cast<uint32>(_mm_movemask_epi8(m1))) << 16
+                | static_cast<uint64>(static_cast<uint32>(_mm_movemask_epi8(m2))) << 32
+                | static_cast<uint64>(static_cast<uint32>(_mm_movemask_epi8(m3))) << 48;
+
+        return i + static_cast<size_t>(__builtin_ctzll(mask));
+    }
+
+    for (; i + 16 <= count; i += 16) {
+        auto const m = _mm_movemask_epi8(_mm_cmpeq_epi8(
+                                             _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + i)), needle));
+        if (m != 0) {
+            return i + static_cast<size_t>(__builtin_ctz(static_cast<uint32>(m)));
+        }
+    }
+
+    for (; i < count; ++i) {
+        if (data[i] == value) {
+            return i;
+        }
+    }
+
+    return count;
+#else
+    auto const found = static_cast<byte const*>(std::memchr(data, value, count));
+
+    return (found == nullptr) ? count : static_cast<size_t>(found - data);
+#endif
+}
+
+}  // anonymous namespace
+
+
+RecordReader::RecordReader(MemoryView data, StringView delimiter)
+    : _data{data.dataAddress()}
+    , _end{data.size()}
+{
+    setDelimiter(delimiter);
+}
+
+
+RecordReader::RecordReader(ByteReader& reader, StringView delimiter)
+    : RecordReader{reader.viewRemaining(), delimiter}
+{
+    _reader = &reader;
+}
+
+
+RecordReader::RecordReader(int fd, MemoryResource&& buffer, StringView delimiter)
+    : _buffer{std::move(buffer)}
+    , _fd{fd}
+    , _eof{false}
+{
+    if (_buffer.size() == 0) {
+        raise<IllegalArgumentException>("buffer");
+    }
+
+    _data = _buffer.view().dataAddress();
+    setDelimiter(delimiter);
+}
+
+
+RecordReader::RecordReader(int fd, StringView delimiter)
+    : RecordReader{fd, getSystemHeapMemoryManager().allocate(kDefaultBufferSize), delimiter}
+{
+}
+
+
+void
+RecordReader::setDelimiter(StringView delimiter) {
+    if (delimiter.empty() || delimiter.size() > kMaxDelimiterLength) {
+        raise<IllegalArgumentException>("delimiter");
+    }
+
+    std::memcpy(_delimiter, delimiter.data(), delimiter.size());
+    _delimiterLength = delimiter.size();
+    _stripCarriageReturn = (_delimiterLength == 1 && _delimiter[0] == '\n');
+}
+
+
+Result<bool, Error>
+RecordReader::refill() {
+    if (_eof) {
+        return Ok(false);
+    }
+
+    auto const pending = _end - _begin;
+    if (_begin != 0) {
+        auto dest = _buffer.view().dataAddress();
+        std::memmove(dest, dest + _begin, pending);
+        _scanned -= _begin;
+        _end = pending;
+        _begin = 0;
+    }
+
+    if (_end == _buffer.size()) {
+        // Buffer is full and there is no delimiter in it: drop the record up to the possible start of a delimiter
+        // and skip the rest of it once the delimiter is found. A record is reported only once, however many
+        // buffers it takes.
+        auto const reported = _skipRecord;
+        auto const dropped = (_scanned != 0) ? _scanned : _end;
+        auto dest = _buffer.view().dataAddress();
+        std::memmove(dest, dest + dropped, _end - dropped);
+        _end -= dropped;
+        _scanned = 0;
+        _consumed += dropped;
+        _skipRecord = true;
+
+        if (!reported) {
+            return Err(makeError(SystemErrors::Overflow, "RecordReader::refill"));
+        }
+    }
+
+    ssize_t bytesRead;
+    do {
+        bytesRead = ::read(_fd, _buffer.view().dataAddress() + _end, _buffer.size() - _end);
+    } while (bytesRead < 0 && errno == EINTR);
+
+    if (bytesRead < 0) {
+        return Err(makeErrno("read"));
+    }
+
+    if (bytesRead == 0) {
+        _eof = true;
+        return Ok(false);
+    }
+
+    _end += static_cast<size_type>(bytesRead);
+
+    return Ok(true);
+}
+
+
+Result<StringView, Error>
+RecordReader::consume(size_type recordLength, size_type delimiterLength) {
+    auto const record = reinterpret_cast<char const*>(_data + _begin);
+    auto const consumed = recordLength + delimiterLength;
+    if (_reader) {
+        auto advanced = _reader->advance(consumed);
+        if (!advanced) {
+            return Err(advanced.moveError());
+        }
+    }
+
+    _begin += consumed;
+    _scanned = _begin;
+    _consumed += consumed;
+
+    if (_stripCarriageReturn && delimiterLength != 0 && recordLength != 0 && record[recordLength - 1] == '\r') {
+        recordLength -= 1;
+    }
+
+    return Ok(StringView{record, static_cast<StringView::size_type>(recordLength)});
+}
+
+
+Result<Optional<StringView>, Error>
+RecordReader::skip(size_type recordLength, size_type delimiterLength) {
+    auto consumed = consume(recordLength, delimiterLength);
+    if (!consumed) {
+        return Err(consumed.moveError());
+    }
+
+    if (_skipRecord) {  // Rest of a record that has already been reported
+        _skipRecord = false;
+        return Ok(Optional<StringView>{none});
+    }
+
+    return Err(makeError(SystemErrors::Overflow, "RecordReader::next"));
+}
+
+
+Result<Optional<StringView>, Error>
+RecordReader::next() {
+    while (true) {
+        while (_scanned < _end) {
+            auto const found = _scanned + findByte(_data + _scanned, _end - _scanned, _delimiter[0]);
+            if (found == _end) {
+                _scanned = _end;
+                break;
+            }
+
+            if (found + _delimiterLength > _end) {  // Delimiter may continue past the end of the data.
+                _scanned = found;
+                break;
+            }
+
+            if (std::memcmp(_data + found + 1, _delimiter + 1, _delimiterLength - 1) != 0) {
+                _scanned = found + 1;
+                continue;
+            }
+
+            auto const recordLength = found - _begin;
+            if (_skipRecord || recordLength > kMaxRecordLength) {
+                auto skipped = skip(recordLength, _delimiterLength);
+                if (!skipped) {
+                    return skipped;
+                }
+
+                continue;
+            }
+
+            auto record = consume(recordLength, _delimiterLength);
+            if (!record) {
+                return Err(record.moveError());
+            }
+
+            return Ok(Optional<StringView>{record.unwrap()});
+        }
+
+        auto more = refill();
+        if (!more) {
+            return Err(more.moveError());
+        }
+
+        if (more.unwrap()) {
+            continue;
+        }
+
+        // End of input: whatever is left is the last record.
+        if (_begin == _end) {
+            return Ok(Optional<StringView>{none});
+        }
+
+        auto const recordLength = _end - _begin;
+        if (_skipRecord || recordLength > kMaxRecordLength) {
+            return skip(recordLength, 0);
+        }
+
+        auto record = consume(recordLength, 0);
+        if (!record) {
+            return Err(record.moveError());
+        }
+
+        return Ok(Optional<StringView>{record.unwrap()});
+    }
+}
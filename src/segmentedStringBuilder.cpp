@@ -0,0 +1,348 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		segmentedStringBuilder.cpp
+ *	@brief		Implementation of SegmentedStringBuilder
+ ******************************************************************************/
+#include "solace/segmentedStringBuilder.hpp"
+#include "solace/exception.hpp"
+
+#include <algorithm>
+#include <cstring>  // memchr, memcmp, memcpy
+#include <limits>
+
+
+using namespace Solace;
+
+
+template<typename SegmentsView, typename F>
+void
+SegmentedStringBuilder::forEachChunk(SegmentsView segments, size_type from, size_type to, F&& f) {
+    size_type segmentStart = 0;
+    for (auto& s : segments) {
+        if (segmentStart >= to) {
+            break;
+        }
+
+        auto const segmentEnd = segmentStart + s.size;
+        auto const first = std::max(from, segmentStart);
+        auto const last = std::min(to, segmentEnd);
+        if (first < last) {
+            f(s, first - segmentStart, last - first, first - from);
+        }
+
+        segmentStart = segmentEnd;
+    }
+}
+
+
+SegmentedStringBuilder::size_type
+SegmentedStringBuilder::capacity() const noexcept {
+    size_type total = 0;
+    for (auto const& s : _segments) {
+        total += s.memory.size();
+    }
+
+    return total;
+}
+
+
+MutableMemoryView
+SegmentedStringBuilder::reserve(size_type minSize) {
+    if (!_segments.empty()) {
+        auto& tail = _segments.view()[_segments.size() - 1];
+        auto const freeSpace = tail.memory.size() - tail.size;
+        if (freeSpace > 0 && freeSpace >= minSize) {
+            return tail.remaining();
+        }
+    }
+
+    if (_segments.size() == _segments.capacity()) {
+        // Grow the table of segments. Only segment handles are moved, the data stays in place.
+        auto const newCapacity = std::max<uint32>(4, 2 * _segments.capacity());
+        auto newSegments = makeVector<Segment>(_memoryManager->allocate(newCapacity * sizeof(Segment)));
+        for (auto& s : _segments) {
+            newSegments.emplace_back(std::move(s.memory), s.size);
+        }
+
+        _segments = std::move(newSegments);
+    }
+
+    auto const segmentSize = _segments.empty()
+            ? _segmentSize
+            : std::min(2 * _segments[_segments.size() - 1].memory.size(), kMaxSegmentSize);
+
+    _segments.emplace_back(_memoryManager->allocate(std::max(segmentSize, minSize)), 0);
+
+    return _segments.view()[_segments.size() - 1].remaining();
+}
+
+
+void
+SegmentedStringBuilder::commit(size_type bytesWritten) noexcept {
+    _segments.view()[_segments.size() - 1].size += bytesWritten;
+    _length += bytesWritten;
+}
+
+
+void
+SegmentedStringBuilder::appendBytes(MemoryView bytes) {
+    while (!bytes.empty()) {
+        auto dest = reserve(0);
+        auto const chunkSize = std::min(dest.size(), bytes.size());
+        std::memcpy(dest.dataAddress(), bytes.dataAddress(), chunkSize);
+        commit(chunkSize);
+
+        bytes = bytes.slice(chunkSize, bytes.size());
+    }
+}
+
+
+SegmentedStringBuilder&
+SegmentedStringBuilder::append(char c) {
+    auto dest = reserve(1);
+    *dest.dataAddress() = static_cast<byte>(c);
+    commit(1);
+
+    return *this;
+}
+
+
+SegmentedStringBuilder&
+SegmentedStringBuilder::append(StringView str) {
+    appendBytes(str.view());
+
+    return *this;
+}
+
+
+SegmentedStringBuilder&
+SegmentedStringBuilder::clear() noexcept {
+    for (auto& s : _segments) {
+        s.size = 0;
+    }
+
+    // Reuse segments from the first one
+    while (_segments.size() > 1) {
+        _segments.pop_back();
+    }
+
+    _length = 0;
+
+    return *this;
+}
+
+
+void
+SegmentedStringBuilder::raiseFormatError(Error const& error, size_type segmentSize) {
+    if (error == makeError(SystemErrors::Overflow, "formatTo()")) {
+        raise<OverflowException>("appendFormat", segmentSize, 0, std::numeric_limits<size_type>::max());
+    }
+
+    raise<IllegalArgumentException>("fmt");
+}
+
+
+char
+SegmentedStringBuilder::charAt(size_type index) const {
+    if (index >= _length) {
+        raise<IndexOutOfRangeException>("index", index, 0, _length);
+    }
+
+    char result = 0;
+    forEachChunk(_segments.view(), index, index + 1,
+                 [&result](Segment const& s, size_type offset, size_type, size_type) {
+        result = static_cast<char>(s.view()[offset]);
+    });
+
+    return result;
+}
+
+
+Optional<SegmentedStringBuilder::size_type>
+SegmentedStringBuilder::indexOf(char ch, size_type fromIndex) const noexcept {
+    size_type segmentStart = 0;
+    for (auto const& s : _segments) {
+        if (fromIndex < segmentStart + s.size) {
+            auto const offset = (fromIndex > segmentStart) ? fromIndex - segmentStart : 0;
+            auto const data = s.view();
+            auto const found = std::memchr(data.dataAddress(offset), ch, s.size - offset);
+            if (found) {
+                return Optional<size_type>(segmentStart +
+                                           static_cast<size_type>(static_cast<byte const*>(found) -
+                                                                  data.dataAddress()));
+            }
+        }
+
+        segmentStart += s.size;
+    }
+
+    return none;
+}
+
+
+Optional<SegmentedStringBuilder::size_type>
+SegmentedStringBuilder::indexOf(StringView str, size_type fromIndex) const noexcept {
+    if (str.empty()) {
+        return (fromIndex <= _length)
+                ? Optional<size_type>(fromIndex)
+                : none;
+    }
+
+    // Find candidates by the first character and verify the rest of the match, which may span segments.
+    for (auto candidate = indexOf(str[0], fromIndex);
+         candidate.isSome();
+         candidate = indexOf(str[0], candidate.get() + 1)) {
+        auto const start = candidate.get();
+        if (start + str.size() > _length) {
+            break;
+        }
+
+        bool matches = true;
+        forEachChunk(_segments.view(), start, start + str.size(),
+                     [&matches, str](Segment const& s, size_type offset, size_type chunkSize, size_type pos) {
+            matches = matches && (std::memcmp(s.view().dataAddress(offset), str.data() + pos, chunkSize) == 0);
+        });
+
+        if (matches) {
+            return candidate;
+        }
+    }
+
+    return none;
+}
+
+
+SegmentedStringBuilder::size_type
+SegmentedStringBuilder::replace(char what, char with) noexcept {
+    size_type count = 0;
+    for (auto& s : _segments) {
+        for (auto& c : s.memory.view().slice(0, s.size)) {
+            if (c == static_cast<byte>(what)) {
+                c = static_cast<byte>(with);
+                count += 1;
+            }
+        }
+    }
+
+    return count;
+}
+
+
+SegmentedStringBuilder::size_type
+SegmentedStringBuilder::replace(StringView what, StringView with) {
+    if (what.empty()) {
+        return 0;
+    }
+
+    size_type count = 0;
+    if (what.size() == with.size()) {
+        for (auto match = indexOf(what, 0); match.isSome(); match = indexOf(what, match.get() + what.size())) {
+            forEachChunk(_segments.view(), match.get(), match.get() + with.size(),
+                         [with](Segment& s, size_type offset, size_type chunkSize, size_type pos) {
+                std::memcpy(s.memory.view().dataAddress(offset), with.data() + pos, chunkSize);
+            });
+
+            count += 1;
+        }
+
+        return count;
+    }
+
+    // Length changes: rebuild content into a new chain of segments sized to fit most of the result.
+    SegmentedStringBuilder result{*_memoryManager, std::max(_segmentSize, _length)};
+    auto copyRange = [this, &result](size_type from, size_type to) {
+        forEachChunk(_segments.view(), from, to,
+                     [&result](Segment const& s, size_type offset, size_type chunkSize, size_type) {
+            result.appendBytes(s.view().slice(offset, offset + chunkSize));
+        });
+    };
+
+    size_type position = 0;
+    for (auto match = indexOf(what, 0); match.isSome(); match = indexOf(what, position)) {
+        copyRange(position, match.get());
+        result.append(with);
+        position = match.get() + what.size();
+        count += 1;
+    }
+
+    if (count > 0) {
+        copyRange(position, _length);
+        swap(result);
+    }
+
+    return count;
+}
+
+
+Result<String, Error>
+SegmentedStringBuilder::substring(size_type from, size_type to) const {
+    from = std::min(from, _length);
+    to = std::min(_length, std::max(to, from));
+
+    auto const stringLength = to - from;
+    if (stringLength > std::numeric_limits<String::size_type>::max()) {
+        return Err(makeError(SystemErrors::Overflow, "SegmentedStringBuilder::substring()"));
+    }
+
+    auto buffer = _memoryManager->allocate(stringLength);  // May throw
+    auto dest = buffer.view();
+    forEachChunk(_segments.view(), from, to,
+                 [&dest](Segment const& s, size_type offset, size_type chunkSize, size_type pos) {
+        std::memcpy(dest.dataAddress(pos), s.view().dataAddress(offset), chunkSize);
+    });
+
+    return Ok(String{std::move(buffer), static_cast<String::size_type>(stringLength)});
+}
+
+
+Result<void, Error>
+SegmentedStringBuilder::copyTo(ByteWriter& dest) const {
+    if (dest.remaining() < _length) {
+        return Err(makeError(SystemErrors::Overflow, "SegmentedStringBuilder::copyTo()"));
+    }
+
+    for (auto const& s : _segments) {
+        auto result = dest.write(s.view());
+        if (!result) {
+            return result;
+        }
+    }
+
+    return Ok();
+}
+
+
+ArrayView<iovec>::size_type
+SegmentedStringBuilder::toIOVec(ArrayView<iovec> dest) const noexcept {
+    ArrayView<iovec>::size_type count = 0;
+    for (auto const& s : _segments) {
+        if (count >= dest.size()) {
+            break;
+        }
+
+        if (s.size == 0) {
+            continue;
+        }
+
+        auto& entry = dest[count++];
+        entry.iov_base = const_cast<byte*>(s.view().dataAddress());
+        entry.iov_len = s.size;
+    }
+
+    return count;
+}
@@ -23,6 +23,8 @@
  ******************************************************************************/
 #include "solace/stringBuilder.hpp"
 #include "solace/byteReader.hpp"
+#include "solace/exception.hpp"
+#include "solace/posixErrorDomain.hpp"
 
 
 using namespace Solace;
@@ -56,6 +58,17 @@ StringBuilder& StringBuilder::append(StringView cstr) {
 	return *this;
 }
 
+void
+StringBuilder::raiseFormatError(ByteWriter::size_type mark, Error const& error) {
+    _buffer.position(mark);
+
+    if (error == makeError(SystemErrors::Overflow, "formatTo()")) {
+        raise<OverflowException>("appendFormat", mark, 0, _buffer.capacity());
+    }
+
+    raise<IllegalArgumentException>("fmt");
+}
+
 StringView
 StringBuilder::view() const noexcept {
     return StringView(_buffer.viewWritten().dataAs<const char>(), _buffer.position());
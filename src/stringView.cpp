@@ -18,6 +18,7 @@
  *	@brief		Implementation of string view class.
  ******************************************************************************/
 #include "solace/stringView.hpp"
+#include "solace/asciiCase.hpp"
 
 #include <cstring>      // strlen
 #include <algorithm>    // std::min
@@ -68,6 +69,30 @@ StringView::compareTo(StringView x) const noexcept {
 }
 
 
+bool
+StringView::equalsIgnoreCase(StringView str) const noexcept {
+    auto const thisLen = size();
+    if (thisLen != str.size()) {
+        return false;
+    }
+
+    return mismatchIgnoreCaseAscii(_data, str._data, thisLen) == thisLen;
+}
+
+
+int
+StringView::compareToIgnoreCase(StringView x) const noexcept {
+    auto const commonSize = std::min(size(), x.size());
+    auto const i = mismatchIgnoreCaseAscii(_data, x._data, commonSize);
+    if (i < commonSize) {
+        return static_cast<unsigned char>(toLowerAscii(_data[i])) -
+                static_cast<unsigned char>(toLowerAscii(x._data[i]));
+    }
+
+    return static_cast<int>(size()) - static_cast<int>(x.size());
+}
+
+
 StringView
 StringView::substring(size_type from, size_type to) const noexcept {
     auto const thisSize = size();
@@ -129,6 +154,39 @@ StringView::indexOf(StringView str, size_type fromIndex) const noexcept {
 
 
 
+Optional<StringView::size_type>
+StringView::indexOfIgnoreCase(StringView str, size_type fromIndex) const noexcept {
+    auto const thisSize = size();
+    auto const strSize = str.size();
+
+    if ((thisSize < fromIndex) || (thisSize < strSize) || (thisSize < fromIndex + strSize)) {
+        return none;
+    }
+
+    if (strSize == 0) {
+        return Optional<size_type>(fromIndex);
+    }
+
+    // Only positions where the needle can start are scanned for its first character.
+    size_type const lastFrom = thisSize - strSize;
+    while (fromIndex <= lastFrom) {
+        auto const offset = findIgnoreCaseAscii(_data + fromIndex, lastFrom - fromIndex + 1, str._data[0]);
+        if (offset > static_cast<size_t>(lastFrom - fromIndex)) {
+            break;
+        }
+
+        fromIndex += static_cast<size_type>(offset);
+        if (mismatchIgnoreCaseAscii(_data + fromIndex + 1, str._data + 1, strSize - 1) == strSize - 1u) {
+            return Optional<size_type>(fromIndex);
+        }
+
+        fromIndex += 1;
+    }
+
+    return none;
+}
+
+
 Optional<StringView::size_type>
 StringView::lastIndexOf(value_type ch, size_type fromIndex) const noexcept {
     auto const thisSize = size();
@@ -191,6 +249,29 @@ StringView::endsWith(StringView suffix) const noexcept {
 }
 
 
+bool
+StringView::startsWithIgnoreCase(StringView prefix) const noexcept {
+    auto const prefixSize = prefix.size();
+    if (size() < prefixSize) {
+        return false;
+    }
+
+    return mismatchIgnoreCaseAscii(_data, prefix._data, prefixSize) == prefixSize;
+}
+
+
+bool
+StringView::endsWithIgnoreCase(StringView suffix) const noexcept {
+    auto const thisSize = size();
+    auto const suffixSize = suffix.size();
+    if (thisSize < suffixSize) {
+        return false;
+    }
+
+    return mismatchIgnoreCaseAscii(_data + (thisSize - suffixSize), suffix._data, suffixSize) == suffixSize;
+}
+
+
 StringView
 StringView::trim() const noexcept {
     size_type fromIndex = 0;
@@ -234,3 +315,15 @@ StringView::hashCode() const noexcept {
 
     return result;
 }
+
+
+uint64
+StringView::hashCodeIgnoreCase() const noexcept {
+    uint64 result = 0;
+    const uint64 prime = 31;
+    for (size_t i = 0; i < _size; ++i) {
+        result = toLowerAscii(_data[i]) + (result * prime);
+    }
+
+    return result;
+}
@@ -0,0 +1,760 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace
+ *	@file		utf8.cpp
+ *	@brief		Implementation of UTF-8 validation and transcoding.
+ *
+ * Vectorized validation follows the lookup algorithm of Keiser and Lemire,
+ * "Validating UTF-8 In Less Than One Instruction Per Byte" (2020): each byte pair is classified
+ * with three 16-entry nibble lookups whose AND is non-zero only for an invalid pair, and
+ * continuation requirements of 3 and 4 byte sequences are checked separately.
+ * On an error the exact offset is found by re-validating with the scalar validator
+ * from the last block boundary known to start a new sequence.
+ ******************************************************************************/
+#include "solace/utf8.hpp"
+#include "solace/cpuFeatures.hpp"
+#include "solace/posixErrorDomain.hpp"
+
+#include <cstring>  // memcpy, memset
+
+#if defined(__x86_64__)
+#define SOLACE_UTF8_X86 1
+#include <immintrin.h>
+#endif
+
+
+using namespace Solace;
+
+using size_type = MemoryView::size_type;
+
+
+Error
+EncodingError::toError() const noexcept {
+    return (kind == Kind::DestinationTooSmall)
+            ? makeError(SystemErrors::Overflow, "utf8")
+            : makeError(SystemErrors::ILSEQ, "utf8");
+}
+
+
+namespace /* anonymous */ {
+
+constexpr bool isContinuation(byte b) noexcept {
+    return (b & 0xC0) == 0x80;
+}
+
+
+/**
+ * Determine length of a well-formed UTF-8 sequence starting at the given offset.
+ * @return Length of the sequence or 0 if the sequence is ill-formed or truncated.
+ */
+size_type sequenceLength(byte const* data, size_type size, size_type i) noexcept {
+    byte const lead = data[i];
+    if (lead < 0x80) {
+        return 1;
+    }
+
+    size_type length = 0;
+    byte low = 0x80;
+    byte high = 0xBF;
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        length = 2;
+    } else if (lead == 0xE0) {
+        length = 3;
+        low = 0xA0;
+    } else if (lead >= 0xE1 && lead <= 0xEC) {
+        length = 3;
+    } else if (lead == 0xED) {  // Exclude surrogates
+        length = 3;
+        high = 0x9F;
+    } else if (lead >= 0xEE && lead <= 0xEF) {
+        length = 3;
+    } else if (lead == 0xF0) {
+        length = 4;
+        low = 0x90;
+    } else if (lead >= 0xF1 && lead <= 0xF3) {
+        length = 4;
+    } else if (lead == 0xF4) {  // Exclude code points above U+10FFFF
+        length = 4;
+        high = 0x8F;
+    } else {
+        return 0;
+    }
+
+    if (size - i < length || data[i + 1] < low || data[i + 1] > high) {
+        return 0;
+    }
+
+    for (size_type k = 2; k < length; ++k) {
+        if (!isContinuation(data[i + k])) {
+            return 0;
+        }
+    }
+
+    return length;
+}
+
+
+/// Decode a well-formed sequence of the given length.
+uint32 decodeSequence(byte const* data, size_type length) noexcept {
+    switch (length) {
+    case 1:
+        return data[0];
+    case 2:
+        return ((data[0] & 0x1Fu) << 6) | (data[1] & 0x3Fu);
+    case 3:
+        return ((data[0] & 0x0Fu) << 12) | ((data[1] & 0x3Fu) << 6) | (data[2] & 0x3Fu);
+    default:
+        return ((data[0] & 0x07u) << 18) | ((data[1] & 0x3Fu) << 12) | ((data[2] & 0x3Fu) << 6) | (data[3] & 0x3Fu);
+    }
+}
+
+
+/// Encode a code point into UTF-8. @return Number of bytes written.
+size_type encodeCodePoint(uint32 cp, byte* out) noexcept {
+    if (cp < 0x80) {
+        out[0] = static_cast<byte>(cp);
+        return 1;
+    }
+
+    if (cp < 0x800) {
+        out[0] = static_cast<byte>(0xC0 | (cp >> 6));
+        out[1] = static_cast<byte>(0x80 | (cp & 0x3F));
+        return 2;
+    }
+
+    if (cp < 0x10000) {
+        out[0] = static_cast<byte>(0xE0 | (cp >> 12));
+        out[1] = static_cast<byte>(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = static_cast<byte>(0x80 | (cp & 0x3F));
+        return 3;
+    }
+
+    out[0] = static_cast<byte>(0xF0 | (cp >> 18));
+    out[1] = static_cast<byte>(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = static_cast<byte>(0x80 | ((cp >> 6) & 0x3F));
+    out[3] = static_cast<byte>(0x80 | (cp & 0x3F));
+
+    return 4;
+}
+
+
+constexpr size_type utf8Width(uint32 cp) noexcept {
+    return (cp < 0x80) ? 1 : (cp < 0x800) ? 2 : (cp < 0x10000) ? 3 : 4;
+}
+
+
+/**
+ * Scalar validation.
+ * @return Offset of the first ill-formed sequence or size if the data is valid.
+ */
+size_type validateScalar(byte const* data, size_type size, size_type i) noexcept {
+    while (i < size) {
+        // Skip ASCII 8 bytes at a time
+        if (size - i >= 8) {
+            uint64 word;
+            std::memcpy(&word, data + i, sizeof(word));
+            if ((word & 0x8080808080808080ULL) == 0) {
+                i += 8;
+                continue;
+            }
+        }
+
+        auto const length = sequenceLength(data, size, i);
+        if (length == 0) {
+            return i;
+        }
+
+        i += length;
+    }
+
+    return size;
+}
+
+
+size_type countCodePointsScalar(byte const* data, size_type size) noexcept {
+    size_type count = 0;
+    for (size_type i = 0; i < size; ++i) {
+        count += isContinuation(data[i]) ? 0 : 1;
+    }
+
+    return count;
+}
+
+
+/**
+ * Vectorized validation function.
+ * @return Size of the data if it is valid, or offset to restart scalar validation from to locate the error.
+ */
+using ValidateFn = size_type (*)(byte const* data, size_type size);
+using CountFn = size_type (*)(byte const* data, size_type size);
+
+
+size_type validateFallback(byte const*, size_type) noexcept {
+    return 0;
+}
+
+
+#ifdef SOLACE_UTF8_X86
+
+// Error bits of the lookup tables
+constexpr byte kTooShort    = 1 << 0;
+constexpr byte kTooLong     = 1 << 1;
+constexpr byte kOverlong3   = 1 << 2;
+constexpr byte kTooLarge    = 1 << 3;
+constexpr byte kSurrogate   = 1 << 4;
+constexpr byte kOverlong2   = 1 << 5;
+constexpr byte kTooLarge1000 = 1 << 6;
+constexpr byte kOverlong4   = 1 << 6;
+constexpr byte kTwoConts    = 1 << 7;
+constexpr byte kCarry       = kTooShort | kTooLong | kTwoConts;
+
+alignas(16) constexpr byte kByte1High[16] = {
+    // 0_______ ________ <ASCII in byte 1>
+    kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong,
+    // 10______ ________ <continuation in byte 1>
+    kTwoConts, kTwoConts, kTwoConts, kTwoConts,
+    // 1100____ ________ <two byte lead in byte 1>
+    kTooShort | kOverlong2,
+    // 1101____ ________ <two byte lead in byte 1>
+    kTooShort,
+    // 1110____ ________ <three byte lead in byte 1>
+    kTooShort | kOverlong3 | kSurrogate,
+    // 1111____ ________ <four+ byte lead in byte 1>
+    kTooShort | kTooLarge | kTooLarge1000 | kOverlong4
+};
+
+alignas(16) constexpr byte kByte1Low[16] = {
+    kCarry | kOverlong3 | kOverlong2 | kOverlong4,      // ____0000
+    kCarry | kOverlong2,                                // ____0001
+    kCarry,                                             // ____001_
+    kCarry,
+    kCarry | kTooLarge,                                 // ____0100
+    kCarry | kTooLarge | kTooLarge1000,                 // ____0101
+    kCarry | kTooLarge | kTooLarge1000,                 // ____011_
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,                 // ____1___
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000 | kSurrogate,    // ____1101
+    kCarry | kTooLarge | kTooLarge1000,
+    kCarry | kTooLarge | kTooLarge1000
+};
+
+alignas(16) constexpr byte kByte2High[16] = {
+    // ________ 0_______ <ASCII in byte 2>
+    kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort,
+    // ________ 1000____
+    kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge1000 | kOverlong4,
+    // ________ 1001____
+    kTooLong | kOverlong2 | kTwoConts | kOverlong3 | kTooLarge,
+    // ________ 101_____
+    kTooLong | kOverlong2 | kTwoConts | kSurrogate  | kTooLarge,
+    kTooLong | kOverlong2 | kTwoConts | kSurrogate  | kTooLarge,
+    // ________ 11______
+    kTooShort, kTooShort, kTooShort, kTooShort
+};
+
+/// Maximum values of the last bytes of a block that do not start an incomplete sequence.
+alignas(32) constexpr byte kIncompleteMax[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xF0 - 1, 0xE0 - 1, 0xC0 - 1
+};
+
+
+inline __m128i load128(byte const* p) noexcept {
+    return _mm_loadu_si128(reinterpret_cast<__m128i const*>(p));
+}
+
+
+__attribute__((target("sse4.1")))
+__m128i checkBlockSse(__m128i input, __m128i prevInput) noexcept {
+    __m128i const lowNibbleMask = _mm_set1_epi8(0x0F);
+
+    __m128i const prev1 = _mm_alignr_epi8(input, prevInput, 16 - 1);
+    __m128i const byte1High = _mm_shuffle_epi8(load128(kByte1High),
+                                               _mm_and_si128(_mm_srli_epi16(prev1, 4), lowNibbleMask));
+    __m128i const byte1Low = _mm_shuffle_epi8(load128(kByte1Low), _mm_and_si128(prev1, lowNibbleMask));
+    __m128i const byte2High = _mm_shuffle_epi8(load128(kByte2High),
+                                               _mm_and_si128(_mm_srli_epi16(input, 4), lowNibbleMask));
+    __m128i const specialCases = _mm_and_si128(_mm_and_si128(byte1High, byte1Low), byte2High);
+
+    __m128i const prev2 = _mm_alignr_epi8(input, prevInput, 16 - 2);
+    __m128i const prev3 = _mm_alignr_epi8(input, prevInput, 16 - 3);
+    __m128i const isThirdByte = _mm_subs_epu8(prev2, _mm_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+    __m128i const isFourthByte = _mm_subs_epu8(prev3, _mm_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+    __m128i const must23 = _mm_and_si128(_mm_or_si128(isThirdByte, isFourthByte),
+                                         _mm_set1_epi8(static_cast<char>(0x80)));
+
+    return _mm_xor_si128(must23, specialCases);
+}
+
+
+__attribute__((target("sse4.1")))
+size_type validateSse41(byte const* data, size_type size) noexcept {
+    constexpr size_type kBlockSize = 16;
+
+    __m128i const incompleteMax = load128(kIncompleteMax + 16);
+    __m128i error = _mm_setzero_si128();
+    __m128i prevInput = _mm_setzero_si128();
+    __m128i prevIncomplete = _mm_setzero_si128();
+    size_type lastBoundary = 0;
+
+    alignas(16) byte tail[kBlockSize];
+    for (size_type pos = 0; pos < size; ) {
+        size_type blockSize = kBlockSize;
+        __m128i input;
+        if (size - pos >= kBlockSize) {
+            input = load128(data + pos);
+        } else {
+            blockSize = size - pos;
+            std::memset(tail, 0, sizeof(tail));
+            std::memcpy(tail, data + pos, blockSize);
+            input = load128(tail);
+        }
+
+        if (_mm_movemask_epi8(input) == 0) {
+            // ASCII block: valid unless the previous block ended with a truncated sequence.
+            error = _mm_or_si128(error, prevIncomplete);
+            prevIncomplete = _mm_setzero_si128();
+        } else {
+            error = _mm_or_si128(error, checkBlockSse(input, prevInput));
+            prevIncomplete = _mm_subs_epu8(input, incompleteMax);
+        }
+
+        if (!_mm_testz_si128(error, error)) {
+            return lastBoundary;
+        }
+
+        prevInput = input;
+        pos += blockSize;
+        if (_mm_testz_si128(prevIncomplete, prevIncomplete)) {
+            lastBoundary = pos;
+        }
+    }
+
+    return _mm_testz_si128(prevIncomplete, prevIncomplete)
+            ? size
+            : lastBoundary;
+}
+
+
+__attribute__((target("avx2")))
+__m256i broadcastTable(byte const* table) noexcept {
+    return _mm256_broadcastsi128_si256(load128(table));
+}
+
+
+__attribute__((target("avx2")))
+__m256i checkBlockAvx2(__m256i input, __m256i prevInput) noexcept {
+    __m256i const lowNibbleMask = _mm256_set1_epi8(0x0F);
+    // Bytes of the previous block followed by the current one, to shift data across 128 bit lanes.
+    __m256i const shifted = _mm256_permute2x128_si256(prevInput, input, 0x21);
+
+    __m256i const prev1 = _mm256_alignr_epi8(input, shifted, 16 - 1);
+    __m256i const byte1High = _mm256_shuffle_epi8(broadcastTable(kByte1High),
+                                                  _mm256_and_si256(_mm256_srli_epi16(prev1, 4), lowNibbleMask));
+    __m256i const byte1Low = _mm256_shuffle_epi8(broadcastTable(kByte1Low),
+                                                 _mm256_and_si256(prev1, lowNibbleMask));
+    __m256i const byte2High = _mm256_shuffle_epi8(broadcastTable(kByte2High),
+                                                  _mm256_and_si256(_mm256_srli_epi16(input, 4), lowNibbleMask));
+    __m256i const specialCases = _mm256_and_si256(_mm256_and_si256(byte1High, byte1Low), byte2High);
+
+    __m256i const prev2 = _mm256_alignr_epi8(input, shifted, 16 - 2);
+    __m256i const prev3 = _mm256_alignr_epi8(input, shifted, 16 - 3);
+    __m256i const isThirdByte = _mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+    __m256i const isFourthByte = _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+    __m256i const must23 = _mm256_and_si256(_mm256_or_si256(isThirdByte, isFourthByte),
+                                            _mm256_set1_epi8(static_cast<char>(0x80)));
+
+    return _mm256_xor_si256(must23, specialCases);
+}
+
+
+__attribute__((target("avx2")))
+size_type validateAvx2(byte const* data, size_type size) noexcept {
+    constexpr size_type kBlockSize = 32;
+
+    __m256i const incompleteMax = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(kIncompleteMax));
+    __m256i error = _mm256_setzero_si256();
+    __m256i prevInput = _mm256_setzero_si256();
+    __m256i prevIncomplete = _mm256_setzero_si256();
+    size_type lastBoundary = 0;
+
+    alignas(32) byte tail[kBlockSize];
+    for (size_type pos = 0; pos < size; ) {
+        size_type blockSize = kBlockSize;
+        __m256i input;
+        if (size - pos >= kBlockSize) {
+            input = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(data + pos));
+        } else {
+            blockSize = size - pos;
+            std::memset(tail, 0, sizeof(tail));
+            std::memcpy(tail, data + pos, blockSize);
+            input = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(tail));
+        }
+
+        if (_mm256_movemask_epi8(input) == 0) {
+            error = _mm256_or_si256(error, prevIncomplete);
+            prevIncomplete = _mm256_setzero_si256();
+        } else {
+            error = _mm256_or_si256(error, checkBlockAvx2(input, prevInput));
+            prevIncomplete = _mm256_subs_epu8(input, incompleteMax);
+        }
+
+        if (!_mm256_testz_si256(error, error)) {
+            return lastBoundary;
+        }
+
+        prevInput = input;
+        pos += blockSize;
+        if (_mm256_testz_si256(prevIncomplete, prevIncomplete)) {
+            lastBoundary = pos;
+        }
+    }
+
+    return _mm256_testz_si256(prevIncomplete, prevIncomplete)
+            ? size
+            : lastBoundary;
+}
+
+
+size_type countCodePointsSse2(byte const* data, size_type size) noexcept {
+    // Count bytes that are not continuation bytes: as signed values those are greater than -65 (0xBF).
+    __m128i const threshold = _mm_set1_epi8(-65);
+    size_type count = 0;
+    size_type i = 0;
+    for (; i + 16 <= size; i += 16) {
+        auto const leads = _mm_cmpgt_epi8(load128(data + i), threshold);
+        count += static_cast<size_type>(__builtin_popcount(static_cast<uint32>(_mm_movemask_epi8(leads))));
+    }
+
+    return count + countCodePointsScalar(data + i, size - i);
+}
+
+
+__attribute__((target("avx2,popcnt")))
+size_type countCodePointsAvx2(byte const* data, size_type size) noexcept {
+    __m256i const threshold = _mm256_set1_epi8(-65);
+    size_type count = 0;
+    size_type i = 0;
+    for (; i + 32 <= size; i += 32) {
+        auto const input = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(data + i));
+        auto const leads = _mm256_cmpgt_epi8(input, threshold);
+        count += static_cast<size_type>(__builtin_popcount(static_cast<uint32>(_mm256_movemask_epi8(leads))));
+    }
+
+    return count + countCodePointsScalar(data + i, size - i);
+}
+
+#endif  // SOLACE_UTF8_X86
+
+
+ValidateFn selectValidate() noexcept {
+#ifdef SOLACE_UTF8_X86
+    if (cpu::hasAvx2()) {
+        return validateAvx2;
+    }
+
+    if (cpu::hasSse41()) {
+        return validateSse41;
+    }
+#endif
+
+    return validateFallback;
+}
+
+
+CountFn selectCount() noexcept {
+#ifdef SOLACE_UTF8_X86
+    if (cpu::hasAvx2()) {
+        return countCodePointsAvx2;
+    }
+
+    return countCodePointsSse2;
+#else
+    return countCodePointsScalar;
+#endif
+}
+
+
+size_type findInvalidUtf8(byte const* data, size_type size) noexcept {
+    static ValidateFn const validate = selectValidate();
+
+    auto const restart = validate(data, size);
+
+    return (restart == size)
+            ? size
+            : validateScalar(data, size, restart);
+}
+
+
+/// Check if the next 16 bytes are all ASCII.
+inline bool isAsciiBlock16(byte const* data) noexcept {
+#ifdef SOLACE_UTF8_X86
+    return _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<__m128i const*>(data))) == 0;
+#else
+    uint64 words[2];
+    std::memcpy(words, data, sizeof(words));
+    return ((words[0] | words[1]) & 0x8080808080808080ULL) == 0;
+#endif
+}
+
+
+template<typename CharT>
+Result<typename ArrayView<CharT>::size_type, EncodingError>
+utf8ToUtfN(MemoryView src, ArrayView<CharT> dest) noexcept {
+    using dest_size_type = typename ArrayView<CharT>::size_type;
+
+    byte const* const data = src.dataAddress();
+    size_type const size = src.size();
+    CharT* const out = dest.begin();
+    dest_size_type const capacity = dest.size();
+
+    size_type i = 0;
+    dest_size_type written = 0;
+    while (i < size) {
+        // ASCII fast path: widen 16 bytes at a time
+        if (size - i >= 16 && capacity - written >= 16 && isAsciiBlock16(data + i)) {
+#ifdef SOLACE_UTF8_X86
+            __m128i const zero = _mm_setzero_si128();
+            __m128i const input = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + i));
+            __m128i const low = _mm_unpacklo_epi8(input, zero);
+            __m128i const high = _mm_unpackhi_epi8(input, zero);
+            if (sizeof(CharT) == 2) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + written), low);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + written + 8), high);
+            } else {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + written), _mm_unpacklo_epi16(low, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + written + 4), _mm_unpackhi_epi16(low, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + written + 8), _mm_unpacklo_epi16(high, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out + written + 12), _mm_unpackhi_epi16(high, zero));
+            }
+#else
+            for (int k = 0; k < 16; ++k) {
+                out[written + k] = data[i + k];
+            }
+#endif
+            i += 16;
+            written += 16;
+            continue;
+        }
+
+        auto const length = sequenceLength(data, size, i);
+        if (length == 0) {
+            return Err(EncodingError{EncodingError::Kind::InvalidSequence, i});
+        }
+
+        auto const codePoint = decodeSequence(data + i, length);
+        if (sizeof(CharT) == 2 && codePoint >= 0x10000) {
+            if (capacity - written < 2) {
+                return Err(EncodingError{EncodingError::Kind::DestinationTooSmall, i});
+            }
+
+            out[written++] = static_cast<CharT>(0xD800 + ((codePoint - 0x10000) >> 10));
+            out[written++] = static_cast<CharT>(0xDC00 + ((codePoint - 0x10000) & 0x3FF));
+        } else {
+            if (capacity - written < 1) {
+                return Err(EncodingError{EncodingError::Kind::DestinationTooSmall, i});
+            }
+
+            out[written++] = static_cast<CharT>(codePoint);
+        }
+
+        i += length;
+    }
+
+    return Ok(written);
+}
+
+}  // anonymous namespace
+
+
+Result<void, EncodingError>
+Solace::validateUtf8(MemoryView data) noexcept {
+    auto const invalidOffset = findInvalidUtf8(data.dataAddress(), data.size());
+    if (invalidOffset != data.size()) {
+        return Err(EncodingError{EncodingError::Kind::InvalidSequence, invalidOffset});
+    }
+
+    return Ok();
+}
+
+
+Result<size_type, EncodingError>
+Solace::countCodePoints(MemoryView data) noexcept {
+    static CountFn const count = selectCount();
+
+    auto const invalidOffset = findInvalidUtf8(data.dataAddress(), data.size());
+    if (invalidOffset != data.size()) {
+        return Err(EncodingError{EncodingError::Kind::InvalidSequence, invalidOffset});
+    }
+
+    return Ok(count(data.dataAddress(), data.size()));
+}
+
+
+size_type
+Solace::utf16Length(MemoryView utf8) noexcept {
+    size_type length = 0;
+    for (auto b : utf8) {
+        // Every lead byte produces one unit, and 4 byte sequences need a surrogate pair.
+        length += (isContinuation(b) ? 0 : 1) + ((b >= 0xF0) ? 1 : 0);
+    }
+
+    return length;
+}
+
+
+size_type
+Solace::utf8Length(ArrayView<const char16_t> utf16) noexcept {
+    size_type length = 0;
+    for (auto unit : utf16) {
+        // Each half of a surrogate pair accounts for 2 of the 4 bytes of the encoded code point.
+        length += (unit < 0x80)
+                ? 1
+                : (unit < 0x800 || (unit >= 0xD800 && unit <= 0xDFFF))
+                  ? 2
+                  : 3;
+    }
+
+    return length;
+}
+
+
+size_type
+Solace::utf8Length(ArrayView<const char32_t> utf32) noexcept {
+    size_type length = 0;
+    for (auto cp : utf32) {
+        length += utf8Width(cp);
+    }
+
+    return length;
+}
+
+
+Result<ArrayView<char16_t>::size_type, EncodingError>
+Solace::utf8ToUtf16(MemoryView src, ArrayView<char16_t> dest) noexcept {
+    return utf8ToUtfN(src, dest);
+}
+
+
+Result<ArrayView<char32_t>::size_type, EncodingError>
+Solace::utf8ToUtf32(MemoryView src, ArrayView<char32_t> dest) noexcept {
+    return utf8ToUtfN(src, dest);
+}
+
+
+Result<void, EncodingError>
+Solace::utf16ToUtf8(ArrayView<const char16_t> src, ByteWriter& dest) noexcept {
+    auto remaining = dest.viewRemaining();
+    byte* const out = remaining.dataAddress();
+    size_type const capacity = remaining.size();
+    char16_t const* const data = src.begin();
+    ArrayView<const char16_t>::size_type const size = src.size();
+
+    size_type written = 0;
+    ArrayView<const char16_t>::size_type i = 0;
+    while (i < size) {
+#ifdef SOLACE_UTF8_X86
+        // ASCII fast path: narrow 8 units at a time
+        if (size - i >= 8 && capacity - written >= 8) {
+            __m128i const input = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + i));
+            __m128i const nonAscii = _mm_and_si128(input, _mm_set1_epi16(static_cast<int16>(0xFF80)));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(nonAscii, _mm_setzero_si128())) == 0xFFFF) {
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(out + written), _mm_packus_epi16(input, input));
+                i += 8;
+                written += 8;
+                continue;
+            }
+        }
+#endif
+
+        uint32 codePoint = data[i];
+        ArrayView<const char16_t>::size_type units = 1;
+        if (codePoint >= 0xD800 && codePoint <= 0xDFFF) {
+            if (codePoint > 0xDBFF || i + 1 >= size || data[i + 1] < 0xDC00 || data[i + 1] > 0xDFFF) {
+                return Err(EncodingError{EncodingError::Kind::InvalidSequence, i});
+            }
+
+            codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (data[i + 1] - 0xDC00u);
+            units = 2;
+        }
+
+        if (capacity - written < utf8Width(codePoint)) {
+            return Err(EncodingError{EncodingError::Kind::DestinationTooSmall, i});
+        }
+
+        written += encodeCodePoint(codePoint, out + written);
+        i += units;
+    }
+
+    dest.advance(written);
+
+    return Ok();
+}
+
+
+Result<void, EncodingError>
+Solace::utf32ToUtf8(ArrayView<const char32_t> src, ByteWriter& dest) noexcept {
+    auto remaining = dest.viewRemaining();
+    byte* const out = remaining.dataAddress();
+    size_type const capacity = remaining.size();
+    char32_t const* const data = src.begin();
+    ArrayView<const char32_t>::size_type const size = src.size();
+
+    size_type written = 0;
+    for (ArrayView<const char32_t>::size_type i = 0; i < size; ++i) {
+#ifdef SOLACE_UTF8_X86
+        // ASCII fast path: narrow 4 code points at a time
+        while (size - i >= 4 && capacity - written >= 4) {
+            __m128i const input = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + i));
+            __m128i const nonAscii = _mm_and_si128(input, _mm_set1_epi32(~0x7F));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(nonAscii, _mm_setzero_si128())) != 0xFFFF) {
+                break;
+            }
+
+            __m128i const packed = _mm_packus_epi16(_mm_packs_epi32(input, input), _mm_setzero_si128());
+            auto const bytes = static_cast<uint32>(_mm_cvtsi128_si32(packed));
+            std::memcpy(out + written, &bytes, sizeof(bytes));
+            i += 4;
+            written += 4;
+        }
+
+        if (i >= size) {
+            break;
+        }
+#endif
+
+        uint32 const codePoint = data[i];
+        if (codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF)) {
+            return Err(EncodingError{EncodingError::Kind::InvalidSequence, i});
+        }
+
+        if (capacity - written < utf8Width(codePoint)) {
+            return Err(EncodingError{EncodingError::Kind::DestinationTooSmall, i});
+        }
+
+        written += encodeCodePoint(codePoint, out + written);
+    }
+
+    dest.advance(written);
+
+    return Ok();
+}
@@ -21,6 +21,7 @@
  *	ID:			$Id$
  ******************************************************************************/
 #include "solace/version.hpp"
+#include "solace/parseNumber.hpp"
 #include "solace/posixErrorDomain.hpp"
 
 #include "solace/libsolace_config.hpp"		// Defines compile time version
@@ -93,23 +94,36 @@ Version::toString() const {
 
 Result<Version, Error>
 Version::parse(StringView str) {
-    value_type majorVersion;
-    value_type minorVersion;
-    value_type patchVersion;
+    value_type majorVersion = 0;
+    value_type minorVersion = 0;
+    value_type patchVersion = 0;
 
     StringView afterPatch;
     StringView::size_type splitIndex = 0;
+    bool isValid = true;
     str.split(NumberSeparator, [&](StringView split) {
         if (splitIndex == 0) {
-            majorVersion = std::strtoul(split.data(), nullptr, 10);
+            auto parsed = parseUint<value_type>(split);
+            isValid = isValid && parsed.isOk();
+            majorVersion = parsed.isOk() ? parsed.unwrap() : 0;
             ++splitIndex;
         } else if (splitIndex == 1) {
-            minorVersion = std::strtoul(split.data(), nullptr, 10);
+            auto parsed = parseUint<value_type>(split);
+            isValid = isValid && parsed.isOk();
+            minorVersion = parsed.isOk() ? parsed.unwrap() : 0;
             ++splitIndex;
         } else if (splitIndex == 2) {
-            char* patchEnd;
-            patchVersion = std::strtoul(split.data(), &patchEnd, 10);
+            // Patch number may be followed by pre-release and build metadata
+            StringView::size_type patchLength = 0;
+            while (patchLength < split.size() && split[patchLength] >= '0' && split[patchLength] <= '9') {
+                ++patchLength;
+            }
+
+            auto parsed = parseUint<value_type>(split.substring(0, patchLength));
+            isValid = isValid && parsed.isOk();
+            patchVersion = parsed.isOk() ? parsed.unwrap() : 0;
 
+            char const* patchEnd = split.data() + patchLength;
             if (patchEnd != str.end()) {
                 ptrdiff_t dist = str.end() - patchEnd;
                 afterPatch = StringView(patchEnd,
@@ -120,6 +134,10 @@ Version::parse(StringView str) {
         }
     });
 
+    if (!isValid) {
+        return Err(makeError(BasicError::InvalidInput, "Version::parse()"));
+    }
+
     if (splitIndex < 3) {
         return Err(makeError(BasicError::InvalidInput, "Version::parse()"));
     }
@@ -0,0 +1,87 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ * @file: test/test_asciiCase.cpp
+ *******************************************************************************/
+#include <solace/asciiCase.hpp>	 // Class being tested
+
+#include <gtest/gtest.h>
+
+
+using namespace Solace;
+
+
+TEST(TestAsciiCase, testCharConversion) {
+    EXPECT_EQ('a', toLowerAscii('A'));
+    EXPECT_EQ('z', toLowerAscii('z'));
+    EXPECT_EQ('@', toLowerAscii('@'));
+    EXPECT_EQ('Z', toUpperAscii('z'));
+    EXPECT_EQ('{', toUpperAscii('{'));
+}
+
+TEST(TestAsciiCase, testToLower) {
+    char buffer[64];
+
+    EXPECT_EQ(StringView{"hello, world!"}, toLowerAscii("Hello, WORLD!", wrapMemory(buffer)).unwrap());
+    // Long enough to be processed in blocks, with non-letters around letter ranges and non-ASCII bytes
+    EXPECT_EQ(StringView{"@az[`az{ 0123456789 \xD0\x9F\xD0\xA0 abcdefghijklmnopqrstuvwxyz"},
+              toLowerAscii("@AZ[`az{ 0123456789 \xD0\x9F\xD0\xA0 ABCDEFGHIJKLMNOPQRSTUVWXYZ",
+                           wrapMemory(buffer)).unwrap());
+    EXPECT_TRUE(toLowerAscii(StringView{}, MutableMemoryView{}).unwrap().empty());
+}
+
+TEST(TestAsciiCase, testToUpper) {
+    char buffer[64];
+
+    EXPECT_EQ(StringView{"@AZ[`AZ{ 0123456789 ABCDEFGHIJKLMNOPQRSTUVWXYZ"},
+              toUpperAscii("@AZ[`az{ 0123456789 abcdefghijklmnopqrstuvwxyz", wrapMemory(buffer)).unwrap());
+}
+
+TEST(TestAsciiCase, testInPlace) {
+    char buffer[] = "Set-Cookie: ID=A3FWa; Expires=Wed, 21 Oct 2015 07:28:00 GMT";
+    auto const size = static_cast<StringView::size_type>(sizeof(buffer) - 1);
+
+    auto const result = toUpperAscii(StringView{buffer, size}, wrapMemory(buffer, size));
+    EXPECT_EQ(StringView{"SET-COOKIE: ID=A3FWA; EXPIRES=WED, 21 OCT 2015 07:28:00 GMT"}, result.unwrap());
+    EXPECT_EQ(buffer, result.unwrap().data());
+}
+
+TEST(TestAsciiCase, testDestinationTooSmall) {
+    char buffer[4];
+
+    EXPECT_TRUE(toLowerAscii("Hello", wrapMemory(buffer)).isError());
+}
+
+TEST(TestAsciiCase, testMismatch) {
+    StringView const a{"Accept-Language: en-US,en;q=0.5 and more"};
+    StringView const b{"accept-language: EN-us,EN;Q=0.5 and MORE"};
+    StringView const c{"accept-language: EN-us,EN;Q=0.7 and MORE"};
+
+    EXPECT_EQ(a.size(), mismatchIgnoreCaseAscii(a.data(), b.data(), a.size()));
+    EXPECT_EQ(30U, mismatchIgnoreCaseAscii(a.data(), c.data(), a.size()));
+    EXPECT_EQ(0U, mismatchIgnoreCaseAscii("a", "b", 1));
+}
+
+TEST(TestAsciiCase, testFind) {
+    StringView const str{"0123456789abcdef0123456789ABCDEF"};
+
+    EXPECT_EQ(10U, findIgnoreCaseAscii(str.data(), str.size(), 'A'));
+    EXPECT_EQ(10U, findIgnoreCaseAscii(str.data(), str.size(), 'a'));
+    EXPECT_EQ(26U, findIgnoreCaseAscii(str.data() + 16, str.size() - 16, 'a') + 16);
+    EXPECT_EQ(str.size(), findIgnoreCaseAscii(str.data(), str.size(), 'x'));
+    EXPECT_EQ(str.size(), findIgnoreCaseAscii(str.data(), str.size(), '@'));
+}
@@ -23,6 +23,8 @@
 #include <solace/exception.hpp>
 #include <gtest/gtest.h>
 
+#include <cstdio>  // snprintf
+
 using namespace Solace;
 
 
@@ -223,3 +225,119 @@ TEST(TestBase16, decodingIntoSmallerBufferErrors) {
 
     EXPECT_TRUE(v.encode(wrapMemory("666F6F626172", 12)).isError());
 }
+
+TEST(TestBase16, testStreamEncodingInChunks) {
+    byte const data[] = {0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF, 0x00, 0xFF};
+    char const expected[] = "0123456789abcdef00ff";
+
+    byte buffer[20];
+    for (size_t chunkSize = 1; chunkSize <= sizeof(data); ++chunkSize) {
+        ByteWriter dest(wrapMemory(buffer));
+        Base16StreamEncoder encoder(dest);
+        for (size_t i = 0; i < sizeof(data); i += chunkSize) {
+            auto const chunk = (sizeof(data) - i < chunkSize) ? sizeof(data) - i : chunkSize;
+            ASSERT_TRUE(encoder.update(wrapMemory(data + i, chunk)).isOk());
+        }
+        ASSERT_TRUE(encoder.finish().isOk());
+
+        EXPECT_EQ(wrapMemory(expected, 20), dest.viewWritten());
+    }
+}
+
+TEST(TestBase16, testStreamDecodingInChunks) {
+    char const text[] = "0123456789abcdefABCDEF";
+    byte const expected[] = {0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF, 0xAB, 0xCD, 0xEF};
+
+    byte buffer[11];
+    for (size_t chunkSize = 1; chunkSize <= 22; ++chunkSize) {
+        ByteWriter dest(wrapMemory(buffer));
+        Base16StreamDecoder decoder(dest);
+        for (size_t i = 0; i < 22; i += chunkSize) {
+            auto const chunk = (22 - i < chunkSize) ? 22 - i : chunkSize;
+            ASSERT_TRUE(decoder.update(wrapMemory(text + i, chunk)).isOk());
+        }
+        ASSERT_TRUE(decoder.finish().isOk());
+
+        EXPECT_EQ(wrapMemory(expected), dest.viewWritten());
+    }
+}
+
+TEST(TestBase16, testStreamDecodingInvalidInput) {
+    byte buffer[8];
+    ByteWriter dest(wrapMemory(buffer));
+
+    Base16StreamDecoder decoder(dest);
+    EXPECT_TRUE(decoder.update(wrapMemory("0", 1)).isOk());
+    EXPECT_TRUE(decoder.update(wrapMemory("g", 1)).isError());
+    EXPECT_TRUE(decoder.update(wrapMemory("\xC0", 1)).isError());
+    EXPECT_TRUE(decoder.update(wrapMemory("12", 2)).isOk());
+    EXPECT_TRUE(decoder.finish().isError());
+    EXPECT_EQ(1, dest.position());
+}
+
+TEST(TestBase16, testBulkRoundTripAllLengths) {
+    byte data[200];
+    for (size_t i = 0; i < sizeof(data); ++i) {
+        data[i] = static_cast<byte>(i * 37 + 11);
+    }
+
+    char expected[401];
+    char upper[401];
+    for (size_t i = 0; i < sizeof(data); ++i) {
+        snprintf(expected + 2 * i, 3, "%02x", data[i]);
+        snprintf(upper + 2 * i, 3, "%02X", data[i]);
+    }
+
+    byte text[400];
+    byte decoded[200];
+    for (size_t length = 0; length <= sizeof(data); ++length) {
+        auto encoded = base16Encode(wrapMemory(data, length), wrapMemory(text));
+        ASSERT_TRUE(encoded.isOk());
+        ASSERT_EQ(2 * length, encoded.unwrap());
+        ASSERT_EQ(wrapMemory(expected, 2 * length), wrapMemory(text, 2 * length));
+
+        auto decodedSize = base16Decode(wrapMemory(text, 2 * length), wrapMemory(decoded));
+        ASSERT_TRUE(decodedSize.isOk());
+        ASSERT_EQ(wrapMemory(data, length), wrapMemory(decoded, decodedSize.unwrap()));
+
+        ASSERT_TRUE(base16Encode(wrapMemory(data, length), wrapMemory(text), LetterCase::Upper).isOk());
+        ASSERT_EQ(wrapMemory(upper, 2 * length), wrapMemory(text, 2 * length));
+        ASSERT_TRUE(base16Decode(wrapMemory(text, 2 * length), wrapMemory(decoded), LetterCase::Upper).isOk());
+        ASSERT_EQ(wrapMemory(data, length), wrapMemory(decoded, length));
+    }
+}
+
+TEST(TestBase16, testDecodingLetterCase) {
+    byte buffer[4];
+
+    EXPECT_TRUE(base16Decode(wrapMemory("aBcD", 4), wrapMemory(buffer)).isOk());
+    EXPECT_TRUE(base16Decode(wrapMemory("abcd", 4), wrapMemory(buffer), LetterCase::Lower).isOk());
+    EXPECT_TRUE(base16Decode(wrapMemory("abcD", 4), wrapMemory(buffer), LetterCase::Lower).isError());
+    EXPECT_TRUE(base16Decode(wrapMemory("ABCD", 4), wrapMemory(buffer), LetterCase::Upper).isOk());
+    EXPECT_TRUE(base16Decode(wrapMemory("ABCd", 4), wrapMemory(buffer), LetterCase::Upper).isError());
+
+    byte dest[64];
+    ByteWriter writer(wrapMemory(dest));
+    EXPECT_TRUE(Base16Encoder(writer, LetterCase::Upper).encode(wrapMemory("\xAB\xCD", 2)).isOk());
+    EXPECT_EQ(wrapMemory("ABCD", 4), writer.viewWritten());
+}
+
+TEST(TestBase16, testBulkDecodingRejectsInvalidCharacterAnywhere) {
+    char text[130];
+    for (size_t i = 0; i < sizeof(text); ++i) {
+        text[i] = "0123456789abcdefABCDEF"[i % 22];
+    }
+
+    byte buffer[65];
+    for (size_t i = 0; i < sizeof(text); ++i) {
+        for (auto const invalid : {'g', 'G', '/', ':', '@', '`', '\xB0', '\0'}) {
+            auto const original = text[i];
+            text[i] = invalid;
+            EXPECT_TRUE(base16Decode(wrapMemory(text, sizeof(text)), wrapMemory(buffer)).isError()) << i;
+            text[i] = original;
+        }
+    }
+
+    EXPECT_TRUE(base16Decode(wrapMemory(text, sizeof(text)), wrapMemory(buffer)).isOk());
+    EXPECT_TRUE(base16Decode(wrapMemory(text, sizeof(text)), wrapMemory(buffer, 64)).isError());
+}
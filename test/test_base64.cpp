@@ -24,10 +24,41 @@
 #include <gtest/gtest.h>
 
 #include <cstring>
+#include <string>
 
 using namespace Solace;
 
 
+namespace {
+
+/// Straightforward encoding to check the vectorized one against.
+std::string referenceEncode(byte const* data, size_t size, char const* alphabet) {
+    std::string result;
+    for (size_t i = 0; i < size; i += 3) {
+        uint32 group = static_cast<uint32>(data[i]) << 16;
+        if (i + 1 < size) group |= static_cast<uint32>(data[i + 1]) << 8;
+        if (i + 2 < size) group |= data[i + 2];
+
+        result += alphabet[(group >> 18) & 0x3F];
+        result += alphabet[(group >> 12) & 0x3F];
+        result += (i + 1 < size) ? alphabet[(group >> 6) & 0x3F] : '=';
+        result += (i + 2 < size) ? alphabet[group & 0x3F] : '=';
+    }
+
+    return result;
+}
+
+void fillPseudoRandom(byte* data, size_t size) {
+    uint32 state = 0x12345678;
+    for (size_t i = 0; i < size; ++i) {
+        state = state * 1103515245 + 12345;
+        data[i] = static_cast<byte>(state >> 16);
+    }
+}
+
+}  // namespace
+
+
 TEST(TestBase64, testEncodedSize) {
     EXPECT_EQ(0, Base64Encoder::encodedSize(0));
     EXPECT_EQ(4, Base64Encoder::encodedSize(1));
@@ -138,7 +169,7 @@ TEST(TestBase64, testBasicDecoding) {
     EXPECT_EQ(wrapMemory("foobar", 6), dest.viewWritten());
 
     dest.rewind();
-    decoder.encode(wrapMemory("VGhpcyBpcyB0ZXN0IG1lc3NhZ2Ugd2Ugd2FudCB0byBlbmNvZGU=", 53));
+    decoder.encode(wrapMemory("VGhpcyBpcyB0ZXN0IG1lc3NhZ2Ugd2Ugd2FudCB0byBlbmNvZGU=", 52));
     EXPECT_EQ(wrapMemory("This is test message we want to encode", 38),
                             dest.viewWritten());
 
@@ -219,3 +250,202 @@ TEST(TestBase64, testUnicodeCharactersDecoding) {
 
     EXPECT_EQ(wrapMemory(expectedMsg, strlen(expectedMsg)), dest.viewWritten());
 }
+
+
+TEST(TestBase64, testRoundTripAllLengths) {
+    byte data[300];
+    fillPseudoRandom(data, sizeof(data));
+
+    byte encoded[400];
+    byte decoded[300];
+    for (size_t length = 0; length <= sizeof(data); ++length) {
+        auto const expected = referenceEncode(data, length,
+                                              "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/");
+
+        ByteWriter text(wrapMemory(encoded));
+        ASSERT_TRUE(Base64Encoder(text).encode(wrapMemory(data, length)).isOk());
+        ASSERT_EQ(wrapMemory(expected.data(), expected.size()), text.viewWritten());
+
+        ByteWriter bytes(wrapMemory(decoded));
+        ASSERT_EQ(length, Base64Decoder::decodedSize(text.viewWritten()));
+        ASSERT_TRUE(Base64Decoder(bytes).encode(text.viewWritten()).isOk());
+        ASSERT_EQ(wrapMemory(data, length), bytes.viewWritten());
+    }
+}
+
+TEST(TestBase64, testUrlRoundTripAllLengths) {
+    byte data[300];
+    fillPseudoRandom(data, sizeof(data));
+
+    byte encoded[400];
+    byte decoded[300];
+    for (size_t length = 0; length <= sizeof(data); ++length) {
+        auto const expected = referenceEncode(data, length,
+                                              "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_");
+
+        ByteWriter text(wrapMemory(encoded));
+        ASSERT_TRUE(Base64UrlEncoder(text).encode(wrapMemory(data, length)).isOk());
+        ASSERT_EQ(wrapMemory(expected.data(), expected.size()), text.viewWritten());
+
+        ByteWriter bytes(wrapMemory(decoded));
+        ASSERT_TRUE(Base64UrlDecoder(bytes).encode(text.viewWritten()).isOk());
+        ASSERT_EQ(wrapMemory(data, length), bytes.viewWritten());
+    }
+}
+
+TEST(TestBase64, testDecodingUnpadded) {
+    byte buffer[8];
+    ByteWriter dest(wrapMemory(buffer));
+
+    EXPECT_EQ(1, Base64Decoder::decodedSize(wrapMemory("Zg", 2)));
+    EXPECT_EQ(2, Base64Decoder::decodedSize(wrapMemory("Zm8", 3)));
+
+    EXPECT_TRUE(Base64UrlDecoder(dest).encode(wrapMemory("Zm8", 3)).isOk());
+    EXPECT_EQ(wrapMemory("fo", 2), dest.viewWritten());
+}
+
+TEST(TestBase64, testDecodingRejectsInvalidInput) {
+    byte buffer[16];
+    ByteWriter dest(wrapMemory(buffer));
+    Base64Decoder decoder(dest);
+
+    EXPECT_TRUE(decoder.encode(wrapMemory("Zm9v!A==", 8)).isError());      // Not in the alphabet
+    EXPECT_TRUE(decoder.encode(wrapMemory("Zg==Zg==", 8)).isError());      // Padding in the middle
+    EXPECT_TRUE(decoder.encode(wrapMemory("Zg=A", 4)).isError());          // Padding followed by data
+    EXPECT_TRUE(decoder.encode(wrapMemory("Zm9vY", 5)).isError());         // A single character can't encode a byte
+    EXPECT_TRUE(decoder.encode(wrapMemory("Zh==", 4)).isError());          // Unused bits are not zero
+    EXPECT_TRUE(decoder.encode(wrapMemory("Zm9=\0", 5)).isError());       // Trailing data after padding
+    EXPECT_TRUE(Base64UrlDecoder(dest).encode(wrapMemory("ab+/", 4)).isError());
+    EXPECT_TRUE(Base64Decoder(dest).encode(wrapMemory("ab-_", 4)).isError());
+
+    EXPECT_TRUE(dest.viewWritten().empty());
+}
+
+TEST(TestBase64, testDecodingRejectsInvalidCharacterAnywhere) {
+    byte data[150];
+    fillPseudoRandom(data, sizeof(data));
+    auto text = referenceEncode(data, sizeof(data),
+                                "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/");
+
+    byte buffer[150];
+    for (size_t i = 0; i < text.size(); ++i) {
+        auto corrupted = text;
+        corrupted[i] = (i % 2) ? '\x80' : '.';
+
+        ByteWriter dest(wrapMemory(buffer));
+        EXPECT_TRUE(Base64Decoder(dest).encode(wrapMemory(corrupted.data(), corrupted.size())).isError()) << i;
+        EXPECT_TRUE(dest.viewWritten().empty());
+    }
+}
+
+TEST(TestBase64, testNotEnoughSpace) {
+    byte buffer[10];
+    ByteWriter dest(wrapMemory(buffer));
+
+    EXPECT_TRUE(Base64Encoder(dest).encode(wrapMemory("foobar", 6)).isOk());
+    EXPECT_TRUE(Base64Encoder(dest).encode(wrapMemory("f", 1)).isError());
+    EXPECT_EQ(wrapMemory("Zm9vYmFy", 8), dest.viewWritten());
+
+    dest.rewind();
+    EXPECT_TRUE(Base64Decoder(dest).encode(wrapMemory("Zm9vYmFyYmF6YmF6", 16)).isError());
+    EXPECT_TRUE(dest.viewWritten().empty());
+}
+
+TEST(TestBase64, testStreamEncodingInChunks) {
+    byte data[200];
+    fillPseudoRandom(data, sizeof(data));
+
+    byte encoded[300];
+    for (size_t length = 195; length <= sizeof(data); ++length) {
+        auto const expected = referenceEncode(data, length,
+                                              "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/");
+
+        for (size_t chunkSize = 1; chunkSize <= 40; ++chunkSize) {
+            ByteWriter dest(wrapMemory(encoded));
+            Base64StreamEncoder encoder(dest);
+            for (size_t i = 0; i < length; i += chunkSize) {
+                auto const chunk = (length - i < chunkSize) ? length - i : chunkSize;
+                ASSERT_TRUE(encoder.update(wrapMemory(data + i, chunk)).isOk());
+            }
+            ASSERT_TRUE(encoder.finish().isOk());
+
+            ASSERT_EQ(wrapMemory(expected.data(), expected.size()), dest.viewWritten()) << chunkSize;
+        }
+    }
+}
+
+TEST(TestBase64, testStreamDecodingInChunks) {
+    byte data[200];
+    fillPseudoRandom(data, sizeof(data));
+
+    byte decoded[200];
+    for (size_t length = 195; length <= sizeof(data); ++length) {
+        auto const text = referenceEncode(data, length,
+                                          "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_");
+
+        for (size_t chunkSize = 1; chunkSize <= 40; ++chunkSize) {
+            ByteWriter dest(wrapMemory(decoded));
+            Base64UrlStreamDecoder decoder(dest);
+            for (size_t i = 0; i < text.size(); i += chunkSize) {
+                auto const chunk = (text.size() - i < chunkSize) ? text.size() - i : chunkSize;
+                ASSERT_TRUE(decoder.update(wrapMemory(text.data() + i, chunk)).isOk());
+            }
+            ASSERT_TRUE(decoder.finish().isOk());
+
+            ASSERT_EQ(wrapMemory(data, length), dest.viewWritten()) << chunkSize;
+        }
+    }
+}
+
+TEST(TestBase64, testStreamDecodingUnpadded) {
+    byte buffer[8];
+    ByteWriter dest(wrapMemory(buffer));
+    Base64StreamDecoder decoder(dest);
+
+    EXPECT_TRUE(decoder.update(wrapMemory("Zm9vY", 5)).isOk());
+    EXPECT_TRUE(decoder.update(wrapMemory("g", 1)).isOk());
+    EXPECT_EQ(3, dest.position());
+    EXPECT_TRUE(decoder.finish().isOk());
+    EXPECT_EQ(wrapMemory("foob", 4), dest.viewWritten());
+}
+
+TEST(TestBase64, testStreamDecodingRejectsInvalidInput) {
+    byte buffer[16];
+    ByteWriter dest(wrapMemory(buffer));
+
+    {   // Nothing may follow the padding
+        Base64StreamDecoder decoder(dest);
+        EXPECT_TRUE(decoder.update(wrapMemory("Zg=", 3)).isOk());
+        EXPECT_TRUE(decoder.update(wrapMemory("=", 1)).isOk());
+        EXPECT_TRUE(decoder.update(wrapMemory("Zg==", 4)).isError());
+    }
+    {
+        Base64StreamDecoder decoder(dest);
+        EXPECT_TRUE(decoder.update(wrapMemory("Zg==Zm9v", 8)).isError());
+    }
+    {   // Dangling character
+        Base64StreamDecoder decoder(dest);
+        EXPECT_TRUE(decoder.update(wrapMemory("Zm9vY", 5)).isOk());
+        EXPECT_TRUE(decoder.finish().isError());
+    }
+    {   // Character of the other alphabet split between chunks
+        Base64UrlStreamDecoder decoder(dest);
+        EXPECT_TRUE(decoder.update(wrapMemory("Zm", 2)).isOk());
+        EXPECT_TRUE(decoder.update(wrapMemory("+v", 2)).isError());
+    }
+}
+
+TEST(TestBase64, testStreamRetryAfterOverflow) {
+    byte buffer[8];
+    ByteWriter dest(wrapMemory(buffer));
+    Base64StreamEncoder encoder(dest);
+
+    EXPECT_TRUE(encoder.update(wrapMemory("foo", 3)).isOk());
+    EXPECT_TRUE(encoder.update(wrapMemory("barbaz", 6)).isError());
+    EXPECT_EQ(wrapMemory("Zm9v", 4), dest.viewWritten());
+
+    dest.rewind();
+    EXPECT_TRUE(encoder.update(wrapMemory("barbaz", 6)).isOk());
+    EXPECT_TRUE(encoder.finish().isOk());
+    EXPECT_EQ(wrapMemory("YmFyYmF6", 8), dest.viewWritten());
+}
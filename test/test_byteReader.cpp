@@ -19,6 +19,7 @@
  * @author: soultaker
  ********************************************************************************/
 #include <solace/byteReader.hpp>  // Class being tested
+#include <solace/byteWriter.hpp>
 
 #include <gtest/gtest.h>
 
@@ -239,3 +240,285 @@ TEST(TestReadBuffer, readLittleEndian) {
         EXPECT_EQ(expected64, result);
     }
 }
+
+
+TEST(TestReadBuffer, readVarint) {
+    byte const bytes[] = {0x00, 0xAC, 0x02, 0x03, 0xFF, 0xFF, 0xFF, 0xFF, 0x0F};
+    ByteReader reader(wrapMemory(bytes));
+
+    uint32 value = 0;
+    EXPECT_TRUE(reader.readVarint(value).isOk());
+    EXPECT_EQ(0U, value);
+    EXPECT_TRUE(reader.readVarint(value).isOk());
+    EXPECT_EQ(300U, value);
+
+    int32 signedValue = 0;
+    EXPECT_TRUE(reader.readVarint(signedValue).isOk());
+    EXPECT_EQ(-2, signedValue);
+    EXPECT_TRUE(reader.readVarint(signedValue).isOk());
+    EXPECT_EQ(-2147483647 - 1, signedValue);
+    EXPECT_FALSE(reader.hasRemaining());
+}
+
+
+TEST(TestReadBuffer, readVarintRoundTrip) {
+    int64 const values[] = {0, 1, -1, 63, -64, 64, 1 << 20, -(1 << 20),
+                            0x7FFFFFFFFFFFFFFF, -0x7FFFFFFFFFFFFFFF - 1};
+
+    byte buffer[128];
+    ByteWriter writer(wrapMemory(buffer));
+    for (auto v : values) {
+        EXPECT_TRUE(writer.writeVarint(v).isOk());
+    }
+
+    ByteReader reader(writer.viewWritten());
+    for (auto v : values) {
+        int64 value = 0;
+        EXPECT_TRUE(reader.readVarint(value).isOk());
+        EXPECT_EQ(v, value);
+    }
+    EXPECT_FALSE(reader.hasRemaining());
+}
+
+
+TEST(TestReadBuffer, readVarintMalformed) {
+    {   // Truncated
+        byte const bytes[] = {0x80, 0x80};
+        ByteReader reader(wrapMemory(bytes));
+        uint32 value;
+        EXPECT_TRUE(reader.readVarint(value).isError());
+        EXPECT_EQ(0, reader.position());
+    }
+    {   // Doesn't fit 32 bits
+        byte const bytes[] = {0xFF, 0xFF, 0xFF, 0xFF, 0x1F};
+        ByteReader reader(wrapMemory(bytes));
+        uint32 value;
+        EXPECT_TRUE(reader.readVarint(value).isError());
+        EXPECT_EQ(0, reader.position());
+
+        uint64 wideValue;
+        EXPECT_TRUE(reader.readVarint(wideValue).isOk());
+        EXPECT_EQ(0x1FFFFFFFFULL, wideValue);
+    }
+    {   // Too long
+        byte const bytes[] = {0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0x00};
+        ByteReader reader(wrapMemory(bytes));
+        uint64 value;
+        EXPECT_TRUE(reader.readVarint(value).isError());
+        EXPECT_EQ(0, reader.position());
+    }
+    {   // Over-long encodings of 0 and 1
+        byte const bytes[] = {0x80, 0x00, 0x81, 0x80, 0x00};
+        ByteReader reader(wrapMemory(bytes));
+        uint32 value;
+        EXPECT_TRUE(reader.readVarint(value).isError());
+        EXPECT_EQ(0, reader.position());
+
+        EXPECT_TRUE(reader.advance(2).isOk());
+        EXPECT_TRUE(reader.readVarint(value).isError());
+        EXPECT_EQ(2, reader.position());
+    }
+}
+
+
+TEST(TestReadBuffer, readVarints) {
+    // Mix of 1 to 5 byte values, so that all the paths of the batch decoder are taken
+    uint32 values[300];
+    uint32 state = 7;
+    for (auto& v : values) {
+        state = state * 1103515245 + 12345;
+        auto const bits = (state >> 28) < 6 ? 7 : (state >> 28) < 10 ? 14 : (state >> 28) < 13 ? 21
+                        : (state >> 28) < 15 ? 28 : 32;
+        v = ((state >> 4) | (state << 28)) & static_cast<uint32>((uint64{1} << bits) - 1);
+    }
+
+    byte buffer[sizeof(values) * 2];
+    ByteWriter writer(wrapMemory(buffer));
+    ASSERT_TRUE(writer.writeVarints(arrayView(values)).isOk());
+
+    for (uint32 count = 0; count <= 300; count += 7) {
+        ByteReader expected(writer.viewWritten());
+        uint32 decoded[300];
+        for (uint32 i = 0; i < count; ++i) {
+            ASSERT_TRUE(expected.readVarint(decoded[i]).isOk());
+        }
+
+        ByteReader reader(writer.viewWritten());
+        uint32 batch[300];
+        ASSERT_TRUE(reader.readVarints(arrayView(batch, count)).isOk());
+        EXPECT_EQ(expected.position(), reader.position());
+        for (uint32 i = 0; i < count; ++i) {
+            ASSERT_EQ(values[i], batch[i]) << i;
+        }
+    }
+
+    // Single byte values only
+    byte small[64];
+    for (byte i = 0; i < 64; ++i) {
+        small[i] = i;
+    }
+    ByteReader reader(wrapMemory(small));
+    uint32 decoded[64];
+    ASSERT_TRUE(reader.readVarints(arrayView(decoded)).isOk());
+    for (uint32 i = 0; i < 64; ++i) {
+        EXPECT_EQ(i, decoded[i]);
+    }
+}
+
+
+TEST(TestReadBuffer, readVarintsMalformed) {
+    byte bytes[40];
+    for (auto& b : bytes) {
+        b = 0x01;
+    }
+    bytes[20] = 0xFF; bytes[21] = 0xFF; bytes[22] = 0xFF; bytes[23] = 0xFF; bytes[24] = 0x7F;
+
+    uint32 values[36];
+    ByteReader reader(wrapMemory(bytes));
+    EXPECT_TRUE(reader.readVarints(arrayView(values)).isError());
+    EXPECT_EQ(0, reader.position());
+
+    // Over-long 2 byte value in a chunk of the vector decoder
+    bytes[20] = 0x80; bytes[21] = 0x00; bytes[22] = 0x01; bytes[23] = 0x01; bytes[24] = 0x01;
+    ByteReader overlong(wrapMemory(bytes));
+    EXPECT_TRUE(overlong.readVarints(arrayView(values)).isError());
+    EXPECT_EQ(0, overlong.position());
+
+    // Malformed value at every position of a block of the vector decoder
+    for (size_t offset = 0; offset + 4 <= 100; ++offset) {
+        byte chunk[100];
+        for (auto& b : chunk) {
+            b = 0x01;
+        }
+
+        chunk[offset] = 0x81; chunk[offset + 1] = 0x80; chunk[offset + 2] = 0x01;
+        uint32 decoded[sizeof(chunk) - 2];
+        ByteReader valid(wrapMemory(chunk));
+        ASSERT_TRUE(valid.readVarints(arrayView(decoded)).isOk()) << offset;
+        EXPECT_EQ(0x4001U, decoded[offset]) << offset;
+        EXPECT_EQ(1U, decoded[offset + 1]) << offset;
+
+        chunk[offset + 2] = 0x00;
+        ByteReader malformed(wrapMemory(chunk));
+        EXPECT_TRUE(malformed.readVarints(arrayView(decoded)).isError()) << offset;
+        EXPECT_EQ(0, malformed.position()) << offset;
+    }
+
+    // Not enough data
+    ByteReader truncated(wrapMemory(bytes, 20));
+    EXPECT_TRUE(truncated.readVarints(arrayView(values, 21)).isError());
+    EXPECT_EQ(0, truncated.position());
+}
+
+
+TEST(TestReadBuffer, readArrayBE) {
+    // Odd offset and size to exercise unaligned access and all the tails
+    byte bytes[1 + 8 * 37];
+    for (size_t i = 0; i < sizeof(bytes); ++i) {
+        bytes[i] = static_cast<byte>(i * 7 + 3);
+    }
+    auto const view = wrapMemory(bytes).slice(1, sizeof(bytes));
+
+    {
+        uint16 values[147];
+        ByteReader reader(view);
+        ASSERT_TRUE(reader.readBE(arrayView(values)).isOk());
+        EXPECT_EQ(sizeof(values), reader.position());
+
+        ByteReader expected(view);
+        for (auto v : values) {
+            uint16 value;
+            ASSERT_TRUE(expected.readBE(value).isOk());
+            EXPECT_EQ(value, v);
+        }
+    }
+    {
+        int32 values[73];
+        ByteReader reader(view);
+        ASSERT_TRUE(reader.readBE(arrayView(values)).isOk());
+
+        ByteReader expected(view);
+        for (auto v : values) {
+            int32 value;
+            ASSERT_TRUE(expected.readBE(value).isOk());
+            EXPECT_EQ(value, v);
+        }
+    }
+    {
+        uint64 values[37];
+        ByteReader reader(view);
+        ASSERT_TRUE(reader.readBE(arrayView(values)).isOk());
+        EXPECT_FALSE(reader.hasRemaining());
+
+        ByteReader expected(view);
+        for (auto v : values) {
+            uint64 value;
+            ASSERT_TRUE(expected.readBE(value).isOk());
+            EXPECT_EQ(value, v);
+        }
+    }
+}
+
+
+TEST(TestReadBuffer, readArrayLE) {
+    byte const bytes[] = {0x00, 0x00, 0x80, 0x3F, 0x00, 0x00, 0x00, 0xC0};
+    float32 values[2];
+    ByteReader reader(wrapMemory(bytes));
+    ASSERT_TRUE(reader.readLE(arrayView(values)).isOk());
+    EXPECT_EQ(1.0f, values[0]);
+    EXPECT_EQ(-2.0f, values[1]);
+
+    auto doubles = makeArray<float64>(1);
+    byte const doubleBytes[] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0xBF};
+    ByteReader doubleReader(wrapMemory(doubleBytes));
+    ASSERT_TRUE(doubleReader.readLE(doubles).isOk());
+    EXPECT_EQ(-1.0, doubles[0]);
+}
+
+
+TEST(TestReadBuffer, readArrayOverflow) {
+    byte const bytes[] = {1, 2, 3, 4, 5, 6, 7};
+    uint16 values[4];
+    ByteReader reader(wrapMemory(bytes));
+
+    EXPECT_TRUE(reader.readBE(arrayView(values)).isError());
+    EXPECT_TRUE(reader.readLE(arrayView(values)).isError());
+    EXPECT_EQ(0, reader.position());
+
+    EXPECT_TRUE(reader.readBE(arrayView(values, 3)).isOk());
+    EXPECT_EQ(0x0102, values[0]);
+    EXPECT_EQ(0x0506, values[2]);
+}
+
+
+TEST(TestReadBuffer, reserveCursor) {
+    byte const bytes[] = {0xAA, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0xFF, 0xFE, 0x07,
+                          0x00, 0x00, 0x80, 0x3F, 'a', 'b', 'c'};
+    ByteReader reader(wrapMemory(bytes));
+    ASSERT_TRUE(reader.advance(1).isOk());
+
+    EXPECT_TRUE(reader.reserve(sizeof(bytes)).isError());
+    EXPECT_EQ(1, reader.position());
+
+    {
+        auto cursor = reader.reserve(13).unwrap();
+        EXPECT_EQ(0x0102, cursor.getBE<uint16>());
+        EXPECT_EQ(0x06050403U, cursor.getLE<uint32>());
+        EXPECT_EQ(-2, cursor.getBE<int16>());
+        EXPECT_EQ(0x07, cursor.get());
+        EXPECT_EQ(1.0f, cursor.getLE<float32>());
+        EXPECT_EQ(13, cursor.consumed());
+        EXPECT_EQ(1, reader.position());  // Committed when the cursor goes out of scope
+    }
+    EXPECT_EQ(14, reader.position());
+
+    {
+        char text[2];
+        auto cursor = reader.reserve(3).unwrap();
+        auto moved = std::move(cursor);
+        moved.skip(1).read(wrapMemory(text));
+        EXPECT_EQ('b', text[0]);
+        EXPECT_EQ('c', text[1]);
+    }
+    EXPECT_FALSE(reader.hasRemaining());
+}
@@ -19,6 +19,7 @@
  * @author: soultaker
 *******************************************************************************/
 #include <solace/byteWriter.hpp>  // Class being tested
+#include <solace/byteReader.hpp>
 
 #include <gtest/gtest.h>
 
@@ -143,3 +144,123 @@ TEST(TestByteWriter, writeLittleEndian) {
         EXPECT_EQ(static_cast<byte>(0x84), bytes[7]);
     }
 }
+
+
+TEST(TestByteWriter, writeVarint) {
+    byte buffer[16];
+    ByteWriter writer(wrapMemory(buffer));
+
+    EXPECT_TRUE(writer.writeVarint(uint32{0}).isOk());
+    EXPECT_TRUE(writer.writeVarint(uint32{127}).isOk());
+    EXPECT_TRUE(writer.writeVarint(uint32{300}).isOk());
+    byte const expectedUnsigned[] = {0x00, 0x7F, 0xAC, 0x02};
+    EXPECT_EQ(wrapMemory(expectedUnsigned), writer.viewWritten());
+
+    writer.rewind();
+    EXPECT_TRUE(writer.writeVarint(int32{0}).isOk());
+    EXPECT_TRUE(writer.writeVarint(int32{-1}).isOk());
+    EXPECT_TRUE(writer.writeVarint(int32{1}).isOk());
+    EXPECT_TRUE(writer.writeVarint(int32{-2147483647 - 1}).isOk());
+    byte const expectedSigned[] = {0x00, 0x01, 0x02, 0xFF, 0xFF, 0xFF, 0xFF, 0x0F};
+    EXPECT_EQ(wrapMemory(expectedSigned), writer.viewWritten());
+
+    writer.rewind();
+    EXPECT_TRUE(writer.writeVarint(uint64{0xFFFFFFFFFFFFFFFF}).isOk());
+    byte const expectedMax[] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01};
+    EXPECT_EQ(wrapMemory(expectedMax), writer.viewWritten());
+
+    EXPECT_TRUE(writer.writeVarint(uint64{0xFFFFFFFFFFFFFFFF}).isError());
+    EXPECT_EQ(10, writer.position());
+}
+
+
+TEST(TestByteWriter, writeVarints) {
+    uint32 const values[] = {1, 128, 16384, 0xFFFFFFFF};
+    byte buffer[10];
+    ByteWriter writer(wrapMemory(buffer));
+
+    EXPECT_TRUE(writer.writeVarints(arrayView(values)).isError());
+    EXPECT_EQ(0, writer.position());
+
+    EXPECT_TRUE(writer.writeVarints(arrayView(values, 3)).isOk());
+    byte const expected[] = {0x01, 0x80, 0x01, 0x80, 0x80, 0x01};
+    EXPECT_EQ(wrapMemory(expected), writer.viewWritten());
+}
+
+
+TEST(TestByteWriter, writeArrayBE) {
+    uint32 values[41];
+    for (uint32 i = 0; i < 41; ++i) {
+        values[i] = 0x01020304 * (i + 1);
+    }
+
+    byte buffer[1 + sizeof(values)];
+    byte expectedBuffer[1 + sizeof(values)];
+    ByteWriter writer(wrapMemory(buffer));
+    ByteWriter expected(wrapMemory(expectedBuffer));
+    ASSERT_TRUE(writer.write(uint8{0}).isOk());  // Unaligned destination
+    ASSERT_TRUE(expected.write(uint8{0}).isOk());
+
+    ASSERT_TRUE(writer.writeBE(arrayView(values)).isOk());
+    for (auto v : values) {
+        ASSERT_TRUE(expected.writeBE(v).isOk());
+    }
+    EXPECT_EQ(expected.viewWritten(), writer.viewWritten());
+
+    // No room left
+    EXPECT_TRUE(writer.writeBE(arrayView(values, 1)).isError());
+    EXPECT_EQ(sizeof(buffer), writer.position());
+}
+
+
+TEST(TestByteWriter, writeArrayLE) {
+    auto values = makeArray<int16>(3);
+    values[0] = 1;
+    values[1] = -2;
+    values[2] = 0x1234;
+
+    byte buffer[6];
+    ByteWriter writer(wrapMemory(buffer));
+    ASSERT_TRUE(writer.writeLE(values).isOk());
+
+    byte const expected[] = {0x01, 0x00, 0xFE, 0xFF, 0x34, 0x12};
+    EXPECT_EQ(wrapMemory(expected), writer.viewWritten());
+
+    ByteReader reader(writer.viewWritten());
+    auto readBack = makeArray<int16>(3);
+    ASSERT_TRUE(reader.readLE(readBack).isOk());
+    EXPECT_EQ(values, readBack);
+}
+
+
+TEST(TestByteWriter, reserveCursor) {
+    byte buffer[16];
+    ByteWriter writer(wrapMemory(buffer));
+    ASSERT_TRUE(writer.write(uint8{0xAA}).isOk());
+
+    EXPECT_TRUE(writer.reserve(16).isError());
+    EXPECT_EQ(1, writer.position());
+
+    {
+        auto cursor = writer.reserve(15).unwrap();
+        cursor.putBE(uint16{0x0102})
+                .putLE(uint32{0x06050403})
+                .putBE(int16{-2})
+                .put(byte{0x07});
+        EXPECT_EQ(9, cursor.written());
+        EXPECT_EQ(1, writer.position());  // Committed when the cursor goes out of scope
+    }
+    EXPECT_EQ(10, writer.position());
+
+    {
+        auto cursor = writer.reserve(6).unwrap();
+        auto moved = std::move(cursor);
+        moved.putBE(float32{1.0f});
+        moved.put(StringView{"ab"}.view());
+    }
+    EXPECT_EQ(16, writer.position());
+
+    byte const expected[] = {0xAA, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0xFF, 0xFE, 0x07,
+                             0x3F, 0x80, 0x00, 0x00, 'a', 'b'};
+    EXPECT_EQ(wrapMemory(expected), writer.viewWritten());
+}
@@ -0,0 +1,154 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ * @file: test/test_chainedByteReader.cpp
+ *******************************************************************************/
+#include <solace/chainedByteReader.hpp>	 // Class being tested
+
+#include <gtest/gtest.h>
+
+#include <cstring>  // memcpy
+
+
+using namespace Solace;
+
+
+class TestChainedByteReader: public ::testing::Test  {
+public:
+
+    TestChainedByteReader()
+        : _memoryManager(64*1024)
+    {}
+
+protected:
+
+    /// Allocate a segment holding a copy of the bytes.
+    template<size_t N>
+    MemoryResource segment(byte const (&bytes)[N]) {
+        auto memory = _memoryManager.allocate(N);
+        std::memcpy(memory.view().dataAddress(), bytes, N);
+
+        return memory;
+    }
+
+    MemoryManager _memoryManager;
+};
+
+
+TEST_F(TestChainedByteReader, testEmpty) {
+    ChainedByteReader reader{_memoryManager};
+
+    EXPECT_FALSE(reader.hasRemaining());
+    EXPECT_EQ(0, reader.remaining());
+    EXPECT_EQ(0, reader.segmentsCount());
+    EXPECT_TRUE(reader.viewRemaining().empty());
+    EXPECT_TRUE(reader.get().isError());
+
+    uint32 value;
+    EXPECT_TRUE(reader.readBE(value).isError());
+}
+
+
+TEST_F(TestChainedByteReader, testReadWithinSegment) {
+    byte const bytes[] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07};
+
+    ChainedByteReader reader{_memoryManager};
+    reader.append(segment(bytes));
+    EXPECT_EQ(sizeof(bytes), reader.remaining());
+
+    uint16 be;
+    EXPECT_TRUE(reader.readBE(be).isOk());
+    EXPECT_EQ(0x0102, be);
+
+    uint32 le;
+    EXPECT_TRUE(reader.readLE(le).isOk());
+    EXPECT_EQ(0x06050403U, le);
+
+    EXPECT_EQ(1, reader.viewRemaining().size());
+    EXPECT_EQ(0x07, reader.get().unwrap());
+    EXPECT_FALSE(reader.hasRemaining());
+}
+
+
+TEST_F(TestChainedByteReader, testReadAcrossSegments) {
+    byte const first[] = {0x01, 0x02, 0x03};
+    byte const second[] = {0x04};
+    byte const third[] = {0x05, 0x06, 0x07, 0x08, 0x09, 0x0A};
+
+    ChainedByteReader reader{_memoryManager};
+    reader.append(segment(first))
+            .append(segment(second))
+            .append(segment(third));
+    EXPECT_EQ(3, reader.segmentsCount());
+    EXPECT_EQ(10, reader.remaining());
+
+    EXPECT_TRUE(reader.advance(1).isOk());
+
+    uint32 value;
+    EXPECT_TRUE(reader.readBE(value).isOk());
+    EXPECT_EQ(0x02030405U, value);
+    EXPECT_EQ(1, reader.segmentsCount());
+    EXPECT_EQ(5, reader.viewRemaining().size());
+
+    uint64 tooBig;
+    EXPECT_TRUE(reader.readLE(tooBig).isError());
+    EXPECT_EQ(5, reader.remaining());
+
+    byte buffer[5];
+    auto dest = wrapMemory(buffer);
+    EXPECT_TRUE(reader.read(dest).isOk());
+    byte const expected[] = {0x06, 0x07, 0x08, 0x09, 0x0A};
+    EXPECT_EQ(wrapMemory(expected), wrapMemory(buffer));
+    EXPECT_EQ(0, reader.segmentsCount());
+}
+
+
+TEST_F(TestChainedByteReader, testReleasesReadSegments) {
+    byte const bytes[] = {0x01, 0x02, 0x03, 0x04};
+
+    ChainedByteReader reader{_memoryManager};
+    reader.append(segment(bytes))
+            .append(segment(bytes));
+    auto const allocated = _memoryManager.size();
+
+    EXPECT_TRUE(reader.advance(5).isOk());
+    EXPECT_EQ(allocated - sizeof(bytes), _memoryManager.size());
+    EXPECT_EQ(0x02, reader.get().unwrap());
+}
+
+
+TEST_F(TestChainedByteReader, testManySegments) {
+    ChainedByteReader reader{_memoryManager};
+    uint32 expected = 0;
+    uint32 next = 0;
+
+    // Keep appending while reading so that the queue of segments is compacted as it grows
+    for (int round = 0; round < 50; ++round) {
+        byte const bytes[] = {static_cast<byte>(next++), static_cast<byte>(next++), static_cast<byte>(next++)};
+        reader.append(segment(bytes));
+
+        while (reader.remaining() >= 2) {
+            uint16 value;
+            ASSERT_TRUE(reader.readLE(value).isOk());
+            EXPECT_EQ(static_cast<byte>(expected), value & 0xFF);
+            EXPECT_EQ(static_cast<byte>(expected + 1), value >> 8);
+            expected += 2;
+        }
+    }
+
+    EXPECT_LE(reader.segmentsCount(), 1);
+}
@@ -0,0 +1,149 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ * @file: test/test_compactVersion.cpp
+ *******************************************************************************/
+#include <solace/compactVersion.hpp>	 // Class being tested
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+
+using namespace Solace;
+
+
+TEST(TestCompactVersion, testParse) {
+    VersionLabels labels;
+
+    auto const release = labels.parse("1.22.333").unwrap();
+    EXPECT_EQ(1U, release.majorNumber());
+    EXPECT_EQ(22U, release.minorNumber());
+    EXPECT_EQ(333U, release.patchNumber());
+    EXPECT_EQ(0U, release.preRelease);
+    EXPECT_EQ(0U, release.build);
+
+    auto const full = labels.parse("2.0.1-rc.1+build.5").unwrap();
+    EXPECT_EQ(StringView{"rc.1"}, labels.label(full.preRelease));
+    EXPECT_EQ(StringView{"build.5"}, labels.label(full.build));
+    EXPECT_EQ(Version(2, 0, 1, "rc.1", "build.5"), labels.expand(full));
+    EXPECT_EQ(StringView{"build.5"}, labels.expand(full).build.view());
+
+    auto const buildOnly = labels.parse("2.0.1+build.5").unwrap();
+    EXPECT_EQ(0U, buildOnly.preRelease);
+    EXPECT_EQ(full.build, buildOnly.build);
+
+    // Labels are interned
+    auto const other = labels.parse("3.0.0-rc.1").unwrap();
+    EXPECT_EQ(full.preRelease, other.preRelease);
+    EXPECT_EQ(2U, labels.size());
+
+    auto const largest = labels.parse("2097151.2097151.2097151").unwrap();
+    EXPECT_EQ(CompactVersion::MaxNumber, largest.majorNumber());
+    EXPECT_EQ(CompactVersion::MaxNumber, largest.patchNumber());
+
+    for (auto invalid : {"", "1", "1.2", "1.2.", "1..3", "a.2.3", "1.2.3-", "1.2.3+", "1.2.3-rc..1",
+                         "1.2.3-r_c", "1.2.3x", "1.2.3-rc+b+c", "2097152.0.0"}) {
+        EXPECT_TRUE(labels.parse(StringView{invalid}).isError()) << invalid;
+    }
+}
+
+TEST(TestCompactVersion, testPrecedence) {
+    // Ordered as in the example of semantic versioning specification
+    char const* const ordered[] = {
+        "1.0.0-alpha", "1.0.0-alpha.1", "1.0.0-alpha.beta", "1.0.0-beta", "1.0.0-beta.2", "1.0.0-beta.11",
+        "1.0.0-rc.1", "1.0.0", "1.0.1-0", "1.0.1", "1.2.0", "1.10.0", "2.0.0-x", "2.0.0",
+    };
+
+    VersionLabels labels;
+    std::vector<CompactVersion> versions;
+    for (auto text : ordered) {
+        versions.push_back(labels.parse(StringView{text}).unwrap());
+    }
+
+    for (size_t i = 0; i < versions.size(); ++i) {
+        for (size_t j = 0; j < versions.size(); ++j) {
+            auto const expected = (i < j) ? -1 : (i > j) ? 1 : 0;
+            auto const actual = labels.compare(versions[i], versions[j]);
+            EXPECT_EQ(expected, (actual > 0) - (actual < 0)) << ordered[i] << " vs " << ordered[j];
+            EXPECT_EQ(i < j, labels.less()(versions[i], versions[j]));
+        }
+    }
+
+    auto shuffled = versions;
+    std::reverse(shuffled.begin(), shuffled.end());
+    std::swap(shuffled[2], shuffled[7]);
+    std::sort(shuffled.begin(), shuffled.end(), labels.less());
+    for (size_t i = 0; i < versions.size(); ++i) {
+        EXPECT_EQ(0, labels.compare(versions[i], shuffled[i]));
+    }
+
+    // Build metadata does not affect precedence
+    EXPECT_EQ(0, labels.compare(labels.parse("1.0.0+a").unwrap(), labels.parse("1.0.0+b").unwrap()));
+    EXPECT_EQ(0, labels.compare(labels.parse("1.0.0-rc.01").unwrap(), labels.parse("1.0.0-rc.1").unwrap()));
+}
+
+TEST(TestCompactVersion, testCompact) {
+    VersionLabels labels;
+    Version const version{3, 1, 4, "beta.2", "sha.1e2f"};
+
+    auto const compact = labels.compact(version).unwrap();
+    EXPECT_EQ(version, labels.expand(compact));
+    EXPECT_EQ(0, labels.compare(compact, labels.parse("3.1.4-beta.2+sha.1e2f").unwrap()));
+
+    EXPECT_TRUE(labels.compact(Version{CompactVersion::MaxNumber + 1, 0, 0}).isError());
+}
+
+TEST(TestCompactVersion, testParseVersions) {
+    char const text[] = "1.0.0\n2.0.0-rc.1\r\n\n1.5.2+b\n0.1.0-rc.1";
+    VersionLabels labels;
+
+    auto parsed = parseVersions(wrapMemory(text, sizeof(text) - 1), labels);
+    ASSERT_TRUE(parsed.isOk());
+    auto const& versions = parsed.unwrap();
+    ASSERT_EQ(4U, versions.size());
+    EXPECT_EQ(Version(1, 0, 0), labels.expand(versions[0]));
+    EXPECT_EQ(Version(2, 0, 0, "rc.1"), labels.expand(versions[1]));
+    EXPECT_EQ(Version(1, 5, 2), labels.expand(versions[2]));
+    EXPECT_EQ(versions[1].preRelease, versions[3].preRelease);
+    EXPECT_EQ(2U, labels.size());
+
+    EXPECT_EQ(0U, parseVersions(wrapMemory(text, 0), labels).unwrap().size());
+    EXPECT_EQ(1U, parseVersions(wrapMemory(text, 6), labels).unwrap().size());
+
+    char const invalid[] = "1.0.0\n1.0\n";
+    EXPECT_TRUE(parseVersions(wrapMemory(invalid, sizeof(invalid) - 1), labels).isError());
+}
+
+TEST(TestCompactVersion, testManyLabels) {
+    // Enough labels to grow the tables several times
+    VersionLabels labels;
+    std::vector<std::string> names;
+    for (int i = 0; i < 1000; ++i) {
+        names.push_back("pre" + std::to_string(i));
+    }
+    for (int round = 0; round < 2; ++round) {
+        for (int i = 0; i < 1000; ++i) {
+            auto const id = labels.intern(StringView{names[i].data(), static_cast<StringView::size_type>(names[i].size())});
+            EXPECT_EQ(static_cast<uint32>(i + 1), id);
+        }
+    }
+    EXPECT_EQ(1000U, labels.size());
+    EXPECT_EQ(StringView{"pre999"}, labels.label(1000));
+}
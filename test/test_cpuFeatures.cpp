@@ -0,0 +1,50 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ *	@file test/test_cpuFeatures.cpp
+ *	@brief		Test suit for Solace::cpu feature detection
+ ******************************************************************************/
+#include <solace/cpuFeatures.hpp>	 // Class being tested
+
+#include <gtest/gtest.h>
+
+
+using namespace Solace;
+
+
+TEST(TestCpuFeatures, testDetectionIsStable) {
+    EXPECT_EQ(cpu::hasSsse3(), cpu::hasSsse3());
+    EXPECT_EQ(cpu::hasSse41(), cpu::hasSse41());
+    EXPECT_EQ(cpu::hasAvx2(), cpu::hasAvx2());
+}
+
+TEST(TestCpuFeatures, testFeaturesAreCumulative) {
+    // Every CPU with AVX2 also supports the earlier SSE extensions
+    if (cpu::hasAvx2()) {
+        EXPECT_TRUE(cpu::hasSse41());
+    }
+
+    if (cpu::hasSse41()) {
+        EXPECT_TRUE(cpu::hasSsse3());
+    }
+}
+
+#if defined(__x86_64__) && defined(__SSSE3__)
+TEST(TestCpuFeatures, testCompileTimeFeaturesAreDetected) {
+    EXPECT_TRUE(cpu::hasSsse3());
+}
+#endif
@@ -0,0 +1,207 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ * @file: test/test_csv.cpp
+ *******************************************************************************/
+#include <solace/csv.hpp>	 // Class being tested
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+
+using namespace Solace;
+
+
+namespace {
+
+using Records = std::vector<std::vector<std::string>>;
+
+/// Parse a document into records of unescaped fields.
+Result<Records, CsvError> parseAll(CsvReader&& reader) {
+    Records records;
+    std::vector<std::string> record;
+    char scratch[256];
+
+    auto result = reader.forEachField([&](CsvField const& field) {
+        auto const value = field.unescape(wrapMemory(scratch)).unwrap();
+        record.emplace_back(value.data(), value.size());
+        if (field.isLastInRecord()) {
+            records.push_back(std::move(record));
+            record.clear();
+        }
+    });
+
+    if (!result) {
+        return Err(result.getError());
+    }
+
+    EXPECT_EQ(records.size(), result.unwrap());
+
+    return Ok(std::move(records));
+}
+
+Records parseAll(MemoryView source) {
+    return parseAll(CsvReader{source}).unwrap();
+}
+
+Records parseAll(StringView source) {
+    return parseAll(source.view());
+}
+
+}  // namespace
+
+
+TEST(TestCsv, testSimple) {
+    EXPECT_EQ((Records{{"a", "b", "c"}, {"1", "2", "3"}}), parseAll(StringView{"a,b,c\n1,2,3\n"}));
+    EXPECT_EQ((Records{{"a", "b"}, {"1", "2"}}), parseAll(StringView{"a,b\r\n1,2"}));
+    EXPECT_EQ((Records{{"", "", ""}, {""}, {"x"}}), parseAll(StringView{",,\n\nx"}));
+    EXPECT_EQ((Records{{"a", ""}}), parseAll(StringView{"a,"}));
+    EXPECT_TRUE(parseAll(StringView{""}).empty());
+}
+
+TEST(TestCsv, testCarriageReturnAtEndOfDocument) {
+    // Document ending with CR without LF gives the same fields as one with CRLF or LF
+    EXPECT_EQ((Records{{"a", "b"}, {"1", "2"}}), parseAll(StringView{"a,b\r\n1,2\r"}));
+    EXPECT_EQ((Records{{"a", "b"}, {"1", "2"}}), parseAll(StringView{"a,b\r\n1,2\r\n"}));
+    EXPECT_EQ((Records{{"a", "x y"}}), parseAll(StringView{"a,\"x y\"\r"}));
+    EXPECT_EQ((Records{{""}}), parseAll(StringView{"\r"}));
+}
+
+TEST(TestCsv, testFieldsAreViews) {
+    StringView const source{"name,value\nx,\"1,5\"\n"};
+    CsvReader reader{source};
+
+    auto const name = reader.next().unwrap().get();
+    EXPECT_EQ(StringView{"name"}, name.raw());
+    EXPECT_EQ(source.data(), name.raw().data());
+    EXPECT_FALSE(name.isLastInRecord());
+    EXPECT_TRUE(reader.next().unwrap().get().isLastInRecord());
+
+    reader.next().unwrap();
+    auto const quoted = reader.next().unwrap().get();
+    EXPECT_TRUE(quoted.isQuoted());
+    EXPECT_FALSE(quoted.hasEscapes());
+    EXPECT_EQ(StringView{"\"1,5\""}, quoted.raw());
+    EXPECT_EQ(StringView{"1,5"}, quoted.view());
+    EXPECT_EQ(quoted.view().data(), quoted.unescape(MutableMemoryView{}).unwrap().data());
+    EXPECT_EQ(source.size() - 6, quoted.offset());
+
+    EXPECT_TRUE(reader.next().unwrap().isNone());
+}
+
+TEST(TestCsv, testQuotedFields) {
+    EXPECT_EQ((Records{{"a,b", "line\nbreak", "say \"hi\"", "", "\""}}),
+              parseAll(StringView{"\"a,b\",\"line\nbreak\",\"say \"\"hi\"\"\",\"\",\"\"\"\"\r\n"}));
+
+    CsvReader reader{StringView{"\"x\"\"y\""}};
+    auto const field = reader.next().unwrap().get();
+    EXPECT_TRUE(field.hasEscapes());
+
+    char small[2];
+    EXPECT_TRUE(field.unescape(wrapMemory(small)).isError());
+}
+
+TEST(TestCsv, testTsv) {
+    CsvReader reader{StringView{"a\t\"b\tc\n"}, CsvDialect::tsv()};
+
+    auto const records = parseAll(std::move(reader)).unwrap();
+    EXPECT_EQ((Records{{"a", "\"b", "c"}}), records);
+
+    CsvDialect const semicolon{';', '\'', true};
+    EXPECT_EQ((Records{{"a;b", "it's"}}),
+              parseAll(CsvReader{StringView{"'a;b';'it''s'"}, semicolon}).unwrap());
+}
+
+TEST(TestCsv, testErrors) {
+    auto const errorAt = [](char const* text) {
+        auto result = parseAll(CsvReader{StringView{text}});
+        EXPECT_TRUE(result.isError()) << text;
+
+        return result.isError() ? result.getError().offset : ~MemoryView::size_type{0};
+    };
+
+    EXPECT_EQ(3U, errorAt("a,b\"c\n"));
+    EXPECT_EQ(5U, errorAt("a,\"b\"c,d\n"));
+    EXPECT_EQ(2U, errorAt("a,\"unclosed\n"));
+    EXPECT_EQ(CsvError::Kind::UnclosedQuote, parseAll(CsvReader{StringView{"\"a"}}).getError().kind);
+
+    // Fields before the error are returned
+    CsvReader reader{StringView{"ok,fine\nbad\"\n"}};
+    EXPECT_EQ(StringView{"ok"}, reader.next().unwrap().get().raw());
+    EXPECT_EQ(StringView{"fine"}, reader.next().unwrap().get().raw());
+    EXPECT_TRUE(reader.next().isError());
+    EXPECT_TRUE(reader.next().isError());
+}
+
+TEST(TestCsv, testLongDocument) {
+    // Quoted fields and escapes cross block boundaries at every offset
+    std::string text;
+    Records expected;
+    for (size_t i = 0; i < 300; ++i) {
+        std::string const value(i % 70, static_cast<char>('a' + i % 26));
+        std::string const special = "q\"" + value + ",\n";
+        expected.push_back({value, special, std::to_string(i)});
+        text += value + ",\"q\"\"" + value + ",\n\"," + std::to_string(i) + "\n";
+    }
+
+    EXPECT_EQ(expected, parseAll(wrapMemory(&text[0], text.size())));
+}
+
+TEST(TestCsv, testParallelChunks) {
+    std::string text;
+    for (size_t i = 0; i < 500; ++i) {
+        text += std::to_string(i) + ",\"multi\nline, \"\"quoted\"\"\n" + std::string(i % 37, 'x') + "\",tail\n";
+    }
+    auto const document = wrapMemory(&text[0], text.size());
+    auto const expected = parseAll(document);
+
+    auto const parseChunks = [&text](std::vector<MemoryView> const& chunks) {
+        Records records;
+        MemoryView::size_type covered = 0;
+        for (auto const& chunk : chunks) {
+            covered += chunk.size();
+            for (auto& record : parseAll(chunk)) {
+                records.push_back(std::move(record));
+            }
+        }
+        EXPECT_EQ(text.size(), covered);
+
+        return records;
+    };
+
+    for (size_t chunksCount : {1, 2, 3, 7, 16, 5000}) {
+        std::vector<MemoryView> chunks(chunksCount);
+
+        // Phase 1 - independent per chunk, could run on separate threads
+        std::vector<CsvChunkSummary> summaries;
+        for (size_t i = 0; i < chunksCount; ++i) {
+            chunks[i] = document.slice(text.size() * i / chunksCount, text.size() * (i + 1) / chunksCount);
+            summaries.push_back(summarizeCsvChunk(chunks[i]));
+        }
+
+        // Phase 2 - sequential fix up of chunk seams
+        alignCsvChunks(document, ArrayView<MemoryView>{chunks.data(), static_cast<uint32>(chunks.size())},
+                       ArrayView<const CsvChunkSummary>{summaries.data(), static_cast<uint32>(summaries.size())});
+        EXPECT_EQ(expected, parseChunks(chunks)) << chunksCount << " chunks";
+
+        std::vector<MemoryView> split(chunksCount);
+        splitCsv(document, ArrayView<MemoryView>{split.data(), static_cast<uint32>(split.size())});
+        EXPECT_EQ(expected, parseChunks(split)) << chunksCount << " chunks";
+    }
+}
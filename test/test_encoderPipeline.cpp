@@ -0,0 +1,254 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ *	@file test/test_encoderPipeline.cpp
+ *	@brief		Test suit for Solace::EncoderPipeline
+ ******************************************************************************/
+#include <solace/encoderPipeline.hpp>    // Class being tested
+
+#include <solace/base16.hpp>
+#include <solace/base64.hpp>
+#include <solace/exception.hpp>
+#include <solace/hashing/sha2.hpp>
+#include <solace/output_utils.hpp>
+
+#include <gtest/gtest.h>
+
+
+using namespace Solace;
+using namespace Solace::hashing;
+
+
+namespace {
+
+byte testData[1000];
+
+MemoryView makeTestData() {
+    for (size_t i = 0; i < sizeof(testData); ++i) {
+        testData[i] = static_cast<byte>(i * 31 + 7);
+    }
+
+    return wrapMemory(testData);
+}
+
+}  // namespace
+
+
+TEST(TestEncoderPipeline, testHashAndEncodeInSinglePass) {
+    auto const data = makeTestData();
+
+    byte expectedBuffer[2048];
+    ByteWriter expected{wrapMemory(expectedBuffer)};
+    ASSERT_TRUE(Base64Encoder{expected}.encode(data).isOk());
+
+    // Block size that is not a multiple of 3 makes the encoder carry bytes over between blocks
+    for (EncoderPipeline::size_type blockSize : {1, 7, 64, 999, 1000, 4096}) {
+        byte buffer[2048];
+        ByteWriter dest{wrapMemory(buffer)};
+        Sha256 hash;
+        Base64StreamEncoder base64{dest};
+
+        EncoderPipeline pipeline{dest, blockSize};
+        pipeline.tap(hash)
+                .pipe(base64);
+        EXPECT_EQ(2U, pipeline.stepsCount());
+
+        ASSERT_TRUE(pipeline.update(data).isOk());
+        ASSERT_TRUE(pipeline.finish().isOk());
+
+        EXPECT_EQ(expected.viewWritten(), dest.viewWritten()) << blockSize;
+        EXPECT_EQ(Sha256{}.update(data).digest(), hash.digest()) << blockSize;
+    }
+}
+
+
+TEST(TestEncoderPipeline, testHashOnlyCopiesIntoDest) {
+    auto const data = makeTestData();
+
+    byte buffer[1024];
+    ByteWriter dest{wrapMemory(buffer)};
+    Sha256 hash;
+
+    EncoderPipeline pipeline{dest, 100};
+    pipeline.tap(hash);
+
+    ASSERT_TRUE(pipeline.update(data).isOk());
+    ASSERT_TRUE(pipeline.finish().isOk());
+
+    EXPECT_EQ(data, dest.viewWritten());
+    EXPECT_EQ(Sha256{}.update(data).digest(), hash.digest());
+}
+
+
+TEST(TestEncoderPipeline, testChainOfEncoders) {
+    auto const data = makeTestData();
+
+    byte hexBuffer[4096];
+    ByteWriter hex{wrapMemory(hexBuffer)};
+    ASSERT_TRUE(Base16Encoder{hex}.encode(data).isOk());
+
+    byte expectedBuffer[4096];
+    ByteWriter expected{wrapMemory(expectedBuffer)};
+    ASSERT_TRUE(Base64Encoder{expected}.encode(hex.viewWritten()).isOk());
+
+    // Scratch buffer of the first encoder only needs to fit the output of a single block
+    byte scratchBuffer[64];
+    ByteWriter scratch{wrapMemory(scratchBuffer)};
+    byte buffer[4096];
+    ByteWriter dest{wrapMemory(buffer)};
+
+    Base16StreamEncoder base16{scratch};
+    Base64StreamEncoder base64{dest};
+    Sha256 plainHash;
+    Sha256 hexHash;
+    Sha256 base64Hash;
+
+    EncoderPipeline pipeline{dest, 32};
+    pipeline.tap(plainHash)
+            .pipe(base16)
+            .tap(hexHash)
+            .pipe(base64)
+            .tap(base64Hash);
+
+    ASSERT_TRUE(pipeline.update(data).isOk());
+    ASSERT_TRUE(pipeline.finish().isOk());
+
+    EXPECT_EQ(expected.viewWritten(), dest.viewWritten());
+    EXPECT_EQ(0U, scratch.position());
+    EXPECT_EQ(Sha256{}.update(data).digest(), plainHash.digest());
+    EXPECT_EQ(Sha256{}.update(hex.viewWritten()).digest(), hexHash.digest());
+    EXPECT_EQ(Sha256{}.update(expected.viewWritten()).digest(), base64Hash.digest());
+}
+
+
+TEST(TestEncoderPipeline, testScratchBufferTooSmall) {
+    byte scratchBuffer[8];
+    ByteWriter scratch{wrapMemory(scratchBuffer)};
+    byte buffer[64];
+    ByteWriter dest{wrapMemory(buffer)};
+
+    Base16StreamEncoder base16{scratch};
+    EncoderPipeline pipeline{dest, 16};
+    pipeline.pipe(base16);
+
+    EXPECT_TRUE(pipeline.update(wrapMemory("abcdefghijklmnop", 16)).isError());
+    EXPECT_EQ(0U, dest.position());
+}
+
+
+TEST(TestEncoderPipeline, testDestFullResumesFromUnprocessedBlock) {
+    auto const data = makeTestData();
+
+    byte expectedBuffer[2048];
+    ByteWriter expected{wrapMemory(expectedBuffer)};
+    ASSERT_TRUE(Base64Encoder{expected}.encode(data).isOk());
+
+    byte buffer[100];
+    ByteWriter dest{wrapMemory(buffer)};
+    Sha256 hash;
+    Base64StreamEncoder base64{dest};
+
+    EncoderPipeline pipeline{dest, 30};
+    pipeline.tap(hash)
+            .pipe(base64);
+
+    byte outputBuffer[2048];
+    ByteWriter output{wrapMemory(outputBuffer)};
+
+    ByteReader reader{data};
+    while (true) {
+        auto const before = reader.remaining();
+        auto result = pipeline.update(reader);
+        if (result) {
+            break;
+        }
+
+        // Only whole blocks are consumed
+        EXPECT_EQ(0U, (before - reader.remaining()) % 30);
+        ASSERT_TRUE(output.write(dest.viewWritten()).isOk());
+        dest.rewind();
+    }
+    ASSERT_TRUE(pipeline.finish().isOk());
+    ASSERT_TRUE(output.write(dest.viewWritten()).isOk());
+
+    EXPECT_EQ(expected.viewWritten(), output.viewWritten());
+    EXPECT_EQ(Sha256{}.update(data).digest(), hash.digest());
+}
+
+
+TEST(TestEncoderPipeline, testDestFullOnFinishKeepsCarriedData) {
+    byte scratchBuffer[16];
+    ByteWriter scratch{wrapMemory(scratchBuffer)};
+    byte buffer[16];
+    ByteWriter dest{wrapMemory(buffer)};
+
+    Base64StreamEncoder base64{scratch};
+    Base16StreamEncoder base16{dest};
+    Sha256 hash;
+
+    EncoderPipeline pipeline{dest};
+    pipeline.pipe(base64)
+            .tap(hash)
+            .pipe(base16);
+
+    // A single byte is carried over by the base64 encoder, nothing is written until finish
+    byte const data[] = {0x04};
+    ASSERT_TRUE(pipeline.update(wrapMemory(data)).isOk());
+    EXPECT_EQ(0U, dest.position());
+
+    // "BA==" encodes into 8 hex digits, one more than the room left
+    ASSERT_TRUE(dest.write(wrapMemory("123456789", 9)).isOk());
+    EXPECT_TRUE(pipeline.finish().isError());
+    EXPECT_EQ(9U, dest.position());
+
+    dest.rewind();
+    ASSERT_TRUE(pipeline.finish().isOk());
+    EXPECT_EQ(wrapMemory("42413d3d", 8), dest.viewWritten());
+    EXPECT_EQ(Sha256{}.update(wrapMemory("BA==", 4)).digest(), hash.digest());
+}
+
+
+TEST(TestEncoderPipeline, testResetDropsCarriedData) {
+    byte buffer[64];
+    ByteWriter dest{wrapMemory(buffer)};
+    Base64StreamEncoder base64{dest};
+
+    EncoderPipeline pipeline{dest};
+    pipeline.pipe(base64);
+
+    ASSERT_TRUE(pipeline.update(wrapMemory("fo", 2)).isOk());
+    pipeline.reset();
+    dest.rewind();
+
+    ASSERT_TRUE(pipeline.update(wrapMemory("foo", 3)).isOk());
+    ASSERT_TRUE(pipeline.finish().isOk());
+    EXPECT_EQ(wrapMemory("Zm9v", 4), dest.viewWritten());
+}
+
+
+TEST(TestEncoderPipeline, testTooManySteps) {
+    byte buffer[64];
+    ByteWriter dest{wrapMemory(buffer)};
+    Sha256 hash;
+
+    EncoderPipeline pipeline{dest};
+    for (uint32 i = 0; i < EncoderPipeline::kMaxSteps; ++i) {
+        pipeline.tap(hash);
+    }
+
+    EXPECT_THROW(pipeline.tap(hash), OverflowException);
+}
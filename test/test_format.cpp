@@ -0,0 +1,175 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ * @file: test/test_format.cpp
+ *******************************************************************************/
+#include <solace/format.hpp>	 // Class being tested
+#include <solace/stringBuilder.hpp>
+#include <solace/exception.hpp>
+
+#include <gtest/gtest.h>
+
+
+using namespace Solace;
+
+
+namespace {
+
+StringView written(ByteWriter const& writer) {
+    auto const view = writer.viewWritten();
+    return {view.dataAs<char const>(), static_cast<StringView::size_type>(view.size())};
+}
+
+}  // namespace
+
+
+// Compile time checks of the format string parser
+static_assert(details::countFormatFields(StringLiteral{""}) == 1, "Empty format string");
+static_assert(details::countFormatFields(StringLiteral{"abc"}) == 1, "Literal only format string");
+static_assert(details::countFormatFields(StringLiteral{"a{}b{}c"}) == 3, "Two fields and a trailing literal");
+
+
+TEST(TestFormat, testLiteralOnly) {
+    char buffer[64];
+    ByteWriter writer{wrapMemory(buffer)};
+
+    EXPECT_TRUE(formatTo(writer, "Hello world"));
+    EXPECT_EQ(StringView{"Hello world"}, written(writer));
+}
+
+TEST(TestFormat, testEscapedBraces) {
+    char buffer[64];
+    ByteWriter writer{wrapMemory(buffer)};
+
+    EXPECT_TRUE(formatTo(writer, SOLACE_FMT("{{{}}} }}{{"), 42));
+    EXPECT_EQ(StringView{"{42} }{"}, written(writer));
+}
+
+TEST(TestFormat, testAutomaticAndManualIndexing) {
+    char buffer[64];
+    ByteWriter writer{wrapMemory(buffer)};
+
+    EXPECT_TRUE(formatTo(writer, SOLACE_FMT("{}-{}-{}"), 1, 'x', StringView{"yz"}));
+    EXPECT_EQ(StringView{"1-x-yz"}, written(writer));
+
+    writer.rewind();
+    EXPECT_TRUE(formatTo(writer, SOLACE_FMT("{1}{0}{1}"), "a", "b"));
+    EXPECT_EQ(StringView{"bab"}, written(writer));
+}
+
+TEST(TestFormat, testIntegers) {
+    char buffer[128];
+    ByteWriter writer{wrapMemory(buffer)};
+
+    EXPECT_TRUE(formatTo(writer, SOLACE_FMT("{} {} {:x} {:X} {:o} {:b} {:c}"),
+                         -17, uint64{18446744073709551615ULL}, 255, 255, 8, 5, 65));
+    EXPECT_EQ(StringView{"-17 18446744073709551615 ff FF 10 101 A"}, written(writer));
+}
+
+TEST(TestFormat, testWidthAndAlignment) {
+    char buffer[128];
+    ByteWriter writer{wrapMemory(buffer)};
+
+    EXPECT_TRUE(formatTo(writer, SOLACE_FMT("[{:5}][{:<5}][{:^6}][{:*>4}][{:5}]"), 42, 42, "ab", 7, "ab"));
+    EXPECT_EQ(StringView{"[   42][42   ][  ab  ][***7][ab   ]"}, written(writer));
+}
+
+TEST(TestFormat, testZeroPadding) {
+    char buffer[64];
+    ByteWriter writer{wrapMemory(buffer)};
+
+    EXPECT_TRUE(formatTo(writer, SOLACE_FMT("{:05} {:08.3f} {:06x}"), -42, -3.14159, 0xbeef));
+    EXPECT_EQ(StringView{"-0042 -003.142 00beef"}, written(writer));
+}
+
+TEST(TestFormat, testFloatingPoint) {
+    char buffer[128];
+    ByteWriter writer{wrapMemory(buffer)};
+
+    EXPECT_TRUE(formatTo(writer, SOLACE_FMT("{} {} {:.2f} {:e} {:.3E} {:g}"), 0.1, 1.5f, 2.0, 1234.5, 0.00012, 1e20));
+    EXPECT_EQ(StringView{"0.1 1.5 2.00 1.2345e+03 1.200E-04 1e+20"}, written(writer));
+}
+
+TEST(TestFormat, testStringsAndBooleans) {
+    char buffer[64];
+    ByteWriter writer{wrapMemory(buffer)};
+
+    String const str = makeString("string");
+    EXPECT_TRUE(formatTo(writer, SOLACE_FMT("{} {:.3} {} {:s}"), str, "truncate", true, false));
+    EXPECT_EQ(StringView{"string tru true false"}, written(writer));
+}
+
+TEST(TestFormat, testPointer) {
+    char buffer[64];
+    ByteWriter writer{wrapMemory(buffer)};
+
+    int const* const ptr = nullptr;
+    EXPECT_TRUE(formatTo(writer, SOLACE_FMT("{}"), ptr));
+    EXPECT_EQ(StringView{"0x0"}, written(writer));
+}
+
+TEST(TestFormat, testOverflowLeavesWriterUnchanged) {
+    char buffer[8];
+    ByteWriter writer{wrapMemory(buffer)};
+
+    EXPECT_TRUE(formatTo(writer, SOLACE_FMT("ab")));
+    EXPECT_TRUE(formatTo(writer, SOLACE_FMT("{}{}"), "12345", 1234).isError());
+    EXPECT_EQ(StringView{"ab"}, written(writer));
+
+    EXPECT_TRUE(formatTo(writer, SOLACE_FMT("{:10}"), 1).isError());
+    EXPECT_EQ(StringView{"ab"}, written(writer));
+}
+
+TEST(TestFormat, testRuntimeFormatErrors) {
+    char buffer[64];
+    ByteWriter writer{wrapMemory(buffer)};
+
+    EXPECT_TRUE(formatTo(writer, StringView{"{"}, 1).isError());
+    EXPECT_TRUE(formatTo(writer, StringView{"}"}, 1).isError());
+    EXPECT_TRUE(formatTo(writer, StringView{"{:q}"}, 1).isError());
+    EXPECT_TRUE(formatTo(writer, StringView{"{} {}"}, 1).isError());
+    EXPECT_TRUE(formatTo(writer, StringView{"{0} {}"}, 1, 2).isError());
+    EXPECT_TRUE(formatTo(writer, StringView{"{:f}"}, 1).isError());
+    EXPECT_TRUE(formatTo(writer, StringView{"{:.2}"}, 1).isError());
+    EXPECT_EQ(0, writer.position());
+
+    EXPECT_TRUE(formatTo(writer, StringView{"{}+{}={}"}, 1, 2, 3));
+    EXPECT_EQ(StringView{"1+2=3"}, written(writer));
+}
+
+TEST(TestFormat, testStringBuilderAppendFormat) {
+    char buffer[64];
+    StringBuilder builder{wrapMemory(buffer)};
+
+    builder.appendFormat(SOLACE_FMT("{}: {:.1f}"), "pi", 3.14159)
+            .append(' ')
+            .appendFormat(StringView{"[{:>3}]"}, 7);
+
+    EXPECT_EQ(StringView{"pi: 3.1 [  7]"}, builder.view());
+}
+
+TEST(TestFormat, testStringBuilderAppendFormatErrors) {
+    char buffer[8];
+    StringBuilder builder{wrapMemory(buffer)};
+    builder.append("ab");
+
+    EXPECT_THROW(builder.appendFormat(SOLACE_FMT("{}{}"), "abcd", 1234), OverflowException);
+    EXPECT_EQ(StringView{"ab"}, builder.view());
+
+    EXPECT_THROW(builder.appendFormat(StringView{"{:q}"}, 7), IllegalArgumentException);
+    EXPECT_EQ(StringView{"ab"}, builder.view());
+}
@@ -0,0 +1,183 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ * @file: test/test_gatherWriter.cpp
+ *******************************************************************************/
+#include <solace/gatherWriter.hpp>	 // Class being tested
+
+#include <gtest/gtest.h>
+
+#include <unistd.h>  // pipe, read, close
+
+
+using namespace Solace;
+
+
+class TestGatherWriter: public ::testing::Test  {
+public:
+
+    TestGatherWriter()
+        : _memoryManager(64*1024)
+    {}
+
+protected:
+    MemoryManager _memoryManager;
+};
+
+
+TEST_F(TestGatherWriter, testEmpty) {
+    GatherWriter writer{_memoryManager};
+
+    EXPECT_TRUE(writer.empty());
+    EXPECT_EQ(0, writer.size());
+    EXPECT_EQ(0, writer.segmentsCount());
+    EXPECT_TRUE(writer.iovecs().empty());
+    EXPECT_EQ(0, _memoryManager.size());
+}
+
+
+TEST_F(TestGatherWriter, testSmallWritesCoalesce) {
+    GatherWriter writer{_memoryManager};
+
+    writer.writeBE(uint16{0x0102})
+            .writeLE(uint32{0x06050403})
+            .write(uint8{7})
+            .write(StringView{"89"}.view());
+
+    EXPECT_EQ(9, writer.size());
+    ASSERT_EQ(1, writer.segmentsCount());
+
+    byte const expected[] = {1, 2, 3, 4, 5, 6, 7, '8', '9'};
+    EXPECT_EQ(wrapMemory(expected), writer.segment(0));
+}
+
+
+TEST_F(TestGatherWriter, testWriteSignedAndFloatingPoint) {
+    GatherWriter writer{_memoryManager};
+
+    writer.writeBE(int16{-2})
+            .writeLE(int64{-2})
+            .writeBE(1.0f);
+
+    byte const expected[] = {0xFF, 0xFE,
+                             0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                             0x3F, 0x80, 0x00, 0x00};
+    ASSERT_EQ(1, writer.segmentsCount());
+    EXPECT_EQ(wrapMemory(expected), writer.segment(0));
+}
+
+
+TEST_F(TestGatherWriter, testLargeViewsAreReferenced) {
+    byte payload[1024];
+    for (size_t i = 0; i < sizeof(payload); ++i) {
+        payload[i] = static_cast<byte>(i);
+    }
+
+    GatherWriter writer{_memoryManager, 256, 512};
+    writer.writeBE(uint32{sizeof(payload)})
+            .write(wrapMemory(payload))
+            .writeBE(uint16{0xCAFE});
+
+    EXPECT_EQ(4 + sizeof(payload) + 2, writer.size());
+    ASSERT_EQ(3, writer.segmentsCount());
+    EXPECT_EQ(payload, writer.segment(1).dataAddress());  // Not copied
+
+    auto const segments = writer.iovecs();
+    EXPECT_EQ(3, segments.size());
+    EXPECT_EQ(4, segments[0].iov_len);
+    EXPECT_EQ(sizeof(payload), segments[1].iov_len);
+    EXPECT_EQ(2, segments[2].iov_len);
+}
+
+
+TEST_F(TestGatherWriter, testCopySpansPages) {
+    char text[100];
+    for (size_t i = 0; i < sizeof(text); ++i) {
+        text[i] = static_cast<char>('a' + i % 26);
+    }
+
+    GatherWriter writer{_memoryManager, 16};
+    writer.copy(wrapMemory(text));
+    writer.copy(wrapMemory(text));
+
+    EXPECT_EQ(2 * sizeof(text), writer.size());
+    EXPECT_LE(13, writer.segmentsCount());
+
+    byte buffer[2 * sizeof(text)];
+    ByteWriter dest{wrapMemory(buffer)};
+    ASSERT_TRUE(writer.copyTo(dest).isOk());
+    EXPECT_EQ(wrapMemory(text), dest.viewWritten().slice(0, sizeof(text)));
+    EXPECT_EQ(wrapMemory(text), dest.viewWritten().slice(sizeof(text), 2 * sizeof(text)));
+
+    byte small[10];
+    ByteWriter smallDest{wrapMemory(small)};
+    EXPECT_TRUE(writer.copyTo(smallDest).isError());
+}
+
+
+TEST_F(TestGatherWriter, testClearReusesPages) {
+    GatherWriter writer{_memoryManager, 64};
+    writer.copy(StringView{"Hello there"}.view());
+    auto const allocated = _memoryManager.size();
+
+    writer.clear();
+    EXPECT_TRUE(writer.empty());
+    EXPECT_EQ(0, writer.segmentsCount());
+
+    writer.copy(StringView{"Again"}.view());
+    EXPECT_EQ(allocated, _memoryManager.size());
+    ASSERT_EQ(1, writer.segmentsCount());
+    EXPECT_EQ(StringView{"Again"}.view(), writer.segment(0));
+}
+
+
+TEST_F(TestGatherWriter, testMove) {
+    GatherWriter writer{_memoryManager};
+    writer.write(uint8{42});
+
+    GatherWriter other{std::move(writer)};
+    EXPECT_EQ(1, other.size());
+    EXPECT_EQ(0, writer.size());
+}
+
+
+TEST_F(TestGatherWriter, testWritev) {
+    byte payload[2000];
+    for (size_t i = 0; i < sizeof(payload); ++i) {
+        payload[i] = static_cast<byte>(i * 3);
+    }
+
+    GatherWriter writer{_memoryManager};
+    writer.writeBE(uint32{sizeof(payload)})
+            .write(wrapMemory(payload));
+
+    int fds[2];
+    ASSERT_EQ(0, ::pipe(fds));
+    auto const segments = writer.iovecs();
+    auto const written = ::writev(fds[1], segments.begin(), static_cast<int>(segments.size()));
+    EXPECT_EQ(static_cast<ssize_t>(writer.size()), written);
+
+    byte received[4 + sizeof(payload)];
+    EXPECT_EQ(static_cast<ssize_t>(sizeof(received)), ::read(fds[0], received, sizeof(received)));
+    ::close(fds[0]);
+    ::close(fds[1]);
+
+    EXPECT_EQ(0, received[0]);
+    EXPECT_EQ(0x07, received[2]);
+    EXPECT_EQ(0xD0, received[3]);
+    EXPECT_EQ(wrapMemory(payload), wrapMemory(received).slice(4, sizeof(received)));
+}
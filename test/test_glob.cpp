@@ -0,0 +1,197 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ * @file: test/test_glob.cpp
+ *******************************************************************************/
+#include <solace/glob.hpp>	 // Class being tested
+
+#include <gtest/gtest.h>
+
+#include <fnmatch.h>
+#include <string>
+#include <vector>
+
+
+using namespace Solace;
+
+
+namespace {
+
+GlobSet compile(std::vector<StringView> const& patterns) {
+    return makeGlobSet(ArrayView<const StringView>{patterns.data(), static_cast<uint32>(patterns.size())}).unwrap();
+}
+
+bool matches(char const* pattern, char const* text) {
+    return compile({StringView{pattern}}).matchesAny(StringView{text});
+}
+
+std::vector<GlobSet::PatternId> matching(GlobSet const& globs, StringView text) {
+    std::vector<GlobSet::PatternId> ids;
+    globs.match(text, [&ids](GlobSet::PatternId id) { ids.push_back(id); });
+
+    return ids;
+}
+
+}  // namespace
+
+
+TEST(TestGlob, testWildcards) {
+    EXPECT_TRUE(matches("main.cpp", "main.cpp"));
+    EXPECT_FALSE(matches("main.cpp", "main.cp"));
+    EXPECT_FALSE(matches("main.cpp", "main.cppx"));
+
+    EXPECT_TRUE(matches("*.cpp", "main.cpp"));
+    EXPECT_TRUE(matches("*.cpp", ".cpp"));
+    EXPECT_FALSE(matches("*.cpp", "src/main.cpp"));
+    EXPECT_TRUE(matches("src/*/*.hpp", "src/solace/path.hpp"));
+    EXPECT_TRUE(matches("*a*b*c*", "xxaxxbxxcxx"));
+    EXPECT_FALSE(matches("*a*b*c*", "xxaxxcxxbxx"));
+
+    EXPECT_TRUE(matches("file?.txt", "file1.txt"));
+    EXPECT_FALSE(matches("file?.txt", "file.txt"));
+    EXPECT_FALSE(matches("a?b", "a/b"));
+
+    EXPECT_TRUE(matches("", ""));
+    EXPECT_FALSE(matches("", "a"));
+    EXPECT_TRUE(matches("*", ""));
+}
+
+TEST(TestGlob, testGlobStar) {
+    EXPECT_TRUE(matches("**", "a/b/c"));
+    EXPECT_TRUE(matches("build/**", "build/obj/main.o"));
+    EXPECT_FALSE(matches("build/**", "src/build/main.o"));
+
+    // Whole component globstar matches zero or more directories
+    EXPECT_TRUE(matches("**/*.o", "main.o"));
+    EXPECT_TRUE(matches("**/*.o", "build/obj/main.o"));
+    EXPECT_TRUE(matches("a/**/b", "a/b"));
+    EXPECT_TRUE(matches("a/**/b", "a/x/b"));
+    EXPECT_TRUE(matches("a/**/b", "a/x/y/z/b"));
+    EXPECT_FALSE(matches("a/**/b", "a/xb"));
+    EXPECT_FALSE(matches("a/**/b", "ab"));
+    EXPECT_TRUE(matches("**/.git/**", ".git/config"));
+    EXPECT_TRUE(matches("**/.git/**", "vendor/lib/.git/objects/ab"));
+    EXPECT_FALSE(matches("**/.git/**", "vendor/lib/.gitignore"));
+
+    // Not a whole component: matches anything
+    EXPECT_TRUE(matches("a**b", "a/x/b"));
+    EXPECT_TRUE(matches("a**b", "ab"));
+}
+
+TEST(TestGlob, testClasses) {
+    EXPECT_TRUE(matches("[abc].txt", "b.txt"));
+    EXPECT_FALSE(matches("[abc].txt", "d.txt"));
+    EXPECT_TRUE(matches("v[0-9][0-9]", "v42"));
+    EXPECT_FALSE(matches("v[0-9]", "vx"));
+    EXPECT_TRUE(matches("[!a-z]*", "Makefile"));
+    EXPECT_FALSE(matches("[^a-z]*", "makefile"));
+    EXPECT_TRUE(matches("[]]", "]"));
+    EXPECT_TRUE(matches("[a-]", "-"));
+    EXPECT_FALSE(matches("a[!x]b", "a/b"));
+
+    EXPECT_TRUE(matches("\\*.txt", "*.txt"));
+    EXPECT_FALSE(matches("\\*.txt", "a.txt"));
+    EXPECT_TRUE(matches("[\\]]", "]"));
+
+    for (auto malformed : {"[abc", "abc\\", "[]", "[!]", "[a-\\"}) {
+        StringView pattern{malformed};
+        EXPECT_TRUE(makeGlobSet(ArrayView<const StringView>{&pattern, 1}).isError()) << malformed;
+    }
+}
+
+TEST(TestGlob, testPatternSet) {
+    auto const globs = compile({"*.cpp", "src/**", "**/test_*", "README", "src/*.hpp"});
+    EXPECT_EQ(5U, globs.patternsCount());
+
+    EXPECT_EQ((std::vector<GlobSet::PatternId>{0}), matching(globs, "main.cpp"));
+    EXPECT_EQ((std::vector<GlobSet::PatternId>{1, 4}), matching(globs, "src/path.hpp"));
+    EXPECT_EQ((std::vector<GlobSet::PatternId>{1, 2}), matching(globs, "src/test/test_path.cpp"));
+    EXPECT_EQ((std::vector<GlobSet::PatternId>{0, 2}), matching(globs, "test_path.cpp"));
+    EXPECT_EQ((std::vector<GlobSet::PatternId>{3}), matching(globs, "README"));
+    EXPECT_TRUE(matching(globs, "docs/README").empty());
+    EXPECT_FALSE(globs.matchesAny(StringView{"include/solace/path.hpp"}));
+
+    auto const empty = compile({});
+    EXPECT_FALSE(empty.matchesAny(StringView{""}));
+}
+
+TEST(TestGlob, testPath) {
+    auto const globs = compile({"/usr/lib/*.so", "**/.cache/**", "etc/*"});
+
+    EXPECT_TRUE(globs.matchesAny(Path::parse(StringView{"/usr/lib/libc.so"}).unwrap()));
+    EXPECT_FALSE(globs.matchesAny(Path::parse(StringView{"/usr/lib/x86/libc.so"}).unwrap()));
+    EXPECT_TRUE(globs.matchesAny(makePath("", "home", "user", ".cache", "thumbnails")));
+    EXPECT_TRUE(globs.matchesAny(makePath("etc", "hosts")));
+    EXPECT_FALSE(globs.matchesAny(makePath("", "etc", "hosts")));
+
+    std::vector<GlobSet::PatternId> ids;
+    globs.match(makePath("etc", ".cache", "x"), [&ids](GlobSet::PatternId id) { ids.push_back(id); });
+    EXPECT_EQ((std::vector<GlobSet::PatternId>{1}), ids);
+}
+
+TEST(TestGlob, testManyPatterns) {
+    // Patterns span many words of states and some share literals
+    std::vector<std::string> storage;
+    for (int i = 0; i < 300; ++i) {
+        storage.push_back("dir" + std::to_string(i % 50) + "/*_" + std::to_string(i) + ".[ch]");
+    }
+    storage.push_back("*");
+    std::vector<StringView> patterns;
+    for (auto const& pattern : storage) {
+        patterns.emplace_back(pattern.data(), static_cast<StringView::size_type>(pattern.size()));
+    }
+
+    auto const globs = compile(patterns);
+    EXPECT_GT(globs.statesCount(), 64U * 32);
+
+    EXPECT_EQ((std::vector<GlobSet::PatternId>{123}), matching(globs, "dir23/file_123.c"));
+    EXPECT_EQ((std::vector<GlobSet::PatternId>{23}), matching(globs, "dir23/x_23.h"));
+    EXPECT_TRUE(matching(globs, "dir24/file_123.c").empty());
+    EXPECT_EQ((std::vector<GlobSet::PatternId>{300}), matching(globs, "file_123.c"));
+}
+
+TEST(TestGlob, testAgainstFnmatch) {
+    // Without globstars the syntax is that of fnmatch with FNM_PATHNAME
+    char const* const patterns[] = {
+        "*", "*.c", "a*", "*b*", "a?c", "a/*", "*/*", "a/*/c", "[a-c]*", "[!a]?", "*[0-9]",
+        "a\\*", "?/?", "a*b*c", "*/b/*", "[]a]*", "ab*", "*a",
+    };
+    char const* const texts[] = {
+        "", "a", "b", "ab", "abc", "a.c", "a/c", "a/b", "a/b/c", "a/bb/c", "b/b/b", "abbbc", "x1",
+        "a*", "]x", "aa", "ba", "/a", "a/", "c9", "ab/c",
+    };
+
+    std::vector<StringView> views;
+    for (auto pattern : patterns) {
+        views.emplace_back(pattern);
+    }
+    auto const globs = compile(views);
+
+    for (auto text : texts) {
+        std::vector<GlobSet::PatternId> expected;
+        for (GlobSet::PatternId id = 0; id < views.size(); ++id) {
+            if (::fnmatch(patterns[id], text, FNM_PATHNAME) == 0) {
+                expected.push_back(id);
+            }
+
+            EXPECT_EQ(::fnmatch(patterns[id], text, FNM_PATHNAME) == 0, matches(patterns[id], text))
+                    << patterns[id] << " ~ " << text;
+        }
+
+        EXPECT_EQ(expected, matching(globs, StringView{text})) << text;
+    }
+}
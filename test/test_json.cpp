@@ -0,0 +1,208 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ * @file: test/test_json.cpp
+ *******************************************************************************/
+#include <solace/json.hpp>	 // Class being tested
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+
+using namespace Solace;
+
+
+TEST(TestJson, testScalars) {
+    EXPECT_TRUE(parseJson(StringView{"null"}).unwrap().root().isNull());
+    EXPECT_TRUE(parseJson(StringView{" true "}).unwrap().root().getBool().unwrap());
+    EXPECT_FALSE(parseJson(StringView{"false"}).unwrap().root().getBool().unwrap());
+    EXPECT_EQ(-42, parseJson(StringView{"-42"}).unwrap().root().getNumber<int32>().unwrap());
+    EXPECT_EQ(1.5e3, parseJson(StringView{"1.5e3"}).unwrap().root().getNumber<float64>().unwrap());
+    EXPECT_EQ(StringView{"text"}, parseJson(StringView{"\"text\""}).unwrap().root().getRawString().unwrap());
+}
+
+TEST(TestJson, testNavigation) {
+    StringView const source{R"({
+        "name": "libsolace",
+        "version": {"major": 0, "minor": 3},
+        "tags": ["c++", "zero-copy", "simd"],
+        "stable": false,
+        "license": null
+    })"};
+
+    auto document = parseJson(source).unwrap();
+    auto const root = document.root();
+    ASSERT_TRUE(root.isObject());
+    EXPECT_EQ(5U, root.size());
+
+    auto const name = root.find("name").get().getRawString().unwrap();
+    EXPECT_EQ(StringView{"libsolace"}, name);
+    // Strings are views into the source
+    EXPECT_TRUE(name.data() > source.data() && name.data() < source.data() + source.size());
+
+    EXPECT_EQ(3, root.find("version").get().find("minor").get().getNumber<uint16>().unwrap());
+
+    auto const tags = root.find("tags").get();
+    ASSERT_TRUE(tags.isArray());
+    EXPECT_EQ(3U, tags.size());
+    EXPECT_EQ(StringView{"simd"}, tags.at(2).get().getRawString().unwrap());
+    EXPECT_TRUE(tags.at(3).isNone());
+
+    EXPECT_TRUE(root.find("license").get().isNull());
+    EXPECT_TRUE(root.find("missing").isNone());
+    EXPECT_TRUE(tags.find("c++").isNone());
+
+    int keys = 0;
+    root.forEachMember([&keys](StringView key, JsonValue) {
+        keys += key.empty() ? 0 : 1;
+    });
+    EXPECT_EQ(5, keys);
+
+    std::string joined;
+    tags.forEachElement([&joined](JsonValue value) {
+        auto const str = value.getRawString().unwrap();
+        joined.append(str.data(), str.size());
+    });
+    EXPECT_EQ("c++zero-copysimd", joined);
+}
+
+TEST(TestJson, testEmptyContainers) {
+    auto document = parseJson(StringView{"[{}, [], [[]], {\"a\": {}}]"}).unwrap();
+    auto const root = document.root();
+
+    EXPECT_EQ(4U, root.size());
+    EXPECT_TRUE(root.at(0).get().isObject());
+    EXPECT_EQ(0U, root.at(0).get().size());
+    EXPECT_EQ(1U, root.at(2).get().size());
+    EXPECT_TRUE(root.at(3).get().find("a").get().isObject());
+}
+
+TEST(TestJson, testTypeErrors) {
+    auto document = parseJson(StringView{"[1, \"one\", 1.5]"}).unwrap();
+    auto const root = document.root();
+
+    EXPECT_TRUE(root.getBool().isError());
+    EXPECT_TRUE(root.at(0).get().getRawString().isError());
+    EXPECT_TRUE(root.at(1).get().getNumber<int32>().isError());
+    EXPECT_TRUE(root.at(2).get().getNumber<int32>().isError());
+    EXPECT_EQ(1.5, root.at(2).get().getNumber<float64>().unwrap());
+}
+
+TEST(TestJson, testEscapes) {
+    auto document = parseJson(StringView{R"(["plain", "quote \" and \\ slash \/", "é€😀\n", "\\"])"})
+            .unwrap();
+    auto const root = document.root();
+    EXPECT_EQ(4U, root.size());
+
+    EXPECT_FALSE(root.at(0).get().hasEscapes());
+    EXPECT_TRUE(root.at(1).get().hasEscapes());
+
+    char buffer[64];
+    ByteWriter writer{wrapMemory(buffer)};
+    ASSERT_TRUE(root.at(1).get().decodeString(writer).isOk());
+    EXPECT_EQ(StringView{"quote \" and \\ slash /"}.view(), writer.viewWritten());
+
+    writer.rewind();
+    ASSERT_TRUE(root.at(2).get().decodeString(writer).isOk());
+    EXPECT_EQ(StringView{"\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80\n"}.view(), writer.viewWritten());
+
+    // Escaped backslash right before the closing quote
+    EXPECT_EQ(StringView{"\\\\"}, root.at(3).get().getRawString().unwrap());
+
+    auto invalid = parseJson(StringView{R"(["\q", "\ud800"])"}).unwrap();
+    writer.rewind();
+    EXPECT_TRUE(invalid.root().at(0).get().decodeString(writer).isError());
+    EXPECT_TRUE(invalid.root().at(1).get().decodeString(writer).isError());
+    EXPECT_EQ(0U, writer.position());
+}
+
+TEST(TestJson, testLongDocument) {
+    // Strings and escapes spanning 64 byte block boundaries
+    std::string source = "[";
+    for (int i = 0; i < 100; ++i) {
+        source += "\"item with \\\"quotes\\\" and \\\\ [brackets], {braces}: ";
+        source += std::to_string(i);
+        source += "\", ";
+        source += std::to_string(i);
+        source += ", ";
+    }
+    source += "true]";
+
+    auto document = parseJson(wrapMemory(source.data(), source.size())).unwrap();
+    auto const root = document.root();
+    EXPECT_EQ(201U, root.size());
+    EXPECT_EQ(57, root.at(115).get().getNumber<int32>().unwrap());
+    EXPECT_TRUE(root.at(200).get().getBool().unwrap());
+    EXPECT_TRUE(root.at(198).get().getRawString().unwrap().endsWith(": 99"));
+}
+
+TEST(TestJson, testSyntaxErrors) {
+    auto errorOffset = [](StringView source) {
+        auto result = parseJson(source);
+        EXPECT_TRUE(result.isError()) << source.data();
+
+        return result.isError()
+                ? result.getError().offset
+                : ~MemoryView::size_type{0};
+    };
+
+    EXPECT_EQ(0U, errorOffset(""));
+    EXPECT_EQ(3U, errorOffset("   "));
+    EXPECT_EQ(4U, errorOffset("[1, ]"));
+    EXPECT_EQ(1U, errorOffset("{1: 2}"));
+    EXPECT_EQ(5U, errorOffset("{\"a\" 2}"));
+    EXPECT_EQ(3U, errorOffset("[1 2]"));
+    EXPECT_EQ(2U, errorOffset("1 2"));
+    EXPECT_EQ(1U, errorOffset("[tru]"));
+    EXPECT_EQ(1U, errorOffset("[nulls]"));
+    EXPECT_EQ(1U, errorOffset("[01]"));
+    EXPECT_EQ(1U, errorOffset("[1.]"));
+    EXPECT_EQ(1U, errorOffset("[+1]"));
+    EXPECT_EQ(2U, errorOffset("[1}"));
+    EXPECT_EQ(3U, errorOffset("[[]"));
+    EXPECT_EQ(3U, errorOffset("[\"a\tb\"]"));
+
+    auto unclosed = parseJson(StringView{"[\"abc"});
+    ASSERT_TRUE(unclosed.isError());
+    EXPECT_EQ(JsonError::Kind::UnclosedString, unclosed.getError().kind);
+
+    auto badUtf8 = parseJson(StringView{"[\"\xC0\xAF\"]"});
+    ASSERT_TRUE(badUtf8.isError());
+    EXPECT_EQ(JsonError::Kind::InvalidUtf8, badUtf8.getError().kind);
+    EXPECT_EQ(2U, badUtf8.getError().offset);
+}
+
+TEST(TestJson, testDepthLimit) {
+    std::string deep(JsonDocument::kMaxDepth, '[');
+    deep += std::string(JsonDocument::kMaxDepth, ']');
+    EXPECT_TRUE(parseJson(wrapMemory(deep.data(), deep.size())).isOk());
+
+    std::string tooDeep(JsonDocument::kMaxDepth + 1, '[');
+    tooDeep += std::string(JsonDocument::kMaxDepth + 1, ']');
+    auto result = parseJson(wrapMemory(tooDeep.data(), tooDeep.size()));
+    ASSERT_TRUE(result.isError());
+    EXPECT_EQ(JsonError::Kind::DepthLimit, result.getError().kind);
+}
+
+TEST(TestJson, testParseFromReader) {
+    StringView const source{"{\"k\": [1, 2, 3]}"};
+    ByteReader reader{source.view()};
+
+    auto document = parseJson(reader).unwrap();
+    EXPECT_EQ(3U, document.root().find("k").get().size());
+}
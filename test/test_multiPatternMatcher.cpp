@@ -0,0 +1,193 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ * @file: test/test_multiPatternMatcher.cpp
+ *******************************************************************************/
+#include <solace/multiPatternMatcher.hpp>	 // Class being tested
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+using namespace Solace;
+
+
+namespace {
+
+using Match = std::pair<MultiPatternMatcher::PatternId, MultiPatternMatcher::size_type>;
+
+std::vector<Match> scanAll(MultiPatternMatcher const& matcher, StringView text) {
+    std::vector<Match> matches;
+    matcher.scan(text, [&matches](MultiPatternMatcher::PatternId id, MultiPatternMatcher::size_type offset) {
+        matches.emplace_back(id, offset);
+    });
+
+    std::sort(matches.begin(), matches.end());
+
+    return matches;
+}
+
+/// Brute force search of every pattern at every position.
+std::vector<Match> naiveScan(std::vector<std::string> const& patterns, std::string const& text) {
+    std::vector<Match> matches;
+    for (MultiPatternMatcher::PatternId id = 0; id < patterns.size(); ++id) {
+        for (auto pos = text.find(patterns[id]); pos != std::string::npos; pos = text.find(patterns[id], pos + 1)) {
+            matches.emplace_back(id, pos);
+        }
+    }
+
+    std::sort(matches.begin(), matches.end());
+
+    return matches;
+}
+
+std::vector<StringView> views(std::vector<std::string> const& strings) {
+    std::vector<StringView> result;
+    for (auto const& s : strings) {
+        result.emplace_back(s.data(), static_cast<StringView::size_type>(s.size()));
+    }
+
+    return result;
+}
+
+}  // namespace
+
+
+TEST(TestMultiPatternMatcher, testClassicExample) {
+    StringView const patterns[] = {"he", "she", "his", "hers"};
+    auto matcher = makeMultiPatternMatcher(arrayView(patterns)).unwrap();
+    EXPECT_EQ(4U, matcher.patternsCount());
+
+    auto const matches = scanAll(matcher, "ushers");
+    std::vector<Match> const expected = {{0, 2}, {1, 1}, {3, 2}};
+    EXPECT_EQ(expected, matches);
+}
+
+TEST(TestMultiPatternMatcher, testNoPatterns) {
+    auto matcher = makeMultiPatternMatcher(ArrayView<const StringView>{}).unwrap();
+
+    EXPECT_EQ(0U, matcher.patternsCount());
+    EXPECT_TRUE(scanAll(matcher, "anything").empty());
+    EXPECT_FALSE(matcher.matchesAny("anything"));
+}
+
+TEST(TestMultiPatternMatcher, testEmptyPatternIsError) {
+    StringView const patterns[] = {"a", ""};
+
+    EXPECT_TRUE(makeMultiPatternMatcher(arrayView(patterns)).isError());
+}
+
+TEST(TestMultiPatternMatcher, testOverlappingAndDuplicates) {
+    StringView const patterns[] = {"aa", "a", "aa", "aaa"};
+    auto matcher = makeMultiPatternMatcher(arrayView(patterns)).unwrap();
+
+    auto const matches = scanAll(matcher, "aaaa");
+    std::vector<Match> const expected = {
+        {0, 0}, {0, 1}, {0, 2},
+        {1, 0}, {1, 1}, {1, 2}, {1, 3},
+        {2, 0}, {2, 1}, {2, 2},
+        {3, 0}, {3, 1}};
+    EXPECT_EQ(expected, matches);
+}
+
+TEST(TestMultiPatternMatcher, testPrefilterMatchesLongText) {
+    StringView const patterns[] = {"ERROR", "WARN", "timeout", "x"};
+    auto matcher = makeMultiPatternMatcher(arrayView(patterns)).unwrap();
+
+    std::string text;
+    for (int i = 0; i < 20; ++i) {
+        text += "2018-06-01 12:00:00 INFO request served in 3ms; ";
+    }
+    text += "ERROR connection timeout; WARN retrying x";
+
+    std::vector<std::string> const patternStrings = {"ERROR", "WARN", "timeout", "x"};
+    EXPECT_EQ(naiveScan(patternStrings, text),
+              scanAll(matcher, StringView{text.data(), static_cast<StringView::size_type>(text.size())}));
+    EXPECT_TRUE(matcher.matchesAny(StringView{text.data(), static_cast<StringView::size_type>(text.size())}));
+    EXPECT_FALSE(matcher.matchesAny("2018-06-01 12:00:00 INFO request served in 3ms"));
+}
+
+TEST(TestMultiPatternMatcher, testMatchesReferenceSearch) {
+    std::mt19937 rng{31};
+    std::uniform_int_distribution<int> letter{'a', 'd'};
+
+    for (size_t patternsCount : {1, 3, 8, 9, 50, 300}) {
+        std::vector<std::string> patterns;
+        for (size_t i = 0; i < patternsCount; ++i) {
+            std::string pattern(std::uniform_int_distribution<size_t>{1, 6}(rng), 'a');
+            for (auto& c : pattern) {
+                c = static_cast<char>(letter(rng));
+            }
+            patterns.push_back(pattern);
+        }
+
+        std::string text(1000, 'a');
+        for (auto& c : text) {
+            c = static_cast<char>(letter(rng));
+        }
+
+        auto const patternViews = views(patterns);
+        auto matcher = makeMultiPatternMatcher(arrayView(patternViews.data(),
+                                                         static_cast<uint32>(patternViews.size()))).unwrap();
+        EXPECT_EQ(patternsCount <= MultiPatternMatcher::kMaxPrefilterPatterns && matcher.usesPrefilter(),
+                  matcher.usesPrefilter());
+        EXPECT_EQ(naiveScan(patterns, text),
+                  scanAll(matcher, StringView{text.data(), static_cast<StringView::size_type>(text.size())}));
+    }
+}
+
+TEST(TestMultiPatternMatcher, testStreamAcrossChunks) {
+    StringView const patterns[] = {"needle", "dle", "haystack"};
+    auto matcher = makeMultiPatternMatcher(arrayView(patterns)).unwrap();
+
+    std::vector<Match> matches;
+    auto onMatch = [&matches](MultiPatternMatcher::PatternId id, MultiPatternMatcher::size_type offset) {
+        matches.emplace_back(id, offset);
+    };
+
+    MultiPatternMatcher::Stream stream{matcher};
+    stream.feed("hay", onMatch)
+            .feed("stack nee", onMatch)
+            .feed("d", onMatch)
+            .feed("", onMatch)
+            .feed("le!", onMatch);
+    EXPECT_EQ(16U, stream.position());
+
+    std::sort(matches.begin(), matches.end());
+    std::vector<Match> const expected = {{0, 9}, {1, 12}, {2, 0}};
+    EXPECT_EQ(expected, matches);
+
+    matches.clear();
+    stream.reset();
+    stream.feed("dle", onMatch);
+    EXPECT_EQ((std::vector<Match>{{1, 0}}), matches);
+}
+
+TEST(TestMultiPatternMatcher, testBinaryPatterns) {
+    char const binary[] = {'\0', '\xFF', '\x80'};
+    StringView const patterns[] = {StringView{binary, 3}, StringView{binary + 1, 1}};
+    auto matcher = makeMultiPatternMatcher(arrayView(patterns)).unwrap();
+
+    char const text[] = {'a', '\0', '\xFF', '\x80', '\xFF'};
+    auto const matches = scanAll(matcher, StringView{text, sizeof(text)});
+    EXPECT_EQ((std::vector<Match>{{0, 1}, {1, 2}, {1, 4}}), matches);
+}
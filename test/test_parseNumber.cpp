@@ -0,0 +1,164 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ * @file: test/test_parseNumber.cpp
+ *******************************************************************************/
+#include <solace/parseNumber.hpp>	 // Class being tested
+#include <solace/posixErrorDomain.hpp>
+
+#include <gtest/gtest.h>
+
+#include <cstring>  // memcpy
+#include <limits>
+
+
+using namespace Solace;
+
+
+namespace {
+
+// Bits are checked directly as -ffinite-math-only of the Release build folds std::isinf and std::isnan to false
+constexpr uint64 kExponentMask = 0x7FF0000000000000ULL;
+constexpr uint64 kMantissaMask = 0x000FFFFFFFFFFFFFULL;
+
+uint64 bitsOf(float64 value) {
+    uint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    return bits;
+}
+
+bool isInfinity(float64 value) {
+    auto const bits = bitsOf(value);
+    return ((bits & kExponentMask) == kExponentMask) && ((bits & kMantissaMask) == 0);
+}
+
+bool isNan(float64 value) {
+    auto const bits = bitsOf(value);
+    return ((bits & kExponentMask) == kExponentMask) && ((bits & kMantissaMask) != 0);
+}
+
+}  // namespace
+
+
+TEST(TestParseNumber, testParseUint) {
+    EXPECT_EQ(0U, parseUint<uint32>("0").unwrap());
+    EXPECT_EQ(7U, parseUint<uint8>("007").unwrap());
+    EXPECT_EQ(255U, parseUint<uint8>("255").unwrap());
+    EXPECT_EQ(1234567890123456789ULL, parseUint<uint64>("1234567890123456789").unwrap());
+    EXPECT_EQ(std::numeric_limits<uint64>::max(), parseUint<uint64>("18446744073709551615").unwrap());
+
+    // Does not require NUL terminated input
+    char const digits[] = {'1', '2', '3', '4'};
+    EXPECT_EQ(12U, parseUint<uint32>(StringView{digits, 2}).unwrap());
+}
+
+TEST(TestParseNumber, testParseUintErrors) {
+    auto const invalidInput = makeError(BasicError::InvalidInput, "");
+    auto const outOfRange = makeError(GenericError::RANGE, "");
+
+    EXPECT_EQ(invalidInput.value(), parseUint<uint32>("").getError().value());
+    EXPECT_EQ(invalidInput.value(), parseUint<uint32>("-1").getError().value());
+    EXPECT_EQ(invalidInput.value(), parseUint<uint32>("+1").getError().value());
+    EXPECT_EQ(invalidInput.value(), parseUint<uint32>(" 1").getError().value());
+    EXPECT_EQ(invalidInput.value(), parseUint<uint32>("12345678x").getError().value());
+    EXPECT_EQ(invalidInput.value(), parseUint<uint64>("123456789012345678901234x").getError().value());
+
+    EXPECT_EQ(outOfRange.value(), parseUint<uint8>("256").getError().value());
+    EXPECT_EQ(outOfRange.value(), parseUint<uint64>("18446744073709551616").getError().value());
+    EXPECT_EQ(outOfRange.value(), parseUint<uint64>("123456789012345678901234").getError().value());
+}
+
+TEST(TestParseNumber, testParseInt) {
+    EXPECT_EQ(0, parseInt<int32>("-0").unwrap());
+    EXPECT_EQ(42, parseInt<int32>("+42").unwrap());
+    EXPECT_EQ(-128, parseInt<int8>("-128").unwrap());
+    EXPECT_EQ(127, parseInt<int8>("127").unwrap());
+    EXPECT_EQ(std::numeric_limits<int64>::min(), parseInt<int64>("-9223372036854775808").unwrap());
+    EXPECT_EQ(std::numeric_limits<int64>::max(), parseInt<int64>("9223372036854775807").unwrap());
+
+    EXPECT_TRUE(parseInt<int8>("-129").isError());
+    EXPECT_TRUE(parseInt<int8>("128").isError());
+    EXPECT_TRUE(parseInt<int64>("9223372036854775808").isError());
+    EXPECT_TRUE(parseInt<int32>("-").isError());
+    EXPECT_TRUE(parseInt<int32>("--1").isError());
+    EXPECT_TRUE(parseInt<int32>("1.0").isError());
+}
+
+TEST(TestParseNumber, testParseFloat) {
+    EXPECT_EQ(0.0, parseFloat<float64>("0").unwrap());
+    EXPECT_EQ(1.5, parseFloat<float64>("1.5").unwrap());
+    EXPECT_EQ(-0.125, parseFloat<float64>("-.125").unwrap());
+    EXPECT_EQ(3.0, parseFloat<float64>("3.").unwrap());
+    EXPECT_EQ(1e22, parseFloat<float64>("1e22").unwrap());
+    EXPECT_EQ(0.1, parseFloat<float64>("0.1").unwrap());
+    EXPECT_EQ(1.7976931348623157e308, parseFloat<float64>("1.7976931348623157e308").unwrap());
+    EXPECT_EQ(2.2250738585072014e-308, parseFloat<float64>("2.2250738585072014e-308").unwrap());
+    EXPECT_EQ(9007199254740993.0, parseFloat<float64>("9007199254740993").unwrap());
+    EXPECT_EQ(0.30000000000000004, parseFloat<float64>("0.30000000000000004").unwrap());
+    EXPECT_EQ(1.5f, parseFloat<float32>("1.5").unwrap());
+    EXPECT_EQ(0.1f, parseFloat<float32>("0.1").unwrap());
+    EXPECT_EQ(3.4028235e38f, parseFloat<float32>("3.4028235e38").unwrap());
+
+    EXPECT_TRUE(isInfinity(parseFloat<float64>("inf").unwrap()));
+    EXPECT_TRUE(isNan(parseFloat<float64>("nan").unwrap()));
+}
+
+TEST(TestParseNumber, testParseFloatErrors) {
+    EXPECT_TRUE(parseFloat<float64>("").isError());
+    EXPECT_TRUE(parseFloat<float64>(".").isError());
+    EXPECT_TRUE(parseFloat<float64>("-").isError());
+    EXPECT_TRUE(parseFloat<float64>("+-1").isError());
+    EXPECT_TRUE(parseFloat<float64>("1e").isError());
+    EXPECT_TRUE(parseFloat<float64>("1.0x").isError());
+    EXPECT_TRUE(parseFloat<float64>(" 1.0").isError());
+    EXPECT_TRUE(parseFloat<float64>("0x10").isError());
+
+    EXPECT_EQ(makeError(GenericError::RANGE, "").value(), parseFloat<float64>("1e400").getError().value());
+    EXPECT_TRUE(parseFloat<float32>("1e39").isError());
+}
+
+TEST(TestParseNumber, testParseList) {
+    auto values = parseList<int32>("1,-2,3,40000", ',');
+    ASSERT_TRUE(values.isOk());
+    ASSERT_EQ(4U, values.unwrap().size());
+    EXPECT_EQ(1, values.unwrap()[0]);
+    EXPECT_EQ(-2, values.unwrap()[1]);
+    EXPECT_EQ(3, values.unwrap()[2]);
+    EXPECT_EQ(40000, values.unwrap()[3]);
+
+    auto floats = parseList<float64>("0.5|1e3", '|');
+    ASSERT_TRUE(floats.isOk());
+    EXPECT_EQ(0.5, floats.unwrap()[0]);
+    EXPECT_EQ(1000.0, floats.unwrap()[1]);
+
+    EXPECT_TRUE(parseList<uint32>("1,,2", ',').isError());
+    EXPECT_TRUE(parseList<uint32>("1,2,", ',').isError());
+    EXPECT_TRUE(parseList<uint32>("1,x", ',').isError());
+}
+
+TEST(TestParseNumber, testParseListIntoView) {
+    uint16 buffer[3];
+
+    auto count = parseList<uint16>("10 20 30", ' ', arrayView(buffer));
+    ASSERT_TRUE(count.isOk());
+    EXPECT_EQ(3U, count.unwrap());
+    EXPECT_EQ(10, buffer[0]);
+    EXPECT_EQ(30, buffer[2]);
+
+    EXPECT_TRUE(parseList<uint16>("1 2 3 4", ' ', arrayView(buffer)).isError());
+}
@@ -27,11 +27,10 @@
 #include <ostream>
 
 
-std::ostream& operator<< (std::ostream& ostr, Solace::Path const& v) {
+std::ostream& operator<< (std::ostream& ostr, Solace::PathView const& v) {
     ostr << "Path:" << v.getComponentsCount() << ":{";
-    for (auto const& c : v) {
-        auto const componentView = c.view();
-        ostr.write(componentView.data(), componentView.size());
+    for (auto const c : v) {
+        ostr.write(c.data(), c.size());
         ostr << " ";
     }
 
@@ -223,7 +222,7 @@ TEST(TestPath, testGetParent) {
         Path root{};
         EXPECT_TRUE(root.empty());
 
-        Path const p = root.getParent();
+        auto const p = root.getParent();
         EXPECT_TRUE(p.empty());
 
         auto somePath = makePath("abc");
@@ -234,6 +233,69 @@ TEST(TestPath, testGetParent) {
 }
 
 
+TEST(TestPath, testTemporaryPathReturnsOwningPath) {
+    static_assert(std::is_same<Path, decltype(makePath("a", "b").getParent())>::value,
+                  "Parent of a temporary must own its storage");
+    static_assert(std::is_same<Path, decltype(makePath("a", "b").subpath(0, 1))>::value,
+                  "Sub path of a temporary must own its storage");
+
+    auto const parent = Path::parse("/usr/local/lib").unwrap().getParent();
+    auto const sub = Path::parse("/usr/local/lib").unwrap().subpath(1, 3);
+
+    // Overwrite the freed storage of the temporaries
+    auto const other = Path::parse("/xxx/xxxxx/xxx").unwrap();
+    EXPECT_EQ(makePath("", "usr", "local"), parent);
+    EXPECT_EQ(makePath("usr", "local"), sub);
+    EXPECT_FALSE(other.empty());
+}
+
+
+TEST(TestPath, testViewsShareStorage) {
+    auto const p = Path::parse("/usr/local/lib/libsolace.so").unwrap();
+
+    auto const parent = p.getParent();
+    EXPECT_EQ(makePath("", "usr", "local", "lib"), parent);
+    EXPECT_EQ(p.getComponent(1).data(), parent.getComponent(1).data());
+    EXPECT_EQ(makePath("", "usr"), parent.getParent().getParent());
+
+    auto const sub = p.subpath(2, 4);
+    EXPECT_EQ(makePath("local", "lib"), sub);
+    EXPECT_EQ(p.getComponent(2).data(), sub.getComponent(0).data());
+    EXPECT_TRUE(p.contains(sub));
+    EXPECT_TRUE(p.startsWith(parent));
+    EXPECT_TRUE(p.endsWith(p.subpath(3, 5)));
+
+    // Owning copy of a view
+    Path const copy{sub};
+    EXPECT_EQ(sub, copy);
+    EXPECT_NE(sub.getComponent(0).data(), copy.getComponent(0).data());
+    EXPECT_EQ(StringLiteral("local/lib"), copy.toString());
+}
+
+
+TEST(TestPath, testStringPrefixAndSuffix) {
+    auto const p = makePath("", "etc", "config.json");
+    EXPECT_TRUE(p.startsWith(""));
+    EXPECT_TRUE(p.startsWith("/"));
+    EXPECT_TRUE(p.startsWith("/et"));
+    EXPECT_TRUE(p.startsWith("/etc/"));
+    EXPECT_TRUE(p.startsWith("/etc/config.json"));
+    EXPECT_FALSE(p.startsWith("/etc/config.json/"));
+    EXPECT_FALSE(p.startsWith("etc"));
+
+    EXPECT_TRUE(p.endsWith(""));
+    EXPECT_TRUE(p.endsWith(".json"));
+    EXPECT_TRUE(p.endsWith("c/config.json"));
+    EXPECT_TRUE(p.endsWith("/etc/config.json"));
+    EXPECT_FALSE(p.endsWith("//etc/config.json"));
+    EXPECT_FALSE(p.endsWith("etc"));
+
+    EXPECT_TRUE(Path::Root.startsWith("/"));
+    EXPECT_TRUE(Path::Root.endsWith("/"));
+    EXPECT_FALSE(Path{}.startsWith("/"));
+}
+
+
 TEST(TestPath, testBasename) {
     EXPECT_EQ(StringView(), Path{}.getBasename());
     EXPECT_EQ(Path::Delimiter, makePath("").getBasename());
@@ -316,15 +378,39 @@ TEST(TestPath, testIterable) {
     auto const p = makePath("e", "so", "lon", "path", "foilx");
 
     String::size_type i = 0;
-    for (auto& v : p) {
+    for (auto v : p) {
         ++i;
         EXPECT_EQ(i, v.length());
     }
 }
 
+TEST(TestPath, testRandomAccessIterator) {
+    auto const p = makePath("e", "so", "lon", "path", "foilx");
+
+    auto it = p.begin();
+    std::advance(it, 3);
+    EXPECT_EQ(StringView("path"), *it);
+    EXPECT_EQ(StringView("lon"), *std::prev(it));
+    EXPECT_EQ(StringView("foilx"), *std::prev(p.end()));
+    EXPECT_EQ(StringView("so"), p.begin()[1]);
+    EXPECT_EQ(StringView("so"), *(it - 2));
+    EXPECT_EQ(it, 3 + p.begin());
+    EXPECT_EQ(5, std::distance(p.begin(), p.end()));
+
+    EXPECT_TRUE(p.begin() < it);
+    EXPECT_TRUE(it <= it);
+    EXPECT_TRUE(p.end() > it);
+    EXPECT_TRUE(it >= p.begin());
+
+    it -= 2;
+    EXPECT_EQ(StringView("so"), *it--);
+    EXPECT_EQ(p.begin(), it);
+    EXPECT_EQ(StringView("so"), *--(it += 2));
+}
+
 TEST(TestPath, testForEach) {
     std::vector<int> counts;
-    makePath("e", "so", "long", "pat", "fx", "x").forEach([&counts] (const String& component){
+    makePath("e", "so", "long", "pat", "fx", "x").forEach([&counts] (StringView component){
         counts.push_back(component.length());
     });
 
@@ -444,6 +530,9 @@ TEST(TestPath, testParsing) {
         EXPECT_EQ(makePath("", "some", "", "file", "path"),
                   Path::parse("{?some{?{?file{?path{?", "{?").unwrap());
     }
+    {
+        EXPECT_TRUE(Path::parse("some/path", "").isError());
+    }
 }
 
 /**
@@ -0,0 +1,210 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ * @file: test/test_pathTrie.cpp
+ *******************************************************************************/
+#include <solace/pathTrie.hpp>	 // Class being tested
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <string>
+
+
+using namespace Solace;
+
+
+namespace {
+
+Path parse(char const* path) {
+    return Path::parse(StringView{path}).unwrap();
+}
+
+std::string toString(PathView path) {
+    auto const str = path.toString();
+    return {str.view().data(), str.size()};
+}
+
+}  // namespace
+
+
+TEST(TestPathTrie, testExactMatch) {
+    PathTrie<int> trie;
+    EXPECT_TRUE(trie.empty());
+    EXPECT_EQ(nullptr, trie.find(parse("/a")));
+
+    trie.insert(parse("/a/b"), 1);
+    trie.insert(parse("/a/c"), 2);
+    trie.insert(parse("/a"), 3);
+    EXPECT_EQ(3U, trie.size());
+
+    ASSERT_NE(nullptr, trie.find(parse("/a/b")));
+    EXPECT_EQ(1, *trie.find(parse("/a/b")));
+    EXPECT_EQ(2, *trie.find(parse("/a/c")));
+    EXPECT_EQ(3, *trie.find(parse("/a")));
+    EXPECT_EQ(nullptr, trie.find(parse("/")));
+    EXPECT_EQ(nullptr, trie.find(parse("/a/b/c")));
+    EXPECT_EQ(nullptr, trie.find(parse("/b")));
+
+    // Insert replaces the value of an existing key
+    trie.insert(parse("/a/b"), 10);
+    EXPECT_EQ(3U, trie.size());
+    EXPECT_EQ(10, *trie.find(parse("/a/b")));
+
+    *trie.find(parse("/a")) = 30;
+    EXPECT_EQ(30, *trie.find(parse("/a")));
+}
+
+TEST(TestPathTrie, testLongestPrefix) {
+    PathTrie<int> trie;
+    EXPECT_TRUE(trie.longestPrefix(parse("/x")).isNone());
+
+    trie.insert(parse("/api"), 1);
+    trie.insert(parse("/api/users"), 2);
+    trie.insert(parse("/api/users/admin/settings"), 3);
+
+    auto const users = trie.longestPrefix(parse("/api/users/admin/profile"));
+    ASSERT_TRUE(users.isSome());
+    EXPECT_EQ(2, *users.get().value);
+    EXPECT_EQ(3U, users.get().depth);
+
+    EXPECT_EQ(1, *trie.longestPrefix(parse("/api/orders")).get().value);
+    EXPECT_EQ(3, *trie.longestPrefix(parse("/api/users/admin/settings/x")).get().value);
+    EXPECT_TRUE(trie.longestPrefix(parse("/static/index.html")).isNone());
+    EXPECT_TRUE(trie.longestPrefix(parse("/ap")).isNone());
+
+    // Empty key is a prefix of every path
+    trie.insert(PathView{}, 0);
+    auto const fallback = trie.longestPrefix(parse("/static"));
+    ASSERT_TRUE(fallback.isSome());
+    EXPECT_EQ(0, *fallback.get().value);
+    EXPECT_EQ(0U, fallback.get().depth);
+}
+
+TEST(TestPathTrie, testWildcards) {
+    PathTrie<int> trie;
+    trie.insert(parse("/users/*"), 1);
+    trie.insert(parse("/users/*/posts"), 2);
+    trie.insert(parse("/users/me"), 3);
+    trie.insert(parse("/*/*/avatar"), 4);
+
+    EXPECT_EQ(1, *trie.match(parse("/users/42")));
+    EXPECT_EQ(2, *trie.match(parse("/users/42/posts")));
+    EXPECT_EQ(3, *trie.match(parse("/users/me")));
+    EXPECT_EQ(nullptr, trie.match(parse("/users")));
+    EXPECT_EQ(nullptr, trie.match(parse("/users/42/comments")));
+
+    // Literal component is preferred, but the wildcard alternative is still followed
+    EXPECT_EQ(2, *trie.match(parse("/users/me/posts")));
+    EXPECT_EQ(4, *trie.match(parse("/users/me/avatar")));
+    EXPECT_EQ(4, *trie.match(parse("/groups/7/avatar")));
+
+    // Wildcard in a key is only found by the wildcard itself
+    EXPECT_EQ(1, *trie.find(parse("/users/*")));
+    EXPECT_EQ(nullptr, trie.find(parse("/users/42")));
+
+    EXPECT_EQ(2, *trie.longestPrefix(parse("/users/42/posts/7")).get().value);
+    EXPECT_EQ(3, *trie.longestPrefix(parse("/users/me/x")).get().value);
+    EXPECT_EQ(4, *trie.longestPrefix(parse("/users/me/avatar/large")).get().value);
+
+    PathTrie<int> custom{StringView{":param"}};
+    custom.insert(parse("/items/:param"), 5);
+    EXPECT_EQ(5, *custom.match(parse("/items/abc")));
+    EXPECT_EQ(nullptr, custom.match(parse("/items/abc/def")));
+}
+
+TEST(TestPathTrie, testWideWildcardFrontier) {
+    // Every combination of literal and wildcard components: 2^8 keys match the path at once
+    constexpr int kDepth = 8;
+    PathTrie<int> trie;
+    for (int mask = 0; mask < (1 << kDepth); ++mask) {
+        std::string key;
+        for (int i = 0; i < kDepth; ++i) {
+            key += (mask & (1 << i)) ? "/*" : "/c";
+        }
+        trie.insert(parse(key.c_str()), mask);
+    }
+
+    EXPECT_EQ(0, *trie.match(parse("/c/c/c/c/c/c/c/c")));
+    // First component differs, so the wildcard takes it, and literals are preferred for the rest
+    EXPECT_EQ(1, *trie.match(parse("/x/c/c/c/c/c/c/c")));
+    EXPECT_EQ((1 << kDepth) - 1, *trie.match(parse("/x/x/x/x/x/x/x/x")));
+    EXPECT_EQ(nullptr, trie.match(parse("/c/c/c/c/c/c/c/c/c")));
+
+    auto const prefix = trie.longestPrefix(parse("/c/x/c/c/c/c/c/c/more"));
+    ASSERT_TRUE(prefix.isSome());
+    EXPECT_EQ(2, *prefix.get().value);
+    EXPECT_EQ(kDepth + 1U, prefix.get().depth);  // Including the root component
+}
+
+TEST(TestPathTrie, testSubtree) {
+    PathTrie<int> trie;
+    trie.insert(parse("/etc"), 1);
+    trie.insert(parse("/etc/hosts"), 2);
+    trie.insert(parse("/etc/ssh/sshd_config"), 3);
+    trie.insert(parse("/var/log"), 4);
+
+    std::map<std::string, int> found;
+    trie.forEachInSubtree(parse("/etc"), [&found](Path const& key, int& value) {
+        found.emplace(toString(key), value);
+        value *= 10;
+    });
+
+    EXPECT_EQ((std::map<std::string, int>{{"/etc", 1}, {"/etc/hosts", 2}, {"/etc/ssh/sshd_config", 3}}), found);
+    EXPECT_EQ(30, *trie.find(parse("/etc/ssh/sshd_config")));
+    EXPECT_EQ(4, *trie.find(parse("/var/log")));
+
+    // Prefix without a value of its own
+    found.clear();
+    trie.forEachInSubtree(parse("/etc/ssh"), [&found](Path const& key, int value) {
+        found.emplace(toString(key), value);
+    });
+    EXPECT_EQ((std::map<std::string, int>{{"/etc/ssh/sshd_config", 30}}), found);
+
+    int count = 0;
+    trie.forEachInSubtree(parse("/usr"), [&count](Path const&, int) { ++count; });
+    trie.forEach([&count](Path const&, int) { ++count; });
+    EXPECT_EQ(4, count);
+}
+
+TEST(TestPathTrie, testManyRoutes) {
+    // Enough keys to grow every table of the index several times
+    PathTrie<std::string> trie;
+    for (int i = 0; i < 2000; ++i) {
+        auto const service = std::to_string(i % 37);
+        auto const id = std::to_string(i);
+        trie.insert(makePath("", "svc", service.c_str(), id.c_str()), "route-" + id);
+    }
+    EXPECT_EQ(2000U, trie.size());
+
+    for (int i = 0; i < 2000; i += 7) {
+        auto const service = std::to_string(i % 37);
+        auto const id = std::to_string(i);
+        auto const match = trie.longestPrefix(makePath("", "svc", service.c_str(), id.c_str(), "details"));
+        ASSERT_TRUE(match.isSome());
+        EXPECT_EQ("route-" + id, *match.get().value);
+        EXPECT_EQ(4U, match.get().depth);
+    }
+
+    int count = 0;
+    trie.forEachInSubtree(makePath("", "svc", "5"), [&count](Path const& key, std::string const& value) {
+        auto const id = key.getBasename();
+        EXPECT_EQ("route-" + std::string(id.data(), id.size()), value);
+        ++count;
+    });
+    EXPECT_EQ(54, count);
+}
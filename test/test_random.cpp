@@ -0,0 +1,101 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ * @file: test/test_random.cpp
+ *******************************************************************************/
+#include <solace/random.hpp>	 // Class being tested
+#include <solace/exception.hpp>
+
+#include <gtest/gtest.h>
+
+#include <set>
+
+
+using namespace Solace;
+
+
+TEST(TestSecureRandom, testChaCha20KeyStream) {
+    // RFC 7539, Appendix A.1: test vectors #1 and #2 are two first blocks of the all zero key
+    byte const expected[] = {
+        0x76, 0xb8, 0xe0, 0xad, 0xa0, 0xf1, 0x3d, 0x90, 0x40, 0x5d, 0x6a, 0xe5, 0x53, 0x86, 0xbd, 0x28,
+        0xbd, 0xd2, 0x19, 0xb8, 0xa0, 0x8d, 0xed, 0x1a, 0xa8, 0x36, 0xef, 0xcc, 0x8b, 0x77, 0x0d, 0xc7,
+        0xda, 0x41, 0x59, 0x7c, 0x51, 0x57, 0x48, 0x8d, 0x77, 0x24, 0xe0, 0x3f, 0xb8, 0xd8, 0x4a, 0x37,
+        0x6a, 0x43, 0xb8, 0xf4, 0x15, 0x18, 0xa1, 0x1c, 0xc3, 0x87, 0xb6, 0x69, 0xb2, 0xee, 0x65, 0x86,
+        0x9f, 0x07, 0xe7, 0xbe, 0x55, 0x51, 0x38, 0x7a, 0x98, 0xba, 0x97, 0x7c, 0x73, 0x2d, 0x08, 0x0d,
+        0xcb, 0x0f, 0x29, 0xa0, 0x48, 0xe3, 0x65, 0x69, 0x12, 0xc6, 0x53, 0x3e, 0x32, 0xee, 0x7a, 0xed,
+        0x29, 0xb7, 0x21, 0x76, 0x9c, 0xe6, 0x4e, 0x43, 0xd5, 0x71, 0x33, 0xb0, 0x74, 0xd8, 0x39, 0xd5,
+        0x31, 0xed, 0x1f, 0x28, 0x51, 0x0a, 0xfb, 0x45, 0xac, 0xe1, 0x0a, 0x1f, 0x4b, 0x79, 0x4d, 0x6f,
+    };
+
+    byte key[SecureRandom::KeySize] = {0};
+    SecureRandom random{wrapMemory(key)};
+
+    // Read in uneven chunks to cross the block boundary
+    byte stream[sizeof(expected)];
+    random.fill(wrapMemory(stream, 5));
+    random.fill(wrapMemory(stream + 5, 70));
+    random.fill(wrapMemory(stream + 75, sizeof(stream) - 75));
+    EXPECT_EQ(wrapMemory(expected), wrapMemory(stream));
+
+    // Different stream of the same key is independent
+    SecureRandom other{wrapMemory(key), 1};
+    EXPECT_NE(SecureRandom{wrapMemory(key)}.nextUInt64(), other.nextUInt64());
+
+    EXPECT_THROW(SecureRandom{wrapMemory(key, 16)}, IllegalArgumentException);
+}
+
+TEST(TestSecureRandom, testLongStream) {
+    // Output spanning many refills never repeats a 64 bit value
+    byte key[SecureRandom::KeySize] = {1, 2, 3};
+    SecureRandom random{wrapMemory(key)};
+
+    std::set<uint64> values;
+    for (int i = 0; i < 10000; ++i) {
+        values.insert(random.nextUInt64());
+        random.nextUInt32();
+    }
+    EXPECT_EQ(10000U, values.size());
+}
+
+TEST(TestSecureRandom, testMoveContinuesStream) {
+    byte key[SecureRandom::KeySize] = {7};
+    SecureRandom expected{wrapMemory(key)};
+    SecureRandom random{wrapMemory(key)};
+    EXPECT_EQ(expected.nextUInt32(), random.nextUInt32());
+
+    SecureRandom moved{std::move(random)};
+    EXPECT_EQ(expected.nextUInt64(), moved.nextUInt64());
+
+    SecureRandom assigned{wrapMemory(key), 1};
+    assigned = std::move(moved);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(expected.nextUInt64(), assigned.nextUInt64());
+    }
+}
+
+TEST(TestSecureRandom, testSystemSeeded) {
+    auto first = makeSecureRandom();
+    auto second = makeSecureRandom();
+    ASSERT_TRUE(first.isOk());
+    ASSERT_TRUE(second.isOk());
+    EXPECT_NE(first.unwrap().nextUInt64(), second.unwrap().nextUInt64());
+
+    // Generator of a thread is created once and keeps its state
+    auto& random = threadLocalRandom();
+    EXPECT_EQ(&random, &threadLocalRandom());
+    EXPECT_NE(random.nextUInt64(), threadLocalRandom().nextUInt64());
+}
@@ -0,0 +1,193 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ * @file: test/test_recordReader.cpp
+ *******************************************************************************/
+#include <solace/recordReader.hpp>	 // Class being tested
+#include <solace/memoryManager.hpp>
+#include <solace/exception.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+
+using namespace Solace;
+
+
+namespace {
+
+std::vector<std::string> readAll(RecordReader& reader) {
+    std::vector<std::string> records;
+    auto result = reader.forEach([&records](StringView record) {
+        records.emplace_back(record.data(), record.size());
+    });
+    EXPECT_TRUE(result.isOk());
+
+    return records;
+}
+
+/// Write the text into a pipe and return the read end. Text must fit into the pipe buffer.
+int makePipe(std::string const& text) {
+    int fds[2];
+    EXPECT_EQ(0, ::pipe(fds));
+    EXPECT_EQ(static_cast<ssize_t>(text.size()), ::write(fds[1], text.data(), text.size()));
+    ::close(fds[1]);
+
+    return fds[0];
+}
+
+}  // namespace
+
+
+TEST(TestRecordReader, testLines) {
+    StringView const text{"first\nsecond\n\nlast"};
+    RecordReader reader{text.view()};
+
+    auto const records = readAll(reader);
+    ASSERT_EQ(4U, records.size());
+    EXPECT_EQ("first", records[0]);
+    EXPECT_EQ("second", records[1]);
+    EXPECT_EQ("", records[2]);
+    EXPECT_EQ("last", records[3]);
+    EXPECT_EQ(text.size(), reader.position());
+
+    // Records are views into the source
+    RecordReader again{text.view()};
+    EXPECT_EQ(text.data(), again.next().unwrap().get().data());
+}
+
+TEST(TestRecordReader, testTrailingDelimiter) {
+    RecordReader reader{StringView{"a\nb\n"}.view()};
+    EXPECT_EQ(StringView{"a"}, reader.next().unwrap().get());
+    EXPECT_EQ(StringView{"b"}, reader.next().unwrap().get());
+    EXPECT_TRUE(reader.next().unwrap().isNone());
+    EXPECT_TRUE(reader.next().unwrap().isNone());
+
+    RecordReader empty{MemoryView{}};
+    EXPECT_TRUE(empty.next().unwrap().isNone());
+}
+
+TEST(TestRecordReader, testCrLf) {
+    RecordReader reader{StringView{"GET / HTTP/1.1\r\nHost: x\r\n\r\n"}.view()};
+
+    auto const records = readAll(reader);
+    ASSERT_EQ(3U, records.size());
+    EXPECT_EQ("GET / HTTP/1.1", records[0]);
+    EXPECT_EQ("Host: x", records[1]);
+    EXPECT_EQ("", records[2]);
+}
+
+TEST(TestRecordReader, testCustomDelimiter) {
+    RecordReader reader{StringView{"a::b:c::::d:"}.view(), "::"};
+
+    auto const records = readAll(reader);
+    ASSERT_EQ(4U, records.size());
+    EXPECT_EQ("a", records[0]);
+    EXPECT_EQ("b:c", records[1]);
+    EXPECT_EQ("", records[2]);
+    EXPECT_EQ("d:", records[3]);
+
+    EXPECT_THROW(RecordReader(MemoryView{}, StringView{}), IllegalArgumentException);
+    EXPECT_THROW(RecordReader(MemoryView{}, "0123456789abcdefX"), IllegalArgumentException);
+}
+
+TEST(TestRecordReader, testLongRecords) {
+    // Records longer than a SIMD block, with delimiters at every offset within a block
+    std::string text;
+    std::vector<std::string> expected;
+    for (size_t i = 0; i < 200; ++i) {
+        expected.emplace_back(i, static_cast<char>('a' + i % 26));
+        text += expected.back();
+        text += '\n';
+    }
+
+    RecordReader reader{wrapMemory(&text[0], text.size())};
+    EXPECT_EQ(expected, readAll(reader));
+}
+
+TEST(TestRecordReader, testByteReader) {
+    char text[] = "one\r\ntwo\r\nthree";
+    ByteReader byteReader{wrapMemory(text, sizeof(text) - 1)};
+    RecordReader reader{byteReader};
+
+    EXPECT_EQ(StringView{"one"}, reader.next().unwrap().get());
+    EXPECT_EQ(5U, byteReader.position());
+    EXPECT_EQ(StringView{"two"}, reader.next().unwrap().get());
+    EXPECT_EQ(10U, byteReader.position());
+    EXPECT_EQ(StringView{"three"}, reader.next().unwrap().get());
+    EXPECT_EQ(0U, byteReader.remaining());
+    EXPECT_TRUE(reader.next().unwrap().isNone());
+}
+
+TEST(TestRecordReader, testFileDescriptor) {
+    std::string text;
+    std::vector<std::string> expected;
+    for (size_t i = 0; i < 100; ++i) {
+        expected.push_back("record-" + std::to_string(i * 7919));
+        text += expected.back();
+        text += "<|>";
+    }
+
+    // Small buffer forces records and delimiters to span refills
+    auto const fd = makePipe(text);
+    RecordReader reader{fd, getSystemHeapMemoryManager().allocate(24), "<|>"};
+    EXPECT_EQ(expected, readAll(reader));
+    EXPECT_EQ(text.size(), reader.position());
+    ::close(fd);
+}
+
+TEST(TestRecordReader, testRecordTooLong) {
+    auto const fd = makePipe("short\nthis record does not fit\nshort\n");
+    RecordReader reader{fd, getSystemHeapMemoryManager().allocate(16)};
+
+    EXPECT_EQ(StringView{"short"}, reader.next().unwrap().get());
+    EXPECT_TRUE(reader.next().isError());
+
+    // Record that is too long is skipped
+    EXPECT_EQ(StringView{"short"}, reader.next().unwrap().get());
+    EXPECT_TRUE(reader.next().unwrap().isNone());
+    ::close(fd);
+}
+
+TEST(TestRecordReader, testRecordSeveralBuffersLong) {
+    auto const fd = makePipe("abc\n" + std::string(50, 'x') + "\nnext\nlast");
+    RecordReader reader{fd, getSystemHeapMemoryManager().allocate(16)};
+
+    EXPECT_EQ(StringView{"abc"}, reader.next().unwrap().get());
+
+    // Single error however many buffers the record takes
+    EXPECT_TRUE(reader.next().isError());
+    EXPECT_EQ(StringView{"next"}, reader.next().unwrap().get());
+    EXPECT_EQ(StringView{"last"}, reader.next().unwrap().get());
+    EXPECT_TRUE(reader.next().unwrap().isNone());
+    ::close(fd);
+}
+
+TEST(TestRecordReader, testRecordLongerThanStringView) {
+    std::string const text = std::string(RecordReader::kMaxRecordLength + 1, 'x') + "\nnext\n" +
+            std::string(RecordReader::kMaxRecordLength + 1, 'y');
+
+    RecordReader reader{wrapMemory(text.data(), text.size())};
+    EXPECT_TRUE(reader.next().isError());
+    EXPECT_EQ(StringView{"next"}, reader.next().unwrap().get());
+    EXPECT_TRUE(reader.next().isError());
+    EXPECT_TRUE(reader.next().unwrap().isNone());
+    EXPECT_EQ(text.size(), reader.position());
+}
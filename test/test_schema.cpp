@@ -0,0 +1,199 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ * @file: test/test_schema.cpp
+ *******************************************************************************/
+#include <solace/schema.hpp>	 // Class being tested
+#include <solace/exception.hpp>
+
+#include <gtest/gtest.h>
+
+
+using namespace Solace;
+
+
+namespace {
+
+struct Point {
+    int32   x;
+    int32   y;
+};
+
+struct Entry {
+    uint64                  id;
+    StringView              name;
+    ArrayView<const uint32> blocks;
+    Optional<int16>         mode;
+    Optional<StringView>    owner;
+    float64                 weight;
+};
+
+struct Record {
+    String          label;
+    Array<uint16>   values;
+};
+
+}  // namespace
+
+
+namespace Solace {
+
+template<>
+struct Schema<Point> {
+    static constexpr auto fields = std::make_tuple(&Point::x, &Point::y);
+};
+
+template<>
+struct Schema<Entry> {
+    static constexpr auto fields = std::make_tuple(&Entry::id, &Entry::name, &Entry::blocks,
+                                                   &Entry::mode, &Entry::owner, &Entry::weight);
+};
+
+template<>
+struct Schema<Record> {
+    static constexpr auto fields = std::make_tuple(&Record::label, &Record::values);
+};
+
+}  // namespace Solace
+
+
+TEST(TestSchema, testFixedLayout) {
+    static_assert(SchemaView<Point>::kFixedSize == 8, "Two 32 bit slots");
+    static_assert(SchemaView<Entry>::kFixedSize == 8 + 8 + 8 + 3 + 9 + 8, "Slots of all the fields");
+
+    Point const point{-2, 0x01020304};
+    EXPECT_EQ(8, encodedSize(point));
+
+    byte buffer[8];
+    ByteWriter writer{wrapMemory(buffer)};
+    ASSERT_TRUE(encode(writer, point).isOk());
+    EXPECT_EQ(8, writer.position());
+
+    byte const expected[] = {0xFE, 0xFF, 0xFF, 0xFF, 0x04, 0x03, 0x02, 0x01};
+    EXPECT_EQ(wrapMemory(expected), writer.viewWritten());
+
+    auto view = makeSchemaView<Point>(writer.viewWritten()).unwrap();
+    EXPECT_EQ(-2, view.get<&Point::x>());
+    EXPECT_EQ(0x01020304, view.get<&Point::y>());
+}
+
+
+TEST(TestSchema, testRoundTrip) {
+    uint32 const blocks[] = {7, 0x10000, 0xFFFFFFFF};
+    Entry const entry{42, "readme.txt", arrayView(blocks), Optional<int16>{-5}, none, 0.5};
+
+    byte buffer[128];
+    ByteWriter writer{wrapMemory(buffer)};
+    ASSERT_TRUE(encode(writer, entry).isOk());
+    EXPECT_EQ(encodedSize(entry), writer.position());
+    EXPECT_EQ(SchemaView<Entry>::kFixedSize + 10 + sizeof(blocks), writer.position());
+
+    auto view = makeSchemaView<Entry>(writer.viewWritten()).unwrap();
+    EXPECT_EQ(42, view.get<&Entry::id>());
+    EXPECT_EQ(StringView{"readme.txt"}, view.get<&Entry::name>());
+    EXPECT_EQ(0.5, view.get<&Entry::weight>());
+
+    auto const decodedBlocks = view.get<&Entry::blocks>();
+    ASSERT_EQ(3, decodedBlocks.size());
+    EXPECT_EQ(7, decodedBlocks[0]);
+    EXPECT_EQ(0x10000, decodedBlocks[1]);
+    EXPECT_EQ(0xFFFFFFFF, decodedBlocks[2]);
+    EXPECT_THROW(decodedBlocks[3], IndexOutOfRangeException);
+
+    auto const mode = view.get<&Entry::mode>();
+    ASSERT_TRUE(mode.isSome());
+    EXPECT_EQ(-5, mode.get());
+    EXPECT_TRUE(view.get<&Entry::owner>().isNone());
+
+    // Strings refer to the message
+    auto const name = view.get<&Entry::name>();
+    EXPECT_GE(name.data(), reinterpret_cast<char const*>(writer.viewWritten().dataAddress()));
+}
+
+
+TEST(TestSchema, testOptionalString) {
+    Entry const entry{1, "", ArrayView<const uint32>{}, none, Optional<StringView>{StringView{"root"}}, 0};
+
+    byte buffer[64];
+    ByteWriter writer{wrapMemory(buffer)};
+    ASSERT_TRUE(encode(writer, entry).isOk());
+
+    auto view = makeSchemaView<Entry>(writer.viewWritten()).unwrap();
+    EXPECT_TRUE(view.get<&Entry::name>().empty());
+    EXPECT_TRUE(view.get<&Entry::blocks>().empty());
+    EXPECT_TRUE(view.get<&Entry::mode>().isNone());
+    ASSERT_TRUE(view.get<&Entry::owner>().isSome());
+    EXPECT_EQ(StringView{"root"}, view.get<&Entry::owner>().get());
+}
+
+
+TEST(TestSchema, testEncodeOverflow) {
+    Entry const entry{1, "name", ArrayView<const uint32>{}, none, none, 0};
+
+    byte buffer[SchemaView<Entry>::kFixedSize + 3];
+    ByteWriter writer{wrapMemory(buffer)};
+    EXPECT_TRUE(encode(writer, entry).isError());
+    EXPECT_EQ(0, writer.position());
+}
+
+
+TEST(TestSchema, testMalformedMessages) {
+    uint32 const blocks[] = {1, 2};
+    Entry const entry{1, "name", arrayView(blocks), none, none, 0};
+
+    byte buffer[64];
+    ByteWriter writer{wrapMemory(buffer)};
+    ASSERT_TRUE(encode(writer, entry).isOk());
+    auto const message = writer.viewWritten();
+
+    // Too short for the slots
+    EXPECT_TRUE(makeSchemaView<Entry>(message.slice(0, SchemaView<Entry>::kFixedSize - 1)).isError());
+
+    // Content of the array is cut off
+    EXPECT_TRUE(makeSchemaView<Entry>(message.slice(0, message.size() - 1)).isError());
+
+    // Invalid presence flag of an optional field
+    byte corrupted[64];
+    std::memcpy(corrupted, message.dataAddress(), message.size());
+    corrupted[24] = 2;
+    EXPECT_TRUE(makeSchemaView<Entry>(wrapMemory(corrupted, message.size())).isError());
+
+    // String offset outside of the message
+    std::memcpy(corrupted, message.dataAddress(), message.size());
+    corrupted[11] = 0x7F;
+    EXPECT_TRUE(makeSchemaView<Entry>(wrapMemory(corrupted, message.size())).isError());
+}
+
+
+TEST(TestSchema, testOwnedMembers) {
+    auto values = makeArray<uint16>(2);
+    values[0] = 0x0102;
+    values[1] = 0x0304;
+    Record const record{makeString("label"), std::move(values)};
+    EXPECT_EQ(16 + 5 + 4, encodedSize(record));
+
+    byte buffer[32];
+    ByteWriter writer{wrapMemory(buffer)};
+    ASSERT_TRUE(encode(writer, record).isOk());
+
+    byte const expectedValues[] = {0x02, 0x01, 0x04, 0x03};
+    EXPECT_EQ(wrapMemory(expectedValues), writer.viewWritten().slice(21, 25));
+
+    auto view = makeSchemaView<Record>(writer.viewWritten()).unwrap();
+    EXPECT_EQ(StringView{"label"}, view.get<&Record::label>());
+    EXPECT_EQ(0x0304, view.get<&Record::values>()[1]);
+}
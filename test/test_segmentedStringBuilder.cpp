@@ -0,0 +1,192 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ * @file: test/test_segmentedStringBuilder.cpp
+ *******************************************************************************/
+#include <solace/segmentedStringBuilder.hpp>	 // Class being tested
+#include <solace/exception.hpp>
+
+#include <gtest/gtest.h>
+
+
+using namespace Solace;
+
+
+class TestSegmentedStringBuilder: public ::testing::Test  {
+public:
+
+    TestSegmentedStringBuilder()
+        : _memoryManager(64*1024)
+    {}
+
+protected:
+    MemoryManager _memoryManager;
+};
+
+
+TEST_F(TestSegmentedStringBuilder, testEmpty) {
+    SegmentedStringBuilder builder{_memoryManager};
+
+    EXPECT_TRUE(builder.empty());
+    EXPECT_EQ(0, builder.length());
+    EXPECT_EQ(0, builder.segmentsCount());
+    EXPECT_TRUE(builder.indexOf('x').isNone());
+    EXPECT_EQ(StringView{}, builder.toString().unwrap().view());
+}
+
+TEST_F(TestSegmentedStringBuilder, testGrowsBeyondSegment) {
+    SegmentedStringBuilder builder{_memoryManager, 4};
+
+    builder.append("Hello")
+            .append(',')
+            .append(' ')
+            .append("world of chained segments");
+
+    EXPECT_EQ(32, builder.length());
+    EXPECT_LT(1, builder.segmentsCount());
+    EXPECT_EQ(StringView{"Hello, world of chained segments"}, builder.toString().unwrap().view());
+    EXPECT_EQ('w', builder[7]);
+    EXPECT_THROW(builder.charAt(32), IndexOutOfRangeException);
+}
+
+TEST_F(TestSegmentedStringBuilder, testGrowthDoesNotMoveData) {
+    SegmentedStringBuilder builder{_memoryManager, 8};
+    builder.append("12345678");
+    auto const firstSegment = builder.segment(0).dataAddress();
+
+    for (int i = 0; i < 100; ++i) {
+        builder.append("abcdefghij");
+    }
+
+    EXPECT_EQ(firstSegment, builder.segment(0).dataAddress());
+    EXPECT_EQ(1008, builder.length());
+}
+
+TEST_F(TestSegmentedStringBuilder, testIndexOfAcrossSegments) {
+    SegmentedStringBuilder builder{_memoryManager, 4};
+    builder.append("abcdefghijklmnop");
+
+    EXPECT_EQ(3, builder.indexOf('d').get());
+    EXPECT_EQ(3, builder.indexOf("defg").get());
+    EXPECT_EQ(10, builder.indexOf("klmno").get());
+    EXPECT_TRUE(builder.indexOf("xyz").isNone());
+    EXPECT_TRUE(builder.indexOf("opq").isNone());
+    EXPECT_TRUE(builder.indexOf("abc", 1).isNone());
+}
+
+TEST_F(TestSegmentedStringBuilder, testSubstring) {
+    SegmentedStringBuilder builder{_memoryManager, 4};
+    builder.append("abcdefghijklmnop");
+
+    EXPECT_EQ(StringView{"cdefghij"}, builder.substring(2, 10).unwrap().view());
+    EXPECT_EQ(StringView{"mnop"}, builder.substring(12, 100).unwrap().view());
+    EXPECT_EQ(StringView{}, builder.substring(5, 5).unwrap().view());
+}
+
+TEST_F(TestSegmentedStringBuilder, testReplaceSameLength) {
+    SegmentedStringBuilder builder{_memoryManager, 4};
+    builder.append("one two one two");
+
+    EXPECT_EQ(2, builder.replace("two", "2+2"));
+    EXPECT_EQ(StringView{"one 2+2 one 2+2"}, builder.toString().unwrap().view());
+
+    EXPECT_EQ(3, builder.replace(' ', '_'));
+    EXPECT_EQ(StringView{"one_2+2_one_2+2"}, builder.toString().unwrap().view());
+}
+
+TEST_F(TestSegmentedStringBuilder, testReplaceDifferentLength) {
+    SegmentedStringBuilder builder{_memoryManager, 4};
+    builder.append("one two one two");
+
+    EXPECT_EQ(2, builder.replace("one", "1"));
+    EXPECT_EQ(StringView{"1 two 1 two"}, builder.toString().unwrap().view());
+
+    EXPECT_EQ(2, builder.replace("two", "three"));
+    EXPECT_EQ(StringView{"1 three 1 three"}, builder.toString().unwrap().view());
+    EXPECT_EQ(15, builder.length());
+
+    EXPECT_EQ(0, builder.replace("four", "4"));
+}
+
+TEST_F(TestSegmentedStringBuilder, testAppendFormat) {
+    SegmentedStringBuilder builder{_memoryManager, 4};
+
+    builder.appendFormat(SOLACE_FMT("{}={:08.3f}"), "pi", 3.14159)
+            .appendFormat(StringView{";{}"}, 42);
+
+    EXPECT_EQ(StringView{"pi=0003.142;42"}, builder.toString().unwrap().view());
+}
+
+TEST_F(TestSegmentedStringBuilder, testAppendFormatInvalidFormat) {
+    SegmentedStringBuilder builder{_memoryManager, 16};
+    builder.append("ab");
+
+    EXPECT_THROW(builder.appendFormat(StringView{"{:q}"}, 7), IllegalArgumentException);
+    EXPECT_EQ(StringView{"ab"}, builder.toString().unwrap().view());
+}
+
+TEST_F(TestSegmentedStringBuilder, testClearKeepsFirstSegment) {
+    SegmentedStringBuilder builder{_memoryManager, 4};
+    builder.append("abcdefghijkl");
+    ASSERT_LT(1U, builder.segmentsCount());
+
+    builder.clear();
+    EXPECT_EQ(1U, builder.segmentsCount());
+    EXPECT_TRUE(builder.empty());
+
+    builder.append("xy");
+    EXPECT_EQ(1U, builder.segmentsCount());
+    EXPECT_EQ(StringView{"xy"}, builder.toString().unwrap().view());
+}
+
+TEST_F(TestSegmentedStringBuilder, testIOVec) {
+    SegmentedStringBuilder builder{_memoryManager, 4};
+    builder.append("abcdefghijkl");
+
+    iovec vecs[8];
+    auto const count = builder.toIOVec(arrayView(vecs));
+    EXPECT_EQ(builder.segmentsCount(), count);
+
+    size_t total = 0;
+    for (uint32 i = 0; i < count; ++i) {
+        total += vecs[i].iov_len;
+    }
+    EXPECT_EQ(builder.length(), total);
+    EXPECT_EQ(0, memcmp(vecs[0].iov_base, "abcd", 4));
+
+    EXPECT_EQ(1, builder.toIOVec(arrayView(vecs, 1)));
+}
+
+TEST_F(TestSegmentedStringBuilder, testCopyToAndClear) {
+    SegmentedStringBuilder builder{_memoryManager, 4};
+    builder.append("abcdefghij");
+
+    char buffer[16];
+    ByteWriter writer{wrapMemory(buffer)};
+    EXPECT_TRUE(builder.copyTo(writer));
+    EXPECT_EQ(10, writer.position());
+    EXPECT_EQ(0, memcmp(buffer, "abcdefghij", 10));
+
+    char small[4];
+    ByteWriter smallWriter{wrapMemory(small)};
+    EXPECT_TRUE(builder.copyTo(smallWriter).isError());
+
+    builder.clear();
+    EXPECT_TRUE(builder.empty());
+    builder.append("xyz");
+    EXPECT_EQ(StringView{"xyz"}, builder.toString().unwrap().view());
+}
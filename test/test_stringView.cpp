@@ -135,6 +135,25 @@ TEST(TestStringView, testCompareTo) {
     EXPECT_TRUE(StringView{"bcd"} < StringLiteral{"bcd0x"});
 }
 
+/**
+* @see StringView::equalsIgnoreCase
+* @see StringView::compareToIgnoreCase
+*/
+TEST(TestStringView, testEqualsIgnoreCase) {
+    EXPECT_TRUE(StringView{}.equalsIgnoreCase(""));
+    EXPECT_TRUE(StringView{"Content-Length"}.equalsIgnoreCase("content-length"));
+    EXPECT_TRUE(StringView{"ACCEPT-encoding: GZIP, deflate"}.equalsIgnoreCase("Accept-Encoding: gzip, DEFLATE"));
+    EXPECT_FALSE(StringView{"Content-Length"}.equalsIgnoreCase("content-length "));
+    EXPECT_FALSE(StringView{"Content-Length: 0123456789"}.equalsIgnoreCase("content-length: 0123456788"));
+    // Only letters are folded
+    EXPECT_FALSE(StringView{"[@"}.equalsIgnoreCase("{`"));
+
+    EXPECT_EQ(0, StringView{"Host"}.compareToIgnoreCase("hOST"));
+    EXPECT_GT(0, StringView{"abc"}.compareToIgnoreCase("ABD"));
+    EXPECT_LT(0, StringView{"User-Agent"}.compareToIgnoreCase("user"));
+    EXPECT_GT(0, StringView{"user"}.compareToIgnoreCase("User-Agent"));
+}
+
 /**
     * @see StringView::length
     */
@@ -181,6 +200,19 @@ TEST(TestStringView, testEndsWith) {
                     .endsWith("Some very long statement that can't possibly"));
 }
 
+/**
+    * @see StringView::startsWithIgnoreCase
+    * @see StringView::endsWithIgnoreCase
+    */
+TEST(TestStringView, testStartsEndsWithIgnoreCase) {
+    EXPECT_TRUE(StringView{}.startsWithIgnoreCase(StringView{}));
+    EXPECT_TRUE(StringView{"Transfer-Encoding: chunked"}.startsWithIgnoreCase("TRANSFER-encoding"));
+    EXPECT_FALSE(StringView{"Transfer"}.startsWithIgnoreCase("Transfer-Encoding"));
+
+    EXPECT_TRUE(StringView{"Transfer-Encoding: chunked"}.endsWithIgnoreCase("CHUNKED"));
+    EXPECT_FALSE(StringView{"Transfer-Encoding: chunked"}.endsWithIgnoreCase("chunk"));
+}
+
 /**
 * @see StringView::substring
 */
@@ -259,6 +291,24 @@ TEST(TestStringView, testIndexOf) {
     EXPECT_TRUE(StringView("hi").indexOf("hi", 5).isNone());
 }
 
+/**
+    * @see StringView::indexOfIgnoreCase
+    */
+TEST(TestStringView, testIndexOfIgnoreCase) {
+    const StringView src("Cache-Control: no-cache, NO-STORE, must-revalidate");
+
+    EXPECT_EQ(0, src.indexOfIgnoreCase("cache").get());
+    EXPECT_EQ(18, src.indexOfIgnoreCase("CACHE", 1).get());
+    EXPECT_EQ(25, src.indexOfIgnoreCase("no-store").get());
+    EXPECT_EQ(35, src.indexOfIgnoreCase("Must-Revalidate").get());
+    EXPECT_EQ(3, src.indexOfIgnoreCase("", 3).get());
+
+    EXPECT_TRUE(src.indexOfIgnoreCase("no-transform").isNone());
+    EXPECT_TRUE(src.indexOfIgnoreCase("cache", 20).isNone());
+    EXPECT_TRUE(StringView("hi").indexOfIgnoreCase("HI", 5).isNone());
+    EXPECT_TRUE(StringView("hi").indexOfIgnoreCase("hi, long string").isNone());
+}
+
 /**
     * @see StringView::lastIndexOf
     */
@@ -304,6 +354,15 @@ TEST(TestStringView, testHashCode) {
                     StringView("Hello out there").hashCode());
 }
 
+/**
+    * @see StringView::hashCodeIgnoreCase
+    */
+TEST(TestStringView, testHashCodeIgnoreCase) {
+    EXPECT_EQ(StringView("content-type").hashCode(), StringView("Content-Type").hashCodeIgnoreCase());
+    EXPECT_EQ(StringView("CONTENT-TYPE").hashCodeIgnoreCase(), StringView("Content-Type").hashCodeIgnoreCase());
+    EXPECT_NE(StringView("Content-Type").hashCodeIgnoreCase(), StringView("Content-Length").hashCodeIgnoreCase());
+}
+
 TEST(TestStringView, testSplitByChar) {
     {
         int acc = 0;
@@ -0,0 +1,213 @@
+/*
+*  Copyright 2018 Ivan Ryabov
+*
+*  Licensed under the Apache License, Version 2.0 (the "License");
+*  you may not use this file except in compliance with the License.
+*  You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing, software
+*  distributed under the License is distributed on an "AS IS" BASIS,
+*  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*  See the License for the specific language governing permissions and
+*  limitations under the License.
+*/
+/*******************************************************************************
+ * libSolace Unit Test Suit
+ * @file: test/test_utf8.cpp
+ *******************************************************************************/
+#include <solace/utf8.hpp>	 // Class being tested
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+
+using namespace Solace;
+
+
+namespace {
+
+/// Straightforward reference validator: offset of the first ill-formed sequence or size if valid.
+size_t referenceInvalidOffset(std::vector<byte> const& data) {
+    size_t i = 0;
+    while (i < data.size()) {
+        auto const start = i;
+        uint32 cp = data[i];
+        size_t len = 1;
+        if (cp >= 0x80) {
+            if (cp >= 0xC0 && cp < 0xE0) { len = 2; cp &= 0x1F; }
+            else if (cp >= 0xE0 && cp < 0xF0) { len = 3; cp &= 0x0F; }
+            else if (cp >= 0xF0 && cp < 0xF8) { len = 4; cp &= 0x07; }
+            else { return start; }
+
+            if (i + len > data.size()) {
+                return start;
+            }
+
+            for (size_t k = 1; k < len; ++k) {
+                if ((data[i + k] & 0xC0) != 0x80) {
+                    return start;
+                }
+                cp = (cp << 6) | (data[i + k] & 0x3F);
+            }
+
+            static const uint32 minValue[] = {0, 0, 0x80, 0x800, 0x10000};
+            if (cp < minValue[len] || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+                return start;
+            }
+        }
+
+        i += len;
+    }
+
+    return data.size();
+}
+
+MemoryView view(std::vector<byte> const& data) {
+    return wrapMemory(data.data(), data.size());
+}
+
+}  // namespace
+
+
+TEST(TestUtf8, testValidate) {
+    EXPECT_TRUE(validateUtf8(StringView{""}).isOk());
+    EXPECT_TRUE(validateUtf8(StringView{"plain ascii"}).isOk());
+    EXPECT_TRUE(validateUtf8(StringView{"\xD0\x9F\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82"}).isOk());
+    EXPECT_TRUE(validateUtf8(StringView{"\xE2\x82\xAC \xF0\x9F\x98\x80 \xF4\x8F\xBF\xBF"}).isOk());
+
+    // Overlong encoding
+    EXPECT_EQ(2U, validateUtf8(StringView{"ab\xC0\xAF"}).getError().offset);
+    // Surrogate
+    EXPECT_EQ(0U, validateUtf8(StringView{"\xED\xA0\x80"}).getError().offset);
+    // Above U+10FFFF
+    EXPECT_EQ(1U, validateUtf8(StringView{"x\xF4\x90\x80\x80"}).getError().offset);
+    // Truncated sequence at the end
+    EXPECT_EQ(3U, validateUtf8(StringView{"abc\xE2\x82"}).getError().offset);
+    // Stray continuation byte
+    EXPECT_EQ(0U, validateUtf8(StringView{"\x80"}).getError().offset);
+}
+
+TEST(TestUtf8, testValidateLongInput) {
+    std::vector<byte> text;
+    for (int i = 0; i < 100; ++i) {
+        for (auto c : StringView{"Hello \xE2\x82\xAC\xF0\x9F\x98\x80 "}) {
+            text.push_back(static_cast<byte>(c));
+        }
+    }
+    EXPECT_TRUE(validateUtf8(view(text)).isOk());
+
+    // Errors at every position within a block are located exactly
+    for (size_t pos = 0; pos < 70; ++pos) {
+        auto corrupted = text;
+        corrupted[pos] = 0xFF;
+        auto const result = validateUtf8(view(corrupted));
+        ASSERT_TRUE(result.isError());
+        EXPECT_EQ(referenceInvalidOffset(corrupted), result.getError().offset);
+    }
+}
+
+TEST(TestUtf8, testValidateMatchesReference) {
+    std::mt19937 rng{42};
+    // Bias towards bytes that form (and break) multi-byte sequences
+    byte const alphabet[] = {'a', 'z', 0x7F, 0x80, 0x8F, 0x90, 0x9F, 0xA0, 0xBF,
+                             0xC2, 0xDF, 0xE0, 0xED, 0xEF, 0xF0, 0xF4, 0xF5, 0xC0};
+
+    for (int round = 0; round < 2000; ++round) {
+        std::vector<byte> data(std::uniform_int_distribution<size_t>{0, 100}(rng));
+        for (auto& b : data) {
+            b = alphabet[std::uniform_int_distribution<size_t>{0, sizeof(alphabet) - 1}(rng)];
+        }
+
+        auto const expected = referenceInvalidOffset(data);
+        auto const result = validateUtf8(view(data));
+        if (expected == data.size()) {
+            EXPECT_TRUE(result.isOk());
+        } else {
+            ASSERT_TRUE(result.isError());
+            EXPECT_EQ(expected, result.getError().offset);
+        }
+    }
+}
+
+TEST(TestUtf8, testCountCodePoints) {
+    EXPECT_EQ(0U, countCodePoints(StringView{""}).unwrap());
+    EXPECT_EQ(5U, countCodePoints(StringView{"hello"}).unwrap());
+    EXPECT_EQ(5U, countCodePoints(StringView{"a\xE2\x82\xAC\xF0\x9F\x98\x80\xD1\x80z"}).unwrap());
+
+    std::vector<byte> text;
+    for (int i = 0; i < 50; ++i) {
+        for (auto c : StringView{"\xE2\x82\xAC-"}) {
+            text.push_back(static_cast<byte>(c));
+        }
+    }
+    EXPECT_EQ(100U, countCodePoints(view(text)).unwrap());
+
+    EXPECT_TRUE(countCodePoints(StringView{"\xE2\x82"}).isError());
+}
+
+TEST(TestUtf8, testUtf8ToUtf16RoundTrip) {
+    StringView const src{"ASCII prefix that is long enough, \xE2\x82\xAC and \xF0\x9F\x98\x80!"};
+
+    char16_t utf16[64];
+    auto const units = utf8ToUtf16(src.view(), arrayView(utf16));
+    ASSERT_TRUE(units.isOk());
+    EXPECT_EQ(utf16Length(src.view()), units.unwrap());
+    EXPECT_EQ(u'A', utf16[0]);
+    EXPECT_EQ(u'€', utf16[34]);
+    EXPECT_EQ(0xD83D, utf16[40]);
+    EXPECT_EQ(0xDE00, utf16[41]);
+
+    byte buffer[128];
+    ByteWriter writer{wrapMemory(buffer)};
+    auto const utf16View = arrayView(static_cast<char16_t const*>(utf16), units.unwrap());
+    EXPECT_EQ(src.size(), utf8Length(utf16View));
+    ASSERT_TRUE(utf16ToUtf8(utf16View, writer).isOk());
+    EXPECT_EQ(src.view(), writer.viewWritten());
+}
+
+TEST(TestUtf8, testUtf8ToUtf32RoundTrip) {
+    StringView const src{"0123456789abcdef\xD0\x9F\xD1\x80\xD0\xB8\xD0\xB2\xD0\xB5\xD1\x82 \xF0\x9F\x98\x80"};
+
+    char32_t utf32[64];
+    auto const count = utf8ToUtf32(src.view(), arrayView(utf32));
+    ASSERT_TRUE(count.isOk());
+    EXPECT_EQ(countCodePoints(src).unwrap(), count.unwrap());
+    EXPECT_EQ(U'f', utf32[15]);
+    EXPECT_EQ(U'П', utf32[16]);
+    EXPECT_EQ(U'\U0001F600', utf32[23]);
+
+    byte buffer[128];
+    ByteWriter writer{wrapMemory(buffer)};
+    auto const utf32View = arrayView(static_cast<char32_t const*>(utf32), count.unwrap());
+    EXPECT_EQ(src.size(), utf8Length(utf32View));
+    ASSERT_TRUE(utf32ToUtf8(utf32View, writer).isOk());
+    EXPECT_EQ(src.view(), writer.viewWritten());
+}
+
+TEST(TestUtf8, testTranscodingErrors) {
+    char16_t utf16[4];
+    auto const invalid = utf8ToUtf16(StringView{"ab\xFF"}.view(), arrayView(utf16));
+    ASSERT_TRUE(invalid.isError());
+    EXPECT_EQ(EncodingError::Kind::InvalidSequence, invalid.getError().kind);
+    EXPECT_EQ(2U, invalid.getError().offset);
+
+    auto const tooSmall = utf8ToUtf16(StringView{"abcde"}.view(), arrayView(utf16));
+    ASSERT_TRUE(tooSmall.isError());
+    EXPECT_EQ(EncodingError::Kind::DestinationTooSmall, tooSmall.getError().kind);
+    EXPECT_EQ(4U, tooSmall.getError().offset);
+
+    byte buffer[16];
+    ByteWriter writer{wrapMemory(buffer)};
+    char16_t const loneSurrogate[] = {u'a', 0xD800, u'b'};
+    auto const result = utf16ToUtf8(arrayView(loneSurrogate), writer);
+    ASSERT_TRUE(result.isError());
+    EXPECT_EQ(1U, result.getError().offset);
+    EXPECT_EQ(0U, writer.position());
+
+    char32_t const outOfRange[] = {U'a', 0x110000};
+    EXPECT_TRUE(utf32ToUtf8(arrayView(outOfRange), writer).isError());
+}
@@ -49,6 +49,57 @@ TEST(TestUUID, testRandom) {
             EXPECT_TRUE(ids[i] != ids[j]);
         }
     }
+
+    EXPECT_EQ(4U, ids[0].version());
+    EXPECT_EQ(0x80, ids[0][8] & 0xC0);
+}
+
+
+TEST(TestUUID, testRandomBatch) {
+    UUID ids[RandomSampleSize];
+    makeRandomUUIDs(arrayView(ids));
+
+    for (uint i = 0; i < RandomSampleSize; ++i) {
+        EXPECT_EQ(4U, ids[i].version());
+        EXPECT_EQ(0x80, ids[i][8] & 0xC0);
+        for (uint j = i + 1; j < RandomSampleSize; ++j) {
+            EXPECT_TRUE(ids[i] != ids[j]);
+        }
+    }
+}
+
+
+TEST(TestUUID, testTimeOrdered) {
+    byte key[SecureRandom::KeySize] = {0};
+    SecureRandom random{wrapMemory(key)};
+    UUIDGenerator generator{random};
+
+    // Timestamp is stored big-endian in the first 48 bits
+    auto const first = generator.timeOrdered(0x0123456789AB);
+    byte const timestamp[] = {0x01, 0x23, 0x45, 0x67, 0x89, 0xAB};
+    EXPECT_EQ(wrapMemory(timestamp), first.view().slice(0, 6));
+    EXPECT_EQ(7U, first.version());
+    EXPECT_EQ(0x80, first[8] & 0xC0);
+
+    // Increasing within a millisecond and when the clock goes backwards
+    auto previous = first;
+    for (uint64 millis : {0x0123456789ABULL, 0x0123456789ABULL, 0x0123456789AAULL, 0x0123456789ACULL, 1ULL}) {
+        auto const next = generator.timeOrdered(millis);
+        EXPECT_LT(previous, next);
+        EXPECT_EQ(7U, next.version());
+        previous = next;
+    }
+
+    // UUIDs of a batch are increasing and follow UUIDs made before
+    UUID batch[RandomSampleSize];
+    auto const before = makeTimeOrderedUUID();
+    makeTimeOrderedUUIDs(arrayView(batch));
+    EXPECT_LT(before, batch[0]);
+    for (uint i = 1; i < RandomSampleSize; ++i) {
+        EXPECT_LT(batch[i - 1], batch[i]);
+        EXPECT_EQ(7U, batch[i].version());
+    }
+    EXPECT_LT(batch[RandomSampleSize - 1], makeTimeOrderedUUID());
 }
 
 
@@ -149,6 +200,60 @@ TEST(TestUUID, testParsable) {
 }
 
 
+TEST(TestUUID, testParseIsStrict) {
+    byte const bytes[] = {0x12, 0x3e, 0x45, 0x67, 0xe8, 0x9b, 0x12, 0xd3,
+                          0xa4, 0x56, 0x42, 0x66, 0x55, 0x44, 0x0, 0x0};
+    EXPECT_EQ(UUID(bytes), UUID::parse("123E4567-E89B-12D3-A456-426655440000").unwrap());
+
+    // Dashes must be where canonical form puts them
+    EXPECT_TRUE(UUID::parse("123e4567e-89b-12d3-a456-426655440000").isError());
+    EXPECT_TRUE(UUID::parse("123e4567-e89b-12d3-a456-4266554400-0").isError());
+    EXPECT_TRUE(UUID::parse("123e4567-e89b-12d3-a456+426655440000").isError());
+
+    // Every character in every digit position is checked
+    char text[] = "123e4567-e89b-12d3-a456-426655440000";
+    for (UUID::size_type i = 0; i < UUID::StringSize; ++i) {
+        if (text[i] == '-') {
+            continue;
+        }
+
+        auto const original = text[i];
+        for (int c = 0; c < 256; ++c) {
+            text[i] = static_cast<char>(c);
+            bool const isHex = (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+            EXPECT_EQ(isHex, UUID::parse(StringView{text, UUID::StringSize}).isOk()) << i << ": " << c;
+        }
+        text[i] = original;
+    }
+}
+
+
+TEST(TestUUID, testBulkConversion) {
+    UUID ids[RandomSampleSize];
+    makeRandomUUIDs(arrayView(ids));
+
+    char text[RandomSampleSize * UUID::StringSize];
+    auto const written = formatUUIDs(arrayView(ids), wrapMemory(text));
+    ASSERT_TRUE(written.isOk());
+    EXPECT_EQ(sizeof(text), written.unwrap());
+
+    for (uint i = 0; i < RandomSampleSize; ++i) {
+        EXPECT_EQ(ids[i].toString(), StringView(text + i * UUID::StringSize, UUID::StringSize));
+    }
+
+    UUID parsed[RandomSampleSize];
+    ASSERT_TRUE(parseUUIDs(wrapMemory(text), arrayView(parsed)).isOk());
+    for (uint i = 0; i < RandomSampleSize; ++i) {
+        EXPECT_EQ(ids[i], parsed[i]);
+    }
+
+    EXPECT_TRUE(formatUUIDs(arrayView(ids), wrapMemory(text, sizeof(text) - 1)).isError());
+    EXPECT_TRUE(parseUUIDs(wrapMemory(text, sizeof(text) - 1), arrayView(parsed)).isError());
+    text[5 * UUID::StringSize + 3] = 'x';
+    EXPECT_TRUE(parseUUIDs(wrapMemory(text), arrayView(parsed)).isError());
+}
+
+
 TEST(TestUUID, testParsing_and_ToString_are_consistent) {
     for (uint i = 0; i < RandomSampleSize; ++i) {
         auto const r0 = makeRandomUUID();
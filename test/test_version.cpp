@@ -236,6 +236,9 @@ TEST(TestVersion, testParsing) {
 		EXPECT_TRUE(Version::parse("x3+Bingo").isError());
 		EXPECT_TRUE(Version::parse("3.+Bingo").isError());
 		EXPECT_TRUE(Version::parse("3.1-+Bingo").isError());
+		EXPECT_TRUE(Version::parse("3.1x.4").isError());
+		EXPECT_TRUE(Version::parse("3.1.+4").isError());
+		EXPECT_TRUE(Version::parse("99999999999.1.4").isError());
 	}
 
 }